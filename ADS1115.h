@@ -72,6 +72,7 @@ public:
     
     // 多路复用器支持
     void setMuxChannel(I2CMux* mux, uint8_t channel);
+    uint8_t getMuxChannel() const { return _channel; }
     
     // 读取原始ADC值
     int16_t readRaw(uint8_t mux = ADS1115_MUX_AIN0_GND);
@@ -0,0 +1,87 @@
+#include "BreathAnalyzer.h"
+
+void BreathAnalyzer::reset() {
+    memset(&_record, 0, sizeof(_record));
+    _recordCount = 0;
+    _lastState = EXHALE;
+    _hasLastSample = false;
+    _lastTimestampUs = 0;
+    _lastPressureKpa = 0;
+    _lastFlowMlMin = NAN;
+    _hasInspirationStart = false;
+    _hasPreviousInspiration = false;
+    _hasExpirationStart = false;
+    _inspirationStartUs = 0;
+    _previousInspirationStartUs = 0;
+    _expirationStartUs = 0;
+    _expiratoryTimeUs = 0;
+    _peepKpa = NAN;
+    _pipKpa = NAN;
+    _volumeMl = 0;
+    _volumeValid = false;
+}
+
+bool BreathAnalyzer::update(unsigned long timestampUs, BreathState state, float pressureKpa, float flowMlMin) {
+    bool emitted = false;
+    bool wasInspiration = _hasLastSample && isInspiration(_lastState);
+    bool inspiration = isInspiration(state);
+
+    if (inspiration && !wasInspiration) {
+        // 吸气开始：结算上一段呼气，呼气末压取开始前最后一个样本
+        if (_hasInspirationStart) {
+            _previousInspirationStartUs = _inspirationStartUs;
+            _hasPreviousInspiration = true;
+        }
+        _inspirationStartUs = timestampUs;
+        _hasInspirationStart = true;
+        if (_hasExpirationStart) {
+            _expiratoryTimeUs = timestampUs - _expirationStartUs;
+            _peepKpa = _hasLastSample ? _lastPressureKpa : pressureKpa;
+        } else {
+            _expiratoryTimeUs = 0;
+            _peepKpa = NAN;
+        }
+        _pipKpa = pressureKpa;
+        _volumeMl = 0;
+        _volumeValid = !isnan(flowMlMin);
+    } else if (inspiration) {
+        // 吸气中：峰压取最大值，流量按上一样本的值积分（ml/min × us -> ml）
+        if (pressureKpa > _pipKpa) _pipKpa = pressureKpa;
+        if (isnan(_lastFlowMlMin)) {
+            _volumeValid = false;
+        } else {
+            _volumeMl += (double)_lastFlowMlMin * (uint32_t)(timestampUs - _lastTimestampUs) / 60e6;
+        }
+    } else if (wasInspiration && _hasInspirationStart) {
+        // 吸气结束：有完整的前一段呼气和上一次吸气时输出记录
+        if (!isnan(_lastFlowMlMin) && _volumeValid) {
+            _volumeMl += (double)_lastFlowMlMin * (uint32_t)(timestampUs - _lastTimestampUs) / 60e6;
+        }
+        uint32_t inspiratoryTimeUs = timestampUs - _inspirationStartUs;
+        if (_hasPreviousInspiration && _expiratoryTimeUs > 0 && inspiratoryTimeUs > 0) {
+            uint32_t periodUs = _inspirationStartUs - _previousInspirationStartUs;
+            _record.breathIndex = _recordCount++;
+            _record.timestampUs = timestampUs;
+            _record.pipKpa = _pipKpa;
+            _record.peepKpa = _peepKpa;
+            _record.respiratoryRate = periodUs ? 60e6f / periodUs : NAN;
+            _record.ieRatio = (float)inspiratoryTimeUs / _expiratoryTimeUs;
+            _record.inspiratoryTimeMs = inspiratoryTimeUs / 1000;
+            _record.expiratoryTimeMs = _expiratoryTimeUs / 1000;
+            _record.tidalVolumeMl = _volumeValid ? (float)_volumeMl : NAN;
+            _record.triggerDelayMs = NAN;
+            _record.complianceMlCmH2O = NAN;
+            _record.resistanceCmH2O = NAN;
+            emitted = true;
+        }
+        _expirationStartUs = timestampUs;
+        _hasExpirationStart = true;
+    }
+
+    _lastState = state;
+    _hasLastSample = true;
+    _lastTimestampUs = timestampUs;
+    _lastPressureKpa = pressureKpa;
+    _lastFlowMlMin = flowMlMin;
+    return emitted;
+}
@@ -0,0 +1,67 @@
+#ifndef BreathAnalyzer_h
+#define BreathAnalyzer_h
+
+#include <Arduino.h>
+
+// 呼吸状态
+enum BreathState { INHALE, EXHALE, PEAK, TROUGH };
+
+// 单次呼吸的统计记录，在吸气结束（进入EXHALE）时生成。
+// 呼气相关字段取本次吸气之前的那段呼气，与呼吸机逐次显示的口径一致。
+struct BreathRecord {
+    uint32_t breathIndex;
+    unsigned long timestampUs;      // 吸气结束时刻
+    float pipKpa;                   // 吸气峰压（相对基准）
+    float peepKpa;                  // 呼气末压：吸气开始前最后一个样本（相对基准）
+    float respiratoryRate;          // 呼吸频率(次/分)：上次与本次吸气开始的间隔
+    float ieRatio;                  // 吸呼比 Ti/Te
+    uint32_t inspiratoryTimeMs;     // Ti
+    uint32_t expiratoryTimeMs;      // Te
+    float tidalVolumeMl;            // 吸气段流量积分；无流量数据时为NAN
+    float triggerDelayMs;           // 本次吸气的触发延迟（由起始检测器填写，未知为NAN）
+    float complianceMlCmH2O;        // 当前顺应性估计（由肺力学估计器填写，无有效估计为NAN）
+    float resistanceCmH2O;          // 当前气道阻力估计 cmH2O/(L/s)
+};
+
+// 逐样本增量计算的呼吸分析器：只保存当前呼吸的累计量，
+// 不缓存波形，每个样本O(1)，可在满采样率下运行。
+// 一次完整的“呼气 -> 吸气 -> 呼气”之后才开始输出记录。
+class BreathAnalyzer {
+public:
+    BreathAnalyzer() { reset(); }
+
+    // 每个主气压样本调用一次：state为状态检测结果，pressureKpa为相对基准的压力，
+    // flowMlMin为当前流量（无流量传感器传NAN）。返回true表示刚生成一条记录
+    bool update(unsigned long timestampUs, BreathState state, float pressureKpa, float flowMlMin);
+
+    const BreathRecord& lastRecord() const { return _record; }
+    uint32_t recordCount() const { return _recordCount; }
+    void reset();
+
+private:
+    bool isInspiration(BreathState state) const { return state == INHALE || state == PEAK; }
+
+    BreathRecord _record;
+    uint32_t _recordCount;
+
+    BreathState _lastState;
+    bool _hasLastSample;
+    unsigned long _lastTimestampUs;
+    float _lastPressureKpa;
+    float _lastFlowMlMin;
+
+    // 当前呼吸的累计量
+    bool _hasInspirationStart;
+    bool _hasPreviousInspiration;
+    bool _hasExpirationStart;
+    unsigned long _inspirationStartUs;
+    unsigned long _previousInspirationStartUs;
+    unsigned long _expirationStartUs;
+    uint32_t _expiratoryTimeUs;
+    float _peepKpa;
+    float _pipKpa;
+    double _volumeMl;
+    bool _volumeValid;
+};
+
+#endif
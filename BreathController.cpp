@@ -2,16 +2,17 @@
 
 // 常量定义
 constexpr int STORE_SIZE = 10;
-constexpr int FILTER_WINDOW = 5;
-constexpr float EWMA_ALPHA = 0.3;
 constexpr int ADAPT_CYCLES = 5;
-constexpr unsigned long RECONNECT_INTERVAL = 5000;
+constexpr unsigned long CONNECTION_STEP_INTERVAL_MS = 10;  // 单核定时循环中连接状态机的推进间隔
+constexpr unsigned long SLOW_WORK_INTERVAL_MS = 100;  // 定时采样模式下慢速设备的轮询间隔
+constexpr uint8_t OLED_CHUNKS_PER_ROUND = 8;          // 定时采样模式下每轮最多发送的OLED显存段数
+constexpr unsigned long PIPELINE_STATS_INTERVAL_MS = 5000;
 
-BreathController::BreathController(I2CMux* mux) : _mux(mux), acd1100(mux, 4, COMM_I2C), ads1115(nullptr), oxygenSensor(nullptr) {
-    // 初始化滤波历史数组
-    for (int i = 0; i < FILTER_WINDOW; i++) {
-        pressureHistory[i] = NAN;
+BreathController::BreathController(I2CMux* mux) : _mux(mux), _scheduler(mux), acd1100(mux, 4, COMM_I2C), ads1115(nullptr), oxygenSensor(nullptr) {
+    for (uint8_t i = 0; i < MAX_MUX_CHANNELS; i++) {
+        _channelDeviceId[i] = -1;
     }
+    _onsetDetector.setSlopeThreshold(pressureThreshold);
 }
 
 void BreathController::begin() {
@@ -31,9 +32,13 @@ void BreathController::begin() {
         scanI2CBus();
     }
     
-    // 初始化气阀控制
-    pinMode(VALVE_PIN, OUTPUT);
-    analogWrite(VALVE_PIN, 0); // 初始关闭气阀
+    // 初始化气阀控制（LEDC高分辨率PWM，初始关闭）
+    _valve.begin(VALVE_PIN, VALVE_LEDC_CHANNEL, _valvePwmFreqHz, _valvePwmBits);
+    if (_valveLinearizer.load()) {
+        Serial.print("已加载气阀特性表，满开响应: ");
+        Serial.print(_valveLinearizer.table().fullScale, 2);
+        Serial.println(_valveLinearizer.table().kind == VALVE_RESPONSE_FLOW ? " ml/min" : " kPa");
+    }
     
     // 初始化传感器
     initSensor();
@@ -124,11 +129,33 @@ void BreathController::begin() {
         Serial.println("提示: 使用calibrateShortCircuit()和calibrateAirEnvironment()进行校准");
     }
     
-    // 连接WiFi
+    // 二进制遥测帧带启动计数，接收端据此区分重启前后序号相同的帧
+    _telemetryEncoder.setBootId(telemetryNextBootId());
+    if (_storeAndForward) {
+        _telemetryLog.begin();
+    }
+    
+    // 连接WiFi：只发起关联，之后由连接状态机在主循环/网络任务中推进
     if (_ssid && _password) {
-        connectToWiFi();
+        _connection.setServerEnabled(_telemetryTransport == TELEMETRY_TCP);
+        _connection.begin(_ssid, _password, _host, (uint16_t)_port);
     }
     
+    // 启动定时采样
+    if (_samplingRateHz > 0 && _mux) {
+        _scheduler.setIdleHook(samplerIdleHook, this);
+        if (!_sampler.begin(_samplingRateHz, primarySampleSource, this)) {
+            Serial.println("定时采样启动失败，使用原有循环");
+            _samplingRateHz = 0;
+        }
+    }
+    
+    // 气阀每个主气压样本更新一次，硬件渐变覆盖一个更新间隔
+    _valve.setUpdateIntervalMs(_samplingRateHz > 0 ? 1000 / _samplingRateHz : SLOW_WORK_INTERVAL_MS);
+    
+    // 注册总线调度设备
+    registerBusDevices();
+    
     // 执行初始校准
     //calibrateZeroPoint();
 }
@@ -176,12 +203,15 @@ void BreathController::initializeOxygenSensor() {
     oxygenSensor = new OxygenSensor(ads1115, ADS1115_MUX_AIN0_GND);
     oxygenSensor->begin();
     
+    if (_oxygenDeviceId < 0) {
+        _oxygenDeviceId = _scheduler.registerDevice(ads1115->getMuxChannel(), "氧传感器");
+    }
+    
     Serial.println("氧传感器初始化完成！");
 }
 
 void BreathController::update() {
-    static unsigned long lastLogTime = 0;
-    static unsigned long lastSensorLogTime = 0;
+    static unsigned long lastSchedLogTime = 0;
     
     // 如果没有多路复用器，使用默认方式
     if (!_mux) {
@@ -189,153 +219,856 @@ void BreathController::update() {
         return;
     }
     
-    // 遍历所有启用的多路复用器通道读取传感器数据（跳过OLED通道）
-    for (uint8_t i = 0; i < _mux->getChannelCount(); i++) {
-        if (_mux->isChannelEnabled(i)) {
-            MuxChannelConfig config = _mux->getChannelConfig(i);
-            
-            // 跳过OLED通道，避免干扰显示
-            if (i == 2) { // OLED现在在通道2
-                continue;
-            }
-            
-            // 选择当前通道
-            if (_mux->selectChannel(i)) {
-                // 移除调试输出，减少串口信息
-                
-                // 启动数据采集
-                startAcquisition();
-                
-                // 等待采集完成
-                unsigned long startTime = millis();
-                while (!operateCheck() && !dataCheck()) {
-                    if (millis() - startTime > 100) {
-                        Serial.println("采集超时!");
-                        break;
-                    }
-                    delay(5);
-                }
-                
-                // 根据传感器类型进行不同操作
-                if (config.sensorAddr == SENSOR_ADDR) {
-                    // 气压传感器
-                    int32_t pressure_adc = readPressureADC();
-                    int16_t temperature_adc = readTemperatureADC();
-                    
-                    // 计算k值
-                    uint32_t k_value = getKValue(PRESSURE_RANGE);
-                    
-                    // 转换为实际值
-                    float temperature_c = calculateTemperature(temperature_adc);
-                    float pressure_kpa = (calculatePressure(pressure_adc, k_value, temperature_c) + 1032) / 12.10111;
-                    
-                    // 应用双重滤波
-                    float filtered_pressure = applyMovingAverage(pressure_kpa);
-                    filtered_pressure = applyEWMA(filtered_pressure);
-                    
-                    // 设置基准值
-                    if (!isBaseSet) {
-                        basePressure = filtered_pressure;
-                        baseTemperature = temperature_c;
-                        isBaseSet = true;
-                    }
-                    
-                    // 计算相对于基准值的差值
-                    float pressureDiff = filtered_pressure - basePressure;
-                    
-                    // 存储差值
-                    storedPressures[storeIndex] = pressureDiff;
-                    storedTemperatures[storeIndex] = temperature_c - baseTemperature;
-                    
-                    // 呼吸状态检测（使用主气压传感器所在通道：1）
-                    if (i == 1) {
-                        currentState = detectBreathState(filtered_pressure);
-                        
-                        // 气阀控制
-                        if (assistEnabled) {
-                            controlValve();
-                        }
-                        
-                        // 显示信息（降低频率到每500ms一次）
-                        if (millis() - lastSensorLogTime > 500) {
-                            Serial.print("主传感器 - 压力: ");
-                            Serial.print(filtered_pressure, 2);
-                            Serial.print("kPa, 温度: ");
-                            Serial.print(temperature_c, 1);
-                            Serial.print("°C, 状态: ");
-                            switch(currentState) {
-                                case INHALE: Serial.print("吸气"); break;
-                                case EXHALE: Serial.print("呼气"); break;
-                                case PEAK: Serial.print("峰值"); break;
-                                case TROUGH: Serial.print("谷值"); break;
-                            }
-                            Serial.println();
-                            lastSensorLogTime = millis();
-                        }
-                        
-                        // 自适应调整
-                        adaptiveModelAdjustment();
-                        
-                        // 通过WiFi发送数据
-                        if (millis() - lastLogTime > 100 && wifiConnected) {
-                            sendDataOverWiFi(filtered_pressure, temperature_c, valveOpening);
-                            lastLogTime = millis();
-                        }
-                    } else if (i == 3) {
-                        // 备用传感器输出（降低频率到每500ms一次）
-                        static unsigned long lastBackupLogTime = 0;
-                        if (millis() - lastBackupLogTime > 500) {
-                            Serial.print("备用传感器 - 压力: ");
-                            Serial.print(filtered_pressure, 2);
-                            Serial.print("kPa, 温度: ");
-                            Serial.print(temperature_c, 1);
-                            Serial.print("°C, 差值: ");
-                            Serial.print(pressureDiff, 3);
-                            Serial.println("kPa");
-                            lastBackupLogTime = millis();
-                        }
-                    }
-                    
-                } else if (config.sensorAddr == FLOW_SENSOR_ADDR) {
-                    // 流量传感器（仅在探测到可用时读取）
-                    if (flowSensorAvailable && (int)i == flowSensorChannel) {
-                        flowRate = readFlowRate();
-                        static unsigned long lastFlowLogTime = 0;
-                        if (millis() - lastFlowLogTime > 1000) {
-                            Serial.print("流量: ");
-                            Serial.print(flowRate, 0);
-                            Serial.println(" ml/min");
-                            lastFlowLogTime = millis();
-                        }
-                    }
-                }
+    // 双核流水线运行时loop()空闲，工作全部在两个固定核的任务中完成
+    if (_pipelineRunning) {
+        delay(100);
+        return;
+    }
+    
+    if (_sampler.isRunning()) {
+        updateTimed();
+        return;
+    }
+    
+    // 按通道排队本轮总线事务，由调度器集中执行，同一通道只选通一次
+    submitBusWork();
+    _scheduler.run();
+    
+    // ACD1100 UART模式不占用I2C总线，直接更新
+    if (acd1100.getCommunicationMode() == COMM_UART) {
+        updateGasSensor();
+    }
+    
+    // 每5秒输出一次各设备实际采样率
+    if (millis() - lastSchedLogTime > 5000) {
+        _scheduler.printStats();
+        _connection.printStats();
+        if (_storeAndForward) _telemetryLog.printStats();
+        if (_telemetryFormat == TELEMETRY_BINARY) _telemetryShaper.printStats();
+        lastSchedLogTime = millis();
+    }
+    
+    _connection.step();
+    backfillStep();
+    
+    // 移动到下一个存储位置
+    storeIndex = (storeIndex + 1) % STORE_SIZE;
+    
+    delay(100); // 每100ms读取一次，提高读取速度
+}
+
+void BreathController::updateTimed() {
+    static unsigned long lastStatsLogTime = 0;
+    
+    // 采集阶段：定时器到期则采一个主气压样本
+    _sampler.poll();
+    
+    // 控制阶段：按顺序处理所有新样本
+    PressureSample sample;
+    while (_sampler.read(CONSUMER_CONTROL, sample)) {
+        processPressureSample(PRIMARY_PRESSURE_CHANNEL, sample.pressureAdc, sample.temperatureAdc, sample.timestampUs);
+    }
+    
+    // 遥测阶段：独立读取位置，二进制格式逐样本打包，文本格式每100ms发送一次最新状态。
+    // 连接状态机的每次推进都是非阻塞的，服务器不可达时也不会拖慢采样
+    if (millis() - _lastConnectionStepTime >= CONNECTION_STEP_INTERVAL_MS) {
+        _lastConnectionStepTime = millis();
+        _connection.step();
+        backfillStep();
+        shapeTelemetry();
+    }
+    while (_sampler.read(CONSUMER_TELEMETRY, sample)) {
+        if (_telemetryFormat == TELEMETRY_BINARY) {
+            sendTelemetry(makeTelemetrySample(sample.timestampUs));
+        } else if (_connection.isConnected() && millis() - _lastTelemetryTime > TEXT_TELEMETRY_INTERVAL_MS) {
+            sendDataOverWiFi(filteredPressure, _primaryTemperatureC, valveOpening, currentState);
+            _lastTelemetryTime = millis();
+        }
+    }
+    
+    // 慢速设备（备用气压、ACD1100、氧传感器、OLED）按固定间隔轮询
+    if (millis() - _lastSlowWorkTime >= SLOW_WORK_INTERVAL_MS) {
+        _lastSlowWorkTime = millis();
+        runSlowWork();
+    }
+    
+    if (millis() - lastStatsLogTime > 5000) {
+        _sampler.printStats();
+        _scheduler.printStats();
+        _connection.printStats();
+        if (_storeAndForward) _telemetryLog.printStats();
+        if (_telemetryFormat == TELEMETRY_BINARY) _telemetryShaper.printStats();
+        lastStatsLogTime = millis();
+    }
+}
+
+void BreathController::runSlowWork() {
+    // 调度器每执行完一个事务就检查一次采样节拍，慢速事务之间不会积压采样
+    submitBusWork();
+    _scheduler.run();
+    
+    if (acd1100.getCommunicationMode() == COMM_UART) {
+        updateGasSensor();
+        _sampler.poll();
+    }
+    
+    storeIndex = (storeIndex + 1) % STORE_SIZE;
+}
+
+bool BreathController::startPipeline() {
+    if (_pipelineRunning) return true;
+    if (!_sampler.isRunning()) {
+        Serial.println("双核流水线需要定时采样，请先setSamplingRate()");
+        return false;
+    }
+    
+    _controlStats = PipelineStats();
+    _networkStats = PipelineStats();
+    _controlStepSumUs = 0;
+    _hasTelemetry = false;
+    _pipelineRunning = true;
+    _pipelineTasksActive = 2;
+    
+    // 先启动网络任务，控制任务一启动就可能发布样本
+    if (xTaskCreatePinnedToCore(networkTaskEntry, "breathNet", NETWORK_TASK_STACK, this,
+                                NETWORK_TASK_PRIORITY, &_networkTask, NETWORK_TASK_CORE) != pdPASS) {
+        Serial.println("网络任务创建失败");
+        _pipelineRunning = false;
+        _pipelineTasksActive = 0;
+        return false;
+    }
+    if (xTaskCreatePinnedToCore(controlTaskEntry, "breathCtl", CONTROL_TASK_STACK, this,
+                                CONTROL_TASK_PRIORITY, &_controlTask, CONTROL_TASK_CORE) != pdPASS) {
+        Serial.println("控制任务创建失败");
+        _pipelineTasksActive = 1;
+        stopPipeline();
+        return false;
+    }
+    
+    Serial.print("双核流水线启动: 控制核");
+    Serial.print(CONTROL_TASK_CORE);
+    Serial.print(", 网络核");
+    Serial.println(NETWORK_TASK_CORE);
+    return true;
+}
+
+void BreathController::stopPipeline() {
+    if (!_pipelineRunning) return;
+    _pipelineRunning = false;
+    if (_controlTask) xTaskNotifyGive(_controlTask);
+    // 等两个任务各自退出循环（网络任务可能正阻塞在服务器重连上）
+    while (_pipelineTasksActive > 0) {
+        delay(1);
+    }
+    _controlTask = nullptr;
+    _networkTask = nullptr;
+}
+
+PipelineStats BreathController::controlSnapshot() const {
+    PipelineStats stats = _controlStats;
+    stats.sampling = _sampler.getStats();
+    stats.meanControlStepUs = stats.controlSteps ? (float)_controlStepSumUs / stats.controlSteps : 0.0f;
+    stats.queueDropped = _telemetryQueue.getDropped();
+    stats.queueHighWater = _telemetryQueue.getHighWater();
+    return stats;
+}
+
+PipelineStats BreathController::getPipelineStats() const {
+    // 停止后返回控制任务退出时的快照，不计入等待网络任务退出的时间
+    PipelineStats stats = _pipelineRunning ? controlSnapshot() : _finalControlStats;
+    stats.consumed = _networkStats.consumed;
+    stats.telemetrySent = _networkStats.telemetrySent;
+    stats.maxNetworkStepUs = _networkStats.maxNetworkStepUs;
+    return stats;
+}
+
+void BreathController::controlTaskEntry(void* self) {
+    BreathController* c = static_cast<BreathController*>(self);
+    c->_sampler.setNotifyTask(xTaskGetCurrentTaskHandle());
+    while (c->_pipelineRunning) {
+        // 由定时器节拍唤醒；超时兜底保证慢速设备照常轮询
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SLOW_WORK_INTERVAL_MS));
+        if (!c->_pipelineRunning) break;
+        c->controlStep();
+    }
+    c->_sampler.setNotifyTask(nullptr);
+    c->_finalControlStats = c->controlSnapshot();
+    c->_pipelineTasksActive--;
+    vTaskDelete(NULL);
+}
+
+void BreathController::controlStep() {
+    static unsigned long lastStatsTime = 0;
+    unsigned long startUs = micros();
+    
+    // 采集 -> 状态检测 -> 气阀控制，每个样本随即发布给网络核
+    _sampler.poll();
+    PressureSample sample;
+    while (_sampler.read(CONSUMER_CONTROL, sample)) {
+        processPressureSample(PRIMARY_PRESSURE_CHANNEL, sample.pressureAdc, sample.temperatureAdc, sample.timestampUs);
+        publishTelemetry(sample);
+    }
+    
+    // 慢速设备仍在本核执行，I2C总线只有一个使用者，无需加锁
+    if (millis() - _lastSlowWorkTime >= SLOW_WORK_INTERVAL_MS) {
+        _lastSlowWorkTime = millis();
+        runSlowWork();
+    }
+    
+    uint32_t stepUs = micros() - startUs;
+    _controlStats.controlSteps++;
+    _controlStepSumUs += stepUs;
+    if (stepUs > _controlStats.maxControlStepUs) _controlStats.maxControlStepUs = stepUs;
+    
+    if (millis() - lastStatsTime > PIPELINE_STATS_INTERVAL_MS) {
+        _statsQueue.push(controlSnapshot());
+        lastStatsTime = millis();
+    }
+}
+
+void BreathController::publishTelemetry(const PressureSample& sample) {
+    TelemetrySample t = makeTelemetrySample(sample.timestampUs);
+    if (_telemetryQueue.push(t)) {
+        _controlStats.published++;
+    }
+}
+
+TelemetrySample BreathController::makeTelemetrySample(unsigned long timestampUs) {
+    TelemetrySample t;
+    t.seq = _telemetrySeq++;
+    t.timestampUs = timestampUs;
+    t.pressureKpa = filteredPressure;
+    t.temperatureC = _primaryTemperatureC;
+    t.basePressureKpa = basePressure;
+    t.baseTemperatureC = baseTemperature;
+    t.backupPressureKpa = _backupPressureKpa;
+    t.backupTemperatureC = _backupTemperatureC;
+    t.flowRate = flowSensorAvailable ? flowRate : NAN;
+    t.valveOpening = valveOpening;
+    t.co2Ppm = acd1100.getFilteredCO2();
+    t.oxygenPercent = _oxygenPercent;
+    t.state = currentState;
+    t.statusFlags = 0;
+    if (isBaseSet) t.statusFlags |= TELEMETRY_FLAG_BASE_SET;
+    if (_preActuating) t.statusFlags |= TELEMETRY_FLAG_PRE_ACTUATING;
+    if (_valveLinearizer.isSweeping()) t.statusFlags |= TELEMETRY_FLAG_VALVE_SWEEP;
+    return t;
+}
+
+void BreathController::sendTelemetry(const TelemetrySample& t) {
+    TelemetryRecord r;
+    r.seq = t.seq;
+    r.timestampUs = t.timestampUs;
+    r.pressureKpa = t.pressureKpa;
+    r.backupPressureKpa = t.backupPressureKpa;
+    r.flowRate = t.flowRate;
+    r.temperatureC = t.temperatureC;
+    r.co2Ppm = t.co2Ppm;
+    r.oxygenPercent = t.oxygenPercent;
+    r.valveFraction = t.valveOpening / MAX_VALVE_OPEN;
+    r.state = (uint8_t)t.state;
+    r.flags = t.statusFlags;
+    _telemetryEncoder.setBase(t.basePressureKpa, t.baseTemperatureC);
+    _telemetryEncoder.setSampleRate((uint16_t)_samplingRateHz);
+    _telemetryNextSeq = t.seq + 1;
+    
+    // 降采样模式攒满一个窗口才产生记录；呼吸摘要模式不发样本，每次呼吸结束时发送摘要
+    if (_telemetryMode == TELEMETRY_MODE_FULL) {
+        if (_telemetryEncoder.pending() == 0) _telemetryFrameStartMs = millis();
+        if (_telemetryEncoder.add(r) || millis() - _telemetryFrameStartMs >= TELEMETRY_MAX_FRAME_AGE_MS) {
+            flushTelemetryFrame();
+        }
+    } else if (_telemetryMode == TELEMETRY_MODE_DECIMATED) {
+        if (_telemetryDecimator.add(r)) {
+            sendTelemetryWindow(_telemetryDecimator.window());
+        } else if (_telemetryEncoder.pending() > 0 &&
+                   millis() - _telemetryFrameStartMs >= TELEMETRY_DECIMATED_FRAME_AGE_MS) {
+            flushTelemetryFrame();
+        }
+    }
+}
+
+void BreathController::sendTelemetryWindow(const TelemetryWindowRecord& window) {
+    if (!_telemetryEncoder.accepts(TELEMETRY_RECORD_WINDOW)) flushTelemetryFrame();
+    if (_telemetryEncoder.pending() == 0) _telemetryFrameStartMs = millis();
+    if (_telemetryEncoder.addWindow(window) || millis() - _telemetryFrameStartMs >= TELEMETRY_DECIMATED_FRAME_AGE_MS) {
+        flushTelemetryFrame();
+    }
+}
+
+void BreathController::sendBreathTelemetry(const BreathRecord& record) {
+    if (_telemetryFormat != TELEMETRY_BINARY || _telemetryMode != TELEMETRY_MODE_SUMMARY) return;
+    TelemetryBreathRecord b;
+    b.breathIndex = record.breathIndex;
+    b.timestampUs = record.timestampUs;
+    b.pipKpa = record.pipKpa;
+    b.peepKpa = record.peepKpa;
+    b.respiratoryRate = record.respiratoryRate;
+    b.ieRatio = record.ieRatio;
+    b.inspiratoryTimeMs = record.inspiratoryTimeMs;
+    b.expiratoryTimeMs = record.expiratoryTimeMs;
+    b.tidalVolumeMl = record.tidalVolumeMl;
+    b.triggerDelayMs = record.triggerDelayMs;
+    b.complianceMlCmH2O = record.complianceMlCmH2O;
+    b.resistanceCmH2O = record.resistanceCmH2O;
+    if (!_telemetryEncoder.accepts(TELEMETRY_RECORD_BREATH)) flushTelemetryFrame();
+    // 每次呼吸只有一条，立即发出
+    _telemetryEncoder.addBreath(b);
+    flushTelemetryFrame();
+}
+
+void BreathController::flushTelemetryFrame() {
+    uint8_t count = _telemetryEncoder.pending();
+    uint8_t type = _telemetryEncoder.recordType();
+    size_t len = _telemetryEncoder.finish(micros());
+    if (len == 0) return;
+    
+    // 整帧一次写出：未连接或写不完整时存入闪存日志待补发（存储转发开启时），
+    // 否则按丢弃计，由下一帧的dropped字段和seq跳号告知接收端。
+    // 未发出的模式切换帧必须先发，保证接收端按顺序看到切换
+    bool linkUp = telemetryLinkUp();
+    bool sent = (_modeFrameLength == 0 || sendPendingModeFrame()) && sendTelemetryFrame(_telemetryEncoder.data(), len);
+    if (linkUp) _telemetryShaper.onSend(len, sent);
+    bool sample = type == TELEMETRY_RECORD_SAMPLE;
+    if (sent) {
+        _telemetryLink.frames++;
+        _telemetryLink.bytes += len;
+        if (sample) _telemetryLink.samples += count;
+        else if (type == TELEMETRY_RECORD_WINDOW) _telemetryLink.windows += count;
+        else if (type == TELEMETRY_RECORD_BREATH) _telemetryLink.breaths += count;
+    } else if (_storeAndForward && _telemetryLog.append(_telemetryEncoder.data(), len)) {
+        if (sample) _telemetryLink.stored += count;
+    } else if (sample) {
+        _telemetryEncoder.addDropped(count);
+        _telemetryLink.dropped += count;
+    } else {
+        _telemetryLink.droppedSummaries += count;
+    }
+}
+
+bool BreathController::sendPendingModeFrame() {
+    if (!sendTelemetryFrame(_modeFrame, _modeFrameLength)) return false;
+    _telemetryShaper.onSend(_modeFrameLength, true);
+    _telemetryLink.frames++;
+    _telemetryLink.bytes += _modeFrameLength;
+    _telemetryLink.modeChanges++;
+    _modeFrameLength = 0;
+    return true;
+}
+
+bool BreathController::telemetryLinkUp() const {
+    return _telemetryTransport == TELEMETRY_UDP ? _connection.isWifiUp() : _connection.isConnected();
+}
+
+// 自适应遥测：每次连接推进后评估链路，模式切换在样本边界进行
+void BreathController::shapeTelemetry() {
+    if (_telemetryFormat != TELEMETRY_BINARY) return;
+    bool linkUp = telemetryLinkUp();
+    if (_modeFrameLength > 0 && linkUp) sendPendingModeFrame();
+    size_t queueDepth = _pipelineRunning ? _telemetryQueue.size() : 0;
+    if (_telemetryShaper.update(millis(), linkUp, _connection.pendingBytes(), queueDepth, TELEMETRY_QUEUE_SIZE)) {
+        applyTelemetryMode();
+    }
+}
+
+void BreathController::setTelemetryMode(uint8_t mode) {
+    _telemetryShaper.setMode(mode, millis());
+    applyTelemetryMode();
+}
+
+void BreathController::applyTelemetryMode() {
+    uint8_t mode = _telemetryShaper.mode();
+    if (mode == _telemetryMode) return;
+    
+    // 旧模式攒下的数据先发出：不满的窗口、不满的帧
+    if (_telemetryMode == TELEMETRY_MODE_DECIMATED && _telemetryDecimator.flush()) {
+        sendTelemetryWindow(_telemetryDecimator.window());
+    }
+    flushTelemetryFrame();
+    _telemetryDecimator.reset();
+    
+    // 切换记录单独成帧，发不出去时保留，先于之后的帧重试（再次切换时被新的切换记录替换）
+    TelemetryModeChange change = _telemetryShaper.lastChange();
+    change.nextSeq = _telemetryNextSeq;
+    _telemetryEncoder.addModeChange(change);
+    _modeFrameLength = _telemetryEncoder.finish(micros());
+    memcpy(_modeFrame, _telemetryEncoder.data(), _modeFrameLength);
+    _telemetryMode = mode;
+    
+    Serial.print("遥测模式: ");
+    Serial.print(telemetryModeName(change.fromMode));
+    Serial.print(" -> ");
+    Serial.print(telemetryModeName(change.toMode));
+    Serial.print("（");
+    Serial.print(telemetryModeReasonName(change.reason));
+    Serial.print("）, 吞吐(B/s): ");
+    Serial.println(change.throughputBps);
+    if (telemetryLinkUp()) sendPendingModeFrame();
+}
+
+// UDP每帧一个数据报，不建连接也没有重连阻塞，链路上的丢失由接收端按帧序号统计。
+// 目的地址用连接管理器异步解析的结果：beginPacket(主机名)每次都会阻塞做DNS查询
+bool BreathController::sendTelemetryFrame(const uint8_t* frame, size_t len) {
+    if (_telemetryTransport == TELEMETRY_UDP) {
+        uint32_t address;
+        return _connection.isWifiUp() && _connection.serverAddress(address) &&
+               _udp.beginPacket(IPAddress(address), _port) && _udp.write(frame, len) == len && _udp.endPacket();
+    }
+    return _connection.send(frame, len);
+}
+
+// 补发：令牌桶限速，每次连接推进后补发桶内字节允许的帧，与实时帧交错；
+// 发送失败（TCP缓冲区未清空等）的帧留在日志中下次再发
+void BreathController::backfillStep() {
+    if (!_storeAndForward || !_telemetryLog.isReady()) return;
+    unsigned long now = millis();
+    uint32_t elapsedMs = now - _lastBackfillMs;
+    _lastBackfillMs = now;
+    if (!telemetryLinkUp() || !_telemetryLog.hasBacklog()) {
+        _backfillTokens = 0;
+        return;
+    }
+    
+    uint64_t tokens = _backfillTokens + (uint64_t)elapsedMs * _backfillBytesPerSec / 1000;
+    if (tokens > 2 * TELEMETRY_MAX_FRAME_SIZE) tokens = 2 * TELEMETRY_MAX_FRAME_SIZE;
+    _backfillTokens = (uint32_t)tokens;
+    while (true) {
+        size_t len = _telemetryLog.peek(_backfillFrame, sizeof(_backfillFrame));
+        if (len == 0 || len > _backfillTokens || !sendTelemetryFrame(_backfillFrame, len)) break;
+        _telemetryLog.pop();
+        _backfillTokens -= len;
+        _telemetryLink.backfillFrames++;
+        _telemetryLink.backfillBytes += len;
+    }
+}
+
+void BreathController::networkTaskEntry(void* self) {
+    BreathController* c = static_cast<BreathController*>(self);
+    while (c->_pipelineRunning) {
+        unsigned long startUs = micros();
+        c->networkStep();
+        uint32_t stepUs = micros() - startUs;
+        if (stepUs > c->_networkStats.maxNetworkStepUs) c->_networkStats.maxNetworkStepUs = stepUs;
+        vTaskDelay(pdMS_TO_TICKS(NETWORK_TASK_PERIOD_MS));
+    }
+    c->_pipelineTasksActive--;
+    vTaskDelete(NULL);
+}
+
+void BreathController::networkStep() {
+    _connection.step();
+    backfillStep();
+    shapeTelemetry();
+    
+    TelemetrySample sample;
+    bool received = false;
+    while (_telemetryQueue.pop(sample)) {
+        _latestTelemetry = sample;
+        _networkStats.consumed++;
+        received = true;
+        if (_telemetryFormat == TELEMETRY_BINARY) sendTelemetry(sample);
+    }
+    if (received) {
+        _hasTelemetry = true;
+        const TelemetrySample& t = _latestTelemetry;
+        
+        // 遥测：文本格式每100ms发送最新状态，服务器重连的阻塞只影响本核
+        if (_telemetryFormat == TELEMETRY_TEXT && _connection.isConnected() && millis() - _lastTelemetryTime > TEXT_TELEMETRY_INTERVAL_MS) {
+            if (sendDataOverWiFi(t.pressureKpa, t.temperatureC, t.valveOpening, t.state)) {
+                _networkStats.telemetrySent++;
             }
+            _lastTelemetryTime = millis();
+        }
+        logTelemetry(t);
+    }
+    
+    // OLED：本核绘制显存，控制核在慢速轮询中分段发送
+    if (_hasTelemetry && !oled.isFlushPending() && oled.isRefreshDue()) {
+        const TelemetrySample& t = _latestTelemetry;
+        oled.render(t.pressureKpa, t.baseTemperatureC, breathStateName(t.state),
+                    (t.valveOpening/MAX_VALVE_OPEN)*100, isnan(t.flowRate) ? 0.0f : t.flowRate);
+    }
+    
+    BreathRecord record;
+    while (_breathQueue.pop(record)) {
+        logBreathRecord(record);
+        sendBreathTelemetry(record);
+    }
+    TrackingStats tracking;
+    while (_trackingQueue.pop(tracking)) {
+        logTrackingStats(tracking);
+    }
+    
+    PipelineStats snapshot;
+    if (_statsQueue.pop(snapshot)) {
+        snapshot.consumed = _networkStats.consumed;
+        snapshot.telemetrySent = _networkStats.telemetrySent;
+        snapshot.maxNetworkStepUs = _networkStats.maxNetworkStepUs;
+        printPipelineStats(snapshot);
+        _connection.printStats();
+        if (_storeAndForward) _telemetryLog.printStats();
+        if (_telemetryFormat == TELEMETRY_BINARY) _telemetryShaper.printStats();
+    }
+}
+
+void BreathController::logTelemetry(const TelemetrySample& t) {
+    static unsigned long lastSensorLogTime = 0;
+    static unsigned long lastFlowLogTime = 0;
+    static unsigned long lastSlowLogTime = 0;
+    
+    // 与单核模式相同的输出频率和格式
+    if (millis() - lastSensorLogTime > 500) {
+        Serial.print("主传感器 - 压力: ");
+        Serial.print(t.pressureKpa, 2);
+        Serial.print("kPa, 温度: ");
+        Serial.print(t.temperatureC, 1);
+        Serial.print("°C, 状态: ");
+        switch(t.state) {
+            case INHALE: Serial.print("吸气"); break;
+            case EXHALE: Serial.print("呼气"); break;
+            case PEAK: Serial.print("峰值"); break;
+            case TROUGH: Serial.print("谷值"); break;
+        }
+        Serial.println();
+        
+        if (!isnan(t.backupPressureKpa)) {
+            Serial.print("备用传感器 - 压力: ");
+            Serial.print(t.backupPressureKpa, 2);
+            Serial.print("kPa, 温度: ");
+            Serial.print(t.backupTemperatureC, 1);
+            Serial.print("°C, 差值: ");
+            Serial.print(t.backupPressureKpa - t.basePressureKpa, 3);
+            Serial.println("kPa");
+        }
+        lastSensorLogTime = millis();
+    }
+    
+    if (!isnan(t.flowRate) && millis() - lastFlowLogTime > 1000) {
+        Serial.print("流量: ");
+        Serial.print(t.flowRate, 0);
+        Serial.println(" ml/min");
+        lastFlowLogTime = millis();
+    }
+    
+    if (millis() - lastSlowLogTime > 2000) {
+        if (t.co2Ppm > 0) {
+            Serial.print("ACD1100 - CO2: ");
+            Serial.print(t.co2Ppm, 0);
+            Serial.println("ppm");
+        }
+        if (!isnan(t.oxygenPercent)) {
+            Serial.print("氧传感器 - 氧气浓度: ");
+            Serial.print(t.oxygenPercent, 2);
+            Serial.println("%");
         }
+        lastSlowLogTime = millis();
     }
+}
+
+void BreathController::logBreathRecord(const BreathRecord& r) {
+    Serial.print("呼吸#");
+    Serial.print(r.breathIndex);
+    Serial.print(" - PIP: ");
+    Serial.print(r.pipKpa, 2);
+    Serial.print("kPa, PEEP: ");
+    Serial.print(r.peepKpa, 2);
+    Serial.print("kPa, 频率: ");
+    Serial.print(r.respiratoryRate, 1);
+    Serial.print("次/分, 吸呼比: 1:");
+    Serial.print(r.ieRatio > 0 ? 1.0f / r.ieRatio : 0.0f, 2);
+    Serial.print(", Ti: ");
+    Serial.print(r.inspiratoryTimeMs);
+    Serial.print("ms, 触发延迟: ");
+    Serial.print(r.triggerDelayMs, 1);
+    Serial.print("ms");
+    if (!isnan(r.tidalVolumeMl)) {
+        Serial.print(", 潮气量: ");
+        Serial.print(r.tidalVolumeMl, 0);
+        Serial.print("ml");
+    }
+    if (!isnan(r.complianceMlCmH2O)) {
+        Serial.print(", 顺应性: ");
+        Serial.print(r.complianceMlCmH2O, 1);
+        Serial.print("ml/cmH2O, 阻力: ");
+        Serial.print(r.resistanceCmH2O, 1);
+        Serial.print("cmH2O/(L/s)");
+    }
+    Serial.println();
+}
+
+void BreathController::logTrackingStats(const TrackingStats& s) {
+    Serial.print("气阀跟踪#");
+    Serial.print(s.cycleIndex);
+    Serial.print(" - 周期: ");
+    Serial.print(s.durationMs);
+    Serial.print("ms, 误差RMS: ");
+    Serial.print(s.rmsErrorKpa, 3);
+    Serial.print("kPa, 最大: ");
+    Serial.print(s.maxAbsErrorKpa, 3);
+    Serial.print("kPa, 偏差: ");
+    Serial.print(s.meanErrorKpa, 3);
+    Serial.print("kPa, 限幅: ");
+    Serial.print(s.saturatedPercent, 0);
+    Serial.println("%");
+}
+
+void BreathController::printPipelineStats(const PipelineStats& stats) {
+    Serial.println("=== 双核流水线统计 ===");
+    Serial.print("采样: ");
+    Serial.print(stats.sampling.actualRateHz, 1);
+    Serial.print(" Hz, 超限: ");
+    Serial.print(stats.sampling.overruns);
+    Serial.print(", 抖动最大 ");
+    Serial.print(stats.sampling.maxJitterUs);
+    Serial.println(" us");
+    Serial.print("控制步: ");
+    Serial.print(stats.controlSteps);
+    Serial.print(", 平均 ");
+    Serial.print(stats.meanControlStepUs, 0);
+    Serial.print(" us, 最大 ");
+    Serial.print(stats.maxControlStepUs);
+    Serial.println(" us");
+    Serial.print("队列: 发布 ");
+    Serial.print(stats.published);
+    Serial.print(", 取出 ");
+    Serial.print(stats.consumed);
+    Serial.print(", 丢弃 ");
+    Serial.print(stats.queueDropped);
+    Serial.print(", 最高水位 ");
+    Serial.print(stats.queueHighWater);
+    Serial.print("/");
+    Serial.println(TELEMETRY_QUEUE_SIZE);
+    Serial.print("遥测发送: ");
+    Serial.print(stats.telemetrySent);
+    Serial.print(", 网络任务单轮最长 ");
+    Serial.print(stats.maxNetworkStepUs / 1000);
+    Serial.println(" ms");
+    Serial.println("======================");
+}
+
+void BreathController::samplerIdleHook(void* self) {
+    static_cast<BreathController*>(self)->_sampler.poll();
+}
+
+bool BreathController::primarySampleSource(void* self, PressureSample& sample) {
+    BreathController* c = static_cast<BreathController*>(self);
+    const uint8_t ch = PRIMARY_PRESSURE_CHANNEL;
+    if (!c->_mux->selectChannel(ch)) return false;
     
-    // 更新气体浓度传感器数据
+    // 流水线模式下读取上一周期启动的转换；首次或阻塞模式下现在启动并等待
+    if (!c->_pipelinedAcquisition || !c->_conversionPending[ch]) {
+        c->startAcquisition();
+        c->_conversionStartUs[ch] = micros();
+        c->_conversionPending[ch] = true;
+    }
+    unsigned long conversionStartUs = c->_conversionStartUs[ch];
+    
+    int32_t pressure_adc;
+    int16_t temperature_adc;
+    bool ok = c->waitForSample(pressure_adc, temperature_adc, 100, conversionStartUs);
+    if (c->_pipelinedAcquisition) {
+        c->startAcquisition();
+        c->_conversionStartUs[ch] = micros();
+    } else {
+        c->_conversionPending[ch] = false;
+    }
+    if (!ok) return false;
+    
+    // 时间戳取转换启动时刻，即传感器实际开始测量的时间；换算留给控制阶段
+    sample.timestampUs = conversionStartUs;
+    sample.pressureAdc = pressure_adc;
+    sample.temperatureAdc = temperature_adc;
+    return true;
+}
+
+void BreathController::registerBusDevices() {
+    if (!_mux) return;
+    
+    for (uint8_t i = 0; i < _mux->getChannelCount(); i++) {
+        if (!_mux->isChannelEnabled(i) || _channelDeviceId[i] >= 0) continue;
+        // 定时采样时主气压由采样引擎负责
+        if (i == PRIMARY_PRESSURE_CHANNEL && _samplingRateHz > 0) continue;
+        MuxChannelConfig config = _mux->getChannelConfig(i);
+        if (config.sensorAddr == SENSOR_ADDR ||
+            (config.sensorAddr == FLOW_SENSOR_ADDR && flowSensorAvailable && (int)i == flowSensorChannel)) {
+            _channelDeviceId[i] = _scheduler.registerDevice(i, config.sensorName);
+        }
+    }
+    
+    if (_gasDeviceId < 0 && acd1100.getCommunicationMode() == COMM_I2C) {
+        _gasDeviceId = _scheduler.registerDevice(acd1100.getMuxChannel(), "ACD1100");
+    }
+    if (_oxygenDeviceId < 0 && oxygenSensor != nullptr && ads1115 != nullptr) {
+        _oxygenDeviceId = _scheduler.registerDevice(ads1115->getMuxChannel(), "氧传感器");
+    }
+    if (_oledDeviceId < 0) {
+        _oledDeviceId = _scheduler.registerDevice(2, "OLED"); // OLED现在在通道2
+    }
+}
+
+void BreathController::acquirePressureRound() {
+    if (!_mux) return;
+    submitPressureWork();
+    _scheduler.run();
+}
+
+void BreathController::setPipelinedAcquisition(bool enable) {
+    _pipelinedAcquisition = enable;
+    // 切换模式时丢弃未读取的转换，重新预启动
+    for (uint8_t i = 0; i < MAX_MUX_CHANNELS; i++) {
+        _conversionPending[i] = false;
+    }
+}
+
+void BreathController::submitPressureWork() {
+    // 气压与流量传感器每轮都采集
+    for (uint8_t i = 0; i < MAX_MUX_CHANNELS; i++) {
+        int8_t id = _channelDeviceId[i];
+        if (id < 0) continue;
+        if (_mux->getChannelConfig(i).sensorAddr == SENSOR_ADDR) {
+            _scheduler.submit(id, pressureTask, this);
+        } else {
+            _scheduler.submit(id, flowTask, this);
+        }
+    }
+}
+
+void BreathController::submitBusWork() {
+    submitPressureWork();
+    
+    // ACD1100只在数据刷新、分段读取就绪或诊断到期时占用总线
+    if (_gasDeviceId >= 0 && (acd1100.isReadDue() || acd1100.isResponseReady() ||
+                              millis() - lastGasDebugTime > 5000)) {
+        _scheduler.submit(_gasDeviceId, gasTask, this);
+    }
+    
+    if (_oxygenDeviceId >= 0 && oxygenSensor != nullptr && oxygenSensor->isCalibrated()) {
+        _scheduler.submit(_oxygenDeviceId, oxygenTask, this);
+    }
+    
+    if (_oledDeviceId < 0) return;
+    if (_sampler.isRunning()) {
+        // 定时采样时分段刷新：到期先绘制显存，每轮最多发送若干段，段间插入采样
+        // 双核流水线时由网络核绘制，这里只负责发送
+        if (!_pipelineRunning && !oled.isFlushPending() && oled.isRefreshDue()) {
+            oled.render(filteredPressure, baseTemperature, breathStateName(), (valveOpening/MAX_VALVE_OPEN)*100, flowRate);
+        }
+        for (uint8_t i = 0; i < OLED_CHUNKS_PER_ROUND && oled.isFlushPending(); i++) {
+            _scheduler.submit(_oledDeviceId, oledChunkTask, this);
+        }
+    } else if (oled.isRefreshDue()) {
+        // OLED只在刷新到期时选通
+        _scheduler.submit(_oledDeviceId, oledTask, this);
+    }
+}
+
+String BreathController::breathStateName() const {
+    return breathStateName(currentState);
+}
+
+String BreathController::breathStateName(BreathState state) {
+    switch(state) {
+        case INHALE: return "INHALE";
+        case EXHALE: return "EXHALE";
+        case PEAK: return "PEAK";
+        case TROUGH: return "TROUGH";
+    }
+    return "";
+}
+
+bool BreathController::pressureTask(void* self, uint8_t channel) {
+    return static_cast<BreathController*>(self)->samplePressureChannel(channel);
+}
+
+bool BreathController::flowTask(void* self, uint8_t /*channel*/) {
+    BreathController* c = static_cast<BreathController*>(self);
+    float flow = c->readFlowRate();
+    if (flow < 0) return false;  // 读取失败时保留上一次的滤波值
+    c->flowRate = c->_flowFilter.update(flow);
+    c->_flowSampleMlMin = flow;
+    c->_flowSampleSeq++;
+    static unsigned long lastFlowLogTime = 0;
+    if (c->inlineLogging() && millis() - lastFlowLogTime > 1000) {
+        Serial.print("流量: ");
+        Serial.print(c->flowRate, 0);
+        Serial.println(" ml/min");
+        lastFlowLogTime = millis();
+    }
+    return true;
+}
+
+bool BreathController::gasTask(void* self, uint8_t /*channel*/) {
+    return static_cast<BreathController*>(self)->updateGasSensor();
+}
+
+bool BreathController::oxygenTask(void* self, uint8_t /*channel*/) {
+    BreathController* c = static_cast<BreathController*>(self);
+    static unsigned long lastOxygenLogTime = 0;
+    float oxygenPercent = c->oxygenSensor->readOxygenConcentration();
+    c->_oxygenPercent = oxygenPercent;
+    if (c->inlineLogging() && millis() - lastOxygenLogTime > 2000) {
+        Serial.print("氧传感器 - 氧气浓度: ");
+        Serial.print(oxygenPercent, 2);
+        Serial.println("%");
+        lastOxygenLogTime = millis();
+    }
+    return true;
+}
+
+bool BreathController::oledTask(void* self, uint8_t /*channel*/) {
+    BreathController* c = static_cast<BreathController*>(self);
+    
+    // 更新OLED显示（使用第一个通道的数据）
+    c->oled.update(c->filteredPressure, c->baseTemperature, c->breathStateName(), (c->valveOpening/MAX_VALVE_OPEN)*100, c->flowRate);
+    return true;
+}
+
+bool BreathController::oledChunkTask(void* self, uint8_t /*channel*/) {
+    BreathController* c = static_cast<BreathController*>(self);
+    // 同一轮提交的段数可能多于剩余段数
+    if (!c->oled.isFlushPending()) return true;
+    return c->oled.flushChunk();
+}
+
+bool BreathController::updateGasSensor() {
     static unsigned long lastGasLogTime = 0;
-    static unsigned long lastDebugTime = 0;
     
     // 每5秒输出一次调试信息
-    if (millis() - lastDebugTime > 5000) {
+    if (millis() - lastGasDebugTime > 5000) {
         Serial.print("ACD1100调试 - 连接状态: ");
         Serial.print(acd1100.isConnected() ? "已连接" : "未连接");
         Serial.print(", 错误码: ");
         Serial.println(acd1100.getLastError());
         
-        // 如果连接失败，尝试简化测试
-        if (!acd1100.isConnected()) {
+        // 如果连接失败，尝试简化测试（分段读取进行中时跳过，避免打断）
+        if (!acd1100.isReadPending() && !acd1100.isConnected()) {
             Serial.println("ACD1100: 尝试简化测试读取");
             acd1100.testSimpleRead();
         }
         
-        lastDebugTime = millis();
+        lastGasDebugTime = millis();
     }
     
-    if (acd1100.update()) {
+    bool updated;
+    if (_sampler.isRunning() && acd1100.getCommunicationMode() == COMM_I2C) {
+        // 定时采样时分段读取：本轮只发命令，等待期间不占用主循环，下一轮取回数据
+        if (acd1100.isResponseReady()) {
+            updated = acd1100.finishRead();
+        } else if (!acd1100.isReadPending() && acd1100.isReadDue()) {
+            return acd1100.startRead();
+        } else {
+            return true;
+        }
+    } else {
+        if (!acd1100.isReadDue()) {
+            return true;
+        }
+        updated = acd1100.update();
+    }
+    
+    if (updated) {
         // 每2秒输出一次气体浓度数据
-        if (millis() - lastGasLogTime > 2000) {
+        if (inlineLogging() && millis() - lastGasLogTime > 2000) {
             Serial.print("ACD1100 - CO2: ");
             Serial.print(acd1100.getFilteredCO2(), 0);
             Serial.print("ppm, 温度: ");
@@ -345,34 +1078,178 @@ void BreathController::update() {
             Serial.println("级");
             lastGasLogTime = millis();
         }
+        return true;
     }
+    return false;
+}
+
+bool BreathController::samplePressureChannel(uint8_t channel) {
+    int32_t pressure_adc;
+    int16_t temperature_adc;
+    unsigned long sampleUs;
     
-    // 读取氧传感器数据
-    static unsigned long lastOxygenLogTime = 0;
-    if (oxygenSensor != nullptr && oxygenSensor->isCalibrated()) {
-        float oxygenPercent = oxygenSensor->readOxygenConcentration();
-        if (millis() - lastOxygenLogTime > 2000) {
-            Serial.print("氧传感器 - 氧气浓度: ");
-            Serial.print(oxygenPercent, 2);
-            Serial.println("%");
-            lastOxygenLogTime = millis();
+    if (_pipelinedAcquisition) {
+        // 首轮只启动转换
+        if (!_conversionPending[channel]) {
+            startAcquisition();
+            _conversionStartUs[channel] = micros();
+            _conversionPending[channel] = true;
+            return true;
+        }
+        
+        // 读取上一轮启动的转换，随即启动下一次，转换与其余总线操作并行
+        sampleUs = _conversionStartUs[channel];
+        bool ok = waitForSample(pressure_adc, temperature_adc, 100, sampleUs);
+        startAcquisition();
+        _conversionStartUs[channel] = micros();
+        if (!ok) {
+            Serial.println("采集超时!");
+            return false;
+        }
+    } else {
+        // 启动数据采集
+        sampleUs = micros();
+        startAcquisition();
+        
+        // 等待采集完成（状态与数据合并读取）
+        if (!waitForSample(pressure_adc, temperature_adc, 100)) {
+            Serial.println("采集超时!");
+            return false;
         }
     }
     
-    // 更新OLED显示（使用第一个通道的数据）
-    String stateStr;
-    switch(currentState) {
-        case INHALE: stateStr = "INHALE"; break;
-        case EXHALE: stateStr = "EXHALE"; break;
-        case PEAK: stateStr = "PEAK"; break;
-        case TROUGH: stateStr = "TROUGH"; break;
+    processPressureSample(channel, pressure_adc, temperature_adc, sampleUs);
+    return true;
+}
+
+void BreathController::processPressureSample(uint8_t channel, int32_t pressure_adc, int16_t temperature_adc, unsigned long timestampUs) {
+    if (channel >= MAX_MUX_CHANNELS) return;
+    
+    if (_fixedPointFilter) {
+        // 定点换算与双重滤波，系数编译期折叠
+        int32_t raw_q = pressureAdcToQ<PRESSURE_K>(pressure_adc);
+        int32_t filtered_q = _fixedPressureFilters[channel].update(raw_q);
+        processPressureValue(channel, pressureQToKpa(filtered_q), pressureQToKpa(raw_q), temperatureQ8ToC(temperature_adc), timestampUs);
+        return;
     }
-    oled.update(filteredPressure, baseTemperature, stateStr, (valveOpening/MAX_VALVE_OPEN)*100, flowRate);
     
-    // 移动到下一个存储位置
-    storeIndex = (storeIndex + 1) % STORE_SIZE;
+    // 计算k值
+    uint32_t k_value = getKValue(PRESSURE_RANGE);
     
-    delay(100); // 每100ms读取一次，提高读取速度
+    // 转换为实际值
+    float temperature_c = calculateTemperature(temperature_adc);
+    float pressure_kpa = (calculatePressure(pressure_adc, k_value, temperature_c) + 1032) / 12.10111;
+    
+    // 应用双重滤波（各通道独立）
+    processPressureValue(channel, _pressureFilters[channel].update(pressure_kpa), pressure_kpa, temperature_c, timestampUs);
+}
+
+void BreathController::processPressureValue(uint8_t channel, float filtered_pressure, float raw_pressure, float temperature_c, unsigned long timestampUs) {
+    static unsigned long lastLogTime = 0;
+    static unsigned long lastSensorLogTime = 0;
+    
+    // 设置基准值（取主传感器）
+    if (!isBaseSet && channel == PRIMARY_PRESSURE_CHANNEL) {
+        basePressure = filtered_pressure;
+        baseTemperature = temperature_c;
+        isBaseSet = true;
+    }
+    
+    // 计算相对于基准值的差值
+    float pressureDiff = filtered_pressure - basePressure;
+    
+    // 存储差值
+    storedPressures[storeIndex] = pressureDiff;
+    storedTemperatures[storeIndex] = temperature_c - baseTemperature;
+    
+    // 呼吸状态检测（使用主气压传感器所在通道：1）
+    if (channel == PRIMARY_PRESSURE_CHANNEL) {
+        filteredPressure = filtered_pressure;
+        _primaryTemperatureC = temperature_c;
+        currentState = detectBreathState(_fastTriggerPath ? raw_pressure : filtered_pressure, timestampUs);
+        
+        // 肺力学估计：每个新的流量样本与当前压力配对更新一次
+        if (flowSensorAvailable && _flowSampleSeq != _mechanicsFlowSeq) {
+            _mechanicsFlowSeq = _flowSampleSeq;
+            _lungMechanics.update(timestampUs, currentState, pressureDiff, _flowSampleMlMin);
+        }
+        
+        // 逐次呼吸统计：流水线运行时交给网络核输出
+        if (_breathAnalyzer.update(timestampUs, currentState, pressureDiff, flowSensorAvailable ? flowRate : NAN)) {
+            BreathRecord record = _breathAnalyzer.lastRecord();
+            record.triggerDelayMs = _onsetDetector.lastTriggerDelayMs();
+            const LungMechanics& mechanics = _lungMechanics.estimate();
+            record.complianceMlCmH2O = mechanics.valid ? mechanics.complianceMlCmH2O : NAN;
+            record.resistanceCmH2O = mechanics.valid ? mechanics.resistanceCmH2O : NAN;
+            if (_pipelineRunning) {
+                _breathQueue.push(record);
+            } else {
+                logBreathRecord(record);
+                sendBreathTelemetry(record);
+            }
+        }
+        
+        // 气阀控制：特性扫描期间由扫描接管占空比
+        if (_characterizationRequested) {
+            _characterizationRequested = false;
+            _valveLinearizer.startSweep(timestampUs);
+        }
+        if (_valveLinearizer.isSweeping()) {
+            float duty = _valveLinearizer.sweepUpdate(timestampUs, pressureDiff, flowSensorAvailable ? flowRate : NAN);
+            _valve.setOpening(duty);
+            valveOpening = duty * MAX_VALVE_OPEN;
+            if (!_valveLinearizer.isSweeping()) finishValveCharacterization();
+        } else if (assistEnabled) {
+            controlValve(timestampUs, pressureDiff);
+        }
+        
+        // 显示信息（降低频率到每500ms一次）
+        if (inlineLogging() && millis() - lastSensorLogTime > 500) {
+            Serial.print("主传感器 - 压力: ");
+            Serial.print(filtered_pressure, 2);
+            Serial.print("kPa, 温度: ");
+            Serial.print(temperature_c, 1);
+            Serial.print("°C, 状态: ");
+            switch(currentState) {
+                case INHALE: Serial.print("吸气"); break;
+                case EXHALE: Serial.print("呼气"); break;
+                case PEAK: Serial.print("峰值"); break;
+                case TROUGH: Serial.print("谷值"); break;
+            }
+            Serial.println();
+            lastSensorLogTime = millis();
+        }
+        
+        // 自适应调整：每完成一次呼吸调整一次
+        if (breathCount != _adaptedBreathCount) {
+            _adaptedBreathCount = breathCount;
+            adaptiveModelAdjustment();
+        }
+        
+        // 通过WiFi发送数据（定时采样时由遥测阶段发送）
+        if (!_sampler.isRunning() && _telemetryFormat == TELEMETRY_BINARY) {
+            sendTelemetry(makeTelemetrySample(timestampUs));
+        } else if (!_sampler.isRunning() && millis() - lastLogTime > 100 && _connection.isConnected()) {
+            sendDataOverWiFi(filtered_pressure, temperature_c, valveOpening, currentState);
+            lastLogTime = millis();
+        }
+    } else if (channel == 3) {
+        _backupPressureKpa = filtered_pressure;
+        _backupTemperatureC = temperature_c;
+        
+        // 备用传感器输出（降低频率到每500ms一次）
+        static unsigned long lastBackupLogTime = 0;
+        if (inlineLogging() && millis() - lastBackupLogTime > 500) {
+            Serial.print("备用传感器 - 压力: ");
+            Serial.print(filtered_pressure, 2);
+            Serial.print("kPa, 温度: ");
+            Serial.print(temperature_c, 1);
+            Serial.print("°C, 差值: ");
+            Serial.print(pressureDiff, 3);
+            Serial.println("kPa");
+            lastBackupLogTime = millis();
+        }
+    }
 }
 
 void BreathController::probeFlowSensor() {
@@ -475,18 +1352,7 @@ void BreathController::initSensor() {
 }
 
 uint32_t BreathController::getKValue(float range_kpa) {
-    if (range_kpa > 1000) return 4;
-    else if (range_kpa > 500) return 8;
-    else if (range_kpa > 260) return 16;  
-    else if (range_kpa > 131) return 32;
-    else if (range_kpa > 65) return 64;
-    else if (range_kpa > 32) return 128;
-    else if (range_kpa > 16) return 256;
-    else if (range_kpa > 8) return 512;
-    else if (range_kpa > 4) return 1024;
-    else if (range_kpa > 2) return 2048;
-    else if (range_kpa > 1) return 4096;
-    else return 8192;
+    return pressureKValue(range_kpa);
 }
 
 void BreathController::writeRegister(uint8_t reg, uint8_t value) {
@@ -532,6 +1398,40 @@ uint8_t BreathController::readRegister(uint8_t reg) {
     return 0;
 }
 
+bool BreathController::readRegisters(uint8_t reg, uint8_t* buffer, uint8_t len) {
+    if (!_mux) return false;
+    
+    uint8_t currentSensorAddr = _mux->getChannelConfig(_mux->getActiveChannel()).sensorAddr;
+    
+    // 写寄存器指针后重复起始读取len字节，传感器内部地址自动递增
+    Wire.beginTransmission(currentSensorAddr);
+    Wire.write(reg);
+    if (Wire.endTransmission(false) != 0) {
+        Serial.print("I2C寻址失败 @ 通道 ");
+        Serial.print(_mux->getActiveChannel());
+        Serial.print(", 寄存器 0x");
+        Serial.println(reg, HEX);
+        return false;
+    }
+    
+    uint8_t bytes = Wire.requestFrom((int)currentSensorAddr, (int)len);
+    if (bytes == len) {
+        for (uint8_t i = 0; i < len; i++) {
+            buffer[i] = Wire.read();
+        }
+        return true;
+    }
+    while (Wire.available()) (void)Wire.read();
+    Serial.print("突发读取失败, 通道 ");
+    Serial.print(_mux->getActiveChannel());
+    Serial.print(", 收到");
+    Serial.print(bytes);
+    Serial.print("/");
+    Serial.print(len);
+    Serial.println("字节");
+    return false;
+}
+
 float BreathController::readFlowRate() {
     if (!_mux) return -1.0f;
     
@@ -550,27 +1450,49 @@ float BreathController::readFlowRate() {
 }
 
 // ... 其余方法保持不变
-int32_t BreathController::readPressureADC() {
-    uint8_t msb = readRegister(REG_DATA_MSB);
-    uint8_t csb = readRegister(REG_DATA_CSB);
-    uint8_t lsb = readRegister(REG_DATA_LSB);
-    return ((uint32_t)msb << 16) | ((uint32_t)csb << 8) | lsb;
-}
-
-int16_t BreathController::readTemperatureADC() {
-    uint8_t msb = readRegister(REG_TEMP_MSB);
-    uint8_t lsb = readRegister(REG_TEMP_LSB);
-    return ((uint16_t)msb << 8) | lsb;
+bool BreathController::fetchSampleIfReady(int32_t& pressureAdc, int16_t& temperatureAdc) {
+    // 从状态寄存器0x02连续读到0x0A：数据就绪时同一次事务已带回数据
+    uint8_t buf[PRESSURE_FETCH_LEN];
+    if (!readRegisters(REG_STATUS, buf, sizeof(buf))) return false;
+    if (!(buf[0] & 0x01)) return false;
+    
+    const uint8_t* data = buf + (REG_DATA_MSB - REG_STATUS);
+    pressureAdc = ((uint32_t)data[0] << 16) | ((uint32_t)data[1] << 8) | data[2];
+    temperatureAdc = ((uint16_t)data[3] << 8) | data[4];
+    return true;
 }
 
-bool BreathController::dataCheck() {
-    uint8_t datacheck = readRegister(REG_STATUS);
-    return (datacheck & 0x01);
+bool BreathController::waitForSample(int32_t& pressureAdc, int16_t& temperatureAdc, unsigned long timeoutMs) {
+    return waitForSample(pressureAdc, temperatureAdc, timeoutMs, micros());
 }
 
-bool BreathController::operateCheck() {
-    uint8_t operatecheck = readRegister(REG_CMD);
-    return !(operatecheck & 0x08);
+bool BreathController::waitForSample(int32_t& pressureAdc, int16_t& temperatureAdc, unsigned long timeoutMs, unsigned long startUs) {
+    // 等满估计的转换时间再读取（流水线模式下通常早已超过），一次合并读取即可拿到数据
+    unsigned long elapsedUs = micros() - startUs;
+    if (elapsedUs < _conversionEstimateUs) {
+        delayMicroseconds(_conversionEstimateUs - elapsedUs);
+    }
+    
+    uint8_t polls = 0;
+    unsigned long startTime = millis();
+    while (!fetchSampleIfReady(pressureAdc, temperatureAdc)) {
+        if (millis() - startTime > timeoutMs) {
+            return false;
+        }
+        polls++;
+        delayMicroseconds(PRESSURE_POLL_US);
+    }
+    
+    // 首次即就绪则缓慢缩短估计值，否则取实际耗时；
+    // 调用前已超过估计值（流水线模式）时首次命中不说明估计偏大
+    if (polls == 0) {
+        if (elapsedUs < _conversionEstimateUs) {
+            _conversionEstimateUs -= _conversionEstimateUs / 16;
+        }
+    } else {
+        _conversionEstimateUs = micros() - startUs;
+    }
+    return true;
 }
 
 void BreathController::startAcquisition() {
@@ -578,11 +1500,7 @@ void BreathController::startAcquisition() {
 }
 
 float BreathController::calculateTemperature(uint16_t adc_value) {
-    if (adc_value & 0x8000) {
-        return (adc_value - 65536.0) / 256.0;
-    } else {
-        return adc_value / 256.0;
-    }
+    return pressureTemperatureC(adc_value);
 }
 
 float BreathController::calculatePressure(uint32_t adc_value, uint32_t k, float temperature) {
@@ -600,51 +1518,26 @@ float BreathController::calculatePressure(uint32_t adc_value, uint32_t k, float
     return pressure;
 }
 
-float BreathController::applyMovingAverage(float newValue) {
-    pressureHistory[historyIndex] = newValue;
-    historyIndex = (historyIndex + 1) % FILTER_WINDOW;
-    
-    float sum = 0.0;
-    int count = 0;
-    for (int i = 0; i < FILTER_WINDOW; i++) {
-        if (!isnan(pressureHistory[i])) {
-            sum += pressureHistory[i];
-            count++;
-        }
-    }
-    
-    return (count > 0) ? (sum / count) : newValue;
-}
-
-float BreathController::applyEWMA(float newValue) {
-    if (!isFilterInitialized) {
-        filteredPressure = newValue;
-        isFilterInitialized = true;
-        return newValue;
-    }
-    
-    filteredPressure = EWMA_ALPHA * newValue + (1 - EWMA_ALPHA) * filteredPressure;
-    return filteredPressure;
-}
-
 void BreathController::calibrateZeroPoint() {
     const int CALIB_SAMPLES = 10;
     float sum = 0.0;
     
     Serial.println("\n开始零点校准...");
     
+    // 校准会覆盖当前通道上未读取的流水线转换
+    if (_mux && _mux->getActiveChannel() < MAX_MUX_CHANNELS) {
+        _conversionPending[_mux->getActiveChannel()] = false;
+    }
+    
     for (int i = 0; i < CALIB_SAMPLES; i++) {
         startAcquisition();
-        unsigned long startTime = millis();
-        while (!operateCheck() && !dataCheck()) {
-            if (millis() - startTime > 100) {
-                Serial.println("校准采集超时!");
-                return;
-            }
-            delay(5);
+        int32_t pressure_adc;
+        int16_t temperature_adc;
+        if (!waitForSample(pressure_adc, temperature_adc, 100)) {
+            Serial.println("校准采集超时!");
+            return;
         }
         
-        int32_t pressure_adc = readPressureADC();
         uint32_t k_value = getKValue(PRESSURE_RANGE);
         float pressure = calculatePressure(pressure_adc, k_value, baseTemperature);
         sum += pressure;
@@ -661,198 +1554,167 @@ void BreathController::calibrateZeroPoint() {
     Serial.println("---------------------");
 }
 
-BreathState BreathController::detectBreathState(float pressure) {
-    static float lastPressure = NAN;
-    static bool firstCall = true;
-    
-    BreathState newState = currentState;
+BreathState BreathController::detectBreathState(float pressure, unsigned long timestampUs) {
+    BreathState newState = _onsetDetector.update(timestampUs, pressure);
     
-    if (firstCall || isnan(lastPressure)) {
-        lastPressure = pressure;
-        firstCall = false;
-        return currentState;
-    }
-
-    switch(currentState) {
-        case EXHALE:
-            if (pressure > lastPressure + pressureThreshold) {
-                newState = INHALE;
+    if (newState != currentState) {
+        switch(newState) {
+            case INHALE:
                 minPressure = pressure;
-            }
-            break;
-            
-        case INHALE:
-            if (pressure < lastPressure) {
-                newState = PEAK;
+                // 预测以估计的起升时刻为起点，提前量相对患者努力而非检测时刻
+                _breathPredictor.onInspiration(timestampUs - (unsigned long)(_onsetDetector.lastTriggerDelayMs() * 1000));
+                break;
+                
+            case PEAK:
                 maxPressure = pressure;
-            }
-            break;
-            
-        case PEAK:
-            if (pressure < lastPressure - pressureThreshold) {
-                newState = EXHALE;
+                break;
+                
+            case EXHALE: {
                 unsigned long currentTime = millis();
                 if (lastBreathTime > 0) {
                     breathPeriod = 0.8 * breathPeriod + 0.2 * (currentTime - lastBreathTime);
                 }
                 lastBreathTime = currentTime;
                 breathCount++;
+                break;
             }
-            break;
-            
-        case TROUGH:
-            if (pressure > lastPressure) {
-                newState = INHALE;
-            }
-            break;
+                
+            case TROUGH:
+                break;
+        }
     }
     
-    lastPressure = pressure;
     return newState;
 }
 
-void BreathController::controlValve() {
-    switch(currentState) {
-        case INHALE:
-            valveOpening = constrain(valveOpening + 10 * responseFactor, 0, MAX_VALVE_OPEN * assistLevel);
-            break;
-            
-        case PEAK:
-            break;
-            
-        case EXHALE:
-            valveOpening = constrain(valveOpening - 20, 0, MAX_VALVE_OPEN);
-            break;
-            
-        case TROUGH:
-            valveOpening = 0;
-            break;
-    }
+void BreathController::controlValve(unsigned long timestampUs, float pressureKpa) {
+    // 提前开阀窗口内按吸气目标控制，患者触发后自然衔接
+    BreathState controlState = currentState;
+    _preActuating = _breathPrediction && _breathPredictor.shouldPreActuate(timestampUs) &&
+                    (currentState == EXHALE || currentState == TROUGH);
+    if (_preActuating) controlState = INHALE;
+    
+    // 按当前阶段的目标压力闭环，响应因子缩放PID增益，开度上限由辅助等级决定
+    valveOpening = _valvePid.update(timestampUs, controlState, pressureKpa, responseFactor, MAX_VALVE_OPEN * assistLevel);
+    float opening = valveOpening / MAX_VALVE_OPEN;
+    _valve.setOpening(_valveLinearization ? _valveLinearizer.dutyFor(opening) : opening);
     
-    analogWrite(VALVE_PIN, (int)valveOpening); 
+    if (_valvePid.cycleCompleted()) {
+        if (_pipelineRunning) {
+            _trackingQueue.push(_valvePid.lastCycle());
+        } else {
+            logTrackingStats(_valvePid.lastCycle());
+        }
+    }
+}
+
+bool BreathController::startValveCharacterization() {
+    if (_valveLinearizer.isSweeping() || !_valve.isReady()) return false;
+    // 在下一个主气压样本开始，扫描与采样在同一上下文中推进
+    _characterizationRequested = true;
+    Serial.println("开始气阀特性扫描...");
+    return true;
+}
+
+void BreathController::cancelValveCharacterization() {
+    _characterizationRequested = false;
+    _valveLinearizer.cancelSweep();
+    _valve.close();
+    valveOpening = 0;
+}
+
+void BreathController::finishValveCharacterization() {
+    _valve.close();
+    valveOpening = 0;
+    if (_valveLinearizer.sweepState() != VALVE_SWEEP_DONE) {
+        Serial.println("气阀特性扫描失败: 满开响应过小，保留原特性表");
+        return;
+    }
+    // 写闪存只在扫描结束时发生一次
+    bool saved = _valveLinearizer.save();
+    const ValveTable& table = _valveLinearizer.table();
+    Serial.print("气阀特性扫描完成，满开响应: ");
+    Serial.print(table.fullScale, 2);
+    Serial.print(table.kind == VALVE_RESPONSE_FLOW ? " ml/min" : " kPa");
+    Serial.print("，半程响应对应占空比: ");
+    Serial.print(_valveLinearizer.dutyFor(0.5f) * 100, 1);
+    Serial.println(saved ? "%，已保存" : "%，保存失败");
 }
 
 void BreathController::adaptiveModelAdjustment() {
-    if (breathCount % ADAPT_CYCLES == 0) {
-        float avgPressureDiff = 0;
-        for (int i = 0; i < STORE_SIZE; i++) {
-            avgPressureDiff += fabs(storedPressures[i]);
+    const LungMechanics& mechanics = _lungMechanics.estimate();
+    if (mechanics.valid) {
+        // 送入参考潮气量所需的压力（弹性 + 阻力项），与标称肺相比缩放辅助等级
+        float requiredCmH2O = REFERENCE_TIDAL_VOLUME_ML / mechanics.complianceMlCmH2O +
+                              mechanics.resistanceCmH2O * REFERENCE_INSPIRATORY_FLOW_LPS;
+        float nominalCmH2O = REFERENCE_TIDAL_VOLUME_ML / NOMINAL_COMPLIANCE_ML_CMH2O +
+                             NOMINAL_RESISTANCE_CMH2O * REFERENCE_INSPIRATORY_FLOW_LPS;
+        assistLevel = constrain(NOMINAL_ASSIST_LEVEL * requiredCmH2O / nominalCmH2O, MIN_ASSIST_LEVEL, MAX_ASSIST_LEVEL);
+        pressureThreshold = constrain(BREATH_THRESHOLD * NOMINAL_COMPLIANCE_ML_CMH2O / mechanics.complianceMlCmH2O,
+                                      MIN_TRIGGER_THRESHOLD, MAX_TRIGGER_THRESHOLD);
+        _onsetDetector.setSlopeThreshold(pressureThreshold);
+        
+        if (inlineLogging()) {
+            Serial.print("肺力学 - 顺应性: ");
+            Serial.print(mechanics.complianceMlCmH2O, 1);
+            Serial.print("ml/cmH2O, 阻力: ");
+            Serial.print(mechanics.resistanceCmH2O, 1);
+            Serial.print("cmH2O/(L/s), 辅助等级: ");
+            Serial.print(assistLevel, 2);
+            Serial.print(", 触发阈值: ");
+            Serial.print(pressureThreshold, 2);
+            Serial.println(" kPa/s");
         }
-        avgPressureDiff /= STORE_SIZE;
+        return;
+    }
+    
+    // 无有效估计（无流量传感器或尚未收敛）：每ADAPT_CYCLES次呼吸按斜率噪声调整一次触发阈值。
+    // 阈值贴近噪声下限时容易误触发，抬高；远高于下限时触发偏晚，降低
+    if (breathCount > 0 && breathCount % ADAPT_CYCLES == 0) {
+        float noiseFloor = SLOPE_NOISE_K * _onsetDetector.slopeNoise();
+        if (noiseFloor <= 0) return;
         
-        if (avgPressureDiff > 1.5 * pressureThreshold) {
+        if (pressureThreshold < TRIGGER_NOISE_MARGIN_LOW * noiseFloor) {
             pressureThreshold *= 1.1;
-            responseFactor *= 1.05;
-            Serial.println("模型调整: 增加灵敏度");
+            if (inlineLogging()) Serial.println("模型调整: 降低灵敏度");
         } 
-        else if (avgPressureDiff < 0.7 * pressureThreshold) {
+        else if (pressureThreshold > TRIGGER_NOISE_MARGIN_HIGH * noiseFloor) {
             pressureThreshold *= 0.9;
-            responseFactor *= 0.95;
-            Serial.println("模型调整: 降低灵敏度");
+            if (inlineLogging()) Serial.println("模型调整: 增加灵敏度");
         }
         
-        pressureThreshold = constrain(pressureThreshold, 0.2, 2.0);
-        responseFactor = constrain(responseFactor, 0.5, 2.0);
+        pressureThreshold = constrain(pressureThreshold, MIN_TRIGGER_THRESHOLD, MAX_TRIGGER_THRESHOLD);
+        _onsetDetector.setSlopeThreshold(pressureThreshold);
         
-        Serial.print("新阈值: ");
-        Serial.print(pressureThreshold, 2);
-        Serial.print(" kPa, 响应因子: ");
-        Serial.println(responseFactor, 2);
-    }
-}
-
-void BreathController::connectToWiFi() {
-    if (!_ssid || !_password) return;
-    
-    Serial.println();
-    Serial.print("正在连接到: ");
-    Serial.println(_ssid);
-
-    WiFi.begin(_ssid, _password);
-    
-    int attempts = 0;
-    while (WiFi.status() != WL_CONNECTED && attempts < 15) {
-        delay(1000);
-        Serial.print(".");
-        attempts++;
-    }
-    
-    if (WiFi.status() == WL_CONNECTED) {
-        wifiConnected = true;
-        Serial.println("");
-        Serial.println("WiFi已连接!");
-        Serial.print("IP地址: ");
-        Serial.println(WiFi.localIP());
-    } else {
-        wifiConnected = false;
-        Serial.println("");
-        Serial.println("WiFi连接失败!");
+        if (inlineLogging()) {
+            Serial.print("新阈值: ");
+            Serial.print(pressureThreshold, 2);
+            Serial.print(" kPa/s, 斜率噪声下限: ");
+            Serial.print(noiseFloor, 2);
+            Serial.println(" kPa/s");
+        }
     }
 }
 
-bool BreathController::connectToServer() {
-    if (!_host || !_port) return false;
-    
-    // 检查WiFi连接状态
-    if (WiFi.status() != WL_CONNECTED) {
-        Serial.println("WiFi未连接，无法连接服务器");
-        wifiConnected = false;
+bool BreathController::sendDataOverWiFi(float pressure, float temp, float valve, BreathState state) {
+    if (!_connection.isConnected()) {
         return false;
     }
     
-    Serial.print("正在连接到服务器: ");
-    Serial.print(_host);
-    Serial.print(":");
-    Serial.println(_port);
-    
-    // 设置连接超时
-    client.setTimeout(5000);
-    
-    if (client.connect(_host, _port)) {
-        Serial.println("服务器连接成功!");
-        Serial.print("本地IP: ");
-        Serial.println(WiFi.localIP());
-        Serial.print("目标IP: ");
-        Serial.println(_host);
-        return true;
-    } else {
-        Serial.println("服务器连接失败!");
-        Serial.print("错误代码: ");
-        Serial.println(client.getWriteError());
-        Serial.println("可能的原因:");
-        Serial.println("1. 服务器未运行");
-        Serial.println("2. IP地址错误");
-        Serial.println("3. 端口被防火墙阻止");
-        Serial.println("4. 网络不通");
-        return false;
-    }
+    // 与原println()相同的行格式；一次整行交给非阻塞发送
+    String data = formatDataLine(millis(), pressure, temp, valve, state);
+    return _connection.send((const uint8_t*)data.c_str(), data.length());
 }
 
-void BreathController::sendDataOverWiFi(float pressure, float temp, float valve) {
-    if (!client.connected()) {
-        if (millis() - lastReconnectAttempt > RECONNECT_INTERVAL) {
-            lastReconnectAttempt = millis();
-            if (!connectToServer()) {
-                return;
-            }
-        } else {
-            return;
-        }
-    }
-    
-    String data = String(millis()) + ",";
+String BreathController::formatDataLine(unsigned long timeMs, float pressure, float temp, float valve, BreathState state) {
+    String data = String(timeMs) + ",";
     data += String(pressure, 4) + ",";
     data += String(temp, 2) + ",";
     data += String(valve/MAX_VALVE_OPEN, 2) + ",";
     
-    switch(currentState) {
-        case INHALE: data += "INHALE"; break;
-        case EXHALE: data += "EXHALE"; break;
-        case PEAK: data += "PEAK"; break;
-        case TROUGH: data += "TROUGH"; break;
-    }
-    
-    client.println(data);
+    data += breathStateName(state);
+    data += "\r\n";
+    return data;
 }
 
 // 设置ACD1100通信模式
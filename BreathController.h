@@ -4,20 +4,51 @@
 #include <Arduino.h>
 #include <Wire.h>
 #include <WiFi.h>
-#include <WiFiClient.h>
+#include <WiFiUdp.h>
 #include "OLEDDisplay.h"
 #include "I2CMux.h"  // 包含新的多路复用器库
+#include "I2CScheduler.h"
+#include "SamplingEngine.h"
+#include "SpscQueue.h"
+#include "PressureMath.h"
+#include "BreathAnalyzer.h"
+#include "OnsetDetector.h"
+#include "BreathPredictor.h"
+#include "PressurePid.h"
+#include "LungMechanics.h"
+#include "ValveDriver.h"
+#include "ValveLinearizer.h"
+#include "TelemetryProtocol.h"
+#include "ConnectionManager.h"
+#include "TelemetryLog.h"
+#include "TelemetryShaper.h"
 #include "gas_concentration.h"  // 包含气体浓度传感器库
 #include "ADS1115.h"
 #include "oxygen_sensor.h"
 
 // 硬件配置
 constexpr uint8_t VALVE_PIN = 3;          // 气阀控制引脚
-constexpr float BREATH_THRESHOLD = 0.5;    // 呼吸检测阈值(kPa)
-constexpr uint8_t MAX_VALVE_OPEN = 255;    // 气阀最大开度
+constexpr float BREATH_THRESHOLD = 0.5;    // 呼吸起始/释放斜率阈值(kPa/s)
+constexpr uint8_t MAX_VALVE_OPEN = 255;    // 气阀开度满量程（逻辑单位，由ValveDriver映射到PWM分辨率）
+
+// 肺力学驱动的自适应辅助：按估计的R/C计算送入参考潮气量所需压力，与标称肺相比缩放辅助等级；
+// 触发阈值按弹性缩放（同样的吸气努力在僵硬的肺上产生更陡的压力斜率）
+constexpr float NOMINAL_COMPLIANCE_ML_CMH2O = 50.0;
+constexpr float NOMINAL_RESISTANCE_CMH2O = 10.0;   // cmH2O/(L/s)
+constexpr float NOMINAL_ASSIST_LEVEL = 0.5;        // 标称肺的辅助等级（开度上限占满量程比例）
+constexpr float REFERENCE_TIDAL_VOLUME_ML = 500.0;
+constexpr float REFERENCE_INSPIRATORY_FLOW_LPS = 0.5;
+constexpr float MIN_ASSIST_LEVEL = 0.2;
+constexpr float MAX_ASSIST_LEVEL = 1.0;
+constexpr float MIN_TRIGGER_THRESHOLD = 0.2;       // kPa/s
+constexpr float MAX_TRIGGER_THRESHOLD = 2.0;
+// 无肺力学估计时按斜率噪声下限（SLOPE_NOISE_K倍噪声RMS）调整触发阈值，保持在下限的1.5~3倍之间
+constexpr float TRIGGER_NOISE_MARGIN_LOW = 1.5;
+constexpr float TRIGGER_NOISE_MARGIN_HIGH = 3.0;
 
 // 传感器配置
 constexpr uint8_t SENSOR_ADDR = 0x6D;      // 气压传感器I2C地址
+constexpr uint8_t PRIMARY_PRESSURE_CHANNEL = 1;  // 主气压传感器所在多路复用器通道
 constexpr uint8_t FLOW_SENSOR_ADDR = 0x50; // 流量传感器I2C地址
 constexpr uint8_t ACD1100_ADDR = 0x2A;     // ACD1100气体浓度传感器I2C地址
 
@@ -34,37 +65,215 @@ constexpr uint8_t REG_CMD = 0x30;
 constexpr uint8_t REG_OTP_CMD = 0x6C;
 constexpr uint8_t REG_SPECIAL = 0xA5;
 
+// 突发读取：寄存器地址自动递增，一次事务读完连续寄存器
+constexpr uint8_t PRESSURE_FETCH_LEN = REG_TEMP_LSB - REG_STATUS + 1;     // 0x02–0x0A：状态+数据
+constexpr uint32_t PRESSURE_POLL_US = 1000;  // 等待转换完成时的轮询间隔
+
 // 命令常量
 constexpr uint8_t CMD_COLLECT = 0x0A;      // 组合采集模式命令
 constexpr uint8_t CMD_CLEAR = 0xFD;        // 清除特殊寄存器命令
 
+constexpr uint8_t FLOW_MEDIAN_WINDOW = 3;  // 流量中值滤波，去除单次读取毛刺
+
 // 量程配置
 constexpr float MIN_PRESSURE = -100.0;     // kPa
 constexpr float MAX_PRESSURE = 300.0;      // kPa
 constexpr float PRESSURE_RANGE = MAX_PRESSURE - MIN_PRESSURE;
+constexpr uint32_t PRESSURE_K = pressureKValue(PRESSURE_RANGE);  // 编译期确定的量程除数
+static_assert(PRESSURE_K >= 16, "定点滤波的int32运行和要求k >= 16");
+
+// 双核流水线：采集/控制固定在核1（与loop()同核），遥测/显示/日志固定在核0（与WiFi协议栈同核）
+constexpr BaseType_t CONTROL_TASK_CORE = 1;
+constexpr BaseType_t NETWORK_TASK_CORE = 0;
+constexpr UBaseType_t CONTROL_TASK_PRIORITY = configMAX_PRIORITIES - 2;
+constexpr UBaseType_t NETWORK_TASK_PRIORITY = 1;
+constexpr uint32_t CONTROL_TASK_STACK = 4096;
+constexpr uint32_t NETWORK_TASK_STACK = 8192;
+constexpr uint32_t NETWORK_TASK_PERIOD_MS = 10;   // 网络任务轮询队列的间隔
+constexpr size_t TELEMETRY_QUEUE_SIZE = 64;       // 200Hz下约320ms的缓冲
+constexpr size_t BREATH_QUEUE_SIZE = 8;           // 逐次呼吸记录
+constexpr size_t TRACKING_QUEUE_SIZE = 4;         // 逐周期气阀跟踪误差
+
+// 控制核每处理一个主气压样本发布一条，网络核据此发送、显示和记录日志
+struct TelemetrySample {
+    uint32_t seq;
+    unsigned long timestampUs;
+    float pressureKpa;          // 滤波后的主气压
+    float temperatureC;
+    float basePressureKpa;
+    float baseTemperatureC;
+    float backupPressureKpa;    // 备用气压（未采集为NAN）
+    float backupTemperatureC;
+    float flowRate;
+    float valveOpening;
+    float co2Ppm;
+    float oxygenPercent;        // 未采集为NAN
+    BreathState state;
+    uint8_t statusFlags;        // 控制器状态位 TELEMETRY_FLAG_BASE_SET/PRE_ACTUATING/VALVE_SWEEP
+};
+
+// 遥测格式：文本为每100ms一行CSV（兼容Server_pp.py），二进制为逐样本批量帧（见TelemetryProtocol.h）
+enum TelemetryFormat { TELEMETRY_TEXT, TELEMETRY_BINARY };
+// 遥测传输：TCP可靠但有队头阻塞和重连阻塞；UDP每帧一个数据报，丢包由接收端按帧序号统计
+enum TelemetryTransport { TELEMETRY_TCP, TELEMETRY_UDP };
+constexpr uint8_t TELEMETRY_BATCH_SAMPLES = 20;       // 每帧样本数（200Hz下100ms一帧）
+constexpr uint32_t TELEMETRY_MAX_FRAME_AGE_MS = 100;   // 不满一帧时最长攒批时间（低采样率时）
+constexpr uint32_t TEXT_TELEMETRY_INTERVAL_MS = 100;   // 文本遥测的发送间隔
+constexpr uint32_t TELEMETRY_BACKFILL_BYTES_PER_SEC = 16384;  // 补发限速（200Hz实时流约6KB/s）
 
-// 呼吸状态
-enum BreathState { INHALE, EXHALE, PEAK, TROUGH };
+// 二进制遥测链路统计（由发送遥测的一方维护：流水线时为网络核）
+struct TelemetryLinkStats {
+    uint32_t frames;            // 成功写出的帧
+    uint32_t samples;           // 成功写出的样本
+    uint32_t bytes;
+    uint32_t dropped;           // 未连接或写失败而丢弃的样本（计入下一帧的dropped字段）
+    uint32_t stored;            // 未能发送而存入闪存日志的样本
+    uint32_t backfillFrames;    // 重连后从闪存补发的帧
+    uint32_t backfillBytes;
+    uint32_t windows;           // 降采样模式写出的窗口记录
+    uint32_t breaths;           // 呼吸摘要模式写出的呼吸记录
+    uint32_t modeChanges;       // 写出的模式切换记录
+    uint32_t droppedSummaries;  // 丢弃的窗口/呼吸记录
+};
+
+// 流水线统计：控制核字段由控制任务维护，网络核字段由网络任务维护
+struct PipelineStats {
+    SamplingStats sampling;
+    uint32_t controlSteps;      // 控制任务被唤醒的次数
+    float meanControlStepUs;
+    uint32_t maxControlStepUs;
+    uint32_t published;         // 推入队列的样本数
+    uint32_t queueDropped;      // 队列满而丢弃的样本数
+    uint32_t queueHighWater;
+    uint32_t consumed;          // 网络核取出的样本数
+    uint32_t telemetrySent;
+    uint32_t maxNetworkStepUs;  // 网络任务单轮最长耗时（含服务器重连阻塞）
+};
 
 class BreathController {
 public:
     BreathController(I2CMux* mux = nullptr); // 可传入外部多路复用器实例
     void begin();
     void update();
+    void acquirePressureRound();  // 只执行一轮气压/流量采集（不含OLED、气体、氧传感器）
+    
+    // 流水线采集：读取上一轮启动的转换结果后立即启动下一次转换，
+    // 转换时间与其他通道的总线操作重叠；代价是样本滞后一轮
+    void setPipelinedAcquisition(bool enable);
+    bool isPipelinedAcquisition() const { return _pipelinedAcquisition; }
+    
+    // 定时采样：主气压由硬件定时器按固定速率采集，慢速设备每100ms轮询一次。
+    // 需在begin()之前调用；0表示沿用每轮delay(100)的原有循环
+    void setSamplingRate(uint32_t rateHz) { _samplingRateHz = rateHz; }
+    SamplingEngine* getSamplingEngine() { return &_sampler; }
+    
+    // 定点换算与滤波（默认开启）：ADC -> Q19.12 kPa -> 定点移动平均/EWMA，
+    // 呼吸检测前才转为浮点；关闭后使用原浮点链路
+    void setFixedPointFilter(bool enable) { _fixedPointFilter = enable; }
+    bool isFixedPointFilter() const { return _fixedPointFilter; }
+    
+    // 双核流水线：需定时采样已启动。控制任务由定时器节拍唤醒，独占I2C总线；
+    // 网络任务从无锁队列取样本，WiFi发送、OLED绘制和日志输出不再占用控制核
+    bool startPipeline();
+    void stopPipeline();
+    bool isPipelineRunning() const { return _pipelineRunning; }
+    PipelineStats getPipelineStats() const;  // 流水线停止后调用，运行中由网络核每5秒输出
+    
+    // 逐次呼吸统计（PIP/PEEP/呼吸频率/吸呼比/Ti/潮气量），每次吸气结束生成一条记录；
+    // 流水线运行中由网络核输出，停止后可读取
+    const BreathAnalyzer& getBreathAnalyzer() const { return _breathAnalyzer; }
+    
+    // 双路径：呼吸触发用未平滑样本的斜率检测（默认），显示/遥测/统计仍用平滑后的压力；
+    // 关闭后触发也改用平滑压力，用于对比触发延迟
+    void setFastTriggerPath(bool enable) { _fastTriggerPath = enable; }
+    bool isFastTriggerPath() const { return _fastTriggerPath; }
+    const OnsetDetector& getOnsetDetector() const { return _onsetDetector; }
+    
+    // 预测性提前开阀（默认关闭）：按吸气起点间隔预测下一次吸气，在预测起点前leadMs
+    // 把气阀目标切到吸气；周期不规律或上次预测落空时只做被动触发
+    void setBreathPrediction(bool enable) { _breathPrediction = enable; }
+    bool isBreathPrediction() const { return _breathPrediction; }
+    void setPredictionLeadMs(uint16_t ms) { _breathPredictor.setLeadMs(ms); }
+    const BreathPredictor& getBreathPredictor() const { return _breathPredictor; }
+    bool isPreActuating() const { return _preActuating; }
+    
+    // 气阀压力闭环：PID + 前馈，每个主气压样本更新一次；目标压力按呼吸阶段设置（相对基准，kPa），
+    // 每个呼吸周期结束输出跟踪误差统计
+    void setValveGains(const PidGains& gains) { _valvePid.setGains(gains); }
+    const PidGains& getValveGains() const { return _valvePid.getGains(); }
+    void setPhaseTarget(BreathState state, float targetKpa) { _valvePid.setPhaseTarget(state, targetKpa); }
+    const PressurePid& getValveController() const { return _valvePid; }
+    // 气阀PWM频率和分辨率（12–16位），需在begin()之前调用
+    void setValvePwm(uint32_t freqHz, uint8_t bits) { _valvePwmFreqHz = freqHz; _valvePwmBits = bits; }
+    const ValveDriver& getValveDriver() const { return _valve; }
+    
+    // 气阀特性扫描：暂停压力闭环，逐点扫描占空比并记录压力/流量响应，完成后生成单调特性表
+    // 并保存到闪存（begin()时自动加载）。需接模拟肺或关闭患者端时运行，约10秒
+    bool startValveCharacterization();
+    void cancelValveCharacterization();
+    // 线性化（默认开启，表有效时生效）：PID输出视为满开响应的比例，经特性表反查为占空比
+    void setValveLinearization(bool enable) { _valveLinearization = enable; }
+    bool isValveLinearization() const { return _valveLinearization; }
+    const ValveLinearizer& getValveLinearizer() const { return _valveLinearizer; }
+    
+    // 肺力学在线估计：每个流量样本用RLS更新阻力/顺应性，估计有效后每次呼吸据此调整
+    // 辅助等级和触发阈值（无流量传感器时退回按压力均值的原调整），估计值随逐次呼吸记录输出
+    const LungMechanicsEstimator& getLungMechanics() const { return _lungMechanics; }
+    float getAssistLevel() const { return assistLevel; }
+    float getTriggerThreshold() const { return pressureThreshold; }
+    
+    // 遥测格式（默认文本）：二进制模式发送每个样本的完整记录，攒够TELEMETRY_BATCH_SAMPLES条
+    // 或TELEMETRY_MAX_FRAME_AGE_MS后打包成带CRC的帧，一次write()发出
+    void setTelemetryFormat(TelemetryFormat format) { _telemetryFormat = format; }
+    TelemetryFormat getTelemetryFormat() const { return _telemetryFormat; }
+    // 二进制帧负载压缩（默认关闭）：整数字段zigzag差值varint、浮点字段异或编码，逐样本在add()时完成；
+    // 压缩帧同样存入闪存日志补发，主机端TelemetryDecoder自动识别
+    void setTelemetryCompression(bool enable) { _telemetryEncoder.setCompression(enable); }
+    bool getTelemetryCompression() const { return _telemetryEncoder.compression(); }
+    // UDP传输发往同一主机/端口，只支持二进制格式（选择UDP时自动切换）；实时监测用UDP，
+    // 需要完整记录时用TCP
+    void setTelemetryTransport(TelemetryTransport transport) {
+        _telemetryTransport = transport;
+        if (transport == TELEMETRY_UDP) _telemetryFormat = TELEMETRY_BINARY;
+        _connection.setServerEnabled(transport == TELEMETRY_TCP);
+    }
+    TelemetryTransport getTelemetryTransport() const { return _telemetryTransport; }
+    TelemetryLinkStats getTelemetryLinkStats() const { return _telemetryLink; }
+    // 断线存储转发（二进制格式，begin()之前设置）：未能发送的帧存入LittleFS环形日志，
+    // 重连后按限速与实时帧交错补发；接收端按(bootId, frameSeq)去重
+    void setStoreAndForward(bool enable) { _storeAndForward = enable; }
+    void setBackfillRate(uint32_t bytesPerSec) { _backfillBytesPerSec = bytesPerSec; }
+    TelemetryLogStats getTelemetryLogStats() const { return _telemetryLog.getStats(); }
+    // 自适应遥测（二进制格式，默认开启）：链路变慢（发送被拒绝、发送端积压、跨核队列积压）时
+    // 由全速逐样本降为窗口最小/最大/平均，再降为只发逐次呼吸摘要，通畅后逐级试探恢复；
+    // 每次切换发送一条模式切换记录。setTelemetryMode()固定模式并关闭自适应
+    void setAdaptiveTelemetry(bool enable) { _telemetryShaper.setAdaptive(enable); }
+    void setTelemetryMode(uint8_t mode);
+    uint8_t getTelemetryMode() const { return _telemetryMode; }
+    TelemetryShaperStats getTelemetryShaperStats() const { return _telemetryShaper.getStats(); }
     
     // WiFi 配置
     void setWiFiCredentials(const char* ssid, const char* password, const char* host, int port);
+    // WiFi/服务器连接由非阻塞状态机管理（begin()不再等待关联），失败按指数退避重试
+    ConnectionStats getConnectionStats() const { return _connection.getStats(); }
     
     // 多路复用器访问
-    void setMux(I2CMux* mux) { _mux = mux; }
+    void setMux(I2CMux* mux) { _mux = mux; _scheduler.setMux(mux); }
     I2CMux* getMux() { return _mux; }
     
+    // 总线调度器（用于读取各设备实际采样率）
+    I2CScheduler* getScheduler() { return &_scheduler; }
+    
     // ADS1115和氧传感器配置
     void setADS1115Channel(uint8_t channel);  // 设置ADS1115的I2C多路复用器通道
     void initializeOxygenSensor();  // 初始化氧传感器
     
     // 设置ACD1100通信模式
     void setACD1100CommunicationMode(ACD1100_COMM_MODE mode);
+    
+    // 文本遥测的一行（sendDataOverWiFi()的线路格式）：millis,压力,温度,气阀开度(0~1),呼吸状态\r\n，
+    // valve为气阀开度逻辑值（0~MAX_VALVE_OPEN）。主机端负载生成器用同一函数生成数据
+    static String formatDataLine(unsigned long timeMs, float pressure, float temp, float valve, BreathState state);
 
 private:
     // 传感器操作
@@ -73,35 +282,77 @@ private:
     uint32_t getKValue(float range_kpa);
     void writeRegister(uint8_t reg, uint8_t value);
     uint8_t readRegister(uint8_t reg);
-    int32_t readPressureADC();
-    int16_t readTemperatureADC();
-    bool dataCheck();
-    bool operateCheck();
+    bool readRegisters(uint8_t reg, uint8_t* buffer, uint8_t len);
+    bool fetchSampleIfReady(int32_t& pressureAdc, int16_t& temperatureAdc);
+    bool waitForSample(int32_t& pressureAdc, int16_t& temperatureAdc, unsigned long timeoutMs);
+    bool waitForSample(int32_t& pressureAdc, int16_t& temperatureAdc, unsigned long timeoutMs, unsigned long startUs);
 
     float readFlowRate();       // 流量计读取操作
     
     // 数据处理
     float calculateTemperature(uint16_t adc_value);
     float calculatePressure(uint32_t adc_value, uint32_t k, float temperature);
-    float applyMovingAverage(float newValue);
-    float applyEWMA(float newValue);
     
     // 校准
     void calibrateZeroPoint();
     
     // 呼吸检测与控制
-    BreathState detectBreathState(float pressure);
-    void controlValve();
+    BreathState detectBreathState(float pressure, unsigned long timestampUs);
+    void controlValve(unsigned long timestampUs, float pressureKpa);
     void adaptiveModelAdjustment();
+    void finishValveCharacterization();
     
     // WiFi 功能
-    void connectToWiFi();
-    bool connectToServer();
-    void sendDataOverWiFi(float pressure, float temp, float valve);
+    bool sendDataOverWiFi(float pressure, float temp, float valve, BreathState state);
+    TelemetrySample makeTelemetrySample(unsigned long timestampUs);
+    void sendTelemetry(const TelemetrySample& sample);
+    void sendTelemetryWindow(const TelemetryWindowRecord& window);
+    void sendBreathTelemetry(const BreathRecord& record);
+    void flushTelemetryFrame();
+    bool sendTelemetryFrame(const uint8_t* frame, size_t len);
+    bool sendPendingModeFrame();
+    void backfillStep();
+    bool telemetryLinkUp() const;
+    void shapeTelemetry();
+    void applyTelemetryMode();
     
     // 设备探测
     void probeFlowSensor();
     
+    // 总线调度
+    void registerBusDevices();
+    void submitBusWork();
+    void submitPressureWork();
+    void processPressureSample(uint8_t channel, int32_t pressure_adc, int16_t temperature_adc, unsigned long timestampUs);
+    void processPressureValue(uint8_t channel, float filtered_pressure, float raw_pressure, float temperature_c, unsigned long timestampUs);
+    void updateTimed();
+    void runSlowWork();
+    static bool primarySampleSource(void* self, PressureSample& sample);
+    static void samplerIdleHook(void* self);
+    static bool oledChunkTask(void* self, uint8_t channel);
+    String breathStateName() const;
+    static String breathStateName(BreathState state);
+    
+    // 双核流水线
+    static void controlTaskEntry(void* self);
+    static void networkTaskEntry(void* self);
+    void controlStep();
+    void networkStep();
+    void publishTelemetry(const PressureSample& sample);
+    void logTelemetry(const TelemetrySample& sample);
+    void logBreathRecord(const BreathRecord& record);
+    void logTrackingStats(const TrackingStats& stats);
+    PipelineStats controlSnapshot() const;  // 只含控制核字段
+    void printPipelineStats(const PipelineStats& stats);
+    bool inlineLogging() const { return !_pipelineRunning; }
+    bool samplePressureChannel(uint8_t channel);
+    bool updateGasSensor();
+    static bool pressureTask(void* self, uint8_t channel);
+    static bool flowTask(void* self, uint8_t channel);
+    static bool gasTask(void* self, uint8_t channel);
+    static bool oxygenTask(void* self, uint8_t channel);
+    static bool oledTask(void* self, uint8_t channel);
+    
     // I2C 诊断
     void scanI2CBus();
     
@@ -114,11 +365,16 @@ private:
     float baseTemperature = 0.0;
 
     float flowRate = 0.0;   // 当前流量值(ml/min)
+    float _flowSampleMlMin = NAN;   // 最近一次未滤波的流量读数（肺力学估计用，避免中值滤波的滞后）
+    uint32_t _flowSampleSeq = 0;    // 每读到一个流量样本加1
     
-    float pressureHistory[5];
-    int historyIndex = 0;
-    float filteredPressure = 0.0;
-    bool isFilterInitialized = false;
+    // 气压滤波：移动平均 + EWMA，按通道隔离，主/备传感器样本互不混合
+    PressureFilter _pressureFilters[MAX_MUX_CHANNELS];
+    FixedPressureFilter _fixedPressureFilters[MAX_MUX_CHANNELS];
+    bool _fixedPointFilter = true;
+    float filteredPressure = 0.0;   // 主气压传感器的滤波值
+    float _primaryTemperatureC = 0.0;
+    MedianFilter<float, FLOW_MEDIAN_WINDOW> _flowFilter;
     
     BreathState currentState = EXHALE;
     unsigned long lastBreathTime = 0;
@@ -126,26 +382,67 @@ private:
     float minPressure = 0;
     float maxPressure = 0;
     int breathCount = 0;
+    BreathAnalyzer _breathAnalyzer;
+    OnsetDetector _onsetDetector;
+    bool _fastTriggerPath = true;
+    BreathPredictor _breathPredictor;
+    bool _breathPrediction = false;
+    bool _preActuating = false;
     
     float valveOpening = 0;
+    PressurePid _valvePid;
+    ValveDriver _valve;
+    uint32_t _valvePwmFreqHz = VALVE_PWM_FREQ_HZ;
+    uint8_t _valvePwmBits = VALVE_PWM_BITS;
+    ValveLinearizer _valveLinearizer;
+    bool _valveLinearization = true;
+    bool _characterizationRequested = false;
     float assistLevel = 0.5;
     bool assistEnabled = true;
     
     float pressureThreshold = BREATH_THRESHOLD;
     float responseFactor = 1.0;
+    LungMechanicsEstimator _lungMechanics;
+    uint32_t _mechanicsFlowSeq = 0;
+    int _adaptedBreathCount = 0;    // 上次自适应调整时的呼吸计数
     
     // WiFi 相关
     const char* _ssid = nullptr;
     const char* _password = nullptr;
     const char* _host = nullptr;
     int _port = 0;
-    WiFiClient client;
-    bool wifiConnected = false;
-    unsigned long lastReconnectAttempt = 0;
+    ConnectionManager _connection;
+    unsigned long _lastConnectionStepTime = 0;
+    TelemetryFormat _telemetryFormat = TELEMETRY_TEXT;
+    TelemetryTransport _telemetryTransport = TELEMETRY_TCP;
+    WiFiUDP _udp;
+    TelemetryEncoder _telemetryEncoder{TELEMETRY_BATCH_SAMPLES};
+    unsigned long _telemetryFrameStartMs = 0;
+    TelemetryLinkStats _telemetryLink = {};
+    TelemetryShaper _telemetryShaper;
+    TelemetryDecimator _telemetryDecimator;
+    uint8_t _telemetryMode = TELEMETRY_MODE_FULL;   // 当前生效的模式（切换在样本边界进行）
+    uint32_t _telemetryNextSeq = 0;                 // 下一个进入遥测的样本seq
+    uint8_t _modeFrame[TELEMETRY_HEADER_SIZE + TELEMETRY_MODE_RECORD_SIZE + TELEMETRY_CRC_SIZE];
+    size_t _modeFrameLength = 0;                    // 尚未发出的模式切换帧，先于其他帧重试
+    bool _storeAndForward = false;
+    TelemetryLog _telemetryLog;
+    uint32_t _backfillBytesPerSec = TELEMETRY_BACKFILL_BYTES_PER_SEC;
+    uint32_t _backfillTokens = 0;           // 令牌桶（字节）
+    unsigned long _lastBackfillMs = 0;
+    uint8_t _backfillFrame[TELEMETRY_MAX_FRAME_SIZE];
     
     // I2C 多路复用器
     I2CMux* _mux;
     
+    // 按通道亲和性调度的总线事务
+    I2CScheduler _scheduler;
+    int8_t _channelDeviceId[MAX_MUX_CHANNELS];  // 气压/流量传感器通道 -> 设备ID
+    int8_t _gasDeviceId = -1;
+    int8_t _oxygenDeviceId = -1;
+    int8_t _oledDeviceId = -1;
+    unsigned long lastGasDebugTime = 0;
+    
     // OLED 显示
     OLEDDisplay oled;
     
@@ -161,6 +458,36 @@ private:
     // 流量传感器状态
     bool flowSensorAvailable = false;
     int8_t flowSensorChannel = -1;
+    uint32_t _conversionEstimateUs = PRESSURE_POLL_US;  // 自适应的气压转换时间估计
+    bool _pipelinedAcquisition = true;
+    bool _conversionPending[MAX_MUX_CHANNELS] = {};      // 该通道已启动、尚未读取的转换
+    unsigned long _conversionStartUs[MAX_MUX_CHANNELS] = {};
+    
+    // 定时采样
+    SamplingEngine _sampler;
+    uint32_t _samplingRateHz = 0;
+    unsigned long _lastSlowWorkTime = 0;
+    unsigned long _lastTelemetryTime = 0;
+    
+    // 双核流水线
+    SpscQueue<TelemetrySample, TELEMETRY_QUEUE_SIZE> _telemetryQueue;
+    SpscQueue<PipelineStats, 2> _statsQueue;   // 控制核每5秒发布一次统计快照
+    SpscQueue<BreathRecord, BREATH_QUEUE_SIZE> _breathQueue;
+    SpscQueue<TrackingStats, TRACKING_QUEUE_SIZE> _trackingQueue;
+    TaskHandle_t _controlTask = nullptr;
+    TaskHandle_t _networkTask = nullptr;
+    std::atomic<bool> _pipelineRunning{false};
+    std::atomic<uint8_t> _pipelineTasksActive{0};
+    PipelineStats _controlStats = {};           // 仅控制任务写
+    uint64_t _controlStepSumUs = 0;
+    PipelineStats _finalControlStats = {};      // 控制任务退出时的快照
+    uint32_t _telemetrySeq = 0;
+    PipelineStats _networkStats = {};           // 仅网络任务写
+    TelemetrySample _latestTelemetry = {};
+    bool _hasTelemetry = false;
+    float _backupPressureKpa = NAN;
+    float _backupTemperatureC = NAN;
+    float _oxygenPercent = NAN;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "BreathPredictor.h"
+
+BreathPredictor::BreathPredictor() : _leadMs(PREDICT_DEFAULT_LEAD_MS) {
+    reset();
+}
+
+void BreathPredictor::reset() {
+    _hasOnset = false;
+    _lastOnsetUs = 0;
+    _periodMs = 0;
+    _deviationMs = 0;
+    _intervals = 0;
+    _missedLast = false;
+    _windowOpen = false;
+    _windowDone = false;
+    _windowStartUs = 0;
+    resetStats();
+}
+
+void BreathPredictor::resetStats() {
+    memset(&_stats, 0, sizeof(_stats));
+    _leadSumMs = 0;
+    _errorSumMs = 0;
+}
+
+bool BreathPredictor::isConfident() const {
+    return _intervals >= PREDICT_MIN_INTERVALS && !_missedLast && jitterRatio() <= PREDICT_MAX_JITTER;
+}
+
+void BreathPredictor::onInspiration(unsigned long timestampUs) {
+    _stats.onsets++;
+    if (_windowOpen) {
+        // 命中：记录开阀领先量和预测误差
+        _stats.hits++;
+        _leadSumMs += (long)(timestampUs - _windowStartUs) / 1000.0;
+        _errorSumMs += (long)(predictedOnsetUs() - timestampUs) / 1000.0;
+        _stats.meanLeadMs = _leadSumMs / _stats.hits;
+        _stats.meanErrorMs = _errorSumMs / _stats.hits;
+    }
+    _windowOpen = false;
+    _windowDone = false;
+    _missedLast = false;
+
+    if (_hasOnset) {
+        float intervalMs = (uint32_t)(timestampUs - _lastOnsetUs) / 1000.0f;
+        if (intervalMs >= PREDICT_MIN_PERIOD_MS && intervalMs <= PREDICT_MAX_PERIOD_MS) {
+            if (_intervals == 0) {
+                _periodMs = intervalMs;
+                _deviationMs = 0;
+            } else {
+                _deviationMs += PREDICT_PERIOD_ALPHA * (fabsf(intervalMs - _periodMs) - _deviationMs);
+                _periodMs += PREDICT_PERIOD_ALPHA * (intervalMs - _periodMs);
+            }
+            if (_intervals < 255) _intervals++;
+        } else {
+            // 间隔异常（漏检或误触发），重新积累
+            _intervals = 0;
+        }
+    }
+    _hasOnset = true;
+    _lastOnsetUs = timestampUs;
+}
+
+bool BreathPredictor::shouldPreActuate(unsigned long timestampUs) {
+    if (_windowOpen) {
+        // 预测起点后仍未触发：落空，本周期退回被动触发
+        float graceMs = _leadMs + PREDICT_WINDOW_DEVIATIONS * _deviationMs;
+        if ((long)(timestampUs - predictedOnsetUs()) > (long)(graceMs * 1000)) {
+            _windowOpen = false;
+            _missedLast = true;
+            _stats.misses++;
+        }
+        return _windowOpen;
+    }
+    if (_windowDone || !_hasOnset || !isConfident()) return false;
+    if ((long)(timestampUs - predictedOnsetUs()) >= -(long)_leadMs * 1000L) {
+        _windowOpen = true;
+        _windowDone = true;
+        _windowStartUs = timestampUs;
+        _stats.windows++;
+    }
+    return _windowOpen;
+}
@@ -0,0 +1,64 @@
+#ifndef BreathPredictor_h
+#define BreathPredictor_h
+
+#include <Arduino.h>
+
+// 吸气起点预测配置
+constexpr uint16_t PREDICT_DEFAULT_LEAD_MS = 100;   // 预测起点前提前开阀的时间（补偿气阀和气路的响应时间）
+constexpr float PREDICT_WINDOW_DEVIATIONS = 2.0;    // 窗口在预测起点后再保持 lead + 2倍周期平均绝对偏差
+constexpr float PREDICT_PERIOD_ALPHA = 0.2;         // 周期EWMA系数（与breathPeriod相同）
+constexpr uint8_t PREDICT_MIN_INTERVALS = 4;        // 至少观察到这么多个周期才预测
+constexpr float PREDICT_MAX_JITTER = 0.08;          // 周期平均绝对偏差/周期超过此值时不预测
+constexpr uint32_t PREDICT_MIN_PERIOD_MS = 1000;    // 间隔不在此范围内的起点不计入周期（误触发/漏触发）
+constexpr uint32_t PREDICT_MAX_PERIOD_MS = 15000;
+
+struct PredictionStats {
+    uint32_t onsets;            // 观察到的吸气起点
+    uint32_t windows;           // 启动的提前开阀窗口
+    uint32_t hits;              // 窗口内患者触发
+    uint32_t misses;            // 窗口结束仍未触发（提前开阀落空）
+    float meanLeadMs;           // 命中时开阀领先于起点的平均时间（负为开阀晚于起点）
+    float meanErrorMs;          // 命中时预测起点与实际起点之差的平均值（正为预测偏晚）
+};
+
+// 呼吸相位预测：按吸气起点间隔的EWMA预测下一次起点，在其前lead时间开启提前开阀窗口，
+// 窗口持续到预测起点后 lead + 2倍平均绝对偏差；周期抖动（间隔与周期的平均绝对偏差）过大、
+// 观察的周期不足或上一个窗口落空时置信度不足，退回被动触发。
+class BreathPredictor {
+public:
+    BreathPredictor();
+
+    // 每次检测到吸气时调用，传入估计的吸气起点时刻
+    void onInspiration(unsigned long timestampUs);
+    // 每个控制节拍调用，返回true表示处于提前开阀窗口（尚未检测到本次吸气）
+    bool shouldPreActuate(unsigned long timestampUs);
+
+    void setLeadMs(uint16_t ms) { _leadMs = ms; }
+    uint16_t getLeadMs() const { return _leadMs; }
+
+    bool isConfident() const;
+    float periodMs() const { return _periodMs; }
+    float jitterRatio() const { return _periodMs > 0 ? _deviationMs / _periodMs : 1; }
+    unsigned long predictedOnsetUs() const { return _lastOnsetUs + (unsigned long)(_periodMs * 1000); }
+    PredictionStats getStats() const { return _stats; }
+    void resetStats();
+    void reset();
+
+private:
+    uint16_t _leadMs;
+    bool _hasOnset;
+    unsigned long _lastOnsetUs;
+    float _periodMs;
+    float _deviationMs;
+    uint8_t _intervals;
+    bool _missedLast;
+
+    bool _windowOpen;
+    bool _windowDone;           // 本周期的窗口已开启过
+    unsigned long _windowStartUs;
+    PredictionStats _stats;
+    double _leadSumMs;
+    double _errorSumMs;
+};
+
+#endif
@@ -0,0 +1,368 @@
+#include "ConnectionManager.h"
+
+#include <errno.h>
+#include <string.h>
+#include <lwip/sockets.h>
+
+ConnectionManager::ConnectionManager()
+    : _ssid(nullptr), _password(nullptr), _host(nullptr), _port(0), _serverEnabled(true),
+      _state(CONN_IDLE), _wifiUp(false), _stateSinceMs(0), _deadlineMs(0), _wifiBackoffMs(0), _serverBackoffMs(0),
+      _hasAddress(false), _address(0), _dnsPending(false), _dnsDone(false), _dnsOk(false), _dnsAddress(0), _fd(-1), _pendingLength(0), _pendingOffset(0), _stats() {
+}
+
+ConnectionManager::~ConnectionManager() {
+    closeSocket();
+}
+
+const char* ConnectionManager::stateName(ConnectionState state) {
+    switch (state) {
+        case CONN_IDLE: return "未配置";
+        case CONN_WIFI_JOINING: return "WiFi连接中";
+        case CONN_WIFI_BACKOFF: return "WiFi退避";
+        case CONN_SERVER_RESOLVING: return "解析服务器地址";
+        case CONN_SERVER_CONNECTING: return "服务器连接中";
+        case CONN_SERVER_BACKOFF: return "服务器退避";
+        case CONN_CONNECTED: return "已连接";
+    }
+    return "?";
+}
+
+void ConnectionManager::begin(const char* ssid, const char* password, const char* host, uint16_t port) {
+    _ssid = ssid;
+    _password = password;
+    _host = host;
+    _port = port;
+    _hasAddress = false;
+    if (!_ssid || !_password) {
+        enter(CONN_IDLE);
+        return;
+    }
+    startJoin();
+}
+
+void ConnectionManager::setServerEnabled(bool enable) {
+    _serverEnabled = enable;
+    if (!enable) {
+        closeSocket();
+        if (_wifiUp && (_state == CONN_SERVER_RESOLVING || _state == CONN_SERVER_CONNECTING || _state == CONN_SERVER_BACKOFF)) {
+            enter(CONN_CONNECTED);
+        }
+    }
+}
+
+void ConnectionManager::enter(ConnectionState state) {
+    if (state != _state) _stats.stateChanges++;
+    _state = state;
+    _stateSinceMs = millis();
+}
+
+uint32_t ConnectionManager::nextBackoff(uint32_t& backoff, uint32_t minMs, uint32_t maxMs) {
+    backoff = backoff ? backoff * 2 : minMs;
+    if (backoff > maxMs) backoff = maxMs;
+    _stats.backoffMs = backoff;
+    return backoff;
+}
+
+void ConnectionManager::recordStepTime(unsigned long startUs) {
+    uint32_t us = micros() - startUs;
+    if (us > _stats.maxStepUs) _stats.maxStepUs = us;
+}
+
+void ConnectionManager::startJoin() {
+    _stats.wifiJoinAttempts++;
+    Serial.print("正在连接到: ");
+    Serial.println(_ssid);
+    WiFi.begin(_ssid, _password);
+    _deadlineMs = millis() + WIFI_JOIN_TIMEOUT_MS;
+    enter(CONN_WIFI_JOINING);
+}
+
+void ConnectionManager::step() {
+    if (_state == CONN_IDLE) return;
+    unsigned long startUs = micros();
+    unsigned long now = millis();
+    bool linkUp = WiFi.status() == WL_CONNECTED;
+
+    switch (_state) {
+        case CONN_WIFI_JOINING:
+            if (linkUp) {
+                _wifiUp = true;
+                _wifiBackoffMs = 0;
+                _stats.wifiJoins++;
+                Serial.print("WiFi已连接! IP地址: ");
+                Serial.println(WiFi.localIP());
+                if (_serverEnabled && _host && _port) startConnect();
+                else enter(CONN_CONNECTED);
+            } else if ((long)(now - _deadlineMs) >= 0) {
+                WiFi.disconnect();
+                _deadlineMs = now + nextBackoff(_wifiBackoffMs, WIFI_BACKOFF_MIN_MS, WIFI_BACKOFF_MAX_MS);
+                enter(CONN_WIFI_BACKOFF);
+                Serial.print("WiFi连接失败，重试间隔(ms): ");
+                Serial.println(_wifiBackoffMs);
+            }
+            break;
+        case CONN_WIFI_BACKOFF:
+            if ((long)(now - _deadlineMs) >= 0) startJoin();
+            break;
+        default:
+            // 以下状态都需要WiFi
+            if (!linkUp) {
+                wifiLost();
+            } else if (_state == CONN_SERVER_RESOLVING) {
+                ResolveResult r = resolve();
+                if (r == RESOLVE_DONE) {
+                    openSocket();
+                } else if (r == RESOLVE_FAILED || (long)(now - _deadlineMs) >= 0) {
+                    Serial.print("无法解析服务器地址: ");
+                    Serial.println(_host);
+                    serverFailed(false);
+                }
+            } else if (_state == CONN_SERVER_CONNECTING) {
+                checkConnect();
+            } else if (_state == CONN_SERVER_BACKOFF) {
+                if (!_serverEnabled) enter(CONN_CONNECTED);
+                else if ((long)(now - _deadlineMs) >= 0) startConnect();
+            } else if (_serverEnabled && _host && _port) {
+                if (_fd < 0) startConnect();
+                else if (flushPending()) checkConnected();
+            }
+            break;
+    }
+    recordStepTime(startUs);
+}
+
+void ConnectionManager::wifiLost() {
+    closeSocket();
+    if (_wifiUp) {
+        _stats.wifiLosses++;
+        Serial.println("WiFi连接断开");
+    }
+    _wifiUp = false;
+    _hasAddress = false;
+    startJoin();
+}
+
+// 回调在tcpip线程中执行：只写结果，由step()取走
+void ConnectionManager::dnsFound(const char* name, const ip_addr_t* ipaddr, void* arg) {
+    (void)name;
+    ConnectionManager* c = static_cast<ConnectionManager*>(arg);
+    c->_dnsOk = ipaddr != nullptr;
+    if (ipaddr) c->_dnsAddress = ip4_addr_get_u32(ip_2_ip4(ipaddr));
+    c->_dnsDone.store(true, std::memory_order_release);
+}
+
+// 同一时刻只有一个查询在进行；查询失败后下次调用重新发起
+ConnectionManager::ResolveResult ConnectionManager::resolve() {
+    if (_hasAddress) return RESOLVE_DONE;
+    if (!_host) return RESOLVE_FAILED;
+    if (_dnsPending) {
+        if (!_dnsDone.load(std::memory_order_acquire)) return RESOLVE_PENDING;
+        _dnsPending = false;
+        _dnsDone.store(false, std::memory_order_relaxed);
+        if (!_dnsOk) return RESOLVE_FAILED;
+        _address = _dnsAddress;
+        _hasAddress = true;
+        return RESOLVE_DONE;
+    }
+    ip_addr_t ip;
+    err_t err = dns_gethostbyname(_host, &ip, dnsFound, this);
+    if (err == ERR_OK) {
+        // IP字面量或DNS缓存命中
+        _address = ip4_addr_get_u32(ip_2_ip4(&ip));
+        _hasAddress = true;
+        return RESOLVE_DONE;
+    }
+    if (err != ERR_INPROGRESS) return RESOLVE_FAILED;
+    _dnsPending = true;
+    return RESOLVE_PENDING;
+}
+
+bool ConnectionManager::serverAddress(uint32_t& address) {
+    if (resolve() != RESOLVE_DONE) return false;
+    address = _address;
+    return true;
+}
+
+void ConnectionManager::startConnect() {
+    closeSocket();
+    _stats.serverAttempts++;
+
+    ResolveResult r = resolve();
+    if (r == RESOLVE_PENDING) {
+        _deadlineMs = millis() + DNS_RESOLVE_TIMEOUT_MS;
+        enter(CONN_SERVER_RESOLVING);
+    } else if (r == RESOLVE_FAILED) {
+        Serial.print("无法解析服务器地址: ");
+        Serial.println(_host);
+        serverFailed(false);
+    } else {
+        openSocket();
+    }
+}
+
+void ConnectionManager::openSocket() {
+    _fd = lwip_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (_fd < 0) {
+        serverFailed(false);
+        return;
+    }
+    int flags = lwip_fcntl(_fd, F_GETFL, 0);
+    lwip_fcntl(_fd, F_SETFL, flags | O_NONBLOCK);
+    int one = 1;
+    lwip_setsockopt(_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(_port);
+    addr.sin_addr.s_addr = _address;
+
+    Serial.print("正在连接到服务器: ");
+    Serial.print(_host);
+    Serial.print(":");
+    Serial.println(_port);
+
+    _deadlineMs = millis() + SERVER_CONNECT_TIMEOUT_MS;
+    enter(CONN_SERVER_CONNECTING);
+    if (lwip_connect(_fd, (struct sockaddr*)&addr, sizeof(addr)) == 0) {
+        checkConnect();
+    } else if (errno != EINPROGRESS) {
+        serverFailed(false);
+    }
+}
+
+// 零超时select查询握手结果
+void ConnectionManager::checkConnect() {
+    fd_set writeSet;
+    FD_ZERO(&writeSet);
+    FD_SET(_fd, &writeSet);
+    struct timeval tv = {0, 0};
+    int rc = lwip_select(_fd + 1, nullptr, &writeSet, nullptr, &tv);
+    if (rc > 0) {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        lwip_getsockopt(_fd, SOL_SOCKET, SO_ERROR, &err, &len);
+        if (err != 0) {
+            serverFailed(false);
+            return;
+        }
+        _stats.serverConnects++;
+        _serverBackoffMs = 0;
+        _pendingLength = _pendingOffset = 0;
+        enter(CONN_CONNECTED);
+        Serial.println("服务器连接成功!");
+    } else if (rc < 0 || (long)(millis() - _deadlineMs) >= 0) {
+        serverFailed(false);
+    }
+}
+
+// 对端关闭或连接出错：非阻塞窥视一个字节
+void ConnectionManager::checkConnected() {
+    uint8_t probe;
+    int n = lwip_recv(_fd, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+        serverFailed(true);
+    }
+}
+
+void ConnectionManager::serverFailed(bool wasConnected) {
+    closeSocket();
+    if (wasConnected) _stats.serverDisconnects++;
+    else _stats.serverFailures++;
+    _deadlineMs = millis() + nextBackoff(_serverBackoffMs, SERVER_BACKOFF_MIN_MS, SERVER_BACKOFF_MAX_MS);
+    enter(CONN_SERVER_BACKOFF);
+    Serial.print(wasConnected ? "服务器连接断开" : "服务器连接失败");
+    Serial.print("，重试间隔(ms): ");
+    Serial.println(_serverBackoffMs);
+}
+
+void ConnectionManager::closeSocket() {
+    if (_fd >= 0) {
+        lwip_close(_fd);
+        _fd = -1;
+    }
+    _pendingLength = _pendingOffset = 0;
+}
+
+// 发送上次剩余的字节，全部发完返回true
+bool ConnectionManager::flushPending() {
+    while (_pendingOffset < _pendingLength) {
+        int n = lwip_send(_fd, _pending + _pendingOffset, _pendingLength - _pendingOffset, MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return false;
+            serverFailed(true);
+            return false;
+        }
+        _pendingOffset += n;
+        _stats.bytesSent += n;
+    }
+    _pendingLength = _pendingOffset = 0;
+    return true;
+}
+
+// 整块接受或整块拒绝：内核缓冲区只收下一部分时剩余字节留到下次发送，
+// 帧/行不会被截断；剩余字节未发完时拒绝新数据
+bool ConnectionManager::send(const uint8_t* data, size_t len) {
+    if (!isConnected()) return false;
+    unsigned long startUs = micros();
+    if (len > CONNECTION_TX_BUFFER || !flushPending()) {
+        if (isConnected()) _stats.sendRejected++;
+        recordStepTime(startUs);
+        return false;
+    }
+    int n = lwip_send(_fd, data, len, MSG_DONTWAIT);
+    if (n < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            serverFailed(true);
+            recordStepTime(startUs);
+            return false;
+        }
+        n = 0;
+    }
+    _stats.bytesSent += n;
+    if ((size_t)n < len) {
+        memcpy(_pending, data + n, len - n);
+        _pendingLength = len - n;
+        _pendingOffset = 0;
+    }
+    recordStepTime(startUs);
+    return true;
+}
+
+ConnectionStats ConnectionManager::getStats() const {
+    ConnectionStats s = _stats;
+    s.state = _state;
+    s.connectedMs = _state == CONN_CONNECTED ? millis() - _stateSinceMs : 0;
+    return s;
+}
+
+void ConnectionManager::printStats() const {
+    ConnectionStats s = getStats();
+    Serial.println("=== 连接统计 ===");
+    Serial.print("状态: ");
+    Serial.print(stateName(s.state));
+    Serial.print(", 已持续(ms): ");
+    Serial.println(s.connectedMs);
+    Serial.print("WiFi: 尝试 ");
+    Serial.print(s.wifiJoinAttempts);
+    Serial.print(", 成功 ");
+    Serial.print(s.wifiJoins);
+    Serial.print(", 断开 ");
+    Serial.println(s.wifiLosses);
+    Serial.print("服务器: 尝试 ");
+    Serial.print(s.serverAttempts);
+    Serial.print(", 成功 ");
+    Serial.print(s.serverConnects);
+    Serial.print(", 失败 ");
+    Serial.print(s.serverFailures);
+    Serial.print(", 断开 ");
+    Serial.print(s.serverDisconnects);
+    Serial.print(", 退避(ms) ");
+    Serial.println(s.backoffMs);
+    Serial.print("发送字节: ");
+    Serial.print(s.bytesSent);
+    Serial.print(", 拒绝: ");
+    Serial.print(s.sendRejected);
+    Serial.print(", 单次最长(us): ");
+    Serial.println(s.maxStepUs);
+}
@@ -0,0 +1,118 @@
+#ifndef ConnectionManager_h
+#define ConnectionManager_h
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <atomic>
+#include <lwip/dns.h>
+
+// 连接管理配置
+constexpr uint32_t WIFI_JOIN_TIMEOUT_MS = 15000;       // 单次关联超时（与原阻塞等待相同）
+constexpr uint32_t WIFI_BACKOFF_MIN_MS = 1000;
+constexpr uint32_t WIFI_BACKOFF_MAX_MS = 60000;
+constexpr uint32_t SERVER_CONNECT_TIMEOUT_MS = 5000;   // TCP握手超时（与原client.setTimeout相同）
+constexpr uint32_t DNS_RESOLVE_TIMEOUT_MS = 10000;     // 等待异步DNS结果的上限（lwIP自身超时后也会回调）
+constexpr uint32_t SERVER_BACKOFF_MIN_MS = 500;
+constexpr uint32_t SERVER_BACKOFF_MAX_MS = 30000;
+constexpr size_t CONNECTION_TX_BUFFER = 2048;          // 部分写出后的剩余字节（大于最大遥测帧）
+
+enum ConnectionState {
+    CONN_IDLE,              // 未配置
+    CONN_WIFI_JOINING,      // WiFi.begin()之后等待关联
+    CONN_WIFI_BACKOFF,      // 关联失败，退避等待
+    CONN_SERVER_RESOLVING,  // 异步DNS查询服务器主机名
+    CONN_SERVER_CONNECTING, // 非阻塞connect()进行中
+    CONN_SERVER_BACKOFF,    // 连接失败或断开，退避等待
+    CONN_CONNECTED,         // WiFi和服务器均已连接（不需要服务器时WiFi已连接即为此状态）
+};
+
+struct ConnectionStats {
+    ConnectionState state;
+    uint32_t wifiJoinAttempts;
+    uint32_t wifiJoins;
+    uint32_t wifiLosses;        // 已连接后WiFi断开
+    uint32_t serverAttempts;
+    uint32_t serverConnects;
+    uint32_t serverFailures;    // 拒绝、超时或出错
+    uint32_t serverDisconnects; // 已连接后断开（对端关闭或写出错）
+    uint32_t backoffMs;         // 当前（或最近一次）退避时间
+    uint32_t bytesSent;
+    uint32_t sendRejected;      // 上一次写出的剩余字节未发完，新数据被拒绝
+    uint32_t maxStepUs;         // step()/send()单次最长耗时
+    uint32_t connectedMs;       // 当前连接已持续时间
+    uint32_t stateChanges;
+};
+
+// 事件驱动的WiFi/服务器连接状态机：step()只检查状态和超时，connect()以非阻塞方式发起，
+// 之后每次step()用零超时的select()查询结果；失败按指数退避重试。send()使用非阻塞套接字，
+// 内核缓冲区满时保留剩余字节在下次step()继续发送，不会阻塞调用者。
+// 服务器主机名在每次WiFi连接后用lwIP的dns_gethostbyname()异步解析一次，结果由回调（tcpip线程）
+// 交回，step()轮询；IP字面量直接转换。
+class ConnectionManager {
+public:
+    ConnectionManager();
+    ~ConnectionManager();
+
+    void begin(const char* ssid, const char* password, const char* host, uint16_t port);
+    // 是否需要TCP服务器连接（UDP遥测只需要WiFi）
+    void setServerEnabled(bool enable);
+
+    void step();
+    bool send(const uint8_t* data, size_t len);
+
+    bool isWifiUp() const { return _wifiUp; }
+    bool isConnected() const { return _state == CONN_CONNECTED && _fd >= 0; }
+    // 上一次写出后留在发送缓冲中的字节（链路跟不上时增长，自适应遥测据此判断拥塞）
+    size_t pendingBytes() const { return _pendingLength - _pendingOffset; }
+    ConnectionState state() const { return _state; }
+    ConnectionStats getStats() const;
+    void printStats() const;
+    static const char* stateName(ConnectionState state);
+    // 已解析的服务器地址（网络字节序）；未解析时发起异步查询并返回false，不阻塞
+    bool serverAddress(uint32_t& address);
+
+private:
+    void enter(ConnectionState state);
+    void startJoin();
+    enum ResolveResult { RESOLVE_DONE, RESOLVE_PENDING, RESOLVE_FAILED };
+    ResolveResult resolve();
+    static void dnsFound(const char* name, const ip_addr_t* ipaddr, void* arg);
+    void startConnect();
+    void openSocket();
+    void checkConnect();
+    void checkConnected();
+    void closeSocket();
+    bool flushPending();
+    void wifiLost();
+    void serverFailed(bool wasConnected);
+    uint32_t nextBackoff(uint32_t& backoff, uint32_t minMs, uint32_t maxMs);
+    void recordStepTime(unsigned long startUs);
+
+    const char* _ssid;
+    const char* _password;
+    const char* _host;
+    uint16_t _port;
+    bool _serverEnabled;
+
+    ConnectionState _state;
+    bool _wifiUp;
+    unsigned long _stateSinceMs;
+    unsigned long _deadlineMs;      // 关联/握手超时或退避结束时刻
+    uint32_t _wifiBackoffMs;
+    uint32_t _serverBackoffMs;
+    bool _hasAddress;
+    uint32_t _address;              // 网络字节序IPv4地址
+    bool _dnsPending;               // 已发起查询，回调尚未被step()取走
+    std::atomic<bool> _dnsDone;     // 回调已写入结果（tcpip线程置位）
+    bool _dnsOk;
+    uint32_t _dnsAddress;
+    int _fd;
+
+    uint8_t _pending[CONNECTION_TX_BUFFER];
+    size_t _pendingLength;
+    size_t _pendingOffset;
+
+    ConnectionStats _stats;
+};
+
+#endif
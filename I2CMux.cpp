@@ -1,11 +1,13 @@
 #include "I2CMux.h"
 
 I2CMux::I2CMux(uint8_t address) 
-    : _address(address), _activeChannel(255), _channelCount(0) {
+    : _address(address), _activeChannel(255), _activeMask(0), _channelCount(0),
+      _groupSelect(true), _groupCount(0) {
     
     // 初始化通道配置
     for (int i = 0; i < MAX_MUX_CHANNELS; i++) {
         _channels[i] = {i, 0, "Unused", false};
+        _groupMask[i] = 1 << i;
     }
 }
 
@@ -31,6 +33,7 @@ void I2CMux::addChannel(uint8_t channel, uint8_t sensorAddr, const char* sensorN
         Serial.print(sensorAddr, HEX);
         Serial.print(", 名称: ");
         Serial.println(sensorName);
+        buildChannelGroups();
     }
 }
 
@@ -40,44 +43,122 @@ void I2CMux::enableChannel(uint8_t channel, bool enable) {
         Serial.print("通道 ");
         Serial.print(channel);
         Serial.println(enable ? " 已启用" : " 已禁用");
+        buildChannelGroups();
     }
 }
 
 bool I2CMux::selectChannel(uint8_t channel) {
     if (channel < MAX_MUX_CHANNELS && _channels[channel].enabled) {
-        // 如果已经是目标通道，直接返回成功
-        if (_activeChannel == channel) {
+        // 目标通道已经打开（单独或随所在组打开），直接返回成功
+        if (_activeMask & (1 << channel)) {
+            _activeChannel = channel;
             return true;
         }
         
-        // 先禁用所有通道，确保干净的状态
-        Wire.beginTransmission(_address);
-        Wire.write(0);
-        Wire.endTransmission();
-        delay(10); // 减少延迟时间，提高切换速度
-        
-        // 选择目标通道
-        Wire.beginTransmission(_address);
-        Wire.write(1 << channel); // 选择对应通道
-        uint8_t error = Wire.endTransmission();
-        if (error == 0) {
+        uint8_t mask = _groupSelect ? _groupMask[channel] : (uint8_t)(1 << channel);
+        if (writeMask(mask)) {
             _activeChannel = channel;
-            delay(20); // 减少延迟时间，提高切换速度
             return true;
-        } else {
-            Serial.print("选择多路复用器通道失败，错误代码: ");
-            Serial.println(error);
-            return false;
         }
     }
     return false;
 }
 
+bool I2CMux::selectChannelExclusive(uint8_t channel) {
+    if (channel < MAX_MUX_CHANNELS && _channels[channel].enabled) {
+        if (_activeMask == (1 << channel)) {
+            _activeChannel = channel;
+            return true;
+        }
+        if (writeMask(1 << channel)) {
+            _activeChannel = channel;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool I2CMux::writeMask(uint8_t mask) {
+    // 直接写入目标通道掩码（控制寄存器整体替换，无需先写0）
+    Wire.beginTransmission(_address);
+    Wire.write(mask);
+    uint8_t error = Wire.endTransmission();
+    if (error == 0) {
+        _activeMask = mask;
+        delayMicroseconds(TCA9548_SETTLE_US);
+        return true;
+    }
+    Serial.print("选择多路复用器通道失败，错误代码: ");
+    Serial.println(error);
+    return false;
+}
+
 void I2CMux::disableAllChannels() {
     Wire.beginTransmission(_address);
     Wire.write(0); // 禁用所有通道
     Wire.endTransmission();
     _activeChannel = 255; // 表示无活动通道
+    _activeMask = 0;
+}
+
+void I2CMux::setGroupSelect(bool enable) {
+    _groupSelect = enable;
+    Serial.print("多通道同时选通: ");
+    Serial.println(enable ? "启用" : "禁用");
+}
+
+uint8_t I2CMux::getGroupMask(uint8_t channel) const {
+    if (channel < MAX_MUX_CHANNELS) {
+        return _groupSelect ? _groupMask[channel] : (uint8_t)(1 << channel);
+    }
+    return 0;
+}
+
+void I2CMux::buildChannelGroups() {
+    // 按通道号依次放入第一个没有地址冲突的组（首次适应）。
+    // 未配置地址或与多路复用器自身地址相同的通道单独成组。
+    uint8_t groups[MAX_MUX_CHANNELS];
+    uint8_t count = 0;
+    
+    for (uint8_t i = 0; i < MAX_MUX_CHANNELS; i++) {
+        _groupMask[i] = 1 << i;
+        if (!_channels[i].enabled) continue;
+        
+        uint8_t addr = _channels[i].sensorAddr;
+        bool isolated = (addr == 0 || addr == _address);
+        int8_t target = -1;
+        for (uint8_t g = 0; g < count && !isolated; g++) {
+            bool conflict = false;
+            for (uint8_t j = 0; j < MAX_MUX_CHANNELS; j++) {
+                if (!(groups[g] & (1 << j))) continue;
+                uint8_t other = _channels[j].sensorAddr;
+                if (other == addr || other == 0 || other == _address) {
+                    conflict = true;
+                    break;
+                }
+            }
+            if (!conflict) {
+                target = g;
+                break;
+            }
+        }
+        if (target < 0) {
+            target = count++;
+            groups[target] = 0;
+        }
+        groups[target] |= 1 << i;
+    }
+    
+    for (uint8_t g = 0; g < count; g++) {
+        for (uint8_t i = 0; i < MAX_MUX_CHANNELS; i++) {
+            if (groups[g] & (1 << i)) _groupMask[i] = groups[g];
+        }
+    }
+    _groupCount = count;
+    
+    // 表变化后当前打开的掩码可能已不满足分组，强制下次重新写入
+    _activeMask = 0;
+    _activeChannel = 255;
 }
 
 MuxChannelConfig I2CMux::getChannelConfig(uint8_t channel) const {
@@ -104,7 +185,12 @@ void I2CMux::printChannelInfo() {
         Serial.print(" (0x");
         Serial.print(_channels[i].sensorAddr, HEX);
         Serial.print(") - ");
-        Serial.println(_channels[i].enabled ? "启用" : "禁用");
+        Serial.print(_channels[i].enabled ? "启用" : "禁用");
+        if (_channels[i].enabled && _groupSelect) {
+            Serial.print(", 组掩码: 0x");
+            Serial.print(_groupMask[i], HEX);
+        }
+        Serial.println();
     }
     Serial.println("============================");
 }
@@ -148,8 +234,8 @@ void I2CMux::scanI2CDevices() {
             Serial.print(_channels[channel].sensorName);
             Serial.print("): ");
             
-            // 选择通道
-            if (selectChannel(channel)) {
+            // 单独选择通道，确认设备确实挂在该通道上
+            if (selectChannelExclusive(channel)) {
                 // 扫描该通道上的设备
                 Wire.beginTransmission(_channels[channel].sensorAddr);
                 error = Wire.endTransmission();
@@ -7,6 +7,9 @@
 // I2C 多路复用器配置
 constexpr uint8_t TCA9548_BASE_ADDR = 0x70;     // TCA9548 基础地址 (A0,A1,A2接地)
 constexpr uint8_t MAX_MUX_CHANNELS = 8;         // TCA9548 最大通道数
+// 通道切换在控制字节写入后的STOP处生效，之后只需满足总线空闲时间t_BUF
+// （标准模式4.7us，快速模式1.3us），取标准模式值向上取整
+constexpr uint32_t TCA9548_SETTLE_US = 5;
 
 // I2C 多路复用器通道配置结构体
 struct MuxChannelConfig {
@@ -27,10 +30,19 @@ public:
     void addChannel(uint8_t channel, uint8_t sensorAddr, const char* sensorName = "Unknown");
     void enableChannel(uint8_t channel, bool enable);
     bool selectChannel(uint8_t channel);
+    bool selectChannelExclusive(uint8_t channel);   // 只打开单个通道（诊断扫描用）
     void disableAllChannels();
     
+    // 多通道同时选通：地址互不冲突的通道归为一组，选中任一通道即打开整组
+    void setGroupSelect(bool enable);
+    bool isGroupSelectEnabled() const { return _groupSelect; }
+    uint8_t getGroupMask(uint8_t channel) const;
+    uint8_t getGroupCount() const { return _groupCount; }
+    
     // 获取信息
     uint8_t getActiveChannel() const { return _activeChannel; }
+    uint8_t getActiveMask() const { return _activeMask; }
+    bool isChannelSelected(uint8_t channel) const { return channel < MAX_MUX_CHANNELS && (_activeMask & (1 << channel)); }
     uint8_t getChannelCount() const { return _channelCount; }
     MuxChannelConfig getChannelConfig(uint8_t channel) const;
     bool isChannelEnabled(uint8_t channel) const;
@@ -50,7 +62,14 @@ private:
     uint8_t _address;
     MuxChannelConfig _channels[MAX_MUX_CHANNELS];
     uint8_t _activeChannel;
+    uint8_t _activeMask;                        // 当前写入控制寄存器的通道掩码
     uint8_t _channelCount;
+    bool _groupSelect;
+    uint8_t _groupMask[MAX_MUX_CHANNELS];       // 每个通道所在地址组的通道掩码
+    uint8_t _groupCount;
+    
+    bool writeMask(uint8_t mask);
+    void buildChannelGroups();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include "I2CScheduler.h"
+
+I2CScheduler::I2CScheduler(I2CMux* mux)
+    : _mux(mux), _idleHook(nullptr), _idleContext(nullptr), _deviceCount(0), _pendingCount(0), _selectCount(0), _runCount(0) {}
+
+int8_t I2CScheduler::registerDevice(uint8_t channel, const char* name) {
+    if (_deviceCount >= MAX_SCHED_DEVICES || channel >= MAX_MUX_CHANNELS) {
+        return -1;
+    }
+    _devices[_deviceCount] = {channel, name, 0, 0, 0, micros(), 0.0f};
+    return (int8_t)_deviceCount++;
+}
+
+bool I2CScheduler::submit(int8_t deviceId, I2CTransaction fn, void* context) {
+    if (deviceId < 0 || deviceId >= _deviceCount || fn == nullptr) {
+        return false;
+    }
+    if (_pendingCount >= MAX_SCHED_PENDING) {
+        Serial.println("总线调度队列已满，丢弃事务");
+        return false;
+    }
+    _pending[_pendingCount++] = {deviceId, fn, context};
+    return true;
+}
+
+uint8_t I2CScheduler::run() {
+    if (_pendingCount == 0) return 0;
+    _runCount++;
+
+    // 取出本轮事务；执行期间新提交的事务留到下一轮
+    Pending batch[MAX_SCHED_PENDING];
+    uint8_t count = _pendingCount;
+    for (uint8_t i = 0; i < count; i++) batch[i] = _pending[i];
+    _pendingCount = 0;
+
+    // 通道顺序：已打开的通道（当前通道或其所在地址组）优先，其余按通道号
+    uint8_t order[MAX_MUX_CHANNELS];
+    uint8_t orderCount = 0;
+    for (uint8_t ch = 0; ch < MAX_MUX_CHANNELS; ch++) {
+        if (_mux && _mux->isChannelSelected(ch)) order[orderCount++] = ch;
+    }
+    for (uint8_t ch = 0; ch < MAX_MUX_CHANNELS; ch++) {
+        if (!_mux || !_mux->isChannelSelected(ch)) order[orderCount++] = ch;
+    }
+
+    uint8_t selections = 0;
+    for (uint8_t o = 0; o < orderCount; o++) {
+        uint8_t ch = order[o];
+        for (uint8_t i = 0; i < count; i++) {
+            Device& dev = _devices[batch[i].deviceId];
+            if (dev.channel != ch) continue;
+
+            // 回调内部可能切换过通道（如诊断扫描），每个事务前确认一次
+            if (_mux && !_mux->isChannelSelected(ch)) {
+                if (!_mux->selectChannel(ch)) {
+                    recordResult(dev, false);
+                    continue;
+                }
+                selections++;
+                _selectCount++;
+            } else if (_mux) {
+                _mux->selectChannel(ch);  // 已打开，仅更新当前通道
+            }
+            recordResult(dev, batch[i].fn(batch[i].context, ch));
+            if (_idleHook) _idleHook(_idleContext);
+        }
+    }
+    return selections;
+}
+
+void I2CScheduler::recordResult(Device& dev, bool ok) {
+    if (!ok) {
+        dev.failed++;
+        return;
+    }
+    dev.completed++;
+    dev.windowCount++;
+
+    unsigned long now = micros();
+    unsigned long elapsed = now - dev.windowStart;
+    if (elapsed >= RATE_WINDOW_US) {
+        dev.sampleRate = dev.windowCount * 1000000.0f / elapsed;
+        dev.windowCount = 0;
+        dev.windowStart = now;
+    }
+}
+
+SchedDeviceStats I2CScheduler::getDeviceStats(int8_t deviceId) const {
+    if (deviceId < 0 || deviceId >= _deviceCount) {
+        return {"Invalid", 0, 0, 0, 0.0f};
+    }
+    const Device& dev = _devices[deviceId];
+    return {dev.name, dev.channel, dev.completed, dev.failed, dev.sampleRate};
+}
+
+float I2CScheduler::getSampleRate(int8_t deviceId) const {
+    if (deviceId < 0 || deviceId >= _deviceCount) return 0.0f;
+    return _devices[deviceId].sampleRate;
+}
+
+void I2CScheduler::printStats() {
+    Serial.println("=== 总线调度统计 ===");
+    Serial.print("调度轮数: ");
+    Serial.print(_runCount);
+    Serial.print(", 通道切换: ");
+    Serial.println(_selectCount);
+    for (uint8_t i = 0; i < _deviceCount; i++) {
+        Serial.print("通道 ");
+        Serial.print(_devices[i].channel);
+        Serial.print(" ");
+        Serial.print(_devices[i].name);
+        Serial.print(": ");
+        Serial.print(_devices[i].sampleRate, 2);
+        Serial.print(" Hz, 成功 ");
+        Serial.print(_devices[i].completed);
+        Serial.print(", 失败 ");
+        Serial.println(_devices[i].failed);
+    }
+    Serial.println("====================");
+}
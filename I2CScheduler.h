@@ -0,0 +1,83 @@
+#ifndef I2CScheduler_h
+#define I2CScheduler_h
+
+#include <Arduino.h>
+#include "I2CMux.h"
+
+// 总线调度配置
+constexpr uint8_t MAX_SCHED_DEVICES = 8;        // 最多注册的设备数
+constexpr uint8_t MAX_SCHED_PENDING = 16;       // 每轮最多排队的事务数
+constexpr unsigned long RATE_WINDOW_US = 1000000; // 采样率统计窗口(1s)
+
+// 事务回调：在目标通道已选中时调用，返回是否成功
+typedef bool (*I2CTransaction)(void* context, uint8_t channel);
+
+// 空闲钩子：每个事务执行完后调用（如插入定时采样）
+typedef void (*I2CIdleHook)(void* context);
+
+// 单个设备的调度统计
+struct SchedDeviceStats {
+    const char* name;       // 设备名称
+    uint8_t channel;        // 所在多路复用器通道
+    uint32_t completed;     // 成功事务数
+    uint32_t failed;        // 失败事务数
+    float sampleRate;       // 最近一个统计窗口的实际采样率(Hz)
+};
+
+// 按通道亲和性调度I2C事务：同一通道的待处理事务集中在一次选通窗口内执行，
+// 并优先处理当前已选通的通道，避免多路复用器来回切换。
+class I2CScheduler {
+public:
+    I2CScheduler(I2CMux* mux = nullptr);
+
+    void setMux(I2CMux* mux) { _mux = mux; }
+    void setIdleHook(I2CIdleHook hook, void* context) { _idleHook = hook; _idleContext = context; }
+
+    // 注册设备，返回设备ID（失败返回-1）
+    int8_t registerDevice(uint8_t channel, const char* name);
+
+    // 提交事务，在下一次run()时执行
+    bool submit(int8_t deviceId, I2CTransaction fn, void* context);
+
+    // 执行所有待处理事务，返回本轮通道选通次数
+    uint8_t run();
+
+    // 统计信息
+    uint8_t getDeviceCount() const { return _deviceCount; }
+    SchedDeviceStats getDeviceStats(int8_t deviceId) const;
+    float getSampleRate(int8_t deviceId) const;
+    uint32_t getSelectCount() const { return _selectCount; }
+    uint32_t getRunCount() const { return _runCount; }
+    void printStats();
+
+private:
+    struct Device {
+        uint8_t channel;
+        const char* name;
+        uint32_t completed;
+        uint32_t failed;
+        uint32_t windowCount;
+        unsigned long windowStart;
+        float sampleRate;
+    };
+
+    struct Pending {
+        int8_t deviceId;
+        I2CTransaction fn;
+        void* context;
+    };
+
+    I2CMux* _mux;
+    I2CIdleHook _idleHook;
+    void* _idleContext;
+    Device _devices[MAX_SCHED_DEVICES];
+    uint8_t _deviceCount;
+    Pending _pending[MAX_SCHED_PENDING];
+    uint8_t _pendingCount;
+    uint32_t _selectCount;
+    uint32_t _runCount;
+
+    void recordResult(Device& dev, bool ok);
+};
+
+#endif
@@ -0,0 +1,95 @@
+#include "LungMechanics.h"
+
+LungMechanicsEstimator::LungMechanicsEstimator() : _memoryS(RLS_MEMORY_S) {
+    reset();
+}
+
+void LungMechanicsEstimator::reset() {
+    for (int i = 0; i < 2; i++) {
+        _theta[i] = 0;
+        for (int j = 0; j < 2; j++) {
+            _p[i][j] = i == j ? RLS_INITIAL_COVARIANCE : 0;
+        }
+    }
+    _residualSq = 0;
+    memset(&_estimate, 0, sizeof(_estimate));
+    _estimate.resistanceCmH2O = NAN;
+    _estimate.complianceMlCmH2O = NAN;
+    _estimate.elastanceKpaPerL = NAN;
+    _estimate.offsetKpa = NAN;
+    _estimate.timeConstantMs = NAN;
+    _inInspiration = false;
+    _volumeValid = false;
+    _lastUs = 0;
+    _lastFlowLps = 0;
+    _volumeL = 0;
+    _startPressureKpa = 0;
+}
+
+bool LungMechanicsEstimator::update(unsigned long timestampUs, BreathState state, float pressureKpa, float flowMlMin) {
+    if (!isInspiration(state)) {
+        _inInspiration = false;
+        _startPressureKpa = pressureKpa;
+        return false;
+    }
+    float flowLps = flowMlMin / 60000.0f;
+    float dt = 0;
+    if (!_inInspiration) {
+        // 吸气开始：容积从0积分，P0取吸气开始前最后一个样本的压力
+        _inInspiration = true;
+        _volumeValid = !isnan(flowLps);
+        _volumeL = 0;
+        _estimate.offsetKpa = _startPressureKpa;
+    } else if (_volumeValid) {
+        dt = (uint32_t)(timestampUs - _lastUs) / 1e6f;
+        if (isnan(flowLps) || dt > RLS_MAX_DT_S) {
+            _volumeValid = false;
+        } else {
+            _volumeL += 0.5f * (flowLps + _lastFlowLps) * dt;
+        }
+    }
+    _lastUs = timestampUs;
+    _lastFlowLps = flowLps;
+    if (!_volumeValid) return false;
+
+    // RLS：k = Pφ/(λ + φᵀPφ)，θ += k·e，P = (P - k·(Pφ)ᵀ)/λ
+    float lambda = _memoryS > 0 ? 1.0f - dt / _memoryS : 1.0f;
+    if (lambda < RLS_MIN_FORGETTING) lambda = RLS_MIN_FORGETTING;
+    const float phi[2] = {flowLps, _volumeL};
+    float pphi[2];
+    float denom = lambda;
+    for (int i = 0; i < 2; i++) {
+        pphi[i] = _p[i][0] * phi[0] + _p[i][1] * phi[1];
+        denom += phi[i] * pphi[i];
+    }
+    float error = pressureKpa - _estimate.offsetKpa - (_theta[0] * phi[0] + _theta[1] * phi[1]);
+    for (int i = 0; i < 2; i++) {
+        _theta[i] += pphi[i] / denom * error;
+    }
+    // 激励不足时协方差会按1/λ增长，迹过大则暂停遗忘
+    float scale = _p[0][0] + _p[1][1] < RLS_MAX_TRACE ? 1.0f / lambda : 1.0f;
+    _p[0][0] = (_p[0][0] - pphi[0] * pphi[0] / denom) * scale;
+    _p[1][1] = (_p[1][1] - pphi[1] * pphi[1] / denom) * scale;
+    _p[0][1] = (_p[0][1] - pphi[0] * pphi[1] / denom) * scale;
+    _p[1][0] = _p[0][1];   // 保持对称，抑制舍入误差累积
+
+    _residualSq += RLS_RESIDUAL_ALPHA * (error * error - _residualSq);
+    _estimate.samples++;
+    refreshEstimate();
+    return true;
+}
+
+void LungMechanicsEstimator::refreshEstimate() {
+    float r = _theta[0] * KPA_TO_CMH2O;
+    float e = _theta[1];
+    float c = e > 0 ? 1000.0f / (e * KPA_TO_CMH2O) : NAN;
+    _estimate.resistanceCmH2O = r;
+    _estimate.elastanceKpaPerL = e;
+    _estimate.complianceMlCmH2O = c;
+    _estimate.residualRmsKpa = sqrtf(_residualSq);
+    // τ = R·C：cmH2O·s/L × ml/cmH2O = ms
+    _estimate.timeConstantMs = r * c;
+    _estimate.valid = _estimate.samples >= RLS_MIN_SAMPLES &&
+                      c >= LUNG_MIN_COMPLIANCE && c <= LUNG_MAX_COMPLIANCE &&
+                      r >= LUNG_MIN_RESISTANCE && r <= LUNG_MAX_RESISTANCE;
+}
@@ -0,0 +1,76 @@
+#ifndef LungMechanics_h
+#define LungMechanics_h
+
+#include <Arduino.h>
+#include "BreathAnalyzer.h"
+
+// 单室肺模型 P = P0 + R·Q + E·V 的递推最小二乘(RLS)估计配置
+constexpr float KPA_TO_CMH2O = 10.1972;
+constexpr float RLS_MEMORY_S = 8.0;             // 遗忘时间常数（按吸气段时间计，约8次呼吸），与流量采样率无关
+constexpr float RLS_MIN_FORGETTING = 0.9;       // 单个样本的遗忘因子下限
+constexpr float RLS_INITIAL_COVARIANCE = 1e4;   // 初始协方差对角元
+constexpr float RLS_MAX_TRACE = 1e5;            // 协方差迹超过此值时暂停遗忘，防止激励不足时发散
+constexpr uint32_t RLS_MIN_SAMPLES = 20;        // 至少更新这么多次才输出有效估计
+constexpr float RLS_MAX_DT_S = 0.5;             // 流量样本间隔超过此值时本次吸气不再积分容积
+constexpr float RLS_RESIDUAL_ALPHA = 0.05;      // 残差均方的EWMA系数
+
+// 生理范围：超出视为估计无效（模型失配或激励不足）
+constexpr float LUNG_MIN_COMPLIANCE = 5.0;      // ml/cmH2O
+constexpr float LUNG_MAX_COMPLIANCE = 200.0;
+constexpr float LUNG_MIN_RESISTANCE = 0.5;      // cmH2O/(L/s)
+constexpr float LUNG_MAX_RESISTANCE = 100.0;
+
+// 当前的肺力学估计
+struct LungMechanics {
+    float resistanceCmH2O;      // 气道阻力 cmH2O/(L/s)
+    float complianceMlCmH2O;    // 顺应性 ml/cmH2O
+    float elastanceKpaPerL;     // 弹性 E = 1/C，kPa/L
+    float offsetKpa;            // P0：最近一次吸气开始前的压力（相对基准）
+    float residualRmsKpa;       // 先验残差RMS
+    float timeConstantMs;       // τ = R·C
+    uint32_t samples;           // 参与估计的样本数
+    bool valid;
+};
+
+// 增量RLS估计：参数θ = [R, E]，回归量φ = [Q(L/s), V(L)]，观测为 P - P0，
+// 固定2×2协方差，每个样本O(1)，不缓存波形。
+// 流量传感器只测吸入方向，因此只用吸气段（INHALE/PEAK）的样本，
+// 容积V从每次吸气开始按梯形积分流量。
+// P0直接取吸气开始前的压力（含PEEP和基准偏差）而不作为参数：每次吸气末的容积相近，
+// P0与E·V几乎共线，一起估计时R/C变化后收敛很慢。代价是呼气不完全（τ接近呼气时间，
+// 存在内源性PEEP）时估计有偏。
+// 遗忘因子按样本间隔计算 λ = 1 - dt/T，流量采样率改变时跟踪速度不变。
+class LungMechanicsEstimator {
+public:
+    LungMechanicsEstimator();
+
+    // 每个新的流量样本调用一次，pressureKpa为同一时刻的压力（相对基准），
+    // flowMlMin为流量（ml/min，NAN表示无数据）。返回true表示本样本参与了估计
+    bool update(unsigned long timestampUs, BreathState state, float pressureKpa, float flowMlMin);
+
+    void setMemorySeconds(float seconds) { _memoryS = seconds; }
+    float getMemorySeconds() const { return _memoryS; }
+
+    const LungMechanics& estimate() const { return _estimate; }
+    void reset();
+
+private:
+    bool isInspiration(BreathState state) const { return state == INHALE || state == PEAK; }
+    void refreshEstimate();
+
+    float _memoryS;
+    float _theta[2];
+    float _p[2][2];
+    float _residualSq;
+    LungMechanics _estimate;
+
+    // 当前吸气的容积积分
+    bool _inInspiration;
+    bool _volumeValid;
+    unsigned long _lastUs;
+    float _lastFlowLps;
+    float _volumeL;
+    float _startPressureKpa;   // 呼气段最后一个样本的压力
+};
+
+#endif
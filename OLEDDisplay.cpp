@@ -118,18 +118,73 @@ void OLEDDisplay::testDisplay() {
 }
 
 void OLEDDisplay::update(float pressure, float temperature, const String& state, float valvePercent, float flow) {
-    if (millis() - lastUpdate < 500) return; // 减少刷新间隔到500ms
+    if (!isRefreshDue()) return; // 刷新间隔500ms
     lastUpdate = millis();
     
-    // 选择OLED通道并等待稳定
+    // 选择OLED通道（切换等待由I2CMux按数据手册处理）
     selectDisplayChannel();
-    delay(20); // 减少延迟提高响应速度
     
     // 完全清除显示缓冲区
     display.clearDisplay();
     display.display(); // 先显示空白屏幕
     delay(10);
     
+    drawStatus(pressure, temperature, state, valvePercent, flow);
+    
+    // 确保显示更新
+    display.display();
+    delay(10); // 减少延迟提高响应速度
+}
+
+void OLEDDisplay::render(float pressure, float temperature, const String& state, float valvePercent, float flow) {
+    // 只绘制到显存，由flushChunk()分段发送，单次总线占用控制在几毫秒内
+    lastUpdate = millis();
+    display.clearDisplay();
+    drawStatus(pressure, temperature, state, valvePercent, flow);
+    _flushOffset = 0;
+    _flushActive = true;
+}
+
+bool OLEDDisplay::flushChunk() {
+    if (!_flushActive) return true;
+    selectDisplayChannel();
+    
+    // 每帧开始时设置整屏页/列地址窗口，之后的数据按地址自动递增写入
+    if (_flushOffset == 0) {
+        Wire.beginTransmission(OLED_ADDR);
+        Wire.write((uint8_t)0x00);
+        Wire.write((uint8_t)SSD1306_PAGEADDR);
+        Wire.write((uint8_t)0);
+        Wire.write((uint8_t)(SCREEN_HEIGHT / 8 - 1));
+        Wire.write((uint8_t)SSD1306_COLUMNADDR);
+        Wire.write((uint8_t)0);
+        Wire.write((uint8_t)(SCREEN_WIDTH - 1));
+        if (Wire.endTransmission() != 0) {
+            return false;
+        }
+    }
+    
+    const uint8_t* buffer = display.getBuffer();
+    uint16_t count = OLED_FRAME_BYTES - _flushOffset;
+    if (count > OLED_FLUSH_CHUNK) count = OLED_FLUSH_CHUNK;
+    
+    Wire.beginTransmission(OLED_ADDR);
+    Wire.write((uint8_t)0x40);
+    Wire.write(buffer + _flushOffset, count);
+    if (Wire.endTransmission() != 0) {
+        // 失败时整帧重发
+        _flushOffset = 0;
+        return false;
+    }
+    
+    _flushOffset += count;
+    if (_flushOffset >= OLED_FRAME_BYTES) {
+        _flushActive = false;
+    }
+    return true;
+}
+
+void OLEDDisplay::drawStatus(float pressure, float temperature, const String& state, float valvePercent, float flow) {
     // 重新设置显示参数
     display.setTextSize(1);
     display.setTextColor(SSD1306_WHITE);
@@ -170,10 +225,6 @@ void OLEDDisplay::update(float pressure, float temperature, const String& state,
     display.setCursor(0, 56);
     display.print("State: ");
     display.print(state);
-    
-    // 确保显示更新
-    display.display();
-    delay(10); // 减少延迟提高响应速度
 }
 
 void OLEDDisplay::clearGraphs() {
@@ -5,18 +5,29 @@
 #include <Wire.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
+#include <atomic>
 #include "I2CMux.h"  // 包含多路复用器库
 
 // OLED 配置
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
 #define OLED_ADDR 0x3C
+#define OLED_REFRESH_MS 500
+#define OLED_FRAME_BYTES (SCREEN_WIDTH * SCREEN_HEIGHT / 8)
+#define OLED_FLUSH_CHUNK 32   // 分段刷新每段字节数（100kHz下约3ms）
 
 class OLEDDisplay {
 public:
     OLEDDisplay(I2CMux* mux = nullptr, uint8_t channel = 0); // 可传入多路复用器和通道
     bool begin();
     void update(float pressure, float temperature, const String& state, float valvePercent, float flow);
+    bool isRefreshDue() const { return millis() - lastUpdate >= OLED_REFRESH_MS; }
+    
+    // 分段刷新：render()只绘制显存，flushChunk()每次发送一段，整帧完成后返回true。
+    // 两者可在不同核调用：render()只在!isFlushPending()时绘制，显存交接以_flushActive为界
+    void render(float pressure, float temperature, const String& state, float valvePercent, float flow);
+    bool flushChunk();
+    bool isFlushPending() const { return _flushActive; }
     void clearGraphs();
     void testDisplay();
     void resetDisplay();
@@ -32,7 +43,11 @@ private:
     I2CMux* _mux;
     uint8_t _channel;
     
+    uint16_t _flushOffset = 0;
+    std::atomic<bool> _flushActive{false};  // 双核流水线中render()与flushChunk()分属两个核
+    
     void selectDisplayChannel();
+    void drawStatus(float pressure, float temperature, const String& state, float valvePercent, float flow);
 };
 
 #endif
\ No newline at end of file
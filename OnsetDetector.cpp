@@ -0,0 +1,89 @@
+#include "OnsetDetector.h"
+
+OnsetDetector::OnsetDetector() : _threshold(0.5f) {
+    reset();
+}
+
+void OnsetDetector::reset() {
+    _index = 0;
+    _count = 0;
+    _state = EXHALE;
+    _slope = 0;
+    _noiseVar = 0;
+    _slopeNoise = 0;
+    _confirm = 0;
+    _riseStartUs = 0;
+    _lastTriggerUs = 0;
+    resetStats();
+}
+
+float OnsetDetector::effectiveThreshold() const {
+    float noiseThreshold = SLOPE_NOISE_K * _slopeNoise;
+    return noiseThreshold > _threshold ? noiseThreshold : _threshold;
+}
+
+void OnsetDetector::resetStats() {
+    memset(&_stats, 0, sizeof(_stats));
+    _delaySumMs = 0;
+}
+
+BreathState OnsetDetector::update(unsigned long timestampUs, float pressureKpa) {
+    // 环形窗口保存最近SLOPE_WINDOW+1个样本，斜率取首尾差分
+    _pressure[_index] = pressureKpa;
+    _timeUs[_index] = timestampUs;
+    if (_count < SLOPE_WINDOW + 1) _count++;
+    uint8_t oldest = _count < SLOPE_WINDOW + 1 ? 0 : (uint8_t)((_index + 1) % (SLOPE_WINDOW + 1));
+    uint32_t spanUs = timestampUs - _timeUs[oldest];
+    _slope = (_count > 1 && spanUs > 0) ? (pressureKpa - _pressure[oldest]) * 1e6f / spanUs : 0;
+    if (_count >= 3) {
+        uint8_t prev1 = _index ? _index - 1 : SLOPE_WINDOW;
+        uint8_t prev2 = prev1 ? prev1 - 1 : SLOPE_WINDOW;
+        float d2 = pressureKpa - 2 * _pressure[prev1] + _pressure[prev2];
+        _noiseVar += (d2 * d2 / 6 - _noiseVar) / (1 << SLOPE_NOISE_SHIFT);
+        // 首尾两点差分的噪声为压力噪声的sqrt(2)倍
+        _slopeNoise = spanUs ? sqrtf(2 * _noiseVar) * 1e6f / spanUs : 0;
+    }
+    if (++_index > SLOPE_WINDOW) _index = 0;
+    float threshold = effectiveThreshold();
+
+    switch (_state) {
+        case EXHALE:
+        case TROUGH:
+            if (_slope > threshold) {
+                if (++_confirm >= ONSET_CONFIRM_SAMPLES) {
+                    _state = INHALE;
+                    _confirm = 0;
+                    _lastTriggerUs = timestampUs;
+                    if (_riseStartUs != 0) {
+                        float delayMs = (uint32_t)(timestampUs - _riseStartUs) / 1000.0f;
+                        _stats.lastDelayMs = delayMs;
+                        _delaySumMs += delayMs;
+                        if (delayMs > _stats.maxDelayMs) _stats.maxDelayMs = delayMs;
+                        _stats.triggers++;
+                        _stats.meanDelayMs = _delaySumMs / _stats.triggers;
+                    }
+                }
+            } else {
+                _confirm = 0;
+                if (_slope <= 0) _riseStartUs = timestampUs;
+            }
+            break;
+
+        case INHALE:
+            if (_slope <= 0) _state = PEAK;
+            break;
+
+        case PEAK:
+            if (_slope < -threshold) {
+                if (++_confirm >= ONSET_CONFIRM_SAMPLES) {
+                    _state = EXHALE;
+                    _confirm = 0;
+                    _riseStartUs = timestampUs;
+                }
+            } else {
+                _confirm = 0;
+            }
+            break;
+    }
+    return _state;
+}
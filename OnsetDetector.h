@@ -0,0 +1,65 @@
+#ifndef OnsetDetector_h
+#define OnsetDetector_h
+
+#include <Arduino.h>
+#include "BreathAnalyzer.h"
+
+// 斜率检测配置
+constexpr uint8_t SLOPE_WINDOW = 8;            // 斜率取最近8个间隔（200Hz下40ms）
+constexpr uint8_t ONSET_CONFIRM_SAMPLES = 2;   // 连续超过阈值的样本数才确认状态切换
+constexpr float SLOPE_NOISE_K = 4.0;           // 有效阈值不低于斜率噪声RMS的K倍
+constexpr uint8_t SLOPE_NOISE_SHIFT = 6;       // 噪声估计的EWMA系数 1/64
+
+// 触发延迟统计：延迟为触发样本时刻减去估计的起升时刻（斜率最后一次不为正的样本）
+struct TriggerStats {
+    uint32_t triggers;
+    float lastDelayMs;
+    float meanDelayMs;
+    float maxDelayMs;
+};
+
+// 基于斜率的呼吸起始检测：直接处理未经平滑的压力样本，
+// 斜率为窗口首尾两个样本的差分（按各自时间戳），每个样本O(1)。
+// 状态转换：EXHALE --斜率>阈值(连续确认)--> INHALE --斜率<=0--> PEAK --斜率<-阈值(连续确认)--> EXHALE
+// 压力噪声由二阶差分估计（呼吸波形在相邻3个样本内近似线性，二阶差分只剩噪声），
+// 有效阈值取设定阈值与斜率噪声RMS的K倍中的较大者，噪声大时自动抬高
+class OnsetDetector {
+public:
+    OnsetDetector();
+
+    BreathState update(unsigned long timestampUs, float pressureKpa);
+
+    // 起始/释放斜率阈值(kPa/s)
+    void setSlopeThreshold(float kpaPerSecond) { _threshold = kpaPerSecond; }
+    float getSlopeThreshold() const { return _threshold; }
+    float effectiveThreshold() const;
+    // 由压力噪声换算的斜率噪声RMS(kPa/s)
+    float slopeNoise() const { return _slopeNoise; }
+
+    BreathState state() const { return _state; }
+    float slope() const { return _slope; }
+    unsigned long lastTriggerUs() const { return _lastTriggerUs; }
+    float lastTriggerDelayMs() const { return _stats.lastDelayMs; }
+    TriggerStats getStats() const { return _stats; }
+    void resetStats();
+    void reset();
+
+private:
+    float _pressure[SLOPE_WINDOW + 1];
+    unsigned long _timeUs[SLOPE_WINDOW + 1];
+    uint8_t _index;
+    uint8_t _count;
+
+    BreathState _state;
+    float _threshold;
+    float _slope;
+    float _noiseVar;      // 压力噪声方差（二阶差分均方值 / 6）
+    float _slopeNoise;    // 由压力噪声换算的斜率噪声RMS
+    uint8_t _confirm;
+    unsigned long _riseStartUs;
+    unsigned long _lastTriggerUs;
+    TriggerStats _stats;
+    double _delaySumMs;
+};
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef PressureMath_h
+#define PressureMath_h
+
+#include <Arduino.h>
+#include "StreamFilter.h"
+
+// 0x6D气压传感器的换算与滤波：浮点参考实现与定点（Q格式）实现。
+// 定点链路中压力为Q19.12 kPa（int32，1 LSB ≈ 0.24 Pa，远小于传感器分辨率），
+// 温度为Q8.8 °C（即传感器温度寄存器原值）；量程除数k和(p + 1032) / 12.10111
+// 的系数在编译期折叠，每个样本只有一次64位乘加和移位，不依赖FPU。
+
+// 滤波配置（每个气压通道独立一组滤波状态）
+constexpr uint8_t FILTER_WINDOW = 5;
+constexpr float EWMA_ALPHA = 0.3;
+
+// 换算常数：kPa = (counts / k + PRESSURE_OFFSET_COUNTS) / PRESSURE_DIVISOR
+constexpr float PRESSURE_OFFSET_COUNTS = 1032;
+constexpr float PRESSURE_DIVISOR = 12.10111;
+
+// 量程 -> 除数k
+constexpr uint32_t pressureKValue(float range_kpa) {
+    return range_kpa > 1000 ? 4 :
+           range_kpa > 500 ? 8 :
+           range_kpa > 260 ? 16 :
+           range_kpa > 131 ? 32 :
+           range_kpa > 65 ? 64 :
+           range_kpa > 32 ? 128 :
+           range_kpa > 16 ? 256 :
+           range_kpa > 8 ? 512 :
+           range_kpa > 4 ? 1024 :
+           range_kpa > 2 ? 2048 :
+           range_kpa > 1 ? 4096 : 8192;
+}
+
+// ---- 浮点参考实现 ----
+inline float pressureTemperatureC(uint16_t adc_value) {
+    return (adc_value & 0x8000) ? (adc_value - 65536.0) / 256.0 : adc_value / 256.0;
+}
+
+inline float pressureAdcToKpa(uint32_t adc_value, uint32_t k) {
+    if (k == 0) k = 16;
+    float pressure = (adc_value & 0x800000) ? (adc_value - 16777216.0) / k : adc_value / (float)k;
+    return (pressure + PRESSURE_OFFSET_COUNTS) / PRESSURE_DIVISOR;
+}
+
+// ---- 定点实现 ----
+constexpr uint8_t PRESSURE_Q_BITS = 12;         // 压力小数位
+constexpr uint8_t PRESSURE_SCALE_SHIFT = 20;    // 换算系数额外保留的精度位
+constexpr int32_t PRESSURE_Q_ONE = 1L << PRESSURE_Q_BITS;
+constexpr int32_t EWMA_ALPHA_Q16 = (int32_t)(EWMA_ALPHA * 65536.0 + 0.5);
+
+// 每个ADC计数对应的Q12 kPa（再左移PRESSURE_SCALE_SHIFT位）及偏移
+constexpr int64_t pressureScaleQ(uint32_t k) {
+    return (int64_t)((double)(1LL << (PRESSURE_Q_BITS + PRESSURE_SCALE_SHIFT)) / (k * (double)PRESSURE_DIVISOR) + 0.5);
+}
+constexpr int64_t PRESSURE_OFFSET_Q =
+    (int64_t)((double)PRESSURE_OFFSET_COUNTS / PRESSURE_DIVISOR * (double)(1LL << (PRESSURE_Q_BITS + PRESSURE_SCALE_SHIFT)) + 0.5);
+
+// 24位补码ADC值 -> Q19.12 kPa；K为编译期确定的量程除数
+template <uint32_t K>
+inline int32_t pressureAdcToQ(uint32_t adc_value) {
+    static constexpr int64_t SCALE = pressureScaleQ(K);
+    int32_t counts = (int32_t)(adc_value << 8) >> 8;
+    return (int32_t)(((int64_t)counts * SCALE + PRESSURE_OFFSET_Q + (1LL << (PRESSURE_SCALE_SHIFT - 1))) >> PRESSURE_SCALE_SHIFT);
+}
+
+inline float pressureQToKpa(int32_t q) {
+    return q * (1.0f / PRESSURE_Q_ONE);
+}
+
+inline float temperatureQ8ToC(uint16_t adc_value) {
+    return (int16_t)adc_value * (1.0f / 256);
+}
+
+// 每个通道的滤波状态：移动平均 + EWMA
+struct PressureFilter {
+    MovingAverage<float, FILTER_WINDOW> average;
+    Ewma<float> ewma{EWMA_ALPHA};
+    float update(float kpa) { return ewma.update(average.update(kpa)); }
+};
+
+// 定点版本：k >= 16时5个满量程Q12样本之和仍不超过int32
+struct FixedPressureFilter {
+    MovingAverage<int32_t, FILTER_WINDOW> average;
+    FixedEwma ewma{EWMA_ALPHA_Q16};
+    int32_t update(int32_t q) { return ewma.update(average.update(q)); }
+};
+
+#endif
@@ -0,0 +1,109 @@
+#include "PressurePid.h"
+
+PressurePid::PressurePid() {
+    _gains.kp = PID_DEFAULT_KP;
+    _gains.ki = PID_DEFAULT_KI;
+    _gains.kd = PID_DEFAULT_KD;
+    _gains.kff = PID_DEFAULT_KFF;
+    _targets[INHALE] = 1.0;
+    _targets[PEAK] = 1.0;
+    _targets[EXHALE] = 0.0;
+    _targets[TROUGH] = 0.0;
+    reset();
+}
+
+void PressurePid::reset() {
+    _hasLast = false;
+    _lastUs = 0;
+    _lastMeasured = 0;
+    _lastState = EXHALE;
+    _integral = 0;
+    _derivative.reset();
+    _target = 0;
+    _error = 0;
+    _output = 0;
+    _cycleCompleted = false;
+    _cycleOpen = false;
+    _cycleStartUs = 0;
+    _cycleSamples = 0;
+    _cycleSaturated = 0;
+    _errorSum = 0;
+    _errorSqSum = 0;
+    _errorMaxAbs = 0;
+    _cycleCount = 0;
+    memset(&_lastCycle, 0, sizeof(_lastCycle));
+}
+
+void PressurePid::setPhaseTarget(BreathState state, float targetKpa) {
+    if ((unsigned)state < 4) _targets[state] = targetKpa;
+}
+
+float PressurePid::getPhaseTarget(BreathState state) const {
+    return (unsigned)state < 4 ? _targets[state] : 0;
+}
+
+float PressurePid::update(unsigned long timestampUs, BreathState state, float measuredKpa, float gainScale, float outputMax) {
+    _cycleCompleted = false;
+    bool onset = state == INHALE && _hasLast && _lastState != INHALE && _lastState != PEAK;
+    if (onset) closeCycle(timestampUs);
+
+    float dt = _hasLast ? (uint32_t)(timestampUs - _lastUs) / 1e6f : 0;
+    if (dt > PID_MAX_DT_S) dt = 0;
+
+    _target = _targets[state];
+    _error = _target - measuredKpa;
+
+    float derivative = 0;
+    if (dt > 0) {
+        derivative = _derivative.update((measuredKpa - _lastMeasured) / dt);
+    }
+
+    float kp = _gains.kp * gainScale;
+    float ki = _gains.ki * gainScale;
+    float kd = _gains.kd * gainScale;
+    float unclamped = _gains.kff * _target + kp * _error + _integral - kd * derivative;
+    float output = constrain(unclamped, 0, outputMax);
+    bool saturated = output != unclamped;
+
+    // 条件积分：只在未限幅，或误差方向会把输出拉回范围内时积分
+    if (dt > 0 && (!saturated || (unclamped > outputMax) != (_error > 0))) {
+        _integral += ki * _error * dt;
+        _integral = constrain(_integral, -outputMax, outputMax);
+    }
+
+    _output = output;
+    _hasLast = true;
+    _lastUs = timestampUs;
+    _lastMeasured = measuredKpa;
+    _lastState = state;
+
+    // 周期跟踪误差
+    if (_cycleOpen) {
+        _cycleSamples++;
+        if (saturated) _cycleSaturated++;
+        _errorSum += _error;
+        _errorSqSum += (double)_error * _error;
+        if (fabsf(_error) > _errorMaxAbs) _errorMaxAbs = fabsf(_error);
+    }
+    return _output;
+}
+
+void PressurePid::closeCycle(unsigned long timestampUs) {
+    if (_cycleOpen && _cycleSamples > 0) {
+        _lastCycle.cycleIndex = _cycleCount++;
+        _lastCycle.samples = _cycleSamples;
+        _lastCycle.durationMs = (uint32_t)(timestampUs - _cycleStartUs) / 1000;
+        _lastCycle.meanErrorKpa = _errorSum / _cycleSamples;
+        _lastCycle.rmsErrorKpa = sqrt(_errorSqSum / _cycleSamples);
+        _lastCycle.maxAbsErrorKpa = _errorMaxAbs;
+        _lastCycle.saturatedPercent = 100.0f * _cycleSaturated / _cycleSamples;
+        _cycleCompleted = true;
+    }
+    _cycleOpen = true;
+    _cycleStartUs = timestampUs;
+    _cycleSamples = 0;
+    _cycleSaturated = 0;
+    _errorSum = 0;
+    _errorSqSum = 0;
+    _errorMaxAbs = 0;
+}
@@ -0,0 +1,90 @@
+#ifndef PressurePid_h
+#define PressurePid_h
+
+#include <Arduino.h>
+#include "BreathAnalyzer.h"
+#include "StreamFilter.h"
+
+// PID默认参数：输出为气阀开度计数（0–MAX_VALVE_OPEN），压力为相对基准的kPa
+constexpr float PID_DEFAULT_KP = 100.0;         // 计数/kPa
+constexpr float PID_DEFAULT_KI = 400.0;         // 计数/(kPa·s)
+constexpr float PID_DEFAULT_KD = 0.0;           // 计数/(kPa/s)
+constexpr float PID_DEFAULT_KFF = 100.0;        // 前馈：计数/kPa目标压力
+constexpr float PID_DERIVATIVE_ALPHA = 0.2;     // 微分项EWMA平滑
+constexpr float PID_MAX_DT_S = 0.5;             // 两次更新间隔超过此值视为中断，不积分
+
+struct PidGains {
+    float kp;
+    float ki;
+    float kd;
+    float kff;
+};
+
+// 单个呼吸周期（吸气开始到下一次吸气开始）的跟踪误差
+struct TrackingStats {
+    uint32_t cycleIndex;
+    uint32_t samples;
+    uint32_t durationMs;
+    float meanErrorKpa;         // 目标 - 实测的平均值（偏差）
+    float rmsErrorKpa;
+    float maxAbsErrorKpa;
+    float saturatedPercent;     // 输出被限幅的样本比例
+};
+
+// 压力目标PID：每个定时采样节拍更新一次，积分和微分按样本时间戳计算，
+// 与主循环速度无关。微分作用在测量值上（目标切换时不产生冲击），
+// 抗积分饱和采用条件积分：输出已限幅且误差方向会加深饱和时停止积分。
+class PressurePid {
+public:
+    PressurePid();
+
+    void setGains(const PidGains& gains) { _gains = gains; }
+    const PidGains& getGains() const { return _gains; }
+
+    // 各呼吸阶段的目标压力（相对基准，kPa）
+    void setPhaseTarget(BreathState state, float targetKpa);
+    float getPhaseTarget(BreathState state) const;
+
+    // 返回新的开度；gainScale缩放P/I/D（自适应响应因子），outputMax为本次开度上限
+    float update(unsigned long timestampUs, BreathState state, float measuredKpa, float gainScale, float outputMax);
+
+    float output() const { return _output; }
+    float target() const { return _target; }
+    float lastError() const { return _error; }
+
+    // 每次进入INHALE时结算上一个周期，返回true表示有新的周期统计
+    bool cycleCompleted() const { return _cycleCompleted; }
+    const TrackingStats& lastCycle() const { return _lastCycle; }
+
+    void reset();
+
+private:
+    void closeCycle(unsigned long timestampUs);
+
+    PidGains _gains;
+    float _targets[4];
+
+    bool _hasLast;
+    unsigned long _lastUs;
+    float _lastMeasured;
+    BreathState _lastState;
+    float _integral;
+    Ewma<float> _derivative{PID_DERIVATIVE_ALPHA};
+    float _target;
+    float _error;
+    float _output;
+
+    // 当前周期的累计量
+    bool _cycleCompleted;
+    bool _cycleOpen;
+    unsigned long _cycleStartUs;
+    uint32_t _cycleSamples;
+    uint32_t _cycleSaturated;
+    double _errorSum;
+    double _errorSqSum;
+    float _errorMaxAbs;
+    uint32_t _cycleCount;
+    TrackingStats _lastCycle;
+};
+
+#endif
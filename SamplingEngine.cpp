@@ -0,0 +1,205 @@
+#include "SamplingEngine.h"
+
+SamplingEngine* SamplingEngine::_instance = nullptr;
+portMUX_TYPE SamplingEngine::_timerMux = portMUX_INITIALIZER_UNLOCKED;
+
+SamplingEngine::SamplingEngine()
+    : _timer(nullptr), _rateHz(0), _periodUs(0), _source(nullptr), _context(nullptr),
+      _tickCount(0), _tickTimeUs(0), _notifyTask(nullptr), _servicedTicks(0), _writeSeq(0) {
+    for (uint8_t i = 0; i < SAMPLE_CONSUMER_COUNT; i++) {
+        _readSeq[i] = 0;
+    }
+    resetStats();
+}
+
+void IRAM_ATTR SamplingEngine::onTimer() {
+    SamplingEngine* self = _instance;
+    if (!self) return;
+    portENTER_CRITICAL_ISR(&_timerMux);
+    self->_tickCount++;
+    self->_tickTimeUs = micros();
+    TaskHandle_t task = self->_notifyTask;
+    portEXIT_CRITICAL_ISR(&_timerMux);
+    
+    if (task != nullptr) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(task, &woken);
+        if (woken) portYIELD_FROM_ISR();
+    }
+}
+
+void SamplingEngine::setNotifyTask(TaskHandle_t task) {
+    portENTER_CRITICAL(&_timerMux);
+    _notifyTask = task;
+    portEXIT_CRITICAL(&_timerMux);
+}
+
+bool SamplingEngine::begin(uint32_t rateHz, SampleSource source, void* context) {
+    if (rateHz == 0 || source == nullptr) return false;
+    if (_instance != nullptr && _instance != this) {
+        Serial.println("采样引擎: 定时器已被占用");
+        return false;
+    }
+    end();
+
+    _rateHz = rateHz;
+    _periodUs = 1000000UL / rateHz;
+    _source = source;
+    _context = context;
+    _tickCount = 0;
+    _servicedTicks = 0;
+    _instance = this;
+
+    _timer = timerBegin(SAMPLE_TIMER_NUM, SAMPLE_TIMER_DIVIDER, true);
+    if (_timer == nullptr) {
+        Serial.println("采样引擎: 硬件定时器初始化失败");
+        _instance = nullptr;
+        return false;
+    }
+    timerAttachInterrupt(_timer, &SamplingEngine::onTimer, true);
+    timerAlarmWrite(_timer, _periodUs, true);
+    timerAlarmEnable(_timer);
+    resetStats();
+
+    Serial.print("采样引擎启动: ");
+    Serial.print(_rateHz);
+    Serial.print(" Hz, 周期 ");
+    Serial.print(_periodUs);
+    Serial.println(" us");
+    return true;
+}
+
+void SamplingEngine::end() {
+    if (_timer == nullptr) return;
+    timerAlarmDisable(_timer);
+    timerDetachInterrupt(_timer);
+    timerEnd(_timer);
+    _timer = nullptr;
+    _instance = nullptr;
+}
+
+bool SamplingEngine::poll() {
+    if (_timer == nullptr) return false;
+
+    portENTER_CRITICAL(&_timerMux);
+    uint32_t ticks = _tickCount;
+    unsigned long tickTimeUs = _tickTimeUs;
+    portEXIT_CRITICAL(&_timerMux);
+
+    if (ticks == _servicedTicks) return false;
+
+    // 积压多个节拍时只采集一次，其余记为超限
+    uint32_t pending = ticks - _servicedTicks;
+    if (pending > 1) {
+        _overruns += pending - 1;
+    }
+    _servicedTicks = ticks;
+
+    unsigned long startUs = micros();
+    uint32_t latency = startUs - tickTimeUs;
+    if (latency > _maxLatencyUs) _maxLatencyUs = latency;
+
+    PressureSample sample;
+    if (!_source(_context, sample)) {
+        _failures++;
+        return false;
+    }
+    sample.seq = _writeSeq;
+
+    // 周期抖动：相邻样本实际间隔与标称周期之差
+    if (_samples > 0) {
+        unsigned long interval = sample.timestampUs - _lastSampleUs;
+        uint32_t jitter = interval > _periodUs ? interval - _periodUs : _periodUs - interval;
+        _jitterSumUs += jitter;
+        _jitterCount++;
+        if (jitter > _maxJitterUs) _maxJitterUs = jitter;
+    }
+    _lastSampleUs = sample.timestampUs;
+
+    _ring[_writeSeq % SAMPLE_RING_SIZE] = sample;
+    _writeSeq++;
+    _samples++;
+    return true;
+}
+
+bool SamplingEngine::read(SampleConsumer consumer, PressureSample& sample) {
+    if (consumer >= SAMPLE_CONSUMER_COUNT) return false;
+    uint32_t& readSeq = _readSeq[consumer];
+    if (readSeq == _writeSeq) return false;
+
+    // 落后超过缓冲长度时跳到最旧的有效样本
+    if (_writeSeq - readSeq > SAMPLE_RING_SIZE) {
+        _dropped[consumer] += _writeSeq - readSeq - SAMPLE_RING_SIZE;
+        readSeq = _writeSeq - SAMPLE_RING_SIZE;
+    }
+    sample = _ring[readSeq % SAMPLE_RING_SIZE];
+    readSeq++;
+    return true;
+}
+
+bool SamplingEngine::latest(PressureSample& sample) const {
+    if (_writeSeq == 0) return false;
+    sample = _ring[(_writeSeq - 1) % SAMPLE_RING_SIZE];
+    return true;
+}
+
+SamplingStats SamplingEngine::getStats() const {
+    SamplingStats stats;
+    stats.ticks = _tickCount - _statsStartTicks;
+    stats.samples = _samples;
+    stats.failures = _failures;
+    stats.overruns = _overruns;
+    for (uint8_t i = 0; i < SAMPLE_CONSUMER_COUNT; i++) {
+        stats.dropped[i] = _dropped[i];
+    }
+    stats.meanJitterUs = _jitterCount ? (float)_jitterSumUs / _jitterCount : 0.0f;
+    stats.maxJitterUs = _maxJitterUs;
+    stats.maxLatencyUs = _maxLatencyUs;
+    unsigned long elapsed = micros() - _statsStartUs;
+    stats.actualRateHz = elapsed ? _samples * 1000000.0f / elapsed : 0.0f;
+    return stats;
+}
+
+void SamplingEngine::resetStats() {
+    _samples = 0;
+    _failures = 0;
+    _overruns = 0;
+    for (uint8_t i = 0; i < SAMPLE_CONSUMER_COUNT; i++) {
+        _dropped[i] = 0;
+    }
+    _jitterSumUs = 0;
+    _jitterCount = 0;
+    _maxJitterUs = 0;
+    _maxLatencyUs = 0;
+    _lastSampleUs = 0;
+    _statsStartUs = micros();
+    _statsStartTicks = _tickCount;
+}
+
+void SamplingEngine::printStats() {
+    SamplingStats stats = getStats();
+    Serial.println("=== 定时采样统计 ===");
+    Serial.print("目标: ");
+    Serial.print(_rateHz);
+    Serial.print(" Hz, 实际: ");
+    Serial.print(stats.actualRateHz, 1);
+    Serial.println(" Hz");
+    Serial.print("样本: ");
+    Serial.print(stats.samples);
+    Serial.print(", 失败: ");
+    Serial.print(stats.failures);
+    Serial.print(", 超限: ");
+    Serial.println(stats.overruns);
+    Serial.print("周期抖动: 平均 ");
+    Serial.print(stats.meanJitterUs, 1);
+    Serial.print(" us, 最大 ");
+    Serial.print(stats.maxJitterUs);
+    Serial.print(" us, 中断延迟最大 ");
+    Serial.print(stats.maxLatencyUs);
+    Serial.println(" us");
+    Serial.print("丢弃(控制/遥测): ");
+    Serial.print(stats.dropped[CONSUMER_CONTROL]);
+    Serial.print("/");
+    Serial.println(stats.dropped[CONSUMER_TELEMETRY]);
+    Serial.println("====================");
+}
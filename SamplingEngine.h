@@ -0,0 +1,108 @@
+#ifndef SamplingEngine_h
+#define SamplingEngine_h
+
+#include <Arduino.h>
+
+// 定时采样配置
+constexpr uint32_t DEFAULT_SAMPLE_RATE_HZ = 200;   // 默认主气压采样率
+constexpr uint8_t SAMPLE_RING_SIZE = 32;            // 样本环形缓冲（2的幂）
+constexpr uint8_t SAMPLE_TIMER_NUM = 0;             // 使用的硬件定时器编号
+constexpr uint16_t SAMPLE_TIMER_DIVIDER = 80;       // 80MHz APB / 80 = 1MHz计数
+
+// 样本消费者：控制和遥测各自维护读取位置，互不影响
+enum SampleConsumer {
+    CONSUMER_CONTROL = 0,
+    CONSUMER_TELEMETRY = 1,
+    SAMPLE_CONSUMER_COUNT
+};
+
+// 带时间戳的单个气压样本
+struct PressureSample {
+    uint32_t seq;               // 样本序号
+    unsigned long timestampUs;  // 采集时刻(micros)
+    uint32_t pressureAdc;       // 24位压力原始值（换算和滤波在控制阶段完成）
+    uint16_t temperatureAdc;    // 16位温度原始值
+};
+
+// 采样统计
+struct SamplingStats {
+    uint32_t ticks;             // 定时器中断次数
+    uint32_t samples;           // 成功采集的样本数
+    uint32_t failures;          // 采集失败次数
+    uint32_t overruns;          // 上一个采样周期未及时处理而丢失的周期数
+    uint32_t dropped[SAMPLE_CONSUMER_COUNT];  // 消费者来不及读取而被覆盖的样本数
+    float meanJitterUs;         // 相邻样本间隔与标称周期之差的平均绝对值
+    uint32_t maxJitterUs;       // 同上，最大值
+    uint32_t maxLatencyUs;      // 定时器中断到开始采集的最大延迟
+    float actualRateHz;         // 实际采样率
+};
+
+// 样本采集回调：在主循环上下文中调用（可以访问I2C），返回是否成功
+typedef bool (*SampleSource)(void* context, PressureSample& sample);
+
+// 硬件定时器驱动的固定速率采样引擎。
+// 定时器中断只记录节拍和时间戳，I2C采集在poll()中完成；
+// 慢速任务之间频繁调用poll()即可保持采样周期稳定；
+// 也可由setNotifyTask()指定的任务在每个节拍被唤醒后调用poll()。
+class SamplingEngine {
+public:
+    SamplingEngine();
+
+    bool begin(uint32_t rateHz, SampleSource source, void* context);
+    void end();
+    bool isRunning() const { return _timer != nullptr; }
+    uint32_t getRateHz() const { return _rateHz; }
+    uint32_t getPeriodUs() const { return _periodUs; }
+
+    // 到期时采集一个样本，返回是否采集
+    bool poll();
+    bool isDue() const { return _tickCount != _servicedTicks; }
+    
+    // 每个定时器节拍通知该任务（ulTaskNotifyTake()等待）；nullptr取消
+    void setNotifyTask(TaskHandle_t task);
+
+    // 读取某个消费者的下一个未读样本
+    bool read(SampleConsumer consumer, PressureSample& sample);
+    bool latest(PressureSample& sample) const;
+
+    SamplingStats getStats() const;
+    void resetStats();
+    void printStats();
+
+private:
+    static void IRAM_ATTR onTimer();
+    static SamplingEngine* _instance;
+    static portMUX_TYPE _timerMux;
+
+    hw_timer_t* _timer;
+    uint32_t _rateHz;
+    uint32_t _periodUs;
+    SampleSource _source;
+    void* _context;
+
+    // 中断与主循环共享
+    volatile uint32_t _tickCount;
+    volatile unsigned long _tickTimeUs;
+    TaskHandle_t volatile _notifyTask;
+    uint32_t _servicedTicks;
+
+    // 样本环形缓冲
+    PressureSample _ring[SAMPLE_RING_SIZE];
+    uint32_t _writeSeq;
+    uint32_t _readSeq[SAMPLE_CONSUMER_COUNT];
+
+    // 统计
+    uint32_t _samples;
+    uint32_t _failures;
+    uint32_t _overruns;
+    uint32_t _dropped[SAMPLE_CONSUMER_COUNT];
+    uint64_t _jitterSumUs;
+    uint32_t _jitterCount;
+    uint32_t _maxJitterUs;
+    uint32_t _maxLatencyUs;
+    unsigned long _lastSampleUs;
+    unsigned long _statsStartUs;
+    uint32_t _statsStartTicks;
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef SpscQueue_h
+#define SpscQueue_h
+
+#include <Arduino.h>
+#include <atomic>
+
+// 单生产者/单消费者无锁环形队列（跨核传递样本）。
+// 生产者只写_head、消费者只写_tail，靠acquire/release保证元素先于索引可见，
+// 不需要临界区也不会阻塞；队列满时丢弃新元素并计数，生产者（控制任务）永不等待。
+template <typename T, size_t N>
+class SpscQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue容量必须是2的幂");
+
+public:
+    // 仅生产者调用
+    bool push(const T& item) {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        uint32_t used = head - _tail.load(std::memory_order_acquire);
+        if (used >= N) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        _items[head & (N - 1)] = item;
+        _head.store(head + 1, std::memory_order_release);
+        if (used + 1 > _highWater.load(std::memory_order_relaxed)) {
+            _highWater.store(used + 1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    // 仅消费者调用
+    bool pop(T& item) {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire)) return false;
+        item = _items[tail & (N - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t size() const { return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire); }
+    static constexpr size_t capacity() { return N; }
+    uint32_t getDropped() const { return _dropped.load(std::memory_order_relaxed); }
+    uint32_t getHighWater() const { return _highWater.load(std::memory_order_relaxed); }
+
+private:
+    T _items[N];
+    std::atomic<uint32_t> _head{0};
+    std::atomic<uint32_t> _tail{0};
+    std::atomic<uint32_t> _dropped{0};
+    std::atomic<uint32_t> _highWater{0};
+};
+
+#endif
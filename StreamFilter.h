@@ -0,0 +1,160 @@
+#ifndef StreamFilter_h
+#define StreamFilter_h
+
+#include <Arduino.h>
+
+// 流式滤波器：窗口大小在编译期确定，每个数据流持有自己的滤波器对象，
+// 每个样本的计算量与历史长度无关（中值滤波为O(N)插入，N为编译期常量）。
+
+// 移动平均：维护运行和，新样本加入、最旧样本移出，不再每次重新求和。
+// 窗口未填满时按已有样本数平均；Acc为累加类型（整数样本用更宽的整数避免溢出）。
+// 浮点运行和使用Kahan补偿，长时间运行也不会累积舍入误差；整数累加时补偿项恒为0。
+template <typename T, uint8_t N, typename Acc = T>
+class MovingAverage {
+    static_assert(N > 0, "MovingAverage窗口不能为0");
+
+public:
+    MovingAverage() : _window(N) { reset(); }
+
+    T update(T value) {
+        if (_count == _window) {
+            add(-(Acc)_buffer[_index]);
+        } else {
+            _count++;
+        }
+        _buffer[_index] = value;
+        add((Acc)value);
+        if (++_index >= _window) _index = 0;
+        return this->value();
+    }
+
+    T value() const { return _count ? (T)(_sum / (Acc)_count) : T(); }
+    uint8_t count() const { return _count; }
+    bool isFull() const { return _count == _window; }
+
+    // 运行时缩小窗口（不超过N），同时清空历史
+    void setWindow(uint8_t window) {
+        if (window == 0 || window > N) return;
+        _window = window;
+        reset();
+    }
+    uint8_t getWindow() const { return _window; }
+
+    void reset() {
+        _sum = Acc();
+        _compensation = Acc();
+        _index = 0;
+        _count = 0;
+    }
+
+private:
+    void add(Acc v) {
+        Acc y = v - _compensation;
+        Acc t = _sum + y;
+        _compensation = (t - _sum) - y;
+        _sum = t;
+    }
+
+    T _buffer[N];
+    Acc _sum;
+    Acc _compensation;
+    uint8_t _window;
+    uint8_t _index;
+    uint8_t _count;
+};
+
+// 指数加权移动平均：首个样本直接作为初值
+template <typename T>
+class Ewma {
+public:
+    explicit Ewma(T alpha) : _alpha(alpha), _value(), _initialized(false) {}
+
+    T update(T value) {
+        if (!_initialized) {
+            _value = value;
+            _initialized = true;
+        } else {
+            _value = _alpha * value + (1 - _alpha) * _value;
+        }
+        return _value;
+    }
+
+    T value() const { return _value; }
+    bool isInitialized() const { return _initialized; }
+    void reset() { _initialized = false; _value = T(); }
+
+private:
+    T _alpha;
+    T _value;
+    bool _initialized;
+};
+
+// 定点EWMA：alpha为Q16（alpha * 65536），样本与状态为同一Q格式的int32，
+// 每个样本一次32x32->64位乘法，四舍五入到最近值
+class FixedEwma {
+public:
+    explicit FixedEwma(int32_t alphaQ16) : _alpha(alphaQ16), _value(0), _initialized(false) {}
+
+    int32_t update(int32_t value) {
+        if (!_initialized) {
+            _value = value;
+            _initialized = true;
+        } else {
+            int64_t delta = (int64_t)(value - _value) * _alpha;
+            _value += (int32_t)((delta + (1 << 15)) >> 16);
+        }
+        return _value;
+    }
+
+    int32_t value() const { return _value; }
+    bool isInitialized() const { return _initialized; }
+    void reset() { _initialized = false; _value = 0; }
+
+private:
+    int32_t _alpha;
+    int32_t _value;
+    bool _initialized;
+};
+
+// 中值滤波：去除单点毛刺。保持窗口的有序副本，新样本插入、最旧样本移出；
+// 窗口未填满时返回已有样本的中值。样本不能为NaN。
+template <typename T, uint8_t N>
+class MedianFilter {
+    static_assert(N >= 3 && (N % 2) == 1, "MedianFilter窗口必须为不小于3的奇数");
+
+public:
+    MedianFilter() { reset(); }
+
+    T update(T value) {
+        if (_count == N) {
+            T oldest = _ring[_index];
+            uint8_t i = 0;
+            while (i + 1 < _count && _sorted[i] != oldest) i++;
+            for (; i + 1 < _count; i++) _sorted[i] = _sorted[i + 1];
+            _count--;
+        }
+        _ring[_index] = value;
+        if (++_index >= N) _index = 0;
+
+        uint8_t j = _count;
+        while (j > 0 && _sorted[j - 1] > value) {
+            _sorted[j] = _sorted[j - 1];
+            j--;
+        }
+        _sorted[j] = value;
+        _count++;
+        return this->value();
+    }
+
+    T value() const { return _count ? _sorted[(_count - 1) / 2] : T(); }
+    uint8_t count() const { return _count; }
+    void reset() { _index = 0; _count = 0; }
+
+private:
+    T _ring[N];
+    T _sorted[N];
+    uint8_t _index;
+    uint8_t _count;
+};
+
+#endif
@@ -0,0 +1,329 @@
+#include "TelemetryLog.h"
+
+#include <LittleFS.h>
+#include <Preferences.h>
+#include <string.h>
+
+namespace {
+
+void putU32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+uint32_t getU32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+}
+
+TelemetryLog::TelemetryLog()
+    : _mounted(false), _hasSegments(false), _startNewSegment(true), _tailSeq(0), _headSeq(0), _headSize(0),
+      _bufferLength(0), _readerOpen(false), _readOffset(TELEMETRY_LOG_SEGMENT_HEADER), _peekLength(0),
+      _backlogBytes(0), _stats() {
+}
+
+void TelemetryLog::segmentPath(uint32_t seq, char* path, size_t size) const {
+    snprintf(path, size, "%s/%u.bin", TELEMETRY_LOG_DIR, (unsigned)(seq % TELEMETRY_LOG_SEGMENTS));
+}
+
+bool TelemetryLog::begin() {
+    _mounted = LittleFS.begin(true);
+    if (!_mounted) {
+        Serial.println("遥测日志: LittleFS挂载失败");
+        return false;
+    }
+    LittleFS.mkdir(TELEMETRY_LOG_DIR);
+
+    // 扫描全部槽位：段头无效或槽位与段序号不符的文件删除
+    uint32_t seqs[TELEMETRY_LOG_SEGMENTS];
+    size_t sizes[TELEMETRY_LOG_SEGMENTS];
+    bool present[TELEMETRY_LOG_SEGMENTS];
+    char path[32];
+    for (uint8_t slot = 0; slot < TELEMETRY_LOG_SEGMENTS; slot++) {
+        present[slot] = false;
+        segmentPath(slot, path, sizeof(path));
+        if (!LittleFS.exists(path)) continue;
+        File f = LittleFS.open(path, FILE_READ);
+        uint8_t header[TELEMETRY_LOG_SEGMENT_HEADER];
+        bool ok = f && f.read(header, sizeof(header)) == sizeof(header) &&
+                  getU32(header) == TELEMETRY_LOG_MAGIC && getU32(header + 4) % TELEMETRY_LOG_SEGMENTS == slot;
+        if (ok) {
+            seqs[slot] = getU32(header + 4);
+            sizes[slot] = f.size();
+            present[slot] = true;
+        }
+        f.close();
+        if (!ok) LittleFS.remove(path);
+    }
+
+    _hasSegments = false;
+    for (uint8_t slot = 0; slot < TELEMETRY_LOG_SEGMENTS; slot++) {
+        if (!present[slot]) continue;
+        if (!_hasSegments || seqs[slot] > _headSeq) _headSeq = seqs[slot];
+        _hasSegments = true;
+    }
+    _backlogBytes = 0;
+    if (_hasSegments) {
+        _tailSeq = _headSeq;
+        for (uint8_t slot = 0; slot < TELEMETRY_LOG_SEGMENTS; slot++) {
+            if (!present[slot]) continue;
+            if (_headSeq - seqs[slot] >= TELEMETRY_LOG_SEGMENTS) {
+                segmentPath(slot, path, sizeof(path));
+                LittleFS.remove(path);
+                continue;
+            }
+            if (seqs[slot] < _tailSeq) _tailSeq = seqs[slot];
+            _backlogBytes += sizes[slot] - TELEMETRY_LOG_SEGMENT_HEADER;
+        }
+        _headSize = TELEMETRY_LOG_SEGMENT_SIZE;
+    }
+    _startNewSegment = true;
+    _readOffset = TELEMETRY_LOG_SEGMENT_HEADER;
+    _peekLength = 0;
+
+    Serial.print("遥测日志: 待补发字节 ");
+    Serial.print(_backlogBytes);
+    Serial.print(", 闪存已用/总量 ");
+    Serial.print((uint32_t)LittleFS.usedBytes());
+    Serial.print("/");
+    Serial.println((uint32_t)LittleFS.totalBytes());
+    return true;
+}
+
+bool TelemetryLog::append(const uint8_t* frame, size_t len) {
+    if (!_mounted || len == 0 || len > TELEMETRY_LOG_WRITE_BLOCK) return false;
+    if (_bufferLength + len > TELEMETRY_LOG_WRITE_BLOCK) flush();
+    uint8_t* p = _buffer + _bufferLength;
+    memcpy(p, frame, len);
+    telemetryAddFrameFlags(p, len, TELEMETRY_FRAME_BACKFILL);
+    _bufferLength += len;
+    _backlogBytes += len;
+    _stats.storedFrames++;
+    _stats.storedBytes += len;
+    return true;
+}
+
+void TelemetryLog::flush() {
+    if (!_mounted || _bufferLength == 0) return;
+    size_t written = 0;
+    if ((_hasSegments && !_startNewSegment && _headSize + _bufferLength <= TELEMETRY_LOG_SEGMENT_SIZE) ||
+        openNewSegment()) {
+        // 正在读的段要追加：关闭读句柄，下次重新打开才能读到新写入的部分
+        if (_readerOpen && _tailSeq == _headSeq) closeReader();
+        char path[32];
+        segmentPath(_headSeq, path, sizeof(path));
+        File f = LittleFS.open(path, FILE_APPEND);
+        written = f ? f.write(_buffer, _bufferLength) : 0;
+        f.close();
+        _stats.flashWrites++;
+        _stats.flashBytes += written;
+    }
+    if (written != _bufferLength) {
+        // 写失败或新段建不起来（分区满等）：这一块丢弃，保持段内只有完整的帧；
+        // 缓冲总是清空，调用方（append、peek）不会因为重试同一块而卡住
+        _backlogBytes -= _bufferLength;
+        _stats.writeErrors++;
+        _startNewSegment = true;
+    } else {
+        _headSize += written;
+    }
+    _bufferLength = 0;
+}
+
+bool TelemetryLog::openNewSegment() {
+    uint32_t seq = _hasSegments ? _headSeq + 1 : 0;
+    // 环满：最旧的段（可能还未补发）让出槽位
+    if (_hasSegments && seq - _tailSeq >= TELEMETRY_LOG_SEGMENTS) dropTailSegment(true);
+
+    char path[32];
+    segmentPath(seq, path, sizeof(path));
+    File f = LittleFS.open(path, FILE_WRITE);
+    uint8_t header[TELEMETRY_LOG_SEGMENT_HEADER];
+    putU32(header, TELEMETRY_LOG_MAGIC);
+    putU32(header + 4, seq);
+    bool ok = f && f.write(header, sizeof(header)) == sizeof(header);
+    f.close();
+    _stats.flashWrites++;
+    if (!ok) {
+        LittleFS.remove(path);
+        return false;
+    }
+    if (!_hasSegments) {
+        _tailSeq = seq;
+        _readOffset = TELEMETRY_LOG_SEGMENT_HEADER;
+    }
+    _hasSegments = true;
+    _headSeq = seq;
+    _headSize = TELEMETRY_LOG_SEGMENT_HEADER;
+    _startNewSegment = false;
+    return true;
+}
+
+void TelemetryLog::dropTailSegment(bool unread) {
+    char path[32];
+    segmentPath(_tailSeq, path, sizeof(path));
+    if (unread) {
+        File f = LittleFS.open(path, FILE_READ);
+        size_t size = f ? f.size() : 0;
+        f.close();
+        uint32_t remaining = size > _readOffset ? (uint32_t)(size - _readOffset) : 0;
+        _backlogBytes = _backlogBytes > remaining ? _backlogBytes - remaining : 0;
+        if (remaining) _stats.overwrittenSegments++;
+    }
+    closeReader();
+    LittleFS.remove(path);
+    _peekLength = 0;
+    _readOffset = TELEMETRY_LOG_SEGMENT_HEADER;
+    if (_tailSeq == _headSeq) {
+        _hasSegments = false;
+        _startNewSegment = true;
+    } else {
+        _tailSeq++;
+    }
+}
+
+bool TelemetryLog::openReader() {
+    if (_readerOpen) return true;
+    char path[32];
+    segmentPath(_tailSeq, path, sizeof(path));
+    _reader = LittleFS.open(path, FILE_READ);
+    _readerOpen = (bool)_reader;
+    return _readerOpen;
+}
+
+void TelemetryLog::closeReader() {
+    if (_readerOpen) _reader.close();
+    _readerOpen = false;
+}
+
+size_t TelemetryLog::peek(uint8_t* buf, size_t cap) {
+    if (!_mounted) return 0;
+    while (true) {
+        if (!_hasSegments) {
+            if (_bufferLength == 0) return 0;
+            flush();
+            if (!_hasSegments) return 0;
+        }
+        // 段缺失（删除过程中掉电等）：跳过
+        if (!openReader()) {
+            dropTailSegment(false);
+            continue;
+        }
+
+        size_t size = _reader.size();
+        size_t available = size > _readOffset ? size - _readOffset : 0;
+        size_t len = 0;
+        if (available >= TELEMETRY_HEADER_SIZE && _reader.seek(_readOffset) &&
+            _reader.read(buf, TELEMETRY_HEADER_SIZE) == TELEMETRY_HEADER_SIZE) {
+            len = telemetryFrameLength(buf, TELEMETRY_HEADER_SIZE);
+            if (len == 0 || len > cap) {
+                // 帧头无效：段内剩余部分无法再定位帧边界，整段跳过
+                _stats.corruptFrames++;
+                _backlogBytes = _backlogBytes > available ? _backlogBytes - (uint32_t)available : 0;
+                _readOffset = size;
+                len = 0;
+                available = 0;
+            }
+        }
+
+        if (len == 0 || len > available) {
+            // 段已读完（或以掉电时写了一半的帧结尾）
+            if (available > 0) {
+                _stats.corruptFrames++;
+                _backlogBytes = _backlogBytes > available ? _backlogBytes - (uint32_t)available : 0;
+            }
+            if (_tailSeq == _headSeq && _bufferLength > 0) {
+                // 最新段读完但内存中还有帧：先写入闪存，再继续读
+                closeReader();
+                _readOffset = size;
+                flush();
+                if (_bufferLength > 0) return 0;
+                continue;
+            }
+            dropTailSegment(false);
+            continue;
+        }
+
+        size_t rest = len - TELEMETRY_HEADER_SIZE;
+        if (_reader.read(buf + TELEMETRY_HEADER_SIZE, rest) != rest || !telemetryFrameValid(buf, len)) {
+            _stats.corruptFrames++;
+            _readOffset += len;
+            _backlogBytes = _backlogBytes > len ? _backlogBytes - (uint32_t)len : 0;
+            continue;
+        }
+        _peekLength = len;
+        return len;
+    }
+}
+
+void TelemetryLog::pop() {
+    if (_peekLength == 0) return;
+    _readOffset += _peekLength;
+    _backlogBytes = _backlogBytes > _peekLength ? _backlogBytes - (uint32_t)_peekLength : 0;
+    _stats.replayedFrames++;
+    _stats.replayedBytes += _peekLength;
+    _peekLength = 0;
+}
+
+void TelemetryLog::clear() {
+    closeReader();
+    char path[32];
+    for (uint8_t slot = 0; slot < TELEMETRY_LOG_SEGMENTS; slot++) {
+        segmentPath(slot, path, sizeof(path));
+        if (LittleFS.exists(path)) LittleFS.remove(path);
+    }
+    _hasSegments = false;
+    _startNewSegment = true;
+    _bufferLength = 0;
+    _backlogBytes = 0;
+    _readOffset = TELEMETRY_LOG_SEGMENT_HEADER;
+    _peekLength = 0;
+}
+
+TelemetryLogStats TelemetryLog::getStats() const {
+    TelemetryLogStats s = _stats;
+    s.backlogBytes = _backlogBytes;
+    s.segments = _hasSegments ? (uint8_t)(_headSeq - _tailSeq + 1) : 0;
+    s.mounted = _mounted;
+    return s;
+}
+
+void TelemetryLog::printStats() const {
+    TelemetryLogStats s = getStats();
+    Serial.println("=== 遥测日志 ===");
+    Serial.print("存入帧: ");
+    Serial.print(s.storedFrames);
+    Serial.print(", 已补发: ");
+    Serial.print(s.replayedFrames);
+    Serial.print(", 待补发字节: ");
+    Serial.print(s.backlogBytes);
+    Serial.print(", 段: ");
+    Serial.println(s.segments);
+    Serial.print("闪存写入: ");
+    Serial.print(s.flashWrites);
+    Serial.print(" 次/");
+    Serial.print(s.flashBytes);
+    Serial.print(" 字节, 覆盖段: ");
+    Serial.print(s.overwrittenSegments);
+    Serial.print(", 损坏帧: ");
+    Serial.print(s.corruptFrames);
+    Serial.print(", 写失败: ");
+    Serial.println(s.writeErrors);
+}
+
+uint16_t telemetryNextBootId() {
+    Preferences prefs;
+    uint16_t boot = 0;
+    if (prefs.begin(TELEMETRY_PREFS_NAMESPACE, false)) {
+        if (prefs.getBytesLength(TELEMETRY_PREFS_BOOT_KEY) == sizeof(boot)) {
+            prefs.getBytes(TELEMETRY_PREFS_BOOT_KEY, &boot, sizeof(boot));
+        }
+        boot++;
+        prefs.putBytes(TELEMETRY_PREFS_BOOT_KEY, &boot, sizeof(boot));
+        prefs.end();
+    }
+    return boot;
+}
@@ -0,0 +1,94 @@
+#ifndef TelemetryLog_h
+#define TelemetryLog_h
+
+#include <Arduino.h>
+#include <FS.h>
+
+#include "TelemetryProtocol.h"
+
+// 闪存遥测日志配置
+constexpr uint8_t TELEMETRY_LOG_SEGMENTS = 16;              // 环形段数（满时覆盖最旧的段）
+constexpr size_t TELEMETRY_LOG_SEGMENT_SIZE = 64 * 1024;     // 每段上限：共1MB，200Hz二进制遥测约3分钟
+constexpr size_t TELEMETRY_LOG_WRITE_BLOCK = 4096;           // 攒满一个擦除扇区再写一次闪存
+constexpr uint32_t TELEMETRY_LOG_MAGIC = 0x31474C54;         // "TLG1"
+constexpr size_t TELEMETRY_LOG_SEGMENT_HEADER = 8;           // magic u32 | 段序号 u32
+constexpr const char* TELEMETRY_LOG_DIR = "/tlog";
+constexpr const char* TELEMETRY_PREFS_NAMESPACE = "telemetry";
+constexpr const char* TELEMETRY_PREFS_BOOT_KEY = "boot";
+
+struct TelemetryLogStats {
+    uint32_t storedFrames;
+    uint32_t storedBytes;
+    uint32_t replayedFrames;        // 已补发（pop）的帧
+    uint32_t replayedBytes;
+    uint32_t overwrittenSegments;   // 未补发就被覆盖的段
+    uint32_t corruptFrames;         // 读出时帧头或CRC无效（掉电时写了一半）而跳过
+    uint32_t writeErrors;           // 写闪存失败（分区满等），该块丢弃
+    uint32_t flashWrites;           // 写闪存次数
+    uint32_t flashBytes;
+    uint32_t backlogBytes;          // 尚未补发的字节（含内存中未写入闪存的部分）
+    uint8_t segments;               // 当前存在的段
+    bool mounted;
+};
+
+// LittleFS上的只追加环形遥测日志：断线时整帧存入（标记TELEMETRY_FRAME_BACKFILL），重连后按
+// 存入顺序读出补发。
+//   段文件 /tlog/<段序号 % 段数>.bin，开头记录段序号，启动时扫描全部槽位恢复最旧/最新段；
+//   帧先攒在内存中，满一个擦除扇区才追加写入一次，帧不跨段；段写满后开新段，环满时删除
+//   最旧的段。每个扇区每绕环一周只擦写一次，LittleFS再在整个分区上做磨损均衡。
+//   补发成功的帧才pop()；读完的段整段删除。重启后从最旧段的开头重读，已补发过的帧由接收端
+//   按(bootId, frameSeq)去重。掉电时最多丢失内存中不足一个扇区的帧，写了一半的帧由CRC识别跳过。
+class TelemetryLog {
+public:
+    TelemetryLog();
+
+    // 挂载文件系统并扫描已有的段（首次使用时格式化）
+    bool begin();
+    bool isReady() const { return _mounted; }
+
+    // 存入一帧（复制并加上补发标志，压缩帧原样保存）；环满时覆盖最旧的段
+    bool append(const uint8_t* frame, size_t len);
+    // 把内存中的帧写入闪存
+    void flush();
+
+    bool hasBacklog() const { return _backlogBytes > 0; }
+    // 取出最旧的未补发帧（不移除），返回帧长度，没有时返回0；发送成功后调用pop()
+    size_t peek(uint8_t* buf, size_t cap);
+    void pop();
+
+    // 删除全部段
+    void clear();
+
+    TelemetryLogStats getStats() const;
+    void printStats() const;
+
+private:
+    void segmentPath(uint32_t seq, char* path, size_t size) const;
+    bool openNewSegment();
+    void dropTailSegment(bool unread);
+    bool openReader();
+    void closeReader();
+
+    bool _mounted;
+    bool _hasSegments;
+    bool _startNewSegment;          // 启动后不续写可能以半帧结尾的旧段
+    uint32_t _tailSeq;              // 最旧的未补发段
+    uint32_t _headSeq;              // 正在写入的段
+    size_t _headSize;
+
+    uint8_t _buffer[TELEMETRY_LOG_WRITE_BLOCK];
+    size_t _bufferLength;
+
+    File _reader;
+    bool _readerOpen;
+    size_t _readOffset;             // 最旧段中下一帧的位置
+    size_t _peekLength;
+    uint32_t _backlogBytes;
+
+    TelemetryLogStats _stats;
+};
+
+// 启动计数：每次调用加1并保存到闪存（Preferences），作为遥测帧的bootId
+uint16_t telemetryNextBootId();
+
+#endif
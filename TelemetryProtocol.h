@@ -0,0 +1,328 @@
+#ifndef TelemetryProtocol_h
+#define TelemetryProtocol_h
+
+// 二进制遥测帧：固件编码、主机解码共用，不依赖Arduino，主机工具可直接编译。
+//
+// 帧 = 帧头(34字节) + 负载 + CRC-32(4字节)，全部小端。负载为recordCount条同一类型的定长记录
+// （每条recordSize字节），或压缩后的样本记录（帧标志TELEMETRY_FRAME_COMPRESSED，见下）：
+//   帧头: A5 5A | version u8 | headerSize u8 | recordSize u8 | recordCount u8 | dropped u16 |
+//         frameSeq u32 | firstSeq u32 | basePressureKpa f32 | sampleRateHz u16 | baseTemperature i16(0.01°C) |
+//         sendTimeUs u32（版本2追加：设备发出该帧时的micros()，接收端据此计算单向延迟）|
+//         bootId u16 | frameFlags u8 | recordType u8（版本3追加：启动计数和帧标志；版本5起保留字节为记录类型）|
+//         payloadLength u16（版本4追加：负载字节数；更早的版本按recordCount*recordSize计算）
+//   样本记录: timestampUs u32 | seq低16位 u16 | state u8 | flags u8 | pressureKpa f32 | backupPressureKpa f32 |
+//         flowRate f32(ml/min) | temperature i16(0.01°C) | co2 u16(ppm) | oxygen u16(0.01%) | valve u16(满量程65535)
+//   窗口记录（降采样模式）: firstSeq u32 | timestampUs u32 | count u8 | state u8 | flags u8 | 保留 u8 |
+//         压力最小/最大/平均 f32×3 | 备用气压平均 f32 | 流量平均 f32 | 温度 i16 | co2 u16 | oxygen u16 |
+//         气阀平均 u16 | 气阀最大 u16
+//   呼吸记录（逐次呼吸摘要模式）: breathIndex u32 | timestampUs u32 | PIP f32 | PEEP f32 | 频率 f32 | 吸呼比 f32 |
+//         Ti u32(ms) | Te u32(ms) | 潮气量 f32 | 触发延迟 f32 | 顺应性 f32 | 阻力 f32
+//   模式切换记录: timestampUs u32 | nextSeq u32 | fromMode u8 | toMode u8 | reason u8 | 队列占用 u8(%) |
+//         吞吐 u32(字节/秒) | 发送端积压 u16 | 被拒绝的发送 u16
+//   非样本帧的firstSeq为首条记录的序号字段（窗口firstSeq、呼吸序号、模式切换nextSeq）。
+//   CRC-32(IEEE 802.3)覆盖帧头和负载。
+// 压缩负载是逐条记录追加的位流（高位在前），每帧从零状态开始，帧之间互不依赖（UDP丢帧、补发都可单独解码）：
+//   时间戳: 第1条varint原值，第2条zigzag差值，之后zigzag二阶差分（定速采样时为0，1字节）
+//   seq低16位: zigzag(与上一条的差 - 1)（第1条相对firstSeq）
+//   state/flags: 1位"未变"，变化时1位+两个字节
+//   主/备用气压、流量(f32): Gorilla式异或——与上一个值相同1位；有效位落在上一个窗口内时2位+窗口位数；
+//     否则2位+5位前导零+5位(有效位数-1)+有效位
+//   温度/CO2/氧/气阀(u16): zigzag差值varint
+// 压缩针对记录的线路编码（定点量化之后）逐位无损；压缩后不小于原始记录时该帧按原始记录发送。
+// headerSize/recordSize随帧发送：新版本只在末尾追加字段，旧解码器按长度跳过不认识的部分。
+
+#include <stddef.h>
+#include <stdint.h>
+
+constexpr uint8_t TELEMETRY_SYNC_0 = 0xA5;
+constexpr uint8_t TELEMETRY_SYNC_1 = 0x5A;
+constexpr uint8_t TELEMETRY_VERSION = 5;
+constexpr size_t TELEMETRY_HEADER_SIZE = 34;
+constexpr size_t TELEMETRY_MIN_HEADER_SIZE = 24;    // 版本1帧头（无发送时刻）
+constexpr size_t TELEMETRY_V2_HEADER_SIZE = 28;     // 版本2帧头（无启动计数和帧标志）
+constexpr size_t TELEMETRY_V3_HEADER_SIZE = 32;     // 版本3帧头（无负载长度）
+constexpr size_t TELEMETRY_RECORD_SIZE = 28;
+constexpr size_t TELEMETRY_WINDOW_RECORD_SIZE = 42;
+constexpr size_t TELEMETRY_BREATH_RECORD_SIZE = 48;
+constexpr size_t TELEMETRY_MODE_RECORD_SIZE = 20;
+constexpr size_t TELEMETRY_CRC_SIZE = 4;
+constexpr uint8_t TELEMETRY_MAX_BATCH = 40;         // 单帧最多记录数（200Hz下200ms）
+constexpr size_t TELEMETRY_MAX_FRAME_SIZE = TELEMETRY_HEADER_SIZE + TELEMETRY_MAX_BATCH * TELEMETRY_RECORD_SIZE + TELEMETRY_CRC_SIZE;
+constexpr size_t TELEMETRY_DECODER_MAX_FRAME = 4096; // 解码器接受的最大帧（容纳更大的新版本记录）
+
+// 记录状态位：低4位表示可选字段有效，高位为控制器状态
+constexpr uint8_t TELEMETRY_FLAG_BACKUP = 0x01;       // 备用气压有效
+constexpr uint8_t TELEMETRY_FLAG_FLOW = 0x02;         // 流量有效
+constexpr uint8_t TELEMETRY_FLAG_CO2 = 0x04;          // CO2有效
+constexpr uint8_t TELEMETRY_FLAG_OXYGEN = 0x08;       // 氧浓度有效
+constexpr uint8_t TELEMETRY_FLAG_BASE_SET = 0x10;     // 基准气压已标定
+constexpr uint8_t TELEMETRY_FLAG_PRE_ACTUATING = 0x20; // 预测提前开阀窗口内
+constexpr uint8_t TELEMETRY_FLAG_VALVE_SWEEP = 0x40;  // 气阀特性扫描进行中（气阀不受控）
+
+// 帧标志
+constexpr uint8_t TELEMETRY_FRAME_BACKFILL = 0x01;    // 断线期间存入闪存、重连后补发的帧（sendTimeUs为存入时刻）
+constexpr uint8_t TELEMETRY_FRAME_COMPRESSED = 0x02;  // 负载为压缩位流
+
+// 记录类型（帧头recordType，每帧只含一种）
+constexpr uint8_t TELEMETRY_RECORD_SAMPLE = 0;        // 逐样本记录（版本5之前的帧都是）
+constexpr uint8_t TELEMETRY_RECORD_WINDOW = 1;        // 窗口聚合
+constexpr uint8_t TELEMETRY_RECORD_BREATH = 2;        // 逐次呼吸摘要
+constexpr uint8_t TELEMETRY_RECORD_MODE = 3;          // 遥测模式切换
+
+// 遥测模式：链路变差时逐级降低数据量
+constexpr uint8_t TELEMETRY_MODE_FULL = 0;            // 全速逐样本
+constexpr uint8_t TELEMETRY_MODE_DECIMATED = 1;       // 每窗口最小/最大/平均
+constexpr uint8_t TELEMETRY_MODE_SUMMARY = 2;         // 只发逐次呼吸摘要
+constexpr uint8_t TELEMETRY_MODE_COUNT = 3;
+
+// 模式切换原因
+constexpr uint8_t TELEMETRY_MODE_REASON_MANUAL = 0;   // 设置固定模式
+constexpr uint8_t TELEMETRY_MODE_REASON_CONGESTION = 1; // 发送被拒绝、发送端积压或队列占用过高
+constexpr uint8_t TELEMETRY_MODE_REASON_RECOVERY = 2; // 持续通畅后试探升级
+
+// 一条遥测记录的解码形式；无效字段为NAN
+struct TelemetryRecord {
+    uint32_t seq;
+    uint32_t timestampUs;
+    float pressureKpa;
+    float backupPressureKpa;
+    float flowRate;
+    float temperatureC;
+    float co2Ppm;
+    float oxygenPercent;
+    float valveFraction;        // 气阀开度 0~1
+    uint8_t state;              // BreathState
+    uint8_t flags;              // TELEMETRY_FLAG_*
+};
+
+// 窗口聚合记录：连续count个样本；无效字段为NAN
+struct TelemetryWindowRecord {
+    uint32_t firstSeq;
+    uint32_t timestampUs;       // 窗口第一个样本
+    uint8_t count;
+    uint8_t state;              // 窗口最后一个样本的呼吸状态
+    uint8_t flags;              // 窗口内状态位的并集（可选字段有效位为全部样本都有效）
+    float pressureMinKpa;
+    float pressureMaxKpa;
+    float pressureMeanKpa;
+    float backupPressureKpa;    // 以下为窗口平均
+    float flowRate;
+    float temperatureC;
+    float co2Ppm;
+    float oxygenPercent;
+    float valveMean;            // 0~1
+    float valveMax;
+};
+
+// 逐次呼吸摘要记录（字段含义同BreathAnalyzer的BreathRecord）
+struct TelemetryBreathRecord {
+    uint32_t breathIndex;
+    uint32_t timestampUs;
+    float pipKpa;
+    float peepKpa;
+    float respiratoryRate;
+    float ieRatio;
+    uint32_t inspiratoryTimeMs;
+    uint32_t expiratoryTimeMs;
+    float tidalVolumeMl;
+    float triggerDelayMs;
+    float complianceMlCmH2O;
+    float resistanceCmH2O;
+};
+
+// 模式切换记录：切换时刻和切换前评估窗口的链路状况
+struct TelemetryModeChange {
+    uint32_t timestampUs;
+    uint32_t nextSeq;           // 切换后第一个样本的seq（接收端据此接续样本跳号统计）
+    uint8_t fromMode;
+    uint8_t toMode;
+    uint8_t reason;             // TELEMETRY_MODE_REASON_*
+    uint8_t queuePercent;       // 跨核队列最高占用
+    uint32_t throughputBps;     // 实际写出的字节/秒
+    uint16_t backlogBytes;      // 发送端最大积压
+    uint16_t rejected;          // 被拒绝的发送
+};
+
+struct TelemetryFrameHeader {
+    uint8_t version;
+    uint8_t headerSize;
+    uint8_t recordSize;
+    uint8_t recordCount;
+    uint16_t dropped;           // 上一帧之后因未连接等原因丢弃的样本数
+    uint32_t frameSeq;
+    uint32_t firstSeq;
+    float basePressureKpa;
+    uint16_t sampleRateHz;
+    float baseTemperatureC;
+    uint32_t sendTimeUs;        // 版本1帧取最后一条记录的时间戳
+    bool hasSendTime;
+    uint16_t bootId;            // 设备启动计数，与frameSeq一起唯一标识一帧（版本3之前为0）
+    uint8_t frameFlags;         // TELEMETRY_FRAME_*
+    uint16_t payloadLength;     // 负载字节数（压缩帧小于recordCount*recordSize）
+    uint8_t recordType;         // TELEMETRY_RECORD_*（版本5之前为样本）
+};
+
+uint32_t telemetryCrc32(const uint8_t* data, size_t len, uint32_t crc = 0);
+
+// 由帧头计算整帧长度（含CRC）；不是合法帧头时返回0。版本4起长度在帧头末尾，
+// 需要min(headerSize, TELEMETRY_HEADER_SIZE)字节，不足时也返回0
+size_t telemetryFrameLength(const uint8_t* data, size_t len);
+// 整帧CRC校验
+bool telemetryFrameValid(const uint8_t* frame, size_t len);
+// 给版本3及以后的帧加上帧标志并重算CRC（旧版本帧返回false）
+bool telemetryAddFrameFlags(uint8_t* frame, size_t len, uint8_t flags);
+// 各记录类型的最小记录长度（未知类型为1，解码时跳过）
+size_t telemetryMinRecordSize(uint8_t recordType);
+const char* telemetryModeName(uint8_t mode);
+const char* telemetryModeReasonName(uint8_t reason);
+
+// 压缩位流的逐记录状态（编码、解码各一份，每帧开始时清零）
+struct TelemetryPackState {
+    uint8_t index;
+    uint32_t timestampUs;
+    uint32_t timestampDelta;
+    uint16_t seq;
+    uint8_t state;
+    uint8_t flags;
+    uint32_t floatBits[3];
+    uint8_t leading[3];         // 上一个异或窗口，32表示还没有窗口
+    uint8_t trailing[3];
+    uint16_t fixed[4];
+};
+
+// 批量编码：add()追加记录，满batchSize条（或帧容量）返回true，随后finish()生成完整帧。
+// 每帧只含一种记录：追加不同类型的记录前先finish()，否则记录被拒绝（返回true）
+class TelemetryEncoder {
+public:
+    explicit TelemetryEncoder(uint8_t batchSize = TELEMETRY_MAX_BATCH);
+
+    void setBatchSize(uint8_t batchSize);
+    uint8_t batchSize() const { return _batchSize; }
+    void setSampleRate(uint16_t rateHz) { _sampleRateHz = rateHz; }
+    void setBase(float pressureKpa, float temperatureC) { _basePressureKpa = pressureKpa; _baseTemperatureC = temperatureC; }
+    void setBootId(uint16_t bootId) { _bootId = bootId; }
+
+    // 压缩负载（默认关闭）：逐条记录在add()时压缩，开销均摊到每个样本
+    void setCompression(bool enable) { _compress = enable; }
+    bool compression() const { return _compress; }
+
+    bool add(const TelemetryRecord& record);
+    bool addWindow(const TelemetryWindowRecord& record);
+    bool addBreath(const TelemetryBreathRecord& record);
+    bool addModeChange(const TelemetryModeChange& record);
+    uint8_t pending() const { return _finished ? 0 : _count; }
+    bool full() const;
+    // 待发记录的类型（无待发记录时任何类型都可追加）
+    uint8_t recordType() const { return _recordType; }
+    bool accepts(uint8_t recordType) const { return pending() == 0 || recordType == _recordType; }
+
+    // 写入帧头和CRC，返回帧长度（无待发记录返回0）；帧内容在下一次add()之前有效。
+    // sendTimeUs为设备发送时刻（micros()）
+    size_t finish(uint32_t sendTimeUs = 0);
+    const uint8_t* data() const { return _buffer; }
+
+    // 记录未能发送的样本（帧发送失败或未连接），计入下一帧的dropped字段
+    void addDropped(uint32_t count);
+    uint32_t frameSeq() const { return _frameSeq; }
+
+private:
+    uint8_t* beginRecord(uint8_t type, size_t size, uint32_t seq);
+    void pack(const uint8_t* record);
+    void putBits(uint32_t value, uint8_t bits);
+    void putVarint(uint32_t value);
+    void putFloat(uint8_t channel, uint32_t bits);
+    size_t flushBits();
+
+    uint8_t _buffer[TELEMETRY_MAX_FRAME_SIZE];
+    uint8_t _batchSize;
+    uint8_t _count;
+    uint8_t _recordType;
+    uint8_t _recordSize;
+    bool _finished;
+    uint32_t _frameSeq;
+    uint32_t _firstSeq;
+    uint32_t _dropped;
+    uint16_t _sampleRateHz;
+    uint16_t _bootId;
+    float _basePressureKpa;
+    float _baseTemperatureC;
+
+    bool _compress;
+    TelemetryPackState _pack;
+    uint8_t _packed[TELEMETRY_MAX_BATCH * TELEMETRY_RECORD_SIZE];  // 超过原始记录大小即放弃压缩
+    size_t _packedLength;
+    uint64_t _bitBuffer;
+    uint8_t _bitCount;
+    bool _packing;                  // 本帧正在压缩（开启压缩且尚未超出原始大小）
+};
+
+struct TelemetryDecoderStats {
+    uint32_t frames;            // CRC正确的帧
+    uint32_t records;           // 样本记录
+    uint32_t windowRecords;
+    uint32_t breathRecords;
+    uint32_t modeChanges;
+    uint32_t unknownFrames;     // 不认识的记录类型（跳过）
+    uint32_t crcErrors;
+    uint32_t badHeaders;        // 版本或长度字段不合法
+    uint32_t skippedBytes;      // 重新同步时丢掉的字节
+    uint32_t lostFrames;        // frameSeq跳号（按到达顺序统计，只适用于TCP等有序流；不含补发帧）
+    uint32_t lostSamples;       // 样本seq跳号（含设备端dropped）
+    uint32_t backfillFrames;    // 补发帧（不参与跳号统计，去重见主机端TelemetryDeduplicator）
+    uint32_t compressedFrames;
+    uint32_t badPayloads;       // CRC正确但负载长度与记录数不符，或压缩负载无法还原（版本不匹配）
+    uint32_t payloadBytes;      // 全部帧的负载字节（压缩后）
+    uint32_t reboots;           // bootId变化次数（跳号统计从新的启动重新开始）
+};
+
+// 流式解码：任意切分的字节流喂给feed()，每帧、每条记录各回调一次。
+// 同步字节搜索帧头，CRC错误时从下一个字节重新同步；UDP数据报逐个feed()即可
+class TelemetryDecoder {
+public:
+    typedef void (*RecordCallback)(void* context, const TelemetryFrameHeader& header, const TelemetryRecord& record);
+    typedef void (*FrameCallback)(void* context, const TelemetryFrameHeader& header);
+    typedef void (*WindowCallback)(void* context, const TelemetryFrameHeader& header, const TelemetryWindowRecord& record);
+    typedef void (*BreathCallback)(void* context, const TelemetryFrameHeader& header, const TelemetryBreathRecord& record);
+    typedef void (*ModeCallback)(void* context, const TelemetryFrameHeader& header, const TelemetryModeChange& record);
+
+    TelemetryDecoder();
+    void setCallback(RecordCallback callback, void* context) { _callback = callback; _context = context; }
+    void setFrameCallback(FrameCallback callback, void* context) { _frameCallback = callback; _frameContext = context; }
+    // 非样本记录的回调共用一个context
+    void setSummaryCallbacks(WindowCallback window, BreathCallback breath, ModeCallback mode, void* context) {
+        _windowCallback = window;
+        _breathCallback = breath;
+        _modeCallback = mode;
+        _summaryContext = context;
+    }
+
+    void feed(const uint8_t* data, size_t len);
+    const TelemetryDecoderStats& stats() const { return _stats; }
+    void reset();
+    // 丢弃缓冲中未成帧的字节，保留统计（按数据报边界解码时使用）
+    void resetStream() { _length = 0; }
+
+private:
+    void process();
+    void deliver();
+    void deliverSummary(const TelemetryFrameHeader& header, const uint8_t* payload);
+    void consume(size_t n);
+
+    uint8_t _buffer[TELEMETRY_DECODER_MAX_FRAME];
+    size_t _length;
+    RecordCallback _callback;
+    void* _context;
+    FrameCallback _frameCallback;
+    void* _frameContext;
+    WindowCallback _windowCallback;
+    BreathCallback _breathCallback;
+    ModeCallback _modeCallback;
+    void* _summaryContext;
+    TelemetryDecoderStats _stats;
+    bool _hasLast;
+    uint16_t _lastBootId;
+    uint32_t _lastFrameSeq;
+    uint32_t _nextSeq;
+};
+
+#endif
@@ -0,0 +1,215 @@
+#include "TelemetryShaper.h"
+
+#include <math.h>
+#include <string.h>
+
+namespace {
+constexpr uint8_t OPTIONAL_FLAGS = TELEMETRY_FLAG_BACKUP | TELEMETRY_FLAG_FLOW | TELEMETRY_FLAG_CO2 | TELEMETRY_FLAG_OXYGEN;
+}
+
+// ---------------- 窗口聚合 ----------------
+
+TelemetryDecimator::TelemetryDecimator() {
+    memset(&_window, 0, sizeof(_window));
+    reset();
+}
+
+void TelemetryDecimator::reset() {
+    _count = 0;
+    _validFlags = OPTIONAL_FLAGS;
+    _controlFlags = 0;
+    _state = 0;
+    _firstSeq = 0;
+    _firstTimestampUs = 0;
+    _min = INFINITY;
+    _max = -INFINITY;
+    for (uint8_t i = 0; i < 7; i++) _sum[i] = 0;
+    _valveMax = 0;
+}
+
+bool TelemetryDecimator::add(const TelemetryRecord& r) {
+    if (_count == 0) {
+        _firstSeq = r.seq;
+        _firstTimestampUs = r.timestampUs;
+    }
+    // 可选字段按编码器的规则判断有效性：窗口内有一个样本无效则整窗无效
+    uint8_t valid = 0;
+    if (!isnan(r.backupPressureKpa)) valid |= TELEMETRY_FLAG_BACKUP;
+    if (!isnan(r.flowRate)) valid |= TELEMETRY_FLAG_FLOW;
+    if (!isnan(r.co2Ppm)) valid |= TELEMETRY_FLAG_CO2;
+    if (!isnan(r.oxygenPercent)) valid |= TELEMETRY_FLAG_OXYGEN;
+    _validFlags &= valid;
+    _controlFlags |= r.flags & ~OPTIONAL_FLAGS;
+    _state = r.state;
+
+    if (r.pressureKpa < _min) _min = r.pressureKpa;
+    if (r.pressureKpa > _max) _max = r.pressureKpa;
+    float valve = isnan(r.valveFraction) ? 0 : r.valveFraction;
+    const float values[7] = {r.pressureKpa, r.backupPressureKpa, r.flowRate, r.temperatureC,
+                             r.co2Ppm, r.oxygenPercent, valve};
+    for (uint8_t i = 0; i < 7; i++) _sum[i] += values[i];
+    if (valve > _valveMax) _valveMax = valve;
+
+    if (++_count < TELEMETRY_DECIMATION_WINDOW) return false;
+    finishWindow();
+    return true;
+}
+
+bool TelemetryDecimator::flush() {
+    if (_count == 0) return false;
+    finishWindow();
+    return true;
+}
+
+void TelemetryDecimator::finishWindow() {
+    float n = _count;
+    _window.firstSeq = _firstSeq;
+    _window.timestampUs = _firstTimestampUs;
+    _window.count = _count;
+    _window.state = _state;
+    _window.flags = _validFlags | _controlFlags;
+    _window.pressureMinKpa = _min;
+    _window.pressureMaxKpa = _max;
+    _window.pressureMeanKpa = _sum[0] / n;
+    _window.backupPressureKpa = (_validFlags & TELEMETRY_FLAG_BACKUP) ? _sum[1] / n : NAN;
+    _window.flowRate = (_validFlags & TELEMETRY_FLAG_FLOW) ? _sum[2] / n : NAN;
+    _window.temperatureC = _sum[3] / n;
+    _window.co2Ppm = (_validFlags & TELEMETRY_FLAG_CO2) ? _sum[4] / n : NAN;
+    _window.oxygenPercent = (_validFlags & TELEMETRY_FLAG_OXYGEN) ? _sum[5] / n : NAN;
+    _window.valveMean = _sum[6] / n;
+    _window.valveMax = _valveMax;
+    reset();
+}
+
+// ---------------- 模式控制 ----------------
+
+TelemetryShaper::TelemetryShaper()
+    : _adaptive(true), _mode(TELEMETRY_MODE_FULL), _intervalStartMs(0), _intervalBytes(0), _intervalRejected(0),
+      _intervalBacklog(0), _intervalQueuePercent(0), _settling(false), _probing(false), _cleanMs(0),
+      _probeHoldMs(TELEMETRY_PROBE_MIN_MS) {
+    memset(&_change, 0, sizeof(_change));
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void TelemetryShaper::setMode(uint8_t mode, unsigned long nowMs) {
+    _adaptive = false;
+    if (mode >= TELEMETRY_MODE_COUNT || mode == _mode) return;
+    switchTo(mode, TELEMETRY_MODE_REASON_MANUAL, nowMs);
+}
+
+void TelemetryShaper::onSend(size_t bytes, bool accepted) {
+    if (accepted) {
+        _intervalBytes += bytes;
+    } else if (_intervalRejected < 0xFFFF) {
+        _intervalRejected++;
+    }
+}
+
+bool TelemetryShaper::update(unsigned long nowMs, bool linkUp, size_t backlogBytes, size_t queueDepth,
+                             size_t queueCapacity) {
+    // 断线由重连和存储转发处理，不当作带宽不足
+    if (!linkUp) {
+        resetInterval(nowMs);
+        _settling = false;
+        _cleanMs = 0;
+        return false;
+    }
+    if (backlogBytes > _intervalBacklog) _intervalBacklog = backlogBytes;
+    uint8_t queuePercent = queueCapacity ? (uint8_t)(queueDepth * 100 / queueCapacity) : 0;
+    if (queuePercent > _intervalQueuePercent) _intervalQueuePercent = queuePercent;
+
+    uint32_t elapsed = nowMs - _intervalStartMs;
+    if (elapsed < TELEMETRY_SHAPER_INTERVAL_MS) return false;
+
+    bool congested = _intervalRejected > 0 || _intervalBacklog > TELEMETRY_SHAPER_BACKLOG_BYTES ||
+                     _intervalQueuePercent >= TELEMETRY_SHAPER_QUEUE_PERCENT;
+    _stats.throughputBps = (uint32_t)((uint64_t)_intervalBytes * 1000 / elapsed);
+    // 切换记录带上触发切换的这个窗口的链路状况
+    _change.throughputBps = _stats.throughputBps;
+    _change.backlogBytes = _intervalBacklog > 0xFFFF ? 0xFFFF : (uint16_t)_intervalBacklog;
+    _change.rejected = _intervalRejected;
+    _change.queuePercent = _intervalQueuePercent;
+    resetInterval(nowMs);
+    if (congested) _stats.congestedIntervals++;
+
+    if (!_adaptive) return false;
+    if (_settling) {
+        _settling = false;
+        return false;
+    }
+
+    if (congested) {
+        _cleanMs = 0;
+        if (_probing) {
+            _stats.failedProbes++;
+            _probeHoldMs = _probeHoldMs * 2 > TELEMETRY_PROBE_MAX_MS ? TELEMETRY_PROBE_MAX_MS : _probeHoldMs * 2;
+            _probing = false;
+        }
+        if (_mode + 1 >= TELEMETRY_MODE_COUNT) return false;
+        _stats.downgrades++;
+        switchTo(_mode + 1, TELEMETRY_MODE_REASON_CONGESTION, nowMs);
+        _settling = true;
+        return true;
+    }
+
+    _cleanMs += elapsed;
+    if (_probing && _cleanMs >= TELEMETRY_PROBE_MIN_MS) {
+        _probing = false;
+        _probeHoldMs = TELEMETRY_PROBE_MIN_MS;
+    }
+    if (_mode == TELEMETRY_MODE_FULL || _probing || _cleanMs < _probeHoldMs) return false;
+    _stats.upgrades++;
+    switchTo(_mode - 1, TELEMETRY_MODE_REASON_RECOVERY, nowMs);
+    _probing = true;
+    _cleanMs = 0;
+    return true;
+}
+
+void TelemetryShaper::switchTo(uint8_t mode, uint8_t reason, unsigned long nowMs) {
+    _change.timestampUs = (uint32_t)micros();
+    _change.nextSeq = 0;
+    _change.fromMode = _mode;
+    _change.toMode = mode;
+    _change.reason = reason;
+    _mode = mode;
+    _stats.modeChanges++;
+    resetInterval(nowMs);
+}
+
+void TelemetryShaper::resetInterval(unsigned long nowMs) {
+    _intervalStartMs = nowMs;
+    _intervalBytes = 0;
+    _intervalRejected = 0;
+    _intervalBacklog = 0;
+    _intervalQueuePercent = 0;
+}
+
+TelemetryShaperStats TelemetryShaper::getStats() const {
+    TelemetryShaperStats s = _stats;
+    s.mode = _mode;
+    s.adaptive = _adaptive;
+    s.probeHoldMs = _probeHoldMs;
+    return s;
+}
+
+void TelemetryShaper::printStats() const {
+    TelemetryShaperStats s = getStats();
+    Serial.println("=== 遥测模式 ===");
+    Serial.print("模式: ");
+    Serial.print(telemetryModeName(s.mode));
+    Serial.print(s.adaptive ? "（自适应）" : "（固定）");
+    Serial.print(", 吞吐(B/s): ");
+    Serial.println(s.throughputBps);
+    Serial.print("切换: ");
+    Serial.print(s.modeChanges);
+    Serial.print(", 降级 ");
+    Serial.print(s.downgrades);
+    Serial.print(", 升级 ");
+    Serial.print(s.upgrades);
+    Serial.print(", 试探失败 ");
+    Serial.print(s.failedProbes);
+    Serial.print(", 拥塞窗口 ");
+    Serial.print(s.congestedIntervals);
+    Serial.print(", 升级等待(ms) ");
+    Serial.println(s.probeHoldMs);
+}
@@ -0,0 +1,103 @@
+#ifndef TelemetryShaper_h
+#define TelemetryShaper_h
+
+#include <Arduino.h>
+
+#include "TelemetryProtocol.h"
+
+// 自适应遥测配置
+constexpr uint8_t TELEMETRY_DECIMATION_WINDOW = 10;        // 降采样窗口样本数（200Hz下20Hz）
+constexpr uint32_t TELEMETRY_DECIMATED_FRAME_AGE_MS = 500;  // 降采样模式的攒批时间
+constexpr uint32_t TELEMETRY_SHAPER_INTERVAL_MS = 500;      // 链路评估窗口
+constexpr size_t TELEMETRY_SHAPER_BACKLOG_BYTES = 1024;     // 发送端积压超过此值算拥塞
+constexpr uint8_t TELEMETRY_SHAPER_QUEUE_PERCENT = 50;      // 跨核队列占用超过此值算拥塞
+constexpr uint32_t TELEMETRY_PROBE_MIN_MS = 5000;           // 持续通畅多久后试探升一级
+constexpr uint32_t TELEMETRY_PROBE_MAX_MS = 60000;          // 试探失败后等待时间加倍，上限
+
+// 窗口聚合：连续TELEMETRY_DECIMATION_WINDOW个样本合成一条最小/最大/平均记录
+class TelemetryDecimator {
+public:
+    TelemetryDecimator();
+
+    // 丢弃不满的窗口
+    void reset();
+    // 加入一个样本，窗口满时返回true，window()给出结果
+    bool add(const TelemetryRecord& record);
+    // 结束不满的窗口（切换模式时），没有样本返回false
+    bool flush();
+    const TelemetryWindowRecord& window() const { return _window; }
+
+private:
+    void finishWindow();
+
+    TelemetryWindowRecord _window;
+    uint8_t _count;
+    uint8_t _validFlags;            // 全部样本都有效的可选字段
+    uint8_t _controlFlags;
+    uint8_t _state;
+    uint32_t _firstSeq;
+    uint32_t _firstTimestampUs;
+    float _min;
+    float _max;
+    float _sum[7];                  // 主气压、备用气压、流量、温度、CO2、氧、气阀
+    float _valveMax;
+};
+
+struct TelemetryShaperStats {
+    uint8_t mode;
+    bool adaptive;
+    uint32_t modeChanges;
+    uint32_t downgrades;
+    uint32_t upgrades;
+    uint32_t failedProbes;          // 升级后很快又拥塞
+    uint32_t congestedIntervals;
+    uint32_t probeHoldMs;           // 当前升级前需要的通畅时长
+    uint32_t throughputBps;         // 最近一个评估窗口的实际写出速率
+};
+
+// 遥测模式控制：按评估窗口统计发送结果、发送端积压和跨核队列占用。
+//   拥塞（有发送被拒绝、积压或队列超过阈值）时立即降一级，降级后的第一个窗口用于排空不评估；
+//   持续通畅probeHold后试探升一级，升级后TELEMETRY_PROBE_MIN_MS内又拥塞则降回并把等待时间加倍
+//   （与连接重试相同的指数退避），升级站稳后等待时间复位。链路断开期间不评估。
+// 只决定模式，不发送数据；生产者（控制核）从不等待。
+class TelemetryShaper {
+public:
+    TelemetryShaper();
+
+    // 自适应（默认开启）；setMode()设置固定模式并关闭自适应
+    void setAdaptive(bool enable) { _adaptive = enable; }
+    bool isAdaptive() const { return _adaptive; }
+    void setMode(uint8_t mode, unsigned long nowMs);
+    uint8_t mode() const { return _mode; }
+
+    // 每次尝试写出后报告结果（只在链路在线时调用）
+    void onSend(size_t bytes, bool accepted);
+    // 每次连接推进后调用；返回true表示模式刚切换，lastChange()给出切换记录（nextSeq由调用方填写）
+    bool update(unsigned long nowMs, bool linkUp, size_t backlogBytes, size_t queueDepth, size_t queueCapacity);
+    const TelemetryModeChange& lastChange() const { return _change; }
+
+    TelemetryShaperStats getStats() const;
+    void printStats() const;
+
+private:
+    void switchTo(uint8_t mode, uint8_t reason, unsigned long nowMs);
+    void resetInterval(unsigned long nowMs);
+
+    bool _adaptive;
+    uint8_t _mode;
+    TelemetryModeChange _change;
+
+    unsigned long _intervalStartMs;
+    uint32_t _intervalBytes;
+    uint16_t _intervalRejected;
+    size_t _intervalBacklog;
+    uint8_t _intervalQueuePercent;
+    bool _settling;                 // 降级后的排空窗口
+    bool _probing;                  // 刚升级，尚未站稳
+    uint32_t _cleanMs;
+    uint32_t _probeHoldMs;
+
+    TelemetryShaperStats _stats;
+};
+
+#endif
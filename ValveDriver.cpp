@@ -0,0 +1,97 @@
+#include "ValveDriver.h"
+
+ValveDriver::ValveDriver()
+    : _ready(false), _fadeInstalled(false), _channel(VALVE_LEDC_CHANNEL), _mode(LEDC_HIGH_SPEED_MODE),
+      _ledcChannel(LEDC_CHANNEL_0), _bits(0), _freqHz(0), _maxDuty(1), _duty(0), _intervalMs(100),
+      _maxSlew(VALVE_MAX_SLEW_PER_S), _fadeEndUs(0), _fading(false) {
+    resetStats();
+}
+
+bool ValveDriver::begin(uint8_t pin, uint8_t channel, uint32_t freqHz, uint8_t bits) {
+    _ready = false;
+    if (bits < VALVE_PWM_MIN_BITS || bits > VALVE_PWM_MAX_BITS || channel >= 16 || freqHz == 0) {
+        Serial.println("气阀PWM配置无效");
+        return false;
+    }
+    if (ledcSetup(channel, freqHz, bits) == 0) {
+        Serial.print("气阀PWM频率过高: ");
+        Serial.print(freqHz);
+        Serial.print("Hz @ ");
+        Serial.print(bits);
+        Serial.println("位");
+        return false;
+    }
+    ledcAttachPin(pin, channel);
+
+    // Arduino通道0–7对应高速组，8–15对应低速组
+    _channel = channel;
+    _mode = (ledc_mode_t)(channel / 8);
+    _ledcChannel = (ledc_channel_t)(channel % 8);
+    _bits = bits;
+    _freqHz = freqHz;
+    _maxDuty = (1UL << bits) - 1;
+
+    // 渐变服务只需安装一次，已安装时返回INVALID_STATE
+    esp_err_t err = ledc_fade_func_install(0);
+    _fadeInstalled = (err == ESP_OK || err == ESP_ERR_INVALID_STATE);
+
+    _ready = true;
+    close();
+    return true;
+}
+
+void ValveDriver::setOpening(float fraction) {
+    if (!_ready) return;
+    _stats.commands++;
+
+    fraction = constrain(fraction, 0.0f, 1.0f);
+    uint32_t target = (uint32_t)(fraction * _maxDuty + 0.5f);
+
+    // 变化率上限：一个更新间隔内最多变化 maxSlew × 间隔
+    uint32_t maxStep = (uint32_t)(_maxSlew * _maxDuty * _intervalMs / 1000.0f);
+    if (maxStep == 0) maxStep = 1;
+    if (target > _duty + maxStep) {
+        target = _duty + maxStep;
+        _stats.slewLimited++;
+    } else if (_duty > maxStep && target < _duty - maxStep) {
+        target = _duty - maxStep;
+        _stats.slewLimited++;
+    }
+
+    if (target == _duty) {
+        _stats.unchanged++;
+        return;
+    }
+
+    // 渐变时间比更新间隔短1ms；间隔不足2ms时直接写入
+    uint16_t fadeMs = _intervalMs > 1 ? _intervalMs - 1 : 0;
+    if (!_fadeInstalled || fadeMs == 0) {
+        writeDuty(target);
+        return;
+    }
+    if (_fading && (long)(micros() - _fadeEndUs) < 0) {
+        _stats.busy++;
+        return;
+    }
+    if (ledc_set_fade_with_time(_mode, _ledcChannel, target, fadeMs) != ESP_OK ||
+        ledc_fade_start(_mode, _ledcChannel, LEDC_FADE_NO_WAIT) != ESP_OK) {
+        writeDuty(target);
+        return;
+    }
+    _duty = target;
+    _fading = true;
+    _fadeEndUs = micros() + (unsigned long)fadeMs * 1000;
+    _stats.fades++;
+}
+
+void ValveDriver::close() {
+    if (!_ready) return;
+    writeDuty(0);
+}
+
+void ValveDriver::writeDuty(uint32_t duty) {
+    ledcWrite(_channel, duty);
+    _duty = duty;
+    _fading = false;
+    _stats.writes++;
+}
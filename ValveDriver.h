@@ -0,0 +1,71 @@
+#ifndef ValveDriver_h
+#define ValveDriver_h
+
+#include <Arduino.h>
+#include "driver/ledc.h"
+
+// 气阀PWM配置：LEDC计数时钟为APB 80MHz，需满足 频率 × 2^位数 <= 80MHz
+constexpr uint8_t VALVE_LEDC_CHANNEL = 0;      // 0–7为高速组
+constexpr uint32_t VALVE_PWM_FREQ_HZ = 4000;
+constexpr uint8_t VALVE_PWM_BITS = 14;         // 16384级；允许12–16位
+constexpr uint8_t VALVE_PWM_MIN_BITS = 12;
+constexpr uint8_t VALVE_PWM_MAX_BITS = 16;
+constexpr float VALVE_MAX_SLEW_PER_S = 20.0;   // 开度变化率上限（满量程/秒）
+
+struct ValveDriverStats {
+    uint32_t commands;      // setOpening调用次数
+    uint32_t writes;        // 直接写入占空比
+    uint32_t fades;         // 启动的硬件渐变
+    uint32_t unchanged;     // 占空比未变化，未访问外设
+    uint32_t busy;          // 上一次渐变尚未结束，本次跳过
+    uint32_t slewLimited;   // 目标被变化率上限截断
+};
+
+// 气阀执行器：LEDC高分辨率PWM，每次开度更新由硬件在一个更新间隔内线性渐变到目标，
+// CPU只在更新时下发一条命令。渐变时间略短于更新间隔：IDF 4.x中新的渐变会等待
+// 上一次渐变结束（阻塞调用者），因此渐变未结束时本次更新直接跳过。
+class ValveDriver {
+public:
+    ValveDriver();
+
+    // 频率与分辨率不合法（位数不在12–16或频率 × 2^位数超过80MHz）时返回false
+    bool begin(uint8_t pin, uint8_t channel = VALVE_LEDC_CHANNEL, uint32_t freqHz = VALVE_PWM_FREQ_HZ,
+               uint8_t bits = VALVE_PWM_BITS);
+
+    // 控制回路的更新间隔（决定每次渐变的时间和单次允许的最大变化）
+    void setUpdateIntervalMs(uint16_t ms) { _intervalMs = ms ? ms : 1; }
+    void setMaxSlewPerSecond(float fullScalePerSecond) { _maxSlew = fullScalePerSecond; }
+
+    // 开度0–1
+    void setOpening(float fraction);
+    void close();   // 立即写0（不渐变）
+
+    bool isReady() const { return _ready; }
+    float getOpening() const { return _duty / (float)_maxDuty; }
+    uint32_t getDuty() const { return _duty; }
+    uint32_t getMaxDuty() const { return _maxDuty; }
+    uint8_t getResolutionBits() const { return _bits; }
+    uint32_t getFrequency() const { return _freqHz; }
+    ValveDriverStats getStats() const { return _stats; }
+    void resetStats() { memset(&_stats, 0, sizeof(_stats)); }
+
+private:
+    void writeDuty(uint32_t duty);
+
+    bool _ready;
+    bool _fadeInstalled;
+    uint8_t _channel;
+    ledc_mode_t _mode;
+    ledc_channel_t _ledcChannel;
+    uint8_t _bits;
+    uint32_t _freqHz;
+    uint32_t _maxDuty;
+    uint32_t _duty;             // 最近一次下发的目标占空比
+    uint16_t _intervalMs;
+    float _maxSlew;
+    unsigned long _fadeEndUs;
+    bool _fading;
+    ValveDriverStats _stats;
+};
+
+#endif
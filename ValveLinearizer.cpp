@@ -0,0 +1,193 @@
+#include "ValveLinearizer.h"
+#include <Preferences.h>
+
+ValveLinearizer::ValveLinearizer() : _valid(false), _sweepState(VALVE_SWEEP_IDLE), _point(0) {
+    memset(&_table, 0, sizeof(_table));
+    for (uint8_t i = 0; i < VALVE_INVERSE_POINTS; i++) {
+        _inverse[i] = (float)i / (VALVE_INVERSE_POINTS - 1);
+    }
+}
+
+void ValveLinearizer::startSweep(unsigned long timestampUs) {
+    _sweepState = VALVE_SWEEP_RUNNING;
+    _point = 0;
+    _pointStartUs = timestampUs;
+    _pressureSum = 0;
+    _flowSum = 0;
+    _sampleCount = 0;
+    _flowCount = 0;
+    _flowValid = true;
+}
+
+void ValveLinearizer::cancelSweep() {
+    if (_sweepState == VALVE_SWEEP_RUNNING) _sweepState = VALVE_SWEEP_IDLE;
+}
+
+float ValveLinearizer::sweepUpdate(unsigned long timestampUs, float pressureKpa, float flowMlMin) {
+    if (_sweepState != VALVE_SWEEP_RUNNING) return 0;
+
+    uint32_t elapsedMs = (uint32_t)(timestampUs - _pointStartUs) / 1000;
+    if (elapsedMs >= VALVE_SWEEP_SETTLE_MS) {
+        _pressureSum += pressureKpa;
+        _sampleCount++;
+        if (!isnan(flowMlMin)) {
+            _flowSum += flowMlMin;
+            _flowCount++;
+        }
+    }
+    if (elapsedMs >= VALVE_SWEEP_SETTLE_MS + VALVE_SWEEP_AVERAGE_MS && _sampleCount > 0) {
+        _pressure[_point] = _pressureSum / _sampleCount;
+        _flow[_point] = _flowCount ? _flowSum / _flowCount : NAN;
+        if (_flowCount == 0) _flowValid = false;
+        _pressureSum = 0;
+        _flowSum = 0;
+        _sampleCount = 0;
+        _flowCount = 0;
+        _pointStartUs = timestampUs;
+        if (++_point >= VALVE_TABLE_POINTS) {
+            finishSweep();
+            return 0;
+        }
+    }
+    return (float)_point / (VALVE_TABLE_POINTS - 1);
+}
+
+void ValveLinearizer::finishSweep() {
+    const float* raw = _flowValid ? _flow : _pressure;
+    float minResponse = _flowValid ? VALVE_MIN_RESPONSE_ML_MIN : VALVE_MIN_RESPONSE_KPA;
+
+    // 保序回归：相邻违序的点合并为均值块，得到与测量最接近的单调不减序列
+    float blockValue[VALVE_TABLE_POINTS];
+    uint8_t blockSize[VALVE_TABLE_POINTS];
+    uint8_t blocks = 0;
+    for (uint8_t i = 0; i < VALVE_TABLE_POINTS; i++) {
+        blockValue[blocks] = raw[i] - raw[0];
+        blockSize[blocks] = 1;
+        blocks++;
+        while (blocks > 1 && blockValue[blocks - 2] > blockValue[blocks - 1]) {
+            uint8_t n = blockSize[blocks - 2] + blockSize[blocks - 1];
+            blockValue[blocks - 2] = (blockValue[blocks - 2] * blockSize[blocks - 2] +
+                                      blockValue[blocks - 1] * blockSize[blocks - 1]) / n;
+            blockSize[blocks - 2] = n;
+            blocks--;
+        }
+    }
+    float monotone[VALVE_TABLE_POINTS];
+    uint8_t index = 0;
+    for (uint8_t b = 0; b < blocks; b++) {
+        for (uint8_t k = 0; k < blockSize[b]; k++) monotone[index++] = blockValue[b];
+    }
+
+    float low = monotone[0];
+    float fullScale = monotone[VALVE_TABLE_POINTS - 1] - low;
+    if (!(fullScale >= minResponse)) {
+        _sweepState = VALVE_SWEEP_FAILED;
+        return;
+    }
+
+    ValveTable table;
+    memset(&table, 0, sizeof(table));
+    table.version = VALVE_TABLE_VERSION;
+    table.kind = _flowValid ? VALVE_RESPONSE_FLOW : VALVE_RESPONSE_PRESSURE;
+    table.points = VALVE_TABLE_POINTS;
+    table.fullScale = fullScale;
+    for (uint8_t i = 0; i < VALVE_TABLE_POINTS; i++) {
+        table.response[i] = (monotone[i] - low) / fullScale;
+    }
+    table.response[0] = 0;
+    table.response[VALVE_TABLE_POINTS - 1] = 1;
+    table.checksum = checksum(table);
+    setTable(table);
+    _sweepState = VALVE_SWEEP_DONE;
+}
+
+bool ValveLinearizer::setTable(const ValveTable& table) {
+    if (table.version != VALVE_TABLE_VERSION || table.points != VALVE_TABLE_POINTS ||
+        table.checksum != checksum(table) || !(table.fullScale > 0)) {
+        return false;
+    }
+    for (uint8_t i = 1; i < VALVE_TABLE_POINTS; i++) {
+        if (!(table.response[i] >= table.response[i - 1])) return false;
+    }
+    _table = table;
+    buildInverse();
+    _valid = true;
+    return true;
+}
+
+void ValveLinearizer::buildInverse() {
+    // 响应单调不减，逐个反查点沿表前进即可；平坦段（死区）取其末端，响应0对应全关
+    const float* r = _table.response;
+    uint8_t seg = 0;
+    _inverse[0] = 0;
+    for (uint8_t k = 1; k < VALVE_INVERSE_POINTS; k++) {
+        float y = (float)k / (VALVE_INVERSE_POINTS - 1);
+        while (seg < VALVE_TABLE_POINTS - 2 && (r[seg + 1] < y || r[seg + 1] <= r[seg])) seg++;
+        float span = r[seg + 1] - r[seg];
+        float f = span > 0 ? (y - r[seg]) / span : 1;
+        f = constrain(f, 0, 1);
+        _inverse[k] = (seg + f) / (VALVE_TABLE_POINTS - 1);
+    }
+}
+
+float ValveLinearizer::dutyFor(float linearOpening) const {
+    if (!_valid) return linearOpening;
+    if (linearOpening <= 0) return 0;
+    if (linearOpening >= 1) return 1;
+    float pos = linearOpening * (VALVE_INVERSE_POINTS - 1);
+    uint8_t i = (uint8_t)pos;
+    if (i >= VALVE_INVERSE_POINTS - 1) return _inverse[VALVE_INVERSE_POINTS - 1];
+    float f = pos - i;
+    return _inverse[i] + f * (_inverse[i + 1] - _inverse[i]);
+}
+
+float ValveLinearizer::dutyForResponse(float response) const {
+    return _valid ? dutyFor(response / _table.fullScale) : 0;
+}
+
+float ValveLinearizer::responseFor(float duty) const {
+    if (!_valid) return duty;
+    if (duty <= 0) return 0;
+    if (duty >= 1) return 1;
+    float pos = duty * (VALVE_TABLE_POINTS - 1);
+    uint8_t i = (uint8_t)pos;
+    float f = pos - i;
+    return _table.response[i] + f * (_table.response[i + 1] - _table.response[i]);
+}
+
+uint32_t ValveLinearizer::checksum(const ValveTable& table) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&table);
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < offsetof(ValveTable, checksum); i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+bool ValveLinearizer::save() const {
+    if (!_valid) return false;
+    Preferences prefs;
+    if (!prefs.begin(VALVE_PREFS_NAMESPACE, false)) return false;
+    bool ok = prefs.putBytes(VALVE_PREFS_KEY, &_table, sizeof(_table)) == sizeof(_table);
+    prefs.end();
+    return ok;
+}
+
+bool ValveLinearizer::load() {
+    Preferences prefs;
+    if (!prefs.begin(VALVE_PREFS_NAMESPACE, true)) return false;
+    ValveTable table;
+    bool ok = prefs.getBytesLength(VALVE_PREFS_KEY) == sizeof(table) &&
+              prefs.getBytes(VALVE_PREFS_KEY, &table, sizeof(table)) == sizeof(table);
+    prefs.end();
+    return ok && setTable(table);
+}
+
+void ValveLinearizer::clear() {
+    _valid = false;
+    Preferences prefs;
+    if (prefs.begin(VALVE_PREFS_NAMESPACE, false)) {
+        prefs.remove(VALVE_PREFS_KEY);
+        prefs.end();
+    }
+}
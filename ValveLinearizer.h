@@ -0,0 +1,84 @@
+#ifndef ValveLinearizer_h
+#define ValveLinearizer_h
+
+#include <Arduino.h>
+
+// 气阀特性扫描与线性化配置
+constexpr uint8_t VALVE_TABLE_POINTS = 17;          // 扫描点：占空比 0, 1/16, ..., 1
+constexpr uint8_t VALVE_INVERSE_POINTS = 65;        // 反查表：归一化响应 0..1 均分
+constexpr uint16_t VALVE_SWEEP_SETTLE_MS = 400;     // 每个扫描点切换后的稳定时间
+constexpr uint16_t VALVE_SWEEP_AVERAGE_MS = 200;    // 稳定后取平均的时间
+constexpr float VALVE_MIN_RESPONSE_KPA = 0.05;      // 满开相对全关的最小压力变化，不足则扫描失败
+constexpr float VALVE_MIN_RESPONSE_ML_MIN = 500.0;  // 同上（流量）
+constexpr uint16_t VALVE_TABLE_VERSION = 1;
+constexpr const char* VALVE_PREFS_NAMESPACE = "valve";
+constexpr const char* VALVE_PREFS_KEY = "table";
+
+enum ValveResponseKind : uint8_t { VALVE_RESPONSE_PRESSURE, VALVE_RESPONSE_FLOW };
+
+// 保存到闪存的特性表：占空比按扫描点均分，响应单调不减并归一化到0..1
+struct ValveTable {
+    uint16_t version;
+    uint8_t kind;                           // ValveResponseKind
+    uint8_t points;
+    float fullScale;                        // 满开相对全关的响应（kPa或ml/min）
+    float response[VALVE_TABLE_POINTS];
+    uint32_t checksum;                      // 前面各字段的FNV-1a
+};
+
+enum ValveSweepState { VALVE_SWEEP_IDLE, VALVE_SWEEP_RUNNING, VALVE_SWEEP_DONE, VALVE_SWEEP_FAILED };
+
+// 气阀线性化：扫描模式下逐点设置占空比、等待稳定后平均压力/流量响应，
+// 用保序回归（相邻违序合并）得到单调表并归一化；有流量数据时按流量建表，否则按压力。
+// 运行时把期望的线性开度（归一化响应）反查为占空比：反查表在建表时一次生成，
+// 每次查询只需一次乘法和线性插值，O(1)。
+class ValveLinearizer {
+public:
+    ValveLinearizer();
+
+    // 扫描：开始后每个主气压样本调用一次sweepUpdate，返回本样本应输出的占空比（0–1）
+    void startSweep(unsigned long timestampUs);
+    float sweepUpdate(unsigned long timestampUs, float pressureKpa, float flowMlMin);
+    void cancelSweep();
+    ValveSweepState sweepState() const { return _sweepState; }
+    bool isSweeping() const { return _sweepState == VALVE_SWEEP_RUNNING; }
+    uint8_t sweepPoint() const { return _point; }
+
+    // 期望线性开度（0–1，满开响应的比例）-> 占空比（0–1）；表无效时原样返回
+    float dutyFor(float linearOpening) const;
+    // 期望响应（kPa或ml/min，相对全关）-> 占空比
+    float dutyForResponse(float response) const;
+    // 正向插值：占空比 -> 归一化响应
+    float responseFor(float duty) const;
+
+    bool isValid() const { return _valid; }
+    const ValveTable& table() const { return _table; }
+    bool setTable(const ValveTable& table);
+
+    // 闪存持久化（Preferences/NVS）
+    bool save() const;
+    bool load();
+    void clear();
+
+private:
+    void finishSweep();
+    void buildInverse();
+    static uint32_t checksum(const ValveTable& table);
+
+    ValveTable _table;
+    bool _valid;
+    float _inverse[VALVE_INVERSE_POINTS];
+
+    ValveSweepState _sweepState;
+    uint8_t _point;
+    unsigned long _pointStartUs;
+    double _pressureSum;
+    double _flowSum;
+    uint32_t _sampleCount;
+    uint32_t _flowCount;
+    float _pressure[VALVE_TABLE_POINTS];
+    float _flow[VALVE_TABLE_POINTS];
+    bool _flowValid;
+};
+
+#endif
@@ -5,15 +5,10 @@ ACD1100::ACD1100(I2CMux* mux, uint8_t channel, ACD1100_COMM_MODE mode)
     _lastCO2 = 0;
     _lastTemp = 0.0;
     _lastError = ERROR_NONE;
-    bufferIndex = 0;
-    previousCO2 = 0;
-    previousTemp = 0;
-    
-    // 初始化滤波缓冲区
-    for (uint8_t i = 0; i < MOVING_AVG_SIZE; i++) {
-        co2Buffer[i] = 0;
-        tempBuffer[i] = 0;
-    }
+    lastUpdateTime = 0;
+    dataValid = false;
+    filteredCO2 = 0;
+    filteredTemperature = 0;
 }
 
 //ACD1100初始化
@@ -109,6 +104,17 @@ bool ACD1100::readCO2(uint32_t &co2_ppm, float &temperature) {
 
 // I2C方式读取CO2
 bool ACD1100::readCO2I2C(uint32_t &co2_ppm, float &temperature) {
+    if (!sendReadCommandI2C()) {
+        return false;
+    }
+    
+    delay(ACD1100_RESPONSE_MS); // 增加等待时间
+    
+    return readMeasurementI2C(co2_ppm, temperature);
+}
+
+// 发送I2C读取命令0x0300
+bool ACD1100::sendReadCommandI2C() {
     if (!selectSensorChannel()) {
         _lastError = ERROR_I2C_COMMUNICATION;
         return false;
@@ -125,8 +131,15 @@ bool ACD1100::readCO2I2C(uint32_t &co2_ppm, float &temperature) {
         return false;
     }
     Serial.println("ACD1100: 命令发送成功");
-    
-    delay(100); // 增加等待时间
+    return true;
+}
+
+// 读取命令发出至少ACD1100_RESPONSE_MS后取回并解析数据
+bool ACD1100::readMeasurementI2C(uint32_t &co2_ppm, float &temperature) {
+    if (!selectSensorChannel()) {
+        _lastError = ERROR_I2C_COMMUNICATION;
+        return false;
+    }
     
     // 按照手册，上行数据格式为：地址(1) + 4字节CO2 + 2字节CRC + 2字节Temp + 1字节CRC = 10 字节
     // 实际上是： 地址(1) + PPM3(1) + PPM2(1) + CRC1(1) + PPM1(1) + PPM0(1) + CRC2(1) + TempH(1) + TempL(1) + CRC3(1)
@@ -407,15 +420,12 @@ uint8_t ACD1100::getLastError() {
 }
 
 bool ACD1100::update() {
-    static unsigned long lastReadTime = 0;
-    unsigned long currentTime = millis();
-    
     // 检查是否达到数据刷新间隔(2秒)
-    if (currentTime - lastReadTime < 2000) {
+    if (!isReadDue()) {
         return dataValid; // 未到读取时间，返回之前的状态
     }
     
-    lastReadTime = currentTime;
+    lastUpdateTime = millis();
     
     uint32_t rawCO2;
     float rawTemperature;
@@ -427,6 +437,46 @@ bool ACD1100::update() {
         return false;
     }
     
+    if (!processMeasurement(rawCO2, rawTemperature)) {
+        return false;
+    }
+    
+    delay(200);
+    
+    return true;
+}
+
+bool ACD1100::startRead() {
+    lastUpdateTime = millis();
+    _readPending = false;
+    if (_commMode != COMM_I2C || !sendReadCommandI2C()) {
+        dataValid = false;
+        return false;
+    }
+    _readPending = true;
+    _readRequestTime = millis();
+    return true;
+}
+
+bool ACD1100::isResponseReady() const {
+    return _readPending && millis() - _readRequestTime >= ACD1100_RESPONSE_MS;
+}
+
+bool ACD1100::finishRead() {
+    if (!_readPending) return false;
+    _readPending = false;
+    
+    uint32_t rawCO2;
+    float rawTemperature;
+    if (!readMeasurementI2C(rawCO2, rawTemperature)) {
+        dataValid = false;
+        _lastError = ERROR_SENSOR_NOT_RESPONDING;
+        return false;
+    }
+    return processMeasurement(rawCO2, rawTemperature);
+}
+
+bool ACD1100::processMeasurement(uint32_t rawCO2, float rawTemperature) {
     // 数据有效性检查
     if (rawCO2 < 400 || rawCO2 > 5000) {
         dataValid = false;
@@ -435,27 +485,21 @@ bool ACD1100::update() {
     }
     
     // 应用双重滤波
-    float tempFiltered = applyMovingAverage(rawTemperature);
-    tempFiltered = applyEWMA(tempFiltered);
-    
-    float co2Filtered = applyMovingAverage((float)rawCO2);
-    co2Filtered = applyEWMA(co2Filtered);
-    
-    // 更新滤波后的值
-    filteredTemperature = tempFiltered;
-    filteredCO2 = co2Filtered;
+    filteredTemperature = _tempEwma.update(_tempAverage.update(rawTemperature));
+    filteredCO2 = _co2Ewma.update(_co2Average.update((float)rawCO2));
     
     // 更新空气质量评估
     updateAirQuality();
     
     dataValid = true;
     _lastError = ERROR_NONE;
-    
-    delay(200);
-    
     return true;
 }
 
+bool ACD1100::isReadDue() {
+    return millis() - lastUpdateTime >= 2000;
+}
+
 bool ACD1100::isDataReady() {
     return (millis() - lastUpdateTime >= 2000) && dataValid;
 }
@@ -472,37 +516,6 @@ uint8_t ACD1100::getAirQuality() {
     return airQuality;
 }
 
-float ACD1100::applyMovingAverage(float newValue) {
-    // 更新循环缓冲区
-    co2Buffer[bufferIndex] = newValue;
-    bufferIndex = (bufferIndex + 1) % MOVING_AVG_SIZE;
-    
-    // 计算移动平均
-    float sum = 0;
-    uint8_t count = 0;
-    for (uint8_t i = 0; i < MOVING_AVG_SIZE; i++) {
-        if (co2Buffer[i] > 0) { // 只计算有效数据
-            sum += co2Buffer[i];
-            count++;
-        }
-    }
-    
-    return (count > 0) ? (sum / count) : newValue;
-}
-
-float ACD1100::applyEWMA(float newValue) {
-    const float alpha = 0.3; // EWMA系数
-    float &previous = (newValue == filteredCO2) ? previousCO2 : previousTemp;
-    
-    if (previous == 0) {
-        previous = newValue; // 首次使用
-    } else {
-        previous = alpha * newValue + (1 - alpha) * previous;
-    }
-    
-    return previous;
-}
-
 void ACD1100::updateAirQuality() {
     // 根据CO2浓度评估空气质量
     if (filteredCO2 <= 800) {
@@ -535,7 +548,6 @@ bool ACD1100::selectSensorChannel() {
         return false;
     }
     
-    delay(20); // 给多路复用器切换时间
     return true;
 }
 
@@ -630,7 +642,7 @@ void ACD1100::testMuxChannels() {
         Serial.print(i);
         Serial.print("...");
         
-        if (_mux->selectChannel(i)) {
+        if (_mux->selectChannelExclusive(i)) {
             Serial.print(" 选择成功");
             
             // 测试I2C通信
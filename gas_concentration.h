@@ -9,9 +9,11 @@
 #include "OLEDDisplay.h"
 #include "I2CMux.h"
 #include "oxygen_sensor.h"
+#include "StreamFilter.h"
 
 #define ACD1100_I2C_ADDR 0x2A  // 7位地址，Arduino自动处理8位转换
 #define ACD1100_UART_BAUD 1200  // UART波特率
+#define ACD1100_RESPONSE_MS 100 // I2C读取命令到数据可读的等待时间
 
 // 通信模式枚举
 enum ACD1100_COMM_MODE {
@@ -25,6 +27,14 @@ public:
     ACD1100(I2CMux* mux = nullptr, uint8_t channel = 0, ACD1100_COMM_MODE mode = COMM_I2C);
     bool update();  // 主要更新函数
     bool isDataReady();  // 检查数据是否准备好
+    bool isReadDue();  // 是否到了下一次读取时间（数据刷新周期2秒）
+    
+    // 分段读取（仅I2C）：startRead()发出读取命令后立即返回，
+    // 等待期间总线可处理其他设备，isResponseReady()后调用finishRead()取回数据
+    bool startRead();
+    bool isReadPending() const { return _readPending; }
+    bool isResponseReady() const;
+    bool finishRead();
     float getFilteredCO2();  // 获取滤波后的CO2值
     float getFilteredTemperature();  // 获取滤波后的温度值
     uint8_t getAirQuality();  // 获取空气质量等级
@@ -38,6 +48,7 @@ public:
     
     // 多路复用器相关
     void setMuxChannel(I2CMux* mux, uint8_t channel);
+    uint8_t getMuxChannel() const { return _channel; }
     bool selectSensorChannel();
     
     // 测试函数
@@ -50,6 +61,8 @@ public:
     bool readCO2(uint32_t &co2_ppm, float &temperature);
     bool readCO2I2C(uint32_t &co2_ppm, float &temperature);
     bool readCO2UART(uint32_t &co2_ppm, float &temperature);
+    bool sendReadCommandI2C();
+    bool readMeasurementI2C(uint32_t &co2_ppm, float &temperature);
     uint32_t getCO2();
     float getTemperature();
     
@@ -88,18 +101,20 @@ private:
     float _lastTemp;
     uint8_t _lastError;
 
+    // 分段读取状态
+    bool _readPending = false;
+    unsigned long _readRequestTime = 0;
+    
     // 滤波相关
-    float applyMovingAverage(float newValue);
-    float applyEWMA(float newValue);
+    bool processMeasurement(uint32_t rawCO2, float rawTemperature);
     void updateAirQuality();
 
-    // 滤波缓冲区
+    // 滤波状态：CO2和温度各自一组，互不混合
     static const uint8_t MOVING_AVG_SIZE = 5;
-    float co2Buffer[MOVING_AVG_SIZE];
-    float tempBuffer[MOVING_AVG_SIZE];
-    uint8_t bufferIndex;
-    float previousCO2;
-    float previousTemp;
+    MovingAverage<float, MOVING_AVG_SIZE> _co2Average;
+    MovingAverage<float, MOVING_AVG_SIZE> _tempAverage;
+    Ewma<float> _co2Ewma{0.3f};
+    Ewma<float> _tempEwma{0.3f};
     
     // I2C通信函数（内部使用，保持兼容性）
     bool sendCommand(uint8_t cmdHigh, uint8_t cmdLow, uint8_t *data = nullptr, uint8_t dataLen = 0);
@@ -0,0 +1,32 @@
+#ifndef _ADAFRUIT_GFX_H
+#define _ADAFRUIT_GFX_H
+
+// 主机仿真用的Adafruit_GFX替身：只维护光标/文字状态，不做字形光栅化
+
+#include "Arduino.h"
+
+class Adafruit_GFX : public Print {
+public:
+    Adafruit_GFX(int16_t w, int16_t h) : _width(w), _height(h) {}
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+    void setCursor(int16_t x, int16_t y) { _cursorX = x; _cursorY = y; }
+    void setTextSize(uint8_t s) { _textSize = s ? s : 1; }
+    void setTextColor(uint16_t c) { _textColor = c; }
+    int16_t width() const { return _width; }
+    int16_t height() const { return _height; }
+
+    size_t write(uint8_t c) override;
+    using Print::write;
+
+protected:
+    int16_t _width;
+    int16_t _height;
+    int16_t _cursorX = 0;
+    int16_t _cursorY = 0;
+    uint8_t _textSize = 1;
+    uint16_t _textColor = 1;
+};
+
+#endif
@@ -0,0 +1,116 @@
+#include "Adafruit_SSD1306.h"
+
+#include <stdlib.h>
+
+namespace {
+constexpr size_t WIRE_MAX = I2C_BUFFER_LENGTH;
+}
+
+size_t Adafruit_GFX::write(uint8_t c) {
+    if (c == '\n') {
+        _cursorX = 0;
+        _cursorY += 8 * _textSize;
+        return 1;
+    }
+    if (c == '\r') return 1;
+    // 用字符码的位图案代替字形，保证显存内容随文字变化
+    for (int col = 0; col < 5; col++) {
+        uint8_t bits = (uint8_t)(c >> (col % 3)) | (col == 0 ? 0x01 : 0);
+        for (int row = 0; row < 7; row++) {
+            if (bits & (1 << row)) {
+                for (int sx = 0; sx < _textSize; sx++) {
+                    for (int sy = 0; sy < _textSize; sy++) {
+                        drawPixel(_cursorX + col * _textSize + sx, _cursorY + row * _textSize + sy, _textColor);
+                    }
+                }
+            }
+        }
+    }
+    _cursorX += 6 * _textSize;
+    return 1;
+}
+
+Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi, int8_t)
+    : Adafruit_GFX(w, h), _wire(twi ? twi : &Wire) {}
+
+Adafruit_SSD1306::~Adafruit_SSD1306() {
+    free(_buffer);
+}
+
+void Adafruit_SSD1306::commandList(const uint8_t* c, uint8_t n) {
+    _wire->beginTransmission(_addr);
+    _wire->write((uint8_t)0x00);
+    size_t bytesOut = 1;
+    while (n--) {
+        if (bytesOut >= WIRE_MAX) {
+            _wire->endTransmission();
+            _wire->beginTransmission(_addr);
+            _wire->write((uint8_t)0x00);
+            bytesOut = 1;
+        }
+        _wire->write(*c++);
+        bytesOut++;
+    }
+    _wire->endTransmission();
+}
+
+bool Adafruit_SSD1306::begin(uint8_t vcs, uint8_t addr, bool, bool) {
+    if (!_buffer) {
+        _buffer = (uint8_t*)malloc((size_t)_width * ((_height + 7) / 8));
+        if (!_buffer) return false;
+    }
+    clearDisplay();
+    _addr = addr ? addr : (_height == 32 ? 0x3C : 0x3D);
+
+    const uint8_t init1[] = {SSD1306_DISPLAYOFF, SSD1306_SETDISPLAYCLOCKDIV, 0x80, SSD1306_SETMULTIPLEX};
+    commandList(init1, sizeof(init1));
+    const uint8_t mux = (uint8_t)(_height - 1);
+    commandList(&mux, 1);
+    const uint8_t init2[] = {SSD1306_SETDISPLAYOFFSET, 0x0, SSD1306_SETSTARTLINE | 0x0, SSD1306_CHARGEPUMP};
+    commandList(init2, sizeof(init2));
+    const uint8_t pump = (vcs == SSD1306_EXTERNALVCC) ? 0x10 : 0x14;
+    commandList(&pump, 1);
+    const uint8_t init3[] = {SSD1306_MEMORYMODE, 0x00, SSD1306_SEGREMAP | 0x1, SSD1306_COMSCANDEC};
+    commandList(init3, sizeof(init3));
+    const uint8_t init4[] = {SSD1306_SETCOMPINS, 0x12, SSD1306_SETCONTRAST, 0xCF, SSD1306_SETPRECHARGE, 0xF1,
+                             SSD1306_SETVCOMDETECT, 0x40, SSD1306_DISPLAYALLON_RESUME, SSD1306_NORMALDISPLAY,
+                             SSD1306_DEACTIVATE_SCROLL, SSD1306_DISPLAYON};
+    commandList(init4, sizeof(init4));
+    return true;
+}
+
+void Adafruit_SSD1306::display() {
+    const uint8_t dlist[] = {SSD1306_PAGEADDR, 0, 0xFF, SSD1306_COLUMNADDR, 0, (uint8_t)(_width - 1)};
+    commandList(dlist, sizeof(dlist));
+
+    size_t count = (size_t)_width * ((_height + 7) / 8);
+    const uint8_t* ptr = _buffer;
+    _wire->beginTransmission(_addr);
+    _wire->write((uint8_t)0x40);
+    size_t bytesOut = 1;
+    while (count--) {
+        if (bytesOut >= WIRE_MAX) {
+            _wire->endTransmission();
+            _wire->beginTransmission(_addr);
+            _wire->write((uint8_t)0x40);
+            bytesOut = 1;
+        }
+        _wire->write(*ptr++);
+        bytesOut++;
+    }
+    _wire->endTransmission();
+}
+
+void Adafruit_SSD1306::clearDisplay() {
+    if (_buffer) memset(_buffer, 0, (size_t)_width * ((_height + 7) / 8));
+}
+
+void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if (!_buffer || x < 0 || y < 0 || x >= _width || y >= _height) return;
+    uint8_t& b = _buffer[x + (y / 8) * _width];
+    switch (color) {
+        case SSD1306_WHITE: b |= (1 << (y & 7)); break;
+        case SSD1306_BLACK: b &= ~(1 << (y & 7)); break;
+        case SSD1306_INVERSE: b ^= (1 << (y & 7)); break;
+    }
+}
@@ -0,0 +1,145 @@
+#include "Arduino.h"
+#include "SimClock.h"
+
+#include <stdio.h>
+#include <map>
+#include <random>
+
+// ---- 时间 ----
+unsigned long millis() {
+    return (unsigned long)(SimClock::nowUs() / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)SimClock::nowUs();
+}
+
+void delay(uint32_t ms) {
+    SimClock::advanceUs((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(uint32_t us) {
+    SimClock::advanceUs(us);
+}
+
+void yield() {}
+
+// ---- GPIO ----
+namespace {
+std::map<uint8_t, int> g_analogOut;
+std::mt19937 g_rng(12345);
+}
+
+void pinMode(uint8_t, uint8_t) {}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    g_analogOut[pin] = val ? 255 : 0;
+}
+
+void analogWrite(uint8_t pin, int value) {
+    g_analogOut[pin] = value;
+}
+
+int simGetAnalogWrite(uint8_t pin) {
+    auto it = g_analogOut.find(pin);
+    return it == g_analogOut.end() ? 0 : it->second;
+}
+
+long random(long howbig) {
+    if (howbig <= 0) return 0;
+    return (long)(g_rng() % (unsigned long)howbig);
+}
+
+long random(long howsmall, long howbig) {
+    if (howsmall >= howbig) return howsmall;
+    return howsmall + random(howbig - howsmall);
+}
+
+// ---- Print ----
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+        if (write(*buffer++)) n++;
+        else break;
+    }
+    return n;
+}
+
+size_t Print::print(const char* s) { return write(s); }
+size_t Print::print(const String& s) { return write(s.c_str(), s.length()); }
+size_t Print::print(char c) { return write((uint8_t)c); }
+size_t Print::print(unsigned char n, int base) { return print((unsigned long)n, base); }
+size_t Print::print(int n, int base) { return print((long)n, base); }
+size_t Print::print(unsigned int n, int base) { return print((unsigned long)n, base); }
+size_t Print::print(long n, int base) { return print((long long)n, base); }
+size_t Print::print(unsigned long n, int base) { return print((unsigned long long)n, base); }
+
+size_t Print::print(long long n, int base) {
+    if (base == 0) return write((uint8_t)n);
+    if (base == 10 && n < 0) {
+        size_t t = print('-');
+        return t + printNumber((unsigned long long)(-n), 10);
+    }
+    return printNumber((unsigned long long)n, base);
+}
+
+size_t Print::print(unsigned long long n, int base) {
+    if (base == 0) return write((uint8_t)n);
+    return printNumber(n, base);
+}
+
+size_t Print::print(double n, int digits) { return printFloat(n, digits); }
+size_t Print::print(const Printable& x) { return x.printTo(*this); }
+
+size_t Print::println() { return write("\r\n"); }
+
+size_t Print::printNumber(unsigned long long n, int base) {
+    char buf[8 * sizeof(n) + 1];
+    char* str = &buf[sizeof(buf) - 1];
+    *str = '\0';
+    if (base < 2) base = 10;
+    do {
+        char c = (char)(n % base);
+        n /= base;
+        *--str = c < 10 ? c + '0' : c + 'A' - 10;
+    } while (n);
+    return write(str);
+}
+
+size_t Print::printFloat(double number, int digits) {
+    char buf[64];
+    if (isnan(number)) return print("nan");
+    if (std::isinf(number)) return print("inf");
+    snprintf(buf, sizeof(buf), "%.*f", digits < 0 ? 0 : digits, number);
+    return write(buf);
+}
+
+// ---- String ----
+namespace {
+std::string toBase(unsigned long long n, unsigned char base) {
+    if (base < 2) base = 10;
+    std::string s;
+    do {
+        char c = (char)(n % base);
+        n /= base;
+        s.insert(s.begin(), c < 10 ? c + '0' : c + 'a' - 10);
+    } while (n);
+    return s;
+}
+
+std::string toFixed(double n, unsigned int decimals) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimals, n);
+    return buf;
+}
+}
+
+String::String(unsigned char n, unsigned char base) : _s(toBase(n, base)) {}
+String::String(int n, unsigned char base)
+    : _s(base == 10 && n < 0 ? "-" + toBase((unsigned long long)(-(long long)n), 10) : toBase((unsigned int)n, base)) {}
+String::String(unsigned int n, unsigned char base) : _s(toBase(n, base)) {}
+String::String(long n, unsigned char base)
+    : _s(base == 10 && n < 0 ? "-" + toBase((unsigned long long)(-(long long)n), 10) : toBase((unsigned long)n, base)) {}
+String::String(unsigned long n, unsigned char base) : _s(toBase(n, base)) {}
+String::String(float n, unsigned int decimalPlaces) : _s(toFixed(n, decimalPlaces)) {}
+String::String(double n, unsigned int decimalPlaces) : _s(toFixed(n, decimalPlaces)) {}
@@ -0,0 +1,148 @@
+#ifndef Arduino_h
+#define Arduino_h
+
+// 主机（Linux）仿真用的Arduino核心替身
+// 只实现本工程驱动实际用到的API子集；时间基于SimClock虚拟时钟。
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <cmath>
+#include <string>
+
+using std::isnan;
+
+#define HEX 16
+#define DEC 10
+#define OCT 8
+#define BIN 2
+
+#define LOW 0x0
+#define HIGH 0x1
+#define INPUT 0x01
+#define OUTPUT 0x03
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// 时间（虚拟时钟）
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+// GPIO（记录最后一次写入，便于仿真检查）
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+void analogWrite(uint8_t pin, int value);
+int simGetAnalogWrite(uint8_t pin);
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+
+class String;
+class Print;
+
+class Printable {
+public:
+    virtual ~Printable() {}
+    virtual size_t printTo(Print& p) const = 0;
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* str) { return str ? write((const uint8_t*)str, strlen(str)) : 0; }
+    size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+    int getWriteError() { return _writeError; }
+    void clearWriteError() { _writeError = 0; }
+
+    size_t print(const char* s);
+    size_t print(const String& s);
+    size_t print(char c);
+    size_t print(unsigned char n, int base = DEC);
+    size_t print(int n, int base = DEC);
+    size_t print(unsigned int n, int base = DEC);
+    size_t print(long n, int base = DEC);
+    size_t print(unsigned long n, int base = DEC);
+    size_t print(long long n, int base = DEC);
+    size_t print(unsigned long long n, int base = DEC);
+    size_t print(double n, int digits = 2);
+    size_t print(const Printable& x);
+
+    size_t println();
+    template <typename T>
+    size_t println(const T& v) { size_t n = print(v); return n + println(); }
+    template <typename T>
+    size_t println(const T& v, int fmt) { size_t n = print(v, fmt); return n + println(); }
+
+protected:
+    void setWriteError(int err = 1) { _writeError = err; }
+
+private:
+    int _writeError = 0;
+    size_t printNumber(unsigned long long n, int base);
+    size_t printFloat(double number, int digits);
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() { return -1; }
+    virtual void flush() {}
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+
+protected:
+    unsigned long _timeout = 1000;
+};
+
+// Arduino String的最小替身（基于std::string）
+class String {
+public:
+    String() {}
+    String(const char* s) : _s(s ? s : "") {}
+    String(const std::string& s) : _s(s) {}
+    explicit String(char c) : _s(1, c) {}
+    explicit String(unsigned char n, unsigned char base = 10);
+    explicit String(int n, unsigned char base = 10);
+    explicit String(unsigned int n, unsigned char base = 10);
+    explicit String(long n, unsigned char base = 10);
+    explicit String(unsigned long n, unsigned char base = 10);
+    explicit String(float n, unsigned int decimalPlaces = 2);
+    explicit String(double n, unsigned int decimalPlaces = 2);
+
+    const char* c_str() const { return _s.c_str(); }
+    unsigned int length() const { return (unsigned int)_s.size(); }
+    char operator[](unsigned int i) const { return _s[i]; }
+    bool operator==(const String& o) const { return _s == o._s; }
+    bool operator==(const char* o) const { return _s == (o ? o : ""); }
+    bool operator!=(const String& o) const { return _s != o._s; }
+
+    String& operator+=(const String& o) { _s += o._s; return *this; }
+    String& operator+=(const char* o) { if (o) _s += o; return *this; }
+    String& operator+=(char c) { _s += c; return *this; }
+
+    friend String operator+(const String& a, const String& b) { return String(a._s + b._s); }
+    friend String operator+(const String& a, const char* b) { return String(a._s + (b ? b : "")); }
+    friend String operator+(const char* a, const String& b) { return String(std::string(a ? a : "") + b._s); }
+
+private:
+    std::string _s;
+};
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp32-hal-timer.h"
+#include "esp32-hal-ledc.h"
+#include "HardwareSerial.h"
+
+#endif
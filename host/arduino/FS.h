@@ -0,0 +1,78 @@
+#ifndef FS_h
+#define FS_h
+
+// ESP32 FS（fs::FS / fs::File）替身：文件保存在主机目录中（见LittleFS.h），
+// 进程退出后仍保留，可模拟掉电重启后从闪存恢复。
+
+#include <memory>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class FS;
+
+class File {
+public:
+    File() {}
+
+    size_t write(const uint8_t* buf, size_t size);
+    size_t write(uint8_t c) { return write(&c, 1); }
+    size_t read(uint8_t* buf, size_t size);
+    int read();
+    int available();
+    bool seek(uint32_t pos, SeekMode mode = SeekSet);
+    size_t position() const;
+    size_t size() const;
+    void flush();
+    void close();
+    const char* path() const { return _path.c_str(); }
+    explicit operator bool() const { return (bool)_file; }
+
+private:
+    friend class FS;
+    std::shared_ptr<FILE> _file;
+    std::string _path;
+    FS* _fs = nullptr;
+};
+
+// 根目录为主机上的一个目录；路径以"/"开头
+class FS {
+public:
+    File open(const char* path, const char* mode = FILE_READ, bool create = false);
+    bool exists(const char* path);
+    bool remove(const char* path);
+    bool rename(const char* from, const char* to);
+    bool mkdir(const char* path);
+
+    // ---- 仿真检查接口 ----
+    void simSetRoot(const char* dir);
+    const char* simRoot() const { return _root.c_str(); }
+    uint64_t simBytesWritten() const { return _bytesWritten; }
+    uint32_t simWriteCalls() const { return _writeCalls; }
+    uint32_t simFilesRemoved() const { return _filesRemoved; }
+
+protected:
+    friend class File;
+    std::string hostPath(const char* path) const;
+
+    std::string _root;
+    bool _mounted = false;
+    uint64_t _bytesWritten = 0;
+    uint32_t _writeCalls = 0;
+    uint32_t _filesRemoved = 0;
+};
+
+}
+
+using fs::File;
+using fs::FS;
+
+#endif
@@ -0,0 +1,92 @@
+#include "HardwareSerial.h"
+#include "SimClock.h"
+
+#include <atomic>
+#include <stdio.h>
+
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+HardwareSerial Serial2(2);
+
+namespace {
+std::atomic<bool> g_consoleEnabled(true);  // 双核流水线中两个任务线程都会输出
+}
+
+void HardwareSerial::setConsoleEnabled(bool enabled) {
+    g_consoleEnabled = enabled;
+}
+
+bool HardwareSerial::consoleEnabled() {
+    return g_consoleEnabled;
+}
+
+void HardwareSerial::begin(unsigned long baud, uint32_t, int8_t, int8_t) {
+    _baud = baud ? baud : 115200;
+}
+
+uint32_t HardwareSerial::byteTimeUs() const {
+    // 8N1：每字节10位
+    return (uint32_t)((10ULL * 1000000 + _baud - 1) / _baud);
+}
+
+int HardwareSerial::available() {
+    uint64_t now = SimClock::nowUs();
+    int n = 0;
+    for (const RxByte& b : _rx) {
+        if (b.arrivalUs > now) break;
+        n++;
+    }
+    return n;
+}
+
+int HardwareSerial::read() {
+    if (_rx.empty() || _rx.front().arrivalUs > SimClock::nowUs()) return -1;
+    uint8_t v = _rx.front().value;
+    _rx.pop_front();
+    return v;
+}
+
+int HardwareSerial::peek() {
+    if (_rx.empty() || _rx.front().arrivalUs > SimClock::nowUs()) return -1;
+    return _rx.front().value;
+}
+
+void HardwareSerial::flush() {
+    if (_uartNum == 0) {
+        if (g_consoleEnabled) fflush(stdout);
+        return;
+    }
+    uint64_t now = SimClock::nowUs();
+    if (_txBusyUntilUs > now) SimClock::advanceUs(_txBusyUntilUs - now);
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    if (_uartNum == 0) {
+        if (g_consoleEnabled) fputc(c, stdout);
+        return 1;
+    }
+    uint64_t now = SimClock::nowUs();
+    uint64_t start = _txBusyUntilUs > now ? _txBusyUntilUs : now;
+    _txBusyUntilUs = start + byteTimeUs();
+    if (_device) _device->onHostByte(c, *this);
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    if (_uartNum == 0) {
+        if (g_consoleEnabled) fwrite(buffer, 1, size, stdout);
+        return size;
+    }
+    for (size_t i = 0; i < size; i++) write(buffer[i]);
+    return size;
+}
+
+void HardwareSerial::deliver(const uint8_t* data, size_t len, uint32_t latencyUs) {
+    uint64_t now = SimClock::nowUs();
+    uint64_t t = (_txBusyUntilUs > now ? _txBusyUntilUs : now) + latencyUs;
+    if (!_rx.empty() && _rx.back().arrivalUs > t) t = _rx.back().arrivalUs;
+    for (size_t i = 0; i < len; i++) {
+        t += byteTimeUs();
+        _rx.push_back({data[i], t});
+    }
+}
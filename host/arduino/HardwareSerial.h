@@ -0,0 +1,52 @@
+#ifndef HardwareSerial_h
+#define HardwareSerial_h
+
+// 主机仿真用的HardwareSerial替身
+// Serial（控制台）输出到stdout，可整体静音；Serial1/Serial2可挂载SimUartDevice模型。
+
+#include <deque>
+#include "Arduino.h"
+#include "SimUartDevice.h"
+
+class HardwareSerial : public Stream, public SimUartLink {
+public:
+    explicit HardwareSerial(int uartNum) : _uartNum(uartNum) {}
+
+    void begin(unsigned long baud, uint32_t config = 0, int8_t rxPin = -1, int8_t txPin = -1);
+    void end() {}
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    void flush() override;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    operator bool() const { return true; }
+
+    // 仿真接口
+    void attachDevice(SimUartDevice* device) { _device = device; }
+    void deliver(const uint8_t* data, size_t len, uint32_t latencyUs) override;
+    static void setConsoleEnabled(bool enabled);
+    static bool consoleEnabled();
+
+private:
+    struct RxByte {
+        uint8_t value;
+        uint64_t arrivalUs;
+    };
+
+    int _uartNum;
+    unsigned long _baud = 115200;
+    SimUartDevice* _device = nullptr;
+    std::deque<RxByte> _rx;
+    uint64_t _txBusyUntilUs = 0;
+
+    uint32_t byteTimeUs() const;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef IPAddress_h
+#define IPAddress_h
+
+#include "Arduino.h"
+
+class IPAddress : public Printable {
+public:
+    IPAddress() : _addr{0, 0, 0, 0} {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _addr{a, b, c, d} {}
+    // 网络字节序（内存中依次为a.b.c.d）
+    IPAddress(uint32_t address) { memcpy(_addr, &address, sizeof(_addr)); }
+    uint8_t operator[](int i) const { return _addr[i]; }
+
+    size_t printTo(Print& p) const override {
+        size_t n = 0;
+        for (int i = 0; i < 4; i++) {
+            n += p.print(_addr[i], DEC);
+            if (i < 3) n += p.print('.');
+        }
+        return n;
+    }
+
+private:
+    uint8_t _addr[4];
+};
+
+#endif
@@ -0,0 +1,169 @@
+#include "LittleFS.h"
+
+#include <filesystem>
+#include <sys/stat.h>
+
+fs::LittleFSFS LittleFS;
+
+namespace fs {
+
+namespace {
+constexpr const char* DEFAULT_ROOT = "/tmp/breath_littlefs";
+}
+
+// ---------------- File ----------------
+
+size_t File::write(const uint8_t* buf, size_t size) {
+    if (!_file || size == 0) return 0;
+    size_t n = fwrite(buf, 1, size, _file.get());
+    if (_fs) {
+        _fs->_bytesWritten += n;
+        _fs->_writeCalls++;
+    }
+    return n;
+}
+
+size_t File::read(uint8_t* buf, size_t size) {
+    if (!_file) return 0;
+    return fread(buf, 1, size, _file.get());
+}
+
+int File::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::available() {
+    if (!_file) return 0;
+    return (int)(size() - position());
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+    if (!_file) return false;
+    int whence = mode == SeekCur ? SEEK_CUR : mode == SeekEnd ? SEEK_END : SEEK_SET;
+    return fseek(_file.get(), (long)pos, whence) == 0;
+}
+
+size_t File::position() const {
+    if (!_file) return 0;
+    long pos = ftell(_file.get());
+    return pos < 0 ? 0 : (size_t)pos;
+}
+
+size_t File::size() const {
+    if (!_file) return 0;
+    fflush(_file.get());
+    struct stat st;
+    if (fstat(fileno(_file.get()), &st) != 0) return 0;
+    return (size_t)st.st_size;
+}
+
+void File::flush() {
+    if (_file) fflush(_file.get());
+}
+
+void File::close() {
+    _file.reset();
+}
+
+// ---------------- FS ----------------
+
+void FS::simSetRoot(const char* dir) {
+    _root = dir ? dir : "";
+}
+
+std::string FS::hostPath(const char* path) const {
+    std::string p = path ? path : "";
+    if (p.empty() || p[0] != '/') p = "/" + p;
+    return _root + p;
+}
+
+File FS::open(const char* path, const char* mode, bool create) {
+    (void)create;
+    File f;
+    if (!_mounted || !path || !mode) return f;
+    std::string hp = hostPath(path);
+    // 与ESP32 VFS一致：写入/追加时自动创建上级目录
+    if (mode[0] == 'w' || mode[0] == 'a') {
+        std::error_code ec;
+        std::filesystem::create_directories(std::filesystem::path(hp).parent_path(), ec);
+    }
+    std::string m = std::string(mode) + "b";
+    FILE* fp = fopen(hp.c_str(), m.c_str());
+    if (!fp) return f;
+    f._file.reset(fp, fclose);
+    f._path = path;
+    f._fs = this;
+    return f;
+}
+
+bool FS::exists(const char* path) {
+    if (!_mounted || !path) return false;
+    std::error_code ec;
+    return std::filesystem::exists(hostPath(path), ec);
+}
+
+bool FS::remove(const char* path) {
+    if (!_mounted || !path) return false;
+    std::error_code ec;
+    bool ok = std::filesystem::remove(hostPath(path), ec);
+    if (ok) _filesRemoved++;
+    return ok;
+}
+
+bool FS::rename(const char* from, const char* to) {
+    if (!_mounted || !from || !to) return false;
+    std::error_code ec;
+    std::filesystem::rename(hostPath(from), hostPath(to), ec);
+    return !ec;
+}
+
+bool FS::mkdir(const char* path) {
+    if (!_mounted || !path) return false;
+    std::error_code ec;
+    std::filesystem::create_directories(hostPath(path), ec);
+    return !ec;
+}
+
+// ---------------- LittleFS ----------------
+
+bool LittleFSFS::begin(bool formatOnFail, const char* basePath, uint8_t maxOpenFiles, const char* partitionLabel) {
+    (void)formatOnFail;
+    (void)basePath;
+    (void)maxOpenFiles;
+    (void)partitionLabel;
+    if (_root.empty()) _root = DEFAULT_ROOT;
+    std::error_code ec;
+    std::filesystem::create_directories(_root, ec);
+    _mounted = !ec;
+    return _mounted;
+}
+
+void LittleFSFS::end() {
+    _mounted = false;
+}
+
+bool LittleFSFS::format() {
+    if (_root.empty()) return false;
+    std::error_code ec;
+    std::filesystem::remove_all(_root, ec);
+    std::filesystem::create_directories(_root, ec);
+    return !ec;
+}
+
+size_t LittleFSFS::totalBytes() {
+    return _capacity;
+}
+
+size_t LittleFSFS::usedBytes() {
+    if (!_mounted) return 0;
+    size_t used = 0;
+    std::error_code ec;
+    for (auto it = std::filesystem::recursive_directory_iterator(_root, ec);
+         !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+        if (it->is_regular_file(ec)) used += (size_t)it->file_size(ec);
+    }
+    return used;
+}
+
+}
@@ -0,0 +1,31 @@
+#ifndef LittleFS_h
+#define LittleFS_h
+
+// ESP32 LittleFS替身：分区内容保存在主机目录（默认/tmp/breath_littlefs，可用simSetRoot()
+// 指定），begin()时创建。容量按默认分区表的数据分区计算，usedBytes()为目录中文件大小之和；
+// 仿真可统计写入字节数和写调用次数（闪存擦写寿命）。
+
+#include "FS.h"
+
+namespace fs {
+
+class LittleFSFS : public FS {
+public:
+    bool begin(bool formatOnFail = false, const char* basePath = "/littlefs", uint8_t maxOpenFiles = 10,
+               const char* partitionLabel = "spiffs");
+    void end();
+    bool format();
+    size_t totalBytes();
+    size_t usedBytes();
+
+    void simSetCapacity(size_t bytes) { _capacity = bytes; }
+
+private:
+    size_t _capacity = 0x160000;   // 默认分区表的1.375MB数据分区
+};
+
+}
+
+extern fs::LittleFSFS LittleFS;
+
+#endif
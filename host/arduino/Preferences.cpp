@@ -0,0 +1,88 @@
+#include "Preferences.h"
+
+#include <map>
+#include <mutex>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr size_t NVS_KEY_MAX = 15;   // NVS命名空间和键名最长15字符
+
+std::map<std::string, std::vector<uint8_t>> g_store;   // "命名空间/键" -> 数据
+uint32_t g_writes = 0;
+std::mutex g_prefsMutex;
+
+std::string storeKey(const char* ns, const char* key) {
+    return std::string(ns) + "/" + key;
+}
+}
+
+bool Preferences::begin(const char* name, bool readOnly) {
+    if (!name || strlen(name) > NVS_KEY_MAX) return false;
+    strncpy(_namespace, name, sizeof(_namespace) - 1);
+    _readOnly = readOnly;
+    _started = true;
+    return true;
+}
+
+void Preferences::end() {
+    _started = false;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+    if (!_started || _readOnly || !key || strlen(key) > NVS_KEY_MAX || !value || len == 0) return 0;
+    std::lock_guard<std::mutex> lock(g_prefsMutex);
+    const uint8_t* bytes = static_cast<const uint8_t*>(value);
+    g_store[storeKey(_namespace, key)].assign(bytes, bytes + len);
+    g_writes++;
+    return len;
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+    if (!_started || !key) return 0;
+    std::lock_guard<std::mutex> lock(g_prefsMutex);
+    auto it = g_store.find(storeKey(_namespace, key));
+    if (it == g_store.end()) return 0;
+    size_t len = it->second.size();
+    if (!buf) return len;
+    if (len > maxLen) return 0;   // 与NVS一致：缓冲区不足时不读取
+    memcpy(buf, it->second.data(), len);
+    return len;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    return getBytes(key, nullptr, 0);
+}
+
+bool Preferences::isKey(const char* key) {
+    return getBytesLength(key) > 0;
+}
+
+bool Preferences::remove(const char* key) {
+    if (!_started || _readOnly || !key) return false;
+    std::lock_guard<std::mutex> lock(g_prefsMutex);
+    return g_store.erase(storeKey(_namespace, key)) > 0;
+}
+
+bool Preferences::clear() {
+    if (!_started || _readOnly) return false;
+    std::lock_guard<std::mutex> lock(g_prefsMutex);
+    std::string prefix = std::string(_namespace) + "/";
+    for (auto it = g_store.begin(); it != g_store.end();) {
+        if (it->first.compare(0, prefix.size(), prefix) == 0) it = g_store.erase(it);
+        else ++it;
+    }
+    return true;
+}
+
+void simPreferencesClear() {
+    std::lock_guard<std::mutex> lock(g_prefsMutex);
+    g_store.clear();
+    g_writes = 0;
+}
+
+uint32_t simPreferencesWrites() {
+    std::lock_guard<std::mutex> lock(g_prefsMutex);
+    return g_writes;
+}
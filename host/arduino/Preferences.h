@@ -0,0 +1,33 @@
+#ifndef Preferences_h
+#define Preferences_h
+
+// ESP32 Preferences（NVS键值存储）替身
+// 各命名空间的数据保存在进程内，多个Preferences实例共享，模拟掉电保留的闪存；
+// 仿真可清空全部存储或统计写入次数（闪存擦写寿命）。
+
+#include <stdint.h>
+#include <stddef.h>
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false);
+    void end();
+
+    size_t putBytes(const char* key, const void* value, size_t len);
+    size_t getBytes(const char* key, void* buf, size_t maxLen);
+    size_t getBytesLength(const char* key);
+    bool isKey(const char* key);
+    bool remove(const char* key);
+    bool clear();
+
+private:
+    char _namespace[16] = {};
+    bool _started = false;
+    bool _readOnly = false;
+};
+
+// ---- 仿真检查接口 ----
+void simPreferencesClear();
+uint32_t simPreferencesWrites();
+
+#endif
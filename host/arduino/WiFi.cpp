@@ -0,0 +1,151 @@
+#include "WiFi.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+WiFiClass WiFi;
+
+wl_status_t WiFiClass::begin(const char*, const char*) {
+    _joining = true;
+    _beginAt = millis();
+    return status();
+}
+
+bool WiFiClass::disconnect(bool) {
+    _joining = false;
+    return true;
+}
+
+wl_status_t WiFiClass::status() {
+    if (!_joining) return WL_DISCONNECTED;
+    if (!_available) return WL_NO_SSID_AVAIL;
+    if (millis() - _beginAt < _joinTimeMs) return WL_IDLE_STATUS;
+    return WL_CONNECTED;
+}
+
+// ---- WiFiClient ----
+WiFiClient::~WiFiClient() {
+    stop();
+}
+
+int WiFiClient::connect(const char* host, uint16_t port) {
+    return connect(host, port, (int32_t)_timeout);
+}
+
+int WiFiClient::connect(const char* host, uint16_t port, int32_t timeoutMs) {
+    stop();
+    if (!host) return 0;
+    if (!WiFi.simServerReachable()) {
+        delay(timeoutMs > 0 ? (uint32_t)timeoutMs : 0);
+        setWriteError(ETIMEDOUT);
+        return 0;
+    }
+
+    struct addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* res = nullptr;
+    char portStr[8];
+    snprintf(portStr, sizeof(portStr), "%u", (unsigned)port);
+    if (getaddrinfo(host, portStr, &hints, &res) != 0 || !res) return 0;
+
+    int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    if (fd < 0) {
+        freeaddrinfo(res);
+        return 0;
+    }
+
+    // 非阻塞连接 + poll等待，超时语义与ESP32一致
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    int rc = ::connect(fd, res->ai_addr, res->ai_addrlen);
+    freeaddrinfo(res);
+    if (rc != 0 && errno == EINPROGRESS) {
+        struct pollfd pfd = {fd, POLLOUT, 0};
+        rc = poll(&pfd, 1, timeoutMs > 0 ? timeoutMs : -1) == 1 ? 0 : -1;
+        if (rc == 0) {
+            int err = 0;
+            socklen_t len = sizeof(err);
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len);
+            rc = err == 0 ? 0 : -1;
+        }
+    }
+    if (rc != 0) {
+        close(fd);
+        setWriteError(errno ? errno : 1);
+        return 0;
+    }
+    fcntl(fd, F_SETFL, flags);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    _fd = fd;
+    clearWriteError();
+    return 1;
+}
+
+uint8_t WiFiClient::connected() {
+    if (_fd < 0) return 0;
+    uint8_t probe;
+    ssize_t n = recv(_fd, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n == 0) {
+        stop();
+        return 0;
+    }
+    if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+        stop();
+        return 0;
+    }
+    return 1;
+}
+
+void WiFiClient::stop() {
+    if (_fd >= 0) {
+        close(_fd);
+        _fd = -1;
+    }
+}
+
+size_t WiFiClient::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t WiFiClient::write(const uint8_t* buf, size_t size) {
+    if (_fd < 0) return 0;
+    size_t sent = 0;
+    while (sent < size) {
+        ssize_t n = send(_fd, buf + sent, size - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            setWriteError(errno ? errno : 1);
+            stop();
+            break;
+        }
+        sent += (size_t)n;
+    }
+    return sent;
+}
+
+int WiFiClient::available() {
+    if (_fd < 0) return 0;
+    uint8_t buf[512];
+    ssize_t n = recv(_fd, buf, sizeof(buf), MSG_PEEK | MSG_DONTWAIT);
+    return n > 0 ? (int)n : 0;
+}
+
+int WiFiClient::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int WiFiClient::read(uint8_t* buf, size_t size) {
+    if (_fd < 0) return -1;
+    ssize_t n = recv(_fd, buf, size, MSG_DONTWAIT);
+    return n > 0 ? (int)n : -1;
+}
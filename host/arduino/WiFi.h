@@ -0,0 +1,54 @@
+#ifndef WiFi_h
+#define WiFi_h
+
+// 主机仿真用的WiFi替身：网络始终通过本机协议栈，可用性由仿真控制
+
+#include "Arduino.h"
+#include "IPAddress.h"
+#include "WiFiClient.h"
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+class WiFiClass {
+public:
+    wl_status_t begin(const char* ssid, const char* passphrase = nullptr);
+    bool disconnect(bool wifioff = false);
+    wl_status_t status();
+    IPAddress localIP() { return IPAddress(127, 0, 0, 1); }
+
+    // 仿真接口：AP是否可用、关联所需时间
+    void simSetAvailable(bool available) { _available = available; }
+    void simSetJoinTimeMs(uint32_t ms) { _joinTimeMs = ms; }
+    // 服务器不可达：WiFiClient::connect()阻塞到超时后失败（如同SYN无应答）
+    void simSetServerReachable(bool reachable) { _serverReachable = reachable; }
+    bool simServerReachable() const { return _serverReachable; }
+    // UDP链路损伤：按概率丢弃数据报，或把数据报推迟到下一个之后发出（乱序）；服务器不可达时全部丢弃
+    void simSetUdpImpairment(float lossRate, float reorderRate) { _udpLossRate = lossRate; _udpReorderRate = reorderRate; }
+    float simUdpLossRate() const { return _udpLossRate; }
+    float simUdpReorderRate() const { return _udpReorderRate; }
+    // TCP链路带宽（字节/秒，0为不限）：lwip_send()按lwIP发送缓冲区（LWIP_SIM_SND_BUF）建模，
+    // 缓冲区按此速率排空，满时只收下一部分或返回EAGAIN
+    void simSetLinkRate(uint32_t bytesPerSec) { _linkRate = bytesPerSec; }
+    uint32_t simLinkRate() const { return _linkRate; }
+
+private:
+    bool _available = true;
+    bool _serverReachable = true;
+    float _udpLossRate = 0;
+    float _udpReorderRate = 0;
+    uint32_t _linkRate = 0;
+    bool _joining = false;
+    uint32_t _joinTimeMs = 0;
+    unsigned long _beginAt = 0;
+};
+
+extern WiFiClass WiFi;
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef WiFiClient_h
+#define WiFiClient_h
+
+// 主机仿真用的WiFiClient替身：基于POSIX TCP套接字，可直接连本机服务端
+
+#include "Arduino.h"
+
+class WiFiClient : public Stream {
+public:
+    WiFiClient() {}
+    ~WiFiClient();
+    WiFiClient(const WiFiClient&) = delete;
+    WiFiClient& operator=(const WiFiClient&) = delete;
+
+    int connect(const char* host, uint16_t port);
+    int connect(const char* host, uint16_t port, int32_t timeoutMs);
+    uint8_t connected();
+    void stop();
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buf, size_t size) override;
+    using Print::write;
+    int available() override;
+    int read() override;
+    int read(uint8_t* buf, size_t size);
+    void flush() override {}
+    void setTimeout(unsigned long timeoutMs) { _timeout = timeoutMs; }
+
+    int fd() const { return _fd; }
+    operator bool() { return connected(); }
+
+private:
+    int _fd = -1;
+};
+
+#endif
@@ -0,0 +1,143 @@
+#include "WiFiUdp.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netdb.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "WiFi.h"
+
+WiFiUDP::~WiFiUDP() {
+    stop();
+}
+
+bool WiFiUDP::ensureSocket() {
+    if (_fd >= 0) return true;
+    _fd = socket(AF_INET, SOCK_DGRAM, 0);
+    return _fd >= 0;
+}
+
+uint8_t WiFiUDP::begin(uint16_t port) {
+    stop();
+    if (!ensureSocket()) return 0;
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(_fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        stop();
+        return 0;
+    }
+    return 1;
+}
+
+void WiFiUDP::stop() {
+    if (_fd >= 0) {
+        if (_heldLength) sendDatagram(_heldBuffer, _heldLength, _heldAddr);
+        close(_fd);
+        _fd = -1;
+    }
+    _heldLength = 0;
+    _rxLength = _rxPos = 0;
+}
+
+int WiFiUDP::beginPacket(IPAddress ip, uint16_t port) {
+    if (!ensureSocket()) return 0;
+    memset(&_txAddr, 0, sizeof(_txAddr));
+    _txAddr.sin_family = AF_INET;
+    uint8_t* a = (uint8_t*)&_txAddr.sin_addr.s_addr;
+    for (int i = 0; i < 4; i++) a[i] = ip[i];
+    _txAddr.sin_port = htons(port);
+    _txLength = 0;
+    _txOverflow = false;
+    return 1;
+}
+
+int WiFiUDP::beginPacket(const char* host, uint16_t port) {
+    if (!host || !ensureSocket()) return 0;
+    struct addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    struct addrinfo* res = nullptr;
+    if (getaddrinfo(host, nullptr, &hints, &res) != 0 || !res) return 0;
+    memcpy(&_txAddr, res->ai_addr, sizeof(_txAddr));
+    freeaddrinfo(res);
+    _txAddr.sin_port = htons(port);
+    _txLength = 0;
+    _txOverflow = false;
+    return 1;
+}
+
+size_t WiFiUDP::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t WiFiUDP::write(const uint8_t* buf, size_t size) {
+    if (_txLength + size > sizeof(_txBuffer)) {
+        _txOverflow = true;
+        return 0;
+    }
+    memcpy(_txBuffer + _txLength, buf, size);
+    _txLength += size;
+    return size;
+}
+
+int WiFiUDP::endPacket() {
+    if (_fd < 0 || _txOverflow) return 0;
+    size_t len = _txLength;
+    _txLength = 0;
+
+    // 损伤模拟：丢失的数据报对发送方仍是“发送成功”，与真实UDP一致
+    if (!WiFi.simServerReachable()) return 1;
+    _rng = _rng * 1664525u + 1013904223u;
+    float u = (_rng >> 8) / 16777216.0f;
+    if (u < WiFi.simUdpLossRate()) return 1;
+    if (!_heldLength && u < WiFi.simUdpLossRate() + WiFi.simUdpReorderRate()) {
+        memcpy(_heldBuffer, _txBuffer, len);
+        _heldLength = len;
+        _heldAddr = _txAddr;
+        return 1;
+    }
+    bool ok = sendDatagram(_txBuffer, len, _txAddr);
+    if (_heldLength) {
+        sendDatagram(_heldBuffer, _heldLength, _heldAddr);
+        _heldLength = 0;
+    }
+    return ok ? 1 : 0;
+}
+
+bool WiFiUDP::sendDatagram(const uint8_t* buf, size_t len, const struct sockaddr_in& addr) {
+    ssize_t n;
+    do {
+        n = sendto(_fd, buf, len, 0, (const struct sockaddr*)&addr, sizeof(addr));
+    } while (n < 0 && errno == EINTR);
+    if (n != (ssize_t)len) {
+        setWriteError(errno ? errno : 1);
+        return false;
+    }
+    return true;
+}
+
+int WiFiUDP::parsePacket() {
+    if (_fd < 0) return 0;
+    ssize_t n = recv(_fd, _rxBuffer, sizeof(_rxBuffer), MSG_DONTWAIT);
+    _rxPos = 0;
+    _rxLength = n > 0 ? (size_t)n : 0;
+    return (int)_rxLength;
+}
+
+int WiFiUDP::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int WiFiUDP::read(uint8_t* buf, size_t size) {
+    size_t n = _rxLength - _rxPos;
+    if (n == 0) return -1;
+    if (n > size) n = size;
+    memcpy(buf, _rxBuffer + _rxPos, n);
+    _rxPos += n;
+    return (int)n;
+}
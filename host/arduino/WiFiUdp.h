@@ -0,0 +1,53 @@
+#ifndef WiFiUdp_h
+#define WiFiUdp_h
+
+// 主机仿真用的WiFiUDP替身：基于POSIX UDP套接字，数据报经本机协议栈发出，
+// 发送时按WiFi.simSetUdpImpairment()模拟丢包和乱序
+
+#include <netinet/in.h>
+
+#include "Arduino.h"
+#include "IPAddress.h"
+
+class WiFiUDP : public Stream {
+public:
+    WiFiUDP() {}
+    ~WiFiUDP();
+    WiFiUDP(const WiFiUDP&) = delete;
+    WiFiUDP& operator=(const WiFiUDP&) = delete;
+
+    uint8_t begin(uint16_t port);
+    void stop();
+
+    int beginPacket(IPAddress ip, uint16_t port);
+    int beginPacket(const char* host, uint16_t port);
+    int endPacket();
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buf, size_t size) override;
+    using Print::write;
+
+    int parsePacket();
+    int available() override { return (int)(_rxLength - _rxPos); }
+    int read() override;
+    int read(uint8_t* buf, size_t size);
+    void flush() override {}
+
+private:
+    bool ensureSocket();
+    bool sendDatagram(const uint8_t* buf, size_t len, const struct sockaddr_in& addr);
+
+    int _fd = -1;
+    uint8_t _txBuffer[1472];    // 以太网MTU下的最大UDP负载
+    size_t _txLength = 0;
+    bool _txOverflow = false;
+    struct sockaddr_in _txAddr = {};
+    uint8_t _heldBuffer[1472];  // 乱序模拟：推迟发送的数据报
+    size_t _heldLength = 0;
+    struct sockaddr_in _heldAddr = {};
+    uint8_t _rxBuffer[1472];
+    size_t _rxLength = 0;
+    size_t _rxPos = 0;
+    uint32_t _rng = 12345;
+};
+
+#endif
@@ -0,0 +1,72 @@
+#include "Wire.h"
+
+TwoWire Wire;
+
+bool TwoWire::begin(int, int, uint32_t frequency) {
+    if (frequency) _bus.setClockHz(frequency);
+    return true;
+}
+
+bool TwoWire::end() {
+    _transmitting = false;
+    _txLength = 0;
+    _rxLength = _rxIndex = 0;
+    return true;
+}
+
+bool TwoWire::setClock(uint32_t frequency) {
+    _bus.setClockHz(frequency);
+    return true;
+}
+
+void TwoWire::beginTransmission(uint16_t address) {
+    _txAddress = address;
+    _txLength = 0;
+    _transmitting = true;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+    if (!_transmitting) return 4;
+    _transmitting = false;
+    return _bus.write((uint8_t)_txAddress, _txBuffer, _txLength, sendStop);
+}
+
+uint8_t TwoWire::requestFrom(int address, int quantity, int) {
+    if (quantity < 0) quantity = 0;
+    if ((size_t)quantity > sizeof(_rxBuffer)) quantity = sizeof(_rxBuffer);
+    _rxIndex = 0;
+    _rxLength = _bus.read((uint8_t)address, _rxBuffer, (size_t)quantity);
+    return (uint8_t)_rxLength;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    if (!_transmitting || _txLength >= sizeof(_txBuffer)) {
+        setWriteError();
+        return 0;
+    }
+    _txBuffer[_txLength++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t quantity) {
+    size_t n = 0;
+    for (size_t i = 0; i < quantity; i++) {
+        if (!write(data[i])) break;
+        n++;
+    }
+    return n;
+}
+
+int TwoWire::available() {
+    return (int)(_rxLength - _rxIndex);
+}
+
+int TwoWire::read() {
+    if (_rxIndex >= _rxLength) return -1;
+    return _rxBuffer[_rxIndex++];
+}
+
+int TwoWire::peek() {
+    if (_rxIndex >= _rxLength) return -1;
+    return _rxBuffer[_rxIndex];
+}
@@ -0,0 +1,55 @@
+#ifndef TwoWire_h
+#define TwoWire_h
+
+// 主机仿真用的TwoWire替身：事务转发给SimBus上的设备模型
+
+#include "Arduino.h"
+#include "SimBus.h"
+
+#ifndef I2C_BUFFER_LENGTH
+#define I2C_BUFFER_LENGTH 128
+#endif
+
+class TwoWire : public Stream {
+public:
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+    bool end();
+    bool setClock(uint32_t frequency);
+    uint32_t getClock() { return _bus.clockHz(); }
+
+    void beginTransmission(uint16_t address);
+    void beginTransmission(int address) { beginTransmission((uint16_t)address); }
+    uint8_t endTransmission(bool sendStop);
+    uint8_t endTransmission() { return endTransmission(true); }
+
+    uint8_t requestFrom(int address, int quantity, int sendStop = 1);
+
+    size_t write(uint8_t data) override;
+    size_t write(const uint8_t* data, size_t quantity) override;
+    using Print::write;
+    size_t write(unsigned long n) { return write((uint8_t)n); }
+    size_t write(long n) { return write((uint8_t)n); }
+    size_t write(unsigned int n) { return write((uint8_t)n); }
+    size_t write(int n) { return write((uint8_t)n); }
+    int available() override;
+    int read() override;
+    int peek() override;
+    void flush() override {}
+
+    // 仿真总线（挂载设备模型、读取统计）
+    SimBus& bus() { return _bus; }
+
+private:
+    SimBus _bus;
+    uint16_t _txAddress = 0;
+    bool _transmitting = false;
+    uint8_t _txBuffer[I2C_BUFFER_LENGTH];
+    size_t _txLength = 0;
+    uint8_t _rxBuffer[I2C_BUFFER_LENGTH];
+    size_t _rxLength = 0;
+    size_t _rxIndex = 0;
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,182 @@
+#include "esp32-hal-ledc.h"
+#include "driver/ledc.h"
+#include "SimClock.h"
+
+#include <math.h>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace {
+constexpr uint32_t APB_CLK_HZ = 80000000;
+
+struct LedcChannel {
+    uint32_t freq = 0;
+    uint8_t bits = 0;
+    // 当前输出：从startDuty在[startUs, endUs]内线性变化到targetDuty
+    uint32_t startDuty = 0;
+    uint32_t targetDuty = 0;
+    uint64_t startUs = 0;
+    uint64_t endUs = 0;
+    // ledc_set_fade_with_time设置、ledc_fade_start启动
+    bool fadePending = false;
+    uint32_t pendingDuty = 0;
+    uint32_t pendingMs = 0;
+
+    uint32_t dutyAt(uint64_t us) const {
+        if (us >= endUs || endUs == startUs) return us >= startUs ? targetDuty : startDuty;
+        if (us <= startUs) return startDuty;
+        double f = (double)(us - startUs) / (endUs - startUs);
+        return (uint32_t)llround(startDuty + f * ((double)targetDuty - startDuty));
+    }
+};
+
+LedcChannel g_channels[SIM_LEDC_CHANNELS];
+std::map<uint8_t, uint8_t> g_pins;
+std::vector<SimLedcCommand> g_commands;
+bool g_fadeInstalled = false;
+std::mutex g_ledcMutex;
+
+void apply(uint8_t channel, SimLedcCommandType type, uint32_t duty, uint32_t fadeMs) {
+    LedcChannel& c = g_channels[channel];
+    uint64_t now = SimClock::nowUs();
+    SimLedcCommand cmd;
+    cmd.timeUs = now;
+    cmd.channel = channel;
+    cmd.type = type;
+    cmd.startDuty = c.dutyAt(now);
+    cmd.targetDuty = duty;
+    cmd.fadeMs = fadeMs;
+    g_commands.push_back(cmd);
+
+    c.startDuty = cmd.startDuty;
+    c.targetDuty = duty;
+    c.startUs = now;
+    c.endUs = now + (uint64_t)fadeMs * 1000;
+}
+
+int toChannel(ledc_mode_t mode, ledc_channel_t channel) {
+    if (mode >= LEDC_SPEED_MODE_MAX || channel >= LEDC_CHANNEL_MAX) return -1;
+    return mode * 8 + channel;
+}
+}
+
+double ledcSetup(uint8_t channel, double freq, uint8_t resolution_bits) {
+    if (channel >= SIM_LEDC_CHANNELS || resolution_bits == 0 || resolution_bits > 20 || freq <= 0) return 0;
+    // 计数器时钟不能超过APB时钟：freq * 2^bits <= 80MHz
+    if (freq * (double)(1UL << resolution_bits) > APB_CLK_HZ) return 0;
+    std::lock_guard<std::mutex> lock(g_ledcMutex);
+    LedcChannel& c = g_channels[channel];
+    c = LedcChannel();
+    c.freq = (uint32_t)freq;
+    c.bits = resolution_bits;
+    return freq;
+}
+
+void ledcAttachPin(uint8_t pin, uint8_t channel) {
+    if (channel >= SIM_LEDC_CHANNELS) return;
+    std::lock_guard<std::mutex> lock(g_ledcMutex);
+    g_pins[pin] = channel;
+}
+
+void ledcDetachPin(uint8_t pin) {
+    std::lock_guard<std::mutex> lock(g_ledcMutex);
+    g_pins.erase(pin);
+}
+
+void ledcWrite(uint8_t channel, uint32_t duty) {
+    if (channel >= SIM_LEDC_CHANNELS) return;
+    std::lock_guard<std::mutex> lock(g_ledcMutex);
+    if (g_channels[channel].bits == 0) return;
+    uint32_t max = (1UL << g_channels[channel].bits);
+    apply(channel, SIM_LEDC_WRITE, duty > max ? max : duty, 0);
+}
+
+uint32_t ledcRead(uint8_t channel) {
+    if (channel >= SIM_LEDC_CHANNELS) return 0;
+    std::lock_guard<std::mutex> lock(g_ledcMutex);
+    return g_channels[channel].dutyAt(SimClock::nowUs());
+}
+
+esp_err_t ledc_fade_func_install(int) {
+    std::lock_guard<std::mutex> lock(g_ledcMutex);
+    if (g_fadeInstalled) return ESP_ERR_INVALID_STATE;
+    g_fadeInstalled = true;
+    return ESP_OK;
+}
+
+void ledc_fade_func_uninstall(void) {
+    std::lock_guard<std::mutex> lock(g_ledcMutex);
+    g_fadeInstalled = false;
+}
+
+esp_err_t ledc_set_fade_with_time(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t target_duty,
+                                  int max_fade_time_ms) {
+    int ch = toChannel(speed_mode, channel);
+    if (ch < 0 || max_fade_time_ms < 0) return ESP_ERR_INVALID_ARG;
+    std::lock_guard<std::mutex> lock(g_ledcMutex);
+    if (!g_fadeInstalled || g_channels[ch].bits == 0) return ESP_ERR_INVALID_STATE;
+    uint32_t max = (1UL << g_channels[ch].bits);
+    g_channels[ch].fadePending = true;
+    g_channels[ch].pendingDuty = target_duty > max ? max : target_duty;
+    g_channels[ch].pendingMs = (uint32_t)max_fade_time_ms;
+    return ESP_OK;
+}
+
+esp_err_t ledc_fade_start(ledc_mode_t speed_mode, ledc_channel_t channel, ledc_fade_mode_t fade_mode) {
+    int ch = toChannel(speed_mode, channel);
+    if (ch < 0) return ESP_ERR_INVALID_ARG;
+    uint64_t endUs;
+    {
+        std::lock_guard<std::mutex> lock(g_ledcMutex);
+        LedcChannel& c = g_channels[ch];
+        if (!g_fadeInstalled || !c.fadePending) return ESP_ERR_INVALID_STATE;
+        c.fadePending = false;
+        apply((uint8_t)ch, SIM_LEDC_FADE, c.pendingDuty, c.pendingMs);
+        endUs = c.endUs;
+    }
+    if (fade_mode == LEDC_FADE_WAIT_DONE && endUs > SimClock::nowUs()) {
+        SimClock::advanceUs(endUs - SimClock::nowUs());
+    }
+    return ESP_OK;
+}
+
+uint32_t ledc_get_duty(ledc_mode_t speed_mode, ledc_channel_t channel) {
+    int ch = toChannel(speed_mode, channel);
+    return ch < 0 ? 0 : ledcRead((uint8_t)ch);
+}
+
+size_t simLedcCommandCount() {
+    std::lock_guard<std::mutex> lock(g_ledcMutex);
+    return g_commands.size();
+}
+
+const SimLedcCommand& simLedcCommand(size_t index) {
+    std::lock_guard<std::mutex> lock(g_ledcMutex);
+    return g_commands[index];
+}
+
+void simLedcClearCommands() {
+    std::lock_guard<std::mutex> lock(g_ledcMutex);
+    g_commands.clear();
+}
+
+uint32_t simLedcDutyAt(uint8_t channel, uint64_t timeUs) {
+    if (channel >= SIM_LEDC_CHANNELS) return 0;
+    std::lock_guard<std::mutex> lock(g_ledcMutex);
+    return g_channels[channel].dutyAt(timeUs);
+}
+
+uint32_t simLedcFrequency(uint8_t channel) {
+    return channel < SIM_LEDC_CHANNELS ? g_channels[channel].freq : 0;
+}
+
+uint8_t simLedcResolution(uint8_t channel) {
+    return channel < SIM_LEDC_CHANNELS ? g_channels[channel].bits : 0;
+}
+
+int simLedcPinChannel(uint8_t pin) {
+    std::lock_guard<std::mutex> lock(g_ledcMutex);
+    auto it = g_pins.find(pin);
+    return it == g_pins.end() ? -1 : it->second;
+}
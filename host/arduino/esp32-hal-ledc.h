@@ -0,0 +1,39 @@
+#ifndef esp32_hal_ledc_h
+#define esp32_hal_ledc_h
+
+// ESP32 LEDC PWM API替身（arduino-esp32 2.x接口）
+// 通道0–7对应高速组、8–15对应低速组，与driver/ledc.h的(模式, 通道)一一对应。
+// 每次占空比写入和硬件渐变都记录下来，仿真可读取命令序列和任意时刻的输出占空比。
+
+#include <stdint.h>
+#include <stddef.h>
+
+constexpr uint8_t SIM_LEDC_CHANNELS = 16;
+
+double ledcSetup(uint8_t channel, double freq, uint8_t resolution_bits);
+void ledcAttachPin(uint8_t pin, uint8_t channel);
+void ledcDetachPin(uint8_t pin);
+void ledcWrite(uint8_t channel, uint32_t duty);
+uint32_t ledcRead(uint8_t channel);
+
+// ---- 仿真检查接口 ----
+enum SimLedcCommandType { SIM_LEDC_WRITE, SIM_LEDC_FADE };
+
+struct SimLedcCommand {
+    uint64_t timeUs;
+    uint8_t channel;
+    SimLedcCommandType type;
+    uint32_t startDuty;     // 命令开始时的输出占空比
+    uint32_t targetDuty;
+    uint32_t fadeMs;        // 写入为0
+};
+
+size_t simLedcCommandCount();
+const SimLedcCommand& simLedcCommand(size_t index);
+void simLedcClearCommands();
+uint32_t simLedcDutyAt(uint8_t channel, uint64_t timeUs);   // 渐变按线性插值
+uint32_t simLedcFrequency(uint8_t channel);
+uint8_t simLedcResolution(uint8_t channel);
+int simLedcPinChannel(uint8_t pin);                         // 未连接为-1
+
+#endif
@@ -0,0 +1,112 @@
+#include "esp32-hal-timer.h"
+#include "SimClock.h"
+
+#include <mutex>
+
+namespace {
+constexpr uint8_t NUM_TIMERS = 4;
+constexpr uint32_t APB_CLK_HZ = 80000000;
+}
+
+struct hw_timer_s {
+    bool used = false;
+    uint16_t divider = 1;
+    uint64_t startUs = 0;
+    uint64_t alarmTicks = 0;
+    bool autoreload = false;
+    bool alarmEnabled = false;
+    uint64_t nextFireUs = UINT64_MAX;
+    void (*isr)(void) = nullptr;
+
+    uint64_t ticksToUs(uint64_t ticks) const { return ticks * divider / (APB_CLK_HZ / 1000000); }
+};
+
+namespace {
+hw_timer_s g_timers[NUM_TIMERS];
+// 实时模式下中断在SimClock事件线程中触发，与定时器API调用互斥
+std::mutex g_timerMutex;
+
+uint64_t nextDeadline() {
+    uint64_t next = UINT64_MAX;
+    for (auto& t : g_timers) {
+        if (t.used && t.alarmEnabled && t.nextFireUs < next) next = t.nextFireUs;
+    }
+    return next;
+}
+
+uint64_t fireTimers(uint64_t nowUs) {
+    std::lock_guard<std::mutex> lock(g_timerMutex);
+    for (auto& t : g_timers) {
+        if (!t.used || !t.alarmEnabled || t.nextFireUs > nowUs) continue;
+        if (t.autoreload && t.alarmTicks > 0) {
+            t.nextFireUs += t.ticksToUs(t.alarmTicks);
+        } else {
+            t.alarmEnabled = false;
+            t.nextFireUs = UINT64_MAX;
+        }
+        if (t.isr) t.isr();
+    }
+    return nextDeadline();
+}
+
+void rearm() {
+    SimClock::setEventHook(fireTimers, nextDeadline());
+}
+}
+
+hw_timer_t* timerBegin(uint8_t num, uint16_t divider, bool) {
+    if (num >= NUM_TIMERS || divider < 2) return nullptr;
+    std::lock_guard<std::mutex> lock(g_timerMutex);
+    hw_timer_s& t = g_timers[num];
+    t = hw_timer_s();
+    t.used = true;
+    t.divider = divider;
+    t.startUs = SimClock::nowUs();
+    return &t;
+}
+
+void timerEnd(hw_timer_t* timer) {
+    if (!timer) return;
+    std::lock_guard<std::mutex> lock(g_timerMutex);
+    *timer = hw_timer_s();
+    rearm();
+}
+
+void timerAttachInterrupt(hw_timer_t* timer, void (*fn)(void), bool) {
+    std::lock_guard<std::mutex> lock(g_timerMutex);
+    if (timer) timer->isr = fn;
+}
+
+void timerDetachInterrupt(hw_timer_t* timer) {
+    std::lock_guard<std::mutex> lock(g_timerMutex);
+    if (timer) timer->isr = nullptr;
+}
+
+void timerAlarmWrite(hw_timer_t* timer, uint64_t alarmValue, bool autoreload) {
+    if (!timer) return;
+    std::lock_guard<std::mutex> lock(g_timerMutex);
+    timer->alarmTicks = alarmValue;
+    timer->autoreload = autoreload;
+}
+
+void timerAlarmEnable(hw_timer_t* timer) {
+    if (!timer || timer->alarmTicks == 0) return;
+    std::lock_guard<std::mutex> lock(g_timerMutex);
+    timer->alarmEnabled = true;
+    timer->startUs = SimClock::nowUs();
+    timer->nextFireUs = timer->startUs + timer->ticksToUs(timer->alarmTicks);
+    rearm();
+}
+
+void timerAlarmDisable(hw_timer_t* timer) {
+    if (!timer) return;
+    std::lock_guard<std::mutex> lock(g_timerMutex);
+    timer->alarmEnabled = false;
+    timer->nextFireUs = UINT64_MAX;
+    rearm();
+}
+
+uint64_t timerRead(hw_timer_t* timer) {
+    if (!timer) return 0;
+    return (SimClock::nowUs() - timer->startUs) * (APB_CLK_HZ / 1000000) / timer->divider;
+}
@@ -0,0 +1,24 @@
+#ifndef esp32_hal_timer_h
+#define esp32_hal_timer_h
+
+// ESP32硬件定时器API替身（arduino-esp32 2.x接口）
+// 定时器以80MHz APB时钟经分频计数；报警中断由SimClock在虚拟时间到达时触发，
+// 实时模式下在SimClock的事件线程中触发（相当于另一个核上的中断）。
+
+#include <stdint.h>
+
+#define IRAM_ATTR
+
+struct hw_timer_s;
+typedef struct hw_timer_s hw_timer_t;
+
+hw_timer_t* timerBegin(uint8_t num, uint16_t divider, bool countUp);
+void timerEnd(hw_timer_t* timer);
+void timerAttachInterrupt(hw_timer_t* timer, void (*fn)(void), bool edge);
+void timerDetachInterrupt(hw_timer_t* timer);
+void timerAlarmWrite(hw_timer_t* timer, uint64_t alarmValue, bool autoreload);
+void timerAlarmEnable(hw_timer_t* timer);
+void timerAlarmDisable(hw_timer_t* timer);
+uint64_t timerRead(hw_timer_t* timer);
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef FreeRTOS_h
+#define FreeRTOS_h
+
+// ESP32 FreeRTOS替身（主机仿真）：只实现本工程用到的类型和宏。
+// 任务由std::thread承载（见task.h），临界区为真实的自旋锁，
+// 因此中断（定时器线程）与多个任务之间的同步语义与双核ESP32一致。
+
+#include <stdint.h>
+#include <atomic>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdFAIL pdFALSE
+#define pdPASS pdTRUE
+
+#define configMAX_PRIORITIES 25
+#define configTICK_RATE_HZ 1000
+#define portTICK_PERIOD_MS (1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(((TickType_t)(ms) * configTICK_RATE_HZ) / 1000))
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+// 临界区：ESP32上是跨核自旋锁，这里同样用原子标志实现
+struct portMUX_TYPE {
+    std::atomic<bool> locked{false};
+};
+#define portMUX_INITIALIZER_UNLOCKED portMUX_TYPE{}
+
+void simPortEnterCritical(portMUX_TYPE* mux);
+void simPortExitCritical(portMUX_TYPE* mux);
+
+#define portENTER_CRITICAL(mux) simPortEnterCritical(mux)
+#define portEXIT_CRITICAL(mux) simPortExitCritical(mux)
+#define portENTER_CRITICAL_ISR(mux) simPortEnterCritical(mux)
+#define portEXIT_CRITICAL_ISR(mux) simPortExitCritical(mux)
+#define portYIELD_FROM_ISR(...) ((void)0)
+
+BaseType_t xPortGetCoreID();
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef task_h
+#define task_h
+
+// FreeRTOS任务API替身：每个任务一个std::thread，任务通知用条件变量实现。
+// 优先级和核亲和性只做记录（主机调度由操作系统决定）；
+// 任务并发运行需要SimClock处于实时模式，虚拟时钟下创建任务会失败。
+
+#include "FreeRTOS.h"
+
+struct tskTaskControlBlock;
+typedef tskTaskControlBlock* TaskHandle_t;
+typedef void (*TaskFunction_t)(void* param);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackDepth, void* param,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t coreId);
+// 只支持删除自身（NULL）：任务函数随后返回，线程结束
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken);
+
+// 仿真接口：等待所有已结束任务的线程退出
+void simTaskJoinAll();
+
+#endif
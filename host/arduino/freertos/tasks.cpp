@@ -0,0 +1,150 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "Arduino.h"
+#include "SimClock.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct tskTaskControlBlock {
+    std::string name;
+    TaskFunction_t fn = nullptr;
+    void* param = nullptr;
+    UBaseType_t priority = 0;
+    BaseType_t core = 1;
+    std::thread thread;
+
+    std::mutex notifyMutex;
+    std::condition_variable notifyCv;
+    uint32_t notifyCount = 0;
+};
+
+namespace {
+// 任务注册表；进程退出时等待仍在运行的任务线程
+struct TaskRegistry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<tskTaskControlBlock>> tasks;
+    ~TaskRegistry() { joinAll(); }
+    void joinAll() {
+        std::vector<tskTaskControlBlock*> pending;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto& t : tasks) pending.push_back(t.get());
+        }
+        for (tskTaskControlBlock* t : pending) {
+            if (t->thread.joinable() && t->thread.get_id() != std::this_thread::get_id()) t->thread.join();
+        }
+    }
+};
+
+TaskRegistry& registry() {
+    static TaskRegistry r;
+    return r;
+}
+
+// Arduino的loopTask运行在核1；非任务线程（主线程、定时器线程）按此处理
+thread_local tskTaskControlBlock* t_currentTask = nullptr;
+
+tskTaskControlBlock* currentTask() {
+    if (t_currentTask) return t_currentTask;
+    auto tcb = std::make_unique<tskTaskControlBlock>();
+    tcb->name = "loopTask";
+    t_currentTask = tcb.get();
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    registry().tasks.push_back(std::move(tcb));
+    return t_currentTask;
+}
+
+void notify(TaskHandle_t task) {
+    if (!task) return;
+    {
+        std::lock_guard<std::mutex> lock(task->notifyMutex);
+        task->notifyCount++;
+    }
+    task->notifyCv.notify_one();
+}
+}
+
+void simPortEnterCritical(portMUX_TYPE* mux) {
+    while (mux->locked.exchange(true, std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+void simPortExitCritical(portMUX_TYPE* mux) {
+    mux->locked.store(false, std::memory_order_release);
+}
+
+BaseType_t xPortGetCoreID() {
+    return t_currentTask ? t_currentTask->core : 1;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t, void* param,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t coreId) {
+    if (!fn || !SimClock::isRealtime()) return pdFAIL;
+
+    auto tcb = std::make_unique<tskTaskControlBlock>();
+    tcb->name = name ? name : "";
+    tcb->fn = fn;
+    tcb->param = param;
+    tcb->priority = priority;
+    tcb->core = coreId == tskNO_AFFINITY ? 0 : coreId;
+    tskTaskControlBlock* raw = tcb.get();
+    {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        registry().tasks.push_back(std::move(tcb));
+    }
+    if (handle) *handle = raw;
+    raw->thread = std::thread([raw]() {
+        t_currentTask = raw;
+        raw->fn(raw->param);
+    });
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t) {
+    // ESP32上删除自身后不再返回；这里由任务函数返回来结束线程
+}
+
+void vTaskDelay(TickType_t ticks) {
+    delay(ticks * portTICK_PERIOD_MS);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    return currentTask();
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait) {
+    tskTaskControlBlock* self = currentTask();
+    std::unique_lock<std::mutex> lock(self->notifyMutex);
+    if (ticksToWait == portMAX_DELAY) {
+        self->notifyCv.wait(lock, [self] { return self->notifyCount > 0; });
+    } else {
+        self->notifyCv.wait_for(lock, std::chrono::milliseconds(ticksToWait * portTICK_PERIOD_MS),
+                                [self] { return self->notifyCount > 0; });
+    }
+    uint32_t count = self->notifyCount;
+    if (count > 0) {
+        self->notifyCount = clearCountOnExit ? 0 : count - 1;
+    }
+    return count;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    notify(task);
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken) {
+    notify(task);
+    if (higherPriorityTaskWoken) *higherPriorityTaskWoken = pdTRUE;
+}
+
+void simTaskJoinAll() {
+    registry().joinAll();
+}
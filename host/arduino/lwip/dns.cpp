@@ -0,0 +1,31 @@
+#include "lwip/dns.h"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <string.h>
+#include <string>
+#include <thread>
+
+err_t dns_gethostbyname(const char* hostname, ip_addr_t* addr, dns_found_callback found, void* callback_arg) {
+    if (!hostname || !addr || !found) return ERR_ARG;
+    struct in_addr in;
+    if (inet_aton(hostname, &in)) {
+        addr->ip4.addr = in.s_addr;
+        return ERR_OK;
+    }
+    std::string name = hostname;
+    std::thread([name, found, callback_arg]() {
+        struct addrinfo hints = {};
+        hints.ai_family = AF_INET;
+        struct addrinfo* res = nullptr;
+        if (getaddrinfo(name.c_str(), nullptr, &hints, &res) == 0 && res) {
+            ip_addr_t ip;
+            ip.ip4.addr = ((struct sockaddr_in*)res->ai_addr)->sin_addr.s_addr;
+            freeaddrinfo(res);
+            found(name.c_str(), &ip, callback_arg);
+        } else {
+            found(name.c_str(), nullptr, callback_arg);
+        }
+    }).detach();
+    return ERR_INPROGRESS;
+}
@@ -0,0 +1,27 @@
+#ifndef lwip_dns_h
+#define lwip_dns_h
+
+// 主机仿真用的lwIP异步DNS替身：IP字面量立即返回ERR_OK；主机名返回ERR_INPROGRESS，
+// 由后台线程（相当于tcpip线程）调用系统解析器后回调，失败时回调的地址为nullptr
+
+#include <stdint.h>
+
+typedef int8_t err_t;
+constexpr err_t ERR_OK = 0;
+constexpr err_t ERR_INPROGRESS = -5;
+constexpr err_t ERR_ARG = -16;
+
+struct ip4_addr_t {
+    uint32_t addr;      // 网络字节序
+};
+struct ip_addr_t {
+    ip4_addr_t ip4;
+};
+#define ip_2_ip4(ipaddr) (&(ipaddr)->ip4)
+#define ip4_addr_get_u32(src_ipaddr) ((src_ipaddr)->addr)
+
+typedef void (*dns_found_callback)(const char* name, const ip_addr_t* ipaddr, void* callback_arg);
+
+err_t dns_gethostbyname(const char* hostname, ip_addr_t* addr, dns_found_callback found, void* callback_arg);
+
+#endif
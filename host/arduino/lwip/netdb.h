@@ -0,0 +1,8 @@
+#ifndef lwip_netdb_h
+#define lwip_netdb_h
+
+// 主机仿真用的lwIP域名解析替身：gethostbyname()即系统解析器
+
+#include <netdb.h>
+
+#endif
@@ -0,0 +1,122 @@
+#include "lwip/sockets.h"
+
+#include <errno.h>
+#include <map>
+#include <mutex>
+#include <set>
+#include <unistd.h>
+
+#include "WiFi.h"
+
+namespace {
+std::mutex g_mutex;
+std::set<int> g_blackholed;     // 握手永不完成的套接字
+
+// 限速时每个套接字发送缓冲区中尚未"发出"的字节
+struct SendBuffer {
+    double queued = 0;
+    unsigned long lastUs = 0;
+};
+std::map<int, SendBuffer> g_sendBuffers;
+
+bool isBlackholed(int s) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    return g_blackholed.count(s) != 0;
+}
+
+// 按链路速率排空后返回缓冲区可收下的字节数
+size_t sendBufferSpace(int s, size_t size) {
+    uint32_t rate = WiFi.simLinkRate();
+    std::lock_guard<std::mutex> lock(g_mutex);
+    SendBuffer& b = g_sendBuffers[s];
+    unsigned long now = micros();
+    if (rate == 0) {
+        b.queued = 0;
+    } else {
+        b.queued -= (double)rate * (unsigned long)(now - b.lastUs) / 1e6;
+        if (b.queued < 0) b.queued = 0;
+    }
+    b.lastUs = now;
+    if (rate == 0) return size;
+    size_t space = (size_t)(LWIP_SIM_SND_BUF - b.queued);
+    if (space > size) space = size;
+    b.queued += space;
+    return space;
+}
+}
+
+int lwip_socket(int domain, int type, int protocol) {
+    return socket(domain, type, protocol);
+}
+
+int lwip_connect(int s, const struct sockaddr* name, socklen_t namelen) {
+    if (!WiFi.simServerReachable()) {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_blackholed.insert(s);
+        errno = EINPROGRESS;
+        return -1;
+    }
+    return connect(s, name, namelen);
+}
+
+int lwip_close(int s) {
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_blackholed.erase(s);
+        g_sendBuffers.erase(s);
+    }
+    return close(s);
+}
+
+int lwip_send(int s, const void* data, size_t size, int flags) {
+    if (isBlackholed(s)) {
+        errno = ENOTCONN;
+        return -1;
+    }
+    size_t space = sendBufferSpace(s, size);
+    if (space == 0) {
+        errno = EAGAIN;
+        return -1;
+    }
+    int n = (int)send(s, data, space, flags | MSG_NOSIGNAL);
+    if (n < (int)space) {
+        // 主机套接字收下的比缓冲区少（或出错）：按实际字节记账
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_sendBuffers[s].queued -= space - (n < 0 ? 0 : n);
+    }
+    return n;
+}
+
+int lwip_recv(int s, void* mem, size_t len, int flags) {
+    if (isBlackholed(s)) {
+        errno = EAGAIN;
+        return -1;
+    }
+    return (int)recv(s, mem, len, flags);
+}
+
+int lwip_fcntl(int s, int cmd, int val) {
+    return fcntl(s, cmd, val);
+}
+
+int lwip_select(int maxfdp1, fd_set* readset, fd_set* writeset, fd_set* exceptset, struct timeval* timeout) {
+    // 未完成握手的套接字从各集合中移除，其余交给系统select
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        for (int s : g_blackholed) {
+            if (s >= maxfdp1) continue;
+            if (readset) FD_CLR(s, readset);
+            if (writeset) FD_CLR(s, writeset);
+            if (exceptset) FD_CLR(s, exceptset);
+        }
+    }
+    return select(maxfdp1, readset, writeset, exceptset, timeout);
+}
+
+int lwip_getsockopt(int s, int level, int optname, void* optval, socklen_t* optlen) {
+    return getsockopt(s, level, optname, optval, optlen);
+}
+
+int lwip_setsockopt(int s, int level, int optname, const void* optval, socklen_t optlen) {
+    return setsockopt(s, level, optname, optval, optlen);
+}
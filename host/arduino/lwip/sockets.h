@@ -0,0 +1,30 @@
+#ifndef lwip_sockets_h
+#define lwip_sockets_h
+
+// 主机仿真用的lwIP套接字替身：lwip_*接口直接映射到POSIX套接字。
+// 服务器不可达仿真（WiFi.simSetServerReachable(false)）时lwip_connect()返回EINPROGRESS，
+// 握手永不完成（如同SYN无应答），lwip_select()不会报告该套接字可写。
+// 限速仿真（WiFi.simSetLinkRate()）时每个套接字有一个LWIP_SIM_SND_BUF字节的发送缓冲区，
+// 按链路速率排空；数据立即交给主机套接字，只模拟发送端看到的背压。
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#define LWIP_SIM_SND_BUF 5744   // ESP32 Arduino默认的TCP_SND_BUF（4×MSS）
+
+int lwip_socket(int domain, int type, int protocol);
+int lwip_connect(int s, const struct sockaddr* name, socklen_t namelen);
+int lwip_close(int s);
+int lwip_send(int s, const void* data, size_t size, int flags);
+int lwip_recv(int s, void* mem, size_t len, int flags);
+int lwip_fcntl(int s, int cmd, int val);
+int lwip_select(int maxfdp1, fd_set* readset, fd_set* writeset, fd_set* exceptset, struct timeval* timeout);
+int lwip_getsockopt(int s, int level, int optname, void* optval, socklen_t* optlen);
+int lwip_setsockopt(int s, int level, int optname, const void* optval, socklen_t optlen);
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef SketchSetup_h
+#define SketchSetup_h
+
+#include "I2CMux.h"
+
+// 与sketch_oct9a.ino setup()中一致的多路复用器通道表
+inline void configureSketchChannels(I2CMux& mux) {
+    mux.addChannel(0, 0x50, "流量传感器");
+    mux.addChannel(1, 0x6D, "SENSOR");
+    mux.addChannel(2, 0x3C, "OLED Display");
+    mux.addChannel(3, 0x6D, "备用气压传感器");
+    mux.addChannel(4, 0x2A, "ACD1100气体传感器");
+    mux.addChannel(5, 0x4A, "ADS1115 ADC");
+
+    mux.enableChannel(0, false);
+    mux.enableChannel(1, true);
+    mux.enableChannel(2, true);
+    mux.enableChannel(3, true);
+    mux.enableChannel(4, true);
+    mux.enableChannel(5, true);
+}
+
+#endif
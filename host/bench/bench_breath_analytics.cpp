@@ -0,0 +1,116 @@
+// 逐次呼吸统计主机基准
+//
+// 按已知参数合成呼吸波形（压力、流量与状态序列），以固定采样率逐样本送入
+// BreathAnalyzer，把输出记录与合成参数对比，并报告每样本耗时（ns）。
+// 分析器只保存当前呼吸的累计量，耗时与采样率、呼吸长度无关。
+//
+// 用法: bench_breath_analytics [--rate HZ] [--breaths N] [--rr BPM] [--ti S] [--no-flow]
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "BreathAnalyzer.h"
+
+namespace {
+constexpr float PEEP_KPA = 0.5f;
+constexpr float PIP_KPA = 2.0f;
+constexpr float INSPIRATORY_FLOW_ML_MIN = 30000.0f;   // 30 L/min
+
+struct Sample {
+    unsigned long timestampUs;
+    BreathState state;
+    float pressureKpa;
+    float flowMlMin;
+};
+
+// 吸气段压力半正弦升至PIP（前半为INHALE，后半为PEAK），呼气段保持PEEP，
+// 吸气段恒流、呼气段流量为0
+std::vector<Sample> makeSamples(uint32_t rateHz, uint32_t breaths, float rr, float ti, bool flow) {
+    double period = 60.0 / rr;
+    uint32_t count = (uint32_t)(breaths * period * rateHz);
+    std::vector<Sample> samples(count);
+    for (uint32_t i = 0; i < count; i++) {
+        double t = (double)i / rateHz;
+        double phase = fmod(t, period);
+        Sample& s = samples[i];
+        s.timestampUs = (unsigned long)llround(t * 1e6);
+        if (phase < ti) {
+            s.state = phase < ti / 2 ? INHALE : PEAK;
+            s.pressureKpa = PEEP_KPA + (PIP_KPA - PEEP_KPA) * (float)sin(phase / ti * M_PI);
+            s.flowMlMin = flow ? INSPIRATORY_FLOW_ML_MIN : NAN;
+        } else {
+            s.state = EXHALE;
+            s.pressureKpa = PEEP_KPA;
+            s.flowMlMin = flow ? 0.0f : NAN;
+        }
+    }
+    return samples;
+}
+}
+
+int main(int argc, char** argv) {
+    uint32_t rateHz = 1000;
+    uint32_t breaths = 200;
+    float rr = 20;
+    float ti = 1.0f;
+    bool flow = true;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--rate") && i + 1 < argc) rateHz = (uint32_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--breaths") && i + 1 < argc) breaths = (uint32_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--rr") && i + 1 < argc) rr = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--ti") && i + 1 < argc) ti = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--no-flow")) flow = false;
+        else {
+            fprintf(stderr, "用法: %s [--rate HZ] [--breaths N] [--rr BPM] [--ti S] [--no-flow]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (rateHz == 0 || breaths < 3 || rr <= 0 || ti <= 0 || ti >= 60.0f / rr) {
+        fprintf(stderr, "参数无效：需要 rate > 0, breaths >= 3, 0 < ti < 60/rr\n");
+        return 2;
+    }
+
+    std::vector<Sample> samples = makeSamples(rateHz, breaths, rr, ti, flow);
+    BreathAnalyzer analyzer;
+    std::vector<BreathRecord> records;
+    records.reserve(breaths);
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (const Sample& s : samples) {
+        if (analyzer.update(s.timestampUs, s.state, s.pressureKpa, s.flowMlMin)) {
+            records.push_back(analyzer.lastRecord());
+        }
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+
+    double te = 60.0 / rr - ti;
+    double expectedVt = flow ? INSPIRATORY_FLOW_ML_MIN * ti / 60.0 : NAN;
+    double maxRrErr = 0, maxIeErr = 0, maxTiErr = 0, maxPipErr = 0, maxPeepErr = 0, maxVtErr = 0;
+    for (const BreathRecord& r : records) {
+        maxRrErr = fmax(maxRrErr, fabs(r.respiratoryRate - rr));
+        maxIeErr = fmax(maxIeErr, fabs(r.ieRatio - ti / te));
+        maxTiErr = fmax(maxTiErr, fabs(r.inspiratoryTimeMs - ti * 1000.0));
+        maxPipErr = fmax(maxPipErr, fabs(r.pipKpa - PIP_KPA));
+        maxPeepErr = fmax(maxPeepErr, fabs(r.peepKpa - PEEP_KPA));
+        if (flow) maxVtErr = fmax(maxVtErr, fabs(r.tidalVolumeMl - expectedVt));
+    }
+
+    printf("=== 逐次呼吸统计 (%u Hz, %u 次呼吸, %u 样本) ===\n", rateHz, breaths, (unsigned)samples.size());
+    printf("每样本耗时:         %.2f ns\n", ns / samples.size());
+    printf("记录数:             %u (首次呼吸无前一段呼气，不输出)\n", (unsigned)records.size());
+    if (!records.empty()) {
+        const BreathRecord& r = records.back();
+        printf("最后一条:           PIP %.3f kPa, PEEP %.3f kPa, %.2f 次/分, I:E 1:%.2f, Ti %u ms, Te %u ms, 潮气量 %.1f ml\n",
+               r.pipKpa, r.peepKpa, r.respiratoryRate, 1.0f / r.ieRatio, r.inspiratoryTimeMs, r.expiratoryTimeMs,
+               r.tidalVolumeMl);
+    }
+    printf("合成参数:           PIP %.3f kPa, PEEP %.3f kPa, %.2f 次/分, I:E 1:%.2f, Ti %.0f ms, 潮气量 %.1f ml\n",
+           PIP_KPA, PEEP_KPA, rr, te / ti, ti * 1000.0, expectedVt);
+    printf("最大误差:           频率 %.3f 次/分, I:E %.4f, Ti %.1f ms, PIP %.4f kPa, PEEP %.4f kPa, 潮气量 %.2f ml\n",
+           maxRrErr, maxIeErr, maxTiErr, maxPipErr, maxPeepErr, maxVtErr);
+    return 0;
+}
@@ -0,0 +1,193 @@
+// 预测性提前开阀主机基准
+//
+// 主气压传感器输出患者自主呼吸波形（升余弦，起点已知），呼吸间隔可按比例随机抖动，
+// 按sketch配置在虚拟时钟下运行定时采样的update()循环，逐样本观察气阀PID的目标何时
+// 切到吸气，加上气阀与气路的响应时间（--valve-delay）即为送气开始。每个真实吸气起点统计：
+//   送气延迟：送气开始 - 真实起点（负值为提前）
+//   人机不同步：延迟或提前超过100ms、无响应（漏触发）、以及与患者努力无关的额外送气
+// 默认启用预测，--reactive 只做被动触发作对照；--jitter 让呼吸不规律以检验置信度回退。
+//
+// 用法: bench_breath_prediction [--reactive] [--lead MS] [--valve-delay MS] [--period S]
+//                               [--jitter FRACTION] [--seconds S] [--noise KPA] [--verbose]
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#include "BreathController.h"
+#include "SimClock.h"
+#include "SimRig.h"
+#include "SketchSetup.h"
+
+namespace {
+constexpr double BASE_KPA = 101.3;
+constexpr double AMPLITUDE_KPA = 2.0;
+constexpr double FIRST_ONSET_S = 0.5;
+constexpr double INSPIRATION_FRACTION = 0.4;
+constexpr double ASYNC_MS = 100.0;
+
+double g_period = 3.0;
+double g_noise = 0.0;
+std::vector<double> g_onsets;
+
+double gaussianNoise(double seconds) {
+    uint64_t x = (uint64_t)llround(seconds * 1e6) * 0x9E3779B97F4A7C15ULL;
+    x ^= x >> 31;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    double u1 = ((x >> 11) + 1.0) / 9007199254740993.0;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 29;
+    double u2 = (x >> 11) / 9007199254740992.0;
+    return sqrt(-2.0 * log(u1)) * cos(2 * M_PI * u2);
+}
+
+// 按时刻找所在的呼吸：返回起点不晚于t的最后一个下标，没有为-1
+int onsetIndex(double t) {
+    auto it = std::upper_bound(g_onsets.begin(), g_onsets.end(), t);
+    return (int)(it - g_onsets.begin()) - 1;
+}
+
+float breathWaveform(double t) {
+    int i = onsetIndex(t);
+    double breath = 0;
+    double ti = g_period * INSPIRATION_FRACTION;
+    if (i >= 0 && t - g_onsets[i] < ti) {
+        breath = 0.5 * (1 - cos(2 * M_PI * (t - g_onsets[i]) / ti));
+    }
+    return (float)(BASE_KPA + AMPLITUDE_KPA * breath + g_noise * gaussianNoise(t));
+}
+
+double percentile(std::vector<double> v, double p) {
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    return v[(size_t)((v.size() - 1) * p + 0.5)];
+}
+}
+
+int main(int argc, char** argv) {
+    bool reactive = false;
+    int leadMs = PREDICT_DEFAULT_LEAD_MS;
+    double valveDelayMs = 100.0;
+    double jitter = 0.0;
+    double seconds = 120.0;
+    bool verbose = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--reactive")) reactive = true;
+        else if (!strcmp(argv[i], "--lead") && i + 1 < argc) leadMs = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--valve-delay") && i + 1 < argc) valveDelayMs = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--period") && i + 1 < argc) g_period = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--jitter") && i + 1 < argc) jitter = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--noise") && i + 1 < argc) g_noise = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--verbose")) verbose = true;
+        else {
+            fprintf(stderr, "用法: %s [--reactive] [--lead MS] [--valve-delay MS] [--period S] [--jitter FRACTION]"
+                            " [--seconds S] [--noise KPA] [--verbose]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (g_period <= 1.0 || jitter < 0 || jitter >= 0.5 || leadMs < 0) {
+        fprintf(stderr, "参数无效：需要 period > 1 s, 0 <= jitter < 0.5, lead >= 0\n");
+        return 2;
+    }
+
+    // 呼吸起点：间隔 = 周期 × (1 ± jitter) 均匀分布，种子固定
+    uint32_t seed = 12345;
+    for (double t = FIRST_ONSET_S; t < seconds + g_period; ) {
+        g_onsets.push_back(t);
+        seed = seed * 1664525u + 1013904223u;
+        double u = (seed >> 8) / 16777216.0;
+        t += g_period * (1 + jitter * (2 * u - 1));
+    }
+
+    SimRig rig;
+    rig.install();
+    rig.primaryPressure.setPressureWaveform(breathWaveform);
+    HardwareSerial::setConsoleEnabled(verbose);
+
+    I2CMux i2cMux(0x70);
+    BreathController breathController(&i2cMux);
+    breathController.setADS1115Channel(5);
+    configureSketchChannels(i2cMux);
+    breathController.setSamplingRate(DEFAULT_SAMPLE_RATE_HZ);
+    breathController.setBreathPrediction(!reactive);
+    breathController.setPredictionLeadMs((uint16_t)leadMs);
+    breathController.begin();
+    breathController.initializeOxygenSensor();
+
+    const PressurePid& pid = breathController.getValveController();
+    uint64_t endUs = SimClock::nowUs() + (uint64_t)(seconds * 1e6);
+    std::vector<double> delayMs(g_onsets.size(), NAN);
+    uint32_t extra = 0;
+    bool lastInspiratory = false;
+    uint32_t preActuatingSamples = 0;
+    uint32_t samples = 0;
+
+    while (SimClock::nowUs() < endUs) {
+        uint64_t t0 = SimClock::nowUs();
+        breathController.update();
+        if (SimClock::nowUs() == t0) SimClock::advanceUs(5);
+
+        bool inspiratory = pid.target() > 0;
+        samples++;
+        if (breathController.isPreActuating()) preActuatingSamples++;
+        if (inspiratory && !lastInspiratory) {
+            // 送气开始：归属到下一个（提前）或当前（滞后）的真实起点
+            double t = SimClock::nowUs() / 1e6 + valveDelayMs / 1000.0;
+            int current = onsetIndex(t);
+            int next = current + 1;
+            int target = -1;
+            if (next < (int)g_onsets.size() && g_onsets[next] - t <= 3 * ASYNC_MS / 1000.0) target = next;
+            else if (current >= 0 && t - g_onsets[current] < g_period * INSPIRATION_FRACTION) target = current;
+            if (target < 0 || !isnan(delayMs[target])) {
+                if (t >= 2 * g_period) extra++;
+            } else {
+                delayMs[target] = (t - g_onsets[target]) * 1000;
+            }
+        }
+        lastInspiratory = inspiratory;
+    }
+    HardwareSerial::setConsoleEnabled(true);
+
+    // 统计窗口：跳过前两个周期（基准与周期学习），只计结束前已完整的呼吸
+    uint32_t efforts = 0, missed = 0, late = 0, early = 0;
+    std::vector<double> delays;
+    double sum = 0, absSum = 0;
+    for (size_t i = 0; i < g_onsets.size(); i++) {
+        if (g_onsets[i] < 2 * g_period || g_onsets[i] + g_period * INSPIRATION_FRACTION > seconds) continue;
+        efforts++;
+        double d = delayMs[i];
+        if (isnan(d)) {
+            missed++;
+            continue;
+        }
+        delays.push_back(d);
+        sum += d;
+        absSum += fabs(d);
+        if (d > ASYNC_MS) late++;
+        if (d < -ASYNC_MS) early++;
+    }
+    uint32_t events = late + early + missed + extra;
+    BreathPredictor predictor = breathController.getBreathPredictor();
+    PredictionStats ps = predictor.getStats();
+
+    printf("=== 预测性提前开阀 (%s, 提前 %d ms, 气阀响应 %.0f ms, 周期 %.1f s ± %.0f%%, 噪声 %.3f kPa, %.0f s) ===\n",
+           reactive ? "被动触发" : "预测", leadMs, valveDelayMs, g_period, jitter * 100, g_noise, seconds);
+    if (!delays.empty()) {
+        printf("送气延迟:           平均 %.1f ms, 平均绝对 %.1f ms, 中位 %.1f ms, P95 %.1f ms, 最早 %.1f ms\n",
+               sum / delays.size(), absSum / delays.size(), percentile(delays, 0.5), percentile(delays, 0.95),
+               percentile(delays, 0.0));
+    }
+    printf("人机不同步:         %u / %u 次努力 (%.1f%%): 延迟>%.0fms %u, 提前>%.0fms %u, 漏触发 %u, 额外送气 %u\n",
+           events, efforts, efforts ? 100.0 * events / efforts : 0.0, ASYNC_MS, late, ASYNC_MS, early, missed, extra);
+    if (!reactive) {
+        printf("预测:               窗口 %u, 命中 %u, 落空 %u, 平均领先 %.1f ms, 预测误差 %.1f ms, 周期 %.0f ms, "
+               "抖动 %.1f%%, 提前开阀占比 %.1f%%\n", ps.windows, ps.hits, ps.misses, ps.meanLeadMs, ps.meanErrorMs,
+               predictor.periodMs(), predictor.jitterRatio() * 100, 100.0 * preActuatingSamples / samples);
+    }
+    return 0;
+}
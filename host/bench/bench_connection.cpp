@@ -0,0 +1,210 @@
+// 连接状态机主机基准
+//
+// 按sketch配置在虚拟时钟下运行定时采样的update()循环，按时间表改变网络条件：
+//   0–20 s   AP不可用（WiFi关联超时、指数退避）
+//   20–40 s  AP可用、服务器不可达（握手无应答，超时后退避）
+//   40–60 s  服务器在线（本机TCP接收端）
+//   60–70 s  服务器关闭（对端断开，之后连接被拒绝）
+//   70–80 s  服务器重新上线
+//   80–85 s  WiFi断开
+//   85 s–    恢复
+// 每个阶段结束时输出连接状态；最后报告单次update()的最长虚拟耗时和主机实际耗时
+// （原阻塞实现在关联时等待15 s、服务器不可达时每5 s阻塞5 s）以及连接统计。
+//
+// --host 用主机名（如localhost）代替IP字面量，走异步DNS解析。
+//
+// 用法: bench_connection [--binary] [--host NAME] [--verbose]
+
+#include <arpa/inet.h>
+#include <chrono>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "BreathController.h"
+#include "SimClock.h"
+#include "SimRig.h"
+#include "SketchSetup.h"
+
+namespace {
+// 非阻塞本机TCP接收端，在主循环中轮询，可关闭后在同一端口重新监听
+class PollingSink {
+public:
+    bool open(uint16_t port) {
+        if (_listenFd >= 0) return true;
+        _listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        if (_listenFd < 0) return false;
+        int one = 1;
+        setsockopt(_listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        struct sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(port);
+        socklen_t len = sizeof(addr);
+        if (bind(_listenFd, (struct sockaddr*)&addr, len) != 0 || listen(_listenFd, 1) != 0 ||
+            getsockname(_listenFd, (struct sockaddr*)&addr, &len) != 0) {
+            close();
+            return false;
+        }
+        fcntl(_listenFd, F_SETFL, O_NONBLOCK);
+        _port = ntohs(addr.sin_port);
+        return true;
+    }
+
+    void close() {
+        if (_fd >= 0) ::close(_fd);
+        if (_listenFd >= 0) ::close(_listenFd);
+        _fd = _listenFd = -1;
+    }
+
+    void poll() {
+        if (_fd < 0 && _listenFd >= 0) {
+            _fd = accept(_listenFd, nullptr, nullptr);
+            if (_fd >= 0) fcntl(_fd, F_SETFL, O_NONBLOCK);
+        }
+        if (_fd < 0) return;
+        char buf[4096];
+        ssize_t n;
+        while ((n = recv(_fd, buf, sizeof(buf), 0)) > 0) _bytes += (uint64_t)n;
+        if (n == 0) {
+            ::close(_fd);
+            _fd = -1;
+        }
+    }
+
+    uint16_t port() const { return _port; }
+    uint64_t bytes() const { return _bytes; }
+
+private:
+    int _listenFd = -1;
+    int _fd = -1;
+    uint16_t _port = 0;
+    uint64_t _bytes = 0;
+};
+
+struct Phase {
+    double endS;
+    const char* name;
+    bool apAvailable;
+    bool serverReachable;
+    bool serverListening;
+};
+
+const Phase PHASES[] = {
+    {20, "AP不可用", false, true, false},
+    {40, "服务器不可达", true, false, false},
+    {60, "服务器在线", true, true, true},
+    {70, "服务器关闭", true, true, false},
+    {80, "服务器恢复", true, true, true},
+    {85, "WiFi断开", false, true, true},
+    {100, "全部恢复", true, true, true},
+};
+}
+
+int main(int argc, char** argv) {
+    bool binary = false;
+    bool verbose = false;
+    const char* host = "127.0.0.1";
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--binary")) binary = true;
+        else if (!strcmp(argv[i], "--host") && i + 1 < argc) host = argv[++i];
+        else if (!strcmp(argv[i], "--verbose")) verbose = true;
+        else {
+            fprintf(stderr, "用法: %s [--binary] [--host NAME] [--verbose]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    PollingSink sink;
+    if (!sink.open(0)) {
+        fprintf(stderr, "无法启动遥测接收端\n");
+        return 1;
+    }
+    uint16_t port = sink.port();
+    sink.close();
+
+    SimRig rig;
+    rig.install();
+    HardwareSerial::setConsoleEnabled(verbose);
+    WiFi.simSetJoinTimeMs(2000);
+
+    I2CMux i2cMux(0x70);
+    BreathController breathController(&i2cMux);
+    breathController.setADS1115Channel(5);
+    configureSketchChannels(i2cMux);
+    breathController.setWiFiCredentials("sim", "sim", host, port);
+    breathController.setSamplingRate(DEFAULT_SAMPLE_RATE_HZ);
+    breathController.setTelemetryFormat(binary ? TELEMETRY_BINARY : TELEMETRY_TEXT);
+
+    const Phase* phase = &PHASES[0];
+    WiFi.simSetAvailable(phase->apAvailable);
+    WiFi.simSetServerReachable(phase->serverReachable);
+
+    uint64_t startUs = SimClock::nowUs();
+    auto beginT0 = std::chrono::steady_clock::now();
+    breathController.begin();
+    double beginWallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - beginT0).count();
+    uint64_t beginVirtualUs = SimClock::nowUs() - startUs;
+    breathController.initializeOxygenSensor();
+
+    printf("=== 连接状态机 (虚拟时钟, %s遥测) ===\n", binary ? "二进制" : "文本");
+    printf("begin():            虚拟 %.1f ms, 主机 %.1f ms\n", beginVirtualUs / 1000.0, beginWallMs);
+
+    startUs = SimClock::nowUs();
+    uint64_t maxVirtualUs = 0;
+    double maxWallUs = 0;
+    uint32_t updates = 0;
+    double recoverFromS = -1;
+    size_t phaseCount = sizeof(PHASES) / sizeof(PHASES[0]);
+    for (size_t p = 0; p < phaseCount; p++) {
+        phase = &PHASES[p];
+        WiFi.simSetAvailable(phase->apAvailable);
+        WiFi.simSetServerReachable(phase->serverReachable);
+        if (phase->serverListening) sink.open(port);
+        else sink.close();
+        double phaseStartS = (SimClock::nowUs() - startUs) / 1e6;
+        bool wasConnected = breathController.getConnectionStats().state == CONN_CONNECTED;
+        recoverFromS = -1;
+
+        while ((SimClock::nowUs() - startUs) / 1e6 < phase->endS) {
+            uint64_t t0 = SimClock::nowUs();
+            auto w0 = std::chrono::steady_clock::now();
+            breathController.update();
+            double wallUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - w0).count();
+            uint64_t virtualUs = SimClock::nowUs() - t0;
+            if (virtualUs > maxVirtualUs) maxVirtualUs = virtualUs;
+            if (wallUs > maxWallUs) maxWallUs = wallUs;
+            if (virtualUs == 0) SimClock::advanceUs(5);
+            if (++updates % 64 == 0) sink.poll();
+
+            if (!wasConnected && recoverFromS < 0 && breathController.getConnectionStats().state == CONN_CONNECTED) {
+                recoverFromS = (SimClock::nowUs() - startUs) / 1e6 - phaseStartS;
+            }
+        }
+        sink.poll();
+        ConnectionStats cs = breathController.getConnectionStats();
+        printf("%5.0f–%3.0f s %-12s 结束状态 %s, 退避 %u ms", phaseStartS, phase->endS, phase->name,
+               ConnectionManager::stateName(cs.state), cs.backoffMs);
+        if (recoverFromS >= 0) printf(", %.2f s后连接", recoverFromS);
+        printf("\n");
+    }
+    sink.close();
+    HardwareSerial::setConsoleEnabled(true);
+
+    ConnectionStats cs = breathController.getConnectionStats();
+    SamplingStats st = breathController.getSamplingEngine()->getStats();
+    printf("update():           %u 次, 最长虚拟 %.2f ms, 最长主机 %.2f ms\n", updates, maxVirtualUs / 1000.0,
+           maxWallUs / 1000.0);
+    printf("连接步最长:         %u us（虚拟）\n", cs.maxStepUs);
+    printf("采样:               %u 样本, 超限 %u, 最大抖动 %u us\n", st.samples, st.overruns, st.maxJitterUs);
+    printf("WiFi:               尝试 %u, 成功 %u, 断开 %u\n", cs.wifiJoinAttempts, cs.wifiJoins, cs.wifiLosses);
+    printf("服务器:             尝试 %u, 成功 %u, 失败 %u, 断开 %u\n", cs.serverAttempts, cs.serverConnects,
+           cs.serverFailures, cs.serverDisconnects);
+    printf("发送:               %u 字节（接收端 %llu）, 拒绝 %u, 状态切换 %u\n", cs.bytesSent,
+           (unsigned long long)sink.bytes(), cs.sendRejected, cs.stateChanges);
+    return 0;
+}
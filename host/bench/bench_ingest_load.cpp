@@ -0,0 +1,492 @@
+// 多设备负载生成器（接收端基准）
+//
+// 在一个进程里模拟N台设备的遥测发送路径：每台设备一个非阻塞TCP连接（依次绑定127.0.0.2起的
+// 本机地址，接收端按来源IP区分设备），按实时时钟以给定采样率产生样本。发送与ConnectionManager
+// 相同：整行/整帧交给send()，只写出一部分时余下的留到下一轮，期间新数据被拒绝（计数）。
+//   文本格式: BreathController::formatDataLine()生成与sendDataOverWiFi()相同的行，按固件节奏
+//             每TEXT_TELEMETRY_INTERVAL_MS一行（--text-interval-ms 0 每个样本一行）
+//   二进制格式(--binary): TelemetryEncoder按固件的批量（20条或100ms一帧）编码，--compress 压缩负载
+// 样本来源: 默认合成呼吸波形（各设备呼吸周期和相位不同）；--sim S 先在虚拟时钟下按sketch配置
+// 运行整机S秒（仿真传感器总线），录下经固件滤波的样本，各设备错开起点循环回放。
+// 默认在本进程内运行IngestServer，按样本的设备时间戳计算从产生到接收端解析完成的延迟
+// （二进制含攒批时间）；--connect HOST:PORT 改为发往外部接收服务，只报告发送端统计。
+// --devices 和 --rate 可给逗号分隔的列表，逐个组合各运行 --seconds 秒，每个组合一行：
+// 期望/实收样本率、接收字节率、被拒绝的样本、延迟P50/P99/最大、接收线程CPU占用。
+//
+// 用法: bench_ingest_load [--devices 1,10,100] [--rate 200] [--seconds S] [--binary [--compress]]
+//                         [--text-interval-ms MS] [--sim S] [--threads T] [--connect HOST:PORT] [--verbose]
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <math.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+#include "BreathController.h"
+#include "IngestServer.h"
+#include "SimClock.h"
+#include "SimRig.h"
+#include "SketchSetup.h"
+#include "TelemetryProtocol.h"
+
+namespace {
+constexpr double BASE_KPA = 101.3;
+constexpr double AMPLITUDE_KPA = 2.0;
+constexpr double INSPIRATION_FRACTION = 0.4;
+constexpr double CONNECT_TIMEOUT_S = 10;
+constexpr double DRAIN_S = 0.5;
+constexpr uint32_t TICK_US = 1000;
+
+struct Options {
+    std::vector<int> devices = {1, 10, 100};
+    std::vector<int> rates = {DEFAULT_SAMPLE_RATE_HZ};
+    double seconds = 5;
+    bool binary = false;
+    bool compress = false;
+    uint32_t textIntervalMs = TEXT_TELEMETRY_INTERVAL_MS;
+    double simSeconds = 0;
+    int threads = 2;
+    std::string host;           // 空串：本进程内的接收服务
+    uint16_t port = 0;
+    bool verbose = false;
+};
+
+// 一个样本的可变字段（来源于合成波形或整机仿真录制）
+struct SourceSample {
+    float pressureKpa;
+    float temperatureC;
+    float valveFraction;
+    float flowRate;
+    float co2Ppm;
+    float oxygenPercent;
+    uint8_t state;
+};
+
+std::vector<SourceSample> g_recorded;
+
+float breathWaveform(double t) {
+    constexpr double period = 3.0;
+    double phase = fmod(t, period);
+    double ti = period * INSPIRATION_FRACTION;
+    return (float)(BASE_KPA + AMPLITUDE_KPA * (phase < ti ? 0.5 * (1 - cos(2 * M_PI * phase / ti)) : 0));
+}
+
+// 设备i的第k个样本
+SourceSample sourceSample(uint32_t device, uint32_t k, int rateHz) {
+    if (!g_recorded.empty()) {
+        return g_recorded[(k + (uint64_t)device * 7919) % g_recorded.size()];
+    }
+    double period = 2.5 + (device % 16) * 0.1;
+    double t = k / (double)rateHz + device * 0.37;
+    double phase = fmod(t, period);
+    bool inhale = phase < period * INSPIRATION_FRACTION;
+    double breath = inhale ? 0.5 * (1 - cos(2 * M_PI * phase / (period * INSPIRATION_FRACTION))) : 0;
+    SourceSample s;
+    s.pressureKpa = (float)(BASE_KPA + AMPLITUDE_KPA * breath);
+    s.temperatureC = 25.0f + 0.01f * (k % 5);
+    s.valveFraction = inhale ? 0.35f : 0.0f;
+    s.flowRate = NAN;
+    s.co2Ppm = 450;
+    s.oxygenPercent = 20.9f;
+    s.state = inhale ? INHALE : EXHALE;
+    return s;
+}
+
+// 按sketch配置在虚拟时钟下运行整机，接收端（同一个IngestServer）录下样本
+bool recordSimulation(double seconds, bool verbose) {
+    IngestServer server;
+    if (!server.listenTcp(0, true)) return false;
+    server.setSampleCallback(
+        [](void*, const IngestDevice&, const IngestSample& s) {
+            SourceSample r = {s.pressureKpa, s.temperatureC, s.valveFraction, s.flowRate,
+                              s.co2Ppm,      s.oxygenPercent, s.state};
+            g_recorded.push_back(r);
+        },
+        nullptr);
+
+    SimRig rig;
+    rig.install();
+    rig.primaryPressure.setPressureWaveform(breathWaveform);
+    HardwareSerial::setConsoleEnabled(verbose);
+    I2CMux i2cMux(0x70);
+    configureSketchChannels(i2cMux);
+    BreathController bc(&i2cMux);
+    bc.setADS1115Channel(5);
+    bc.setWiFiCredentials("sim", "sim", "127.0.0.1", server.tcpPort());
+    bc.setSamplingRate(DEFAULT_SAMPLE_RATE_HZ);
+    bc.setTelemetryFormat(TELEMETRY_BINARY);
+    bc.begin();
+    bc.initializeOxygenSensor();
+
+    uint64_t endUs = SimClock::nowUs() + (uint64_t)(seconds * 1e6);
+    uint32_t updates = 0;
+    while (SimClock::nowUs() < endUs) {
+        uint64_t t0 = SimClock::nowUs();
+        bc.update();
+        if (SimClock::nowUs() == t0) SimClock::advanceUs(5);
+        if (++updates % 64 == 0) server.poll(0);
+    }
+    bc.getSamplingEngine()->end();
+    for (int i = 0; i < 10; i++) server.poll(10);
+    HardwareSerial::setConsoleEnabled(true);
+    return !g_recorded.empty();
+}
+
+struct DeviceStats {
+    uint64_t samples;           // 产生的样本
+    uint64_t sentSamples;       // 随行/帧成功交给send()的样本
+    uint64_t rejectedSamples;   // 上一块还没写完而丢弃
+    uint64_t bytes;
+};
+
+// 一台虚拟设备的遥测路径
+class VirtualDevice {
+public:
+    VirtualDevice(uint32_t index, const Options& options, int rateHz)
+        : _index(index), _options(options), _rateHz(rateHz), _encoder(TELEMETRY_BATCH_SAMPLES) {
+        _encoder.setBase((float)BASE_KPA, 25.0f);
+        _encoder.setSampleRate((uint16_t)rateHz);
+        _encoder.setBootId((uint16_t)(index + 1));
+        _encoder.setCompression(options.compress);
+    }
+    ~VirtualDevice() {
+        if (_fd >= 0) close(_fd);
+    }
+
+    bool connectTo(const std::string& host, uint16_t port) {
+        _fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (_fd < 0) return false;
+        struct sockaddr_in server = {};
+        server.sin_family = AF_INET;
+        server.sin_port = htons(port);
+        if (host.empty()) {
+            server.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            // 本机接收服务按来源IP区分设备：127.0.0.2, 127.0.0.3, ...
+            struct sockaddr_in local = {};
+            local.sin_family = AF_INET;
+            local.sin_addr.s_addr = htonl(INADDR_LOOPBACK + 1 + _index);
+            if (bind(_fd, (struct sockaddr*)&local, sizeof(local)) != 0) return false;
+        } else if (inet_pton(AF_INET, host.c_str(), &server.sin_addr) != 1) {
+            return false;
+        }
+        // 阻塞connect的超时（Linux下SO_SNDTIMEO对connect同样有效）
+        struct timeval timeout = {(time_t)CONNECT_TIMEOUT_S, 0};
+        setsockopt(_fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        if (connect(_fd, (struct sockaddr*)&server, sizeof(server)) != 0) return false;
+        int flags = 1;
+        setsockopt(_fd, IPPROTO_TCP, 1 /* TCP_NODELAY */, &flags, sizeof(flags));
+        return true;
+    }
+
+    void start(uint64_t startUs) {
+        _nextSampleUs = startUs + (uint64_t)_index * 997 % (1000000 / _rateHz);
+        _lastLineUs = 0;
+        _frameStartUs = 0;
+    }
+
+    // 产生到nowUs为止应有的样本并尽量写出
+    void step(uint64_t nowUs) {
+        uint64_t periodUs = 1000000 / _rateHz;
+        while (_nextSampleUs <= nowUs) {
+            produce(_nextSampleUs, nowUs);
+            _nextSampleUs += periodUs;
+        }
+        if (_options.binary && _encoder.pending() > 0 && nowUs - _frameStartUs >= TELEMETRY_MAX_FRAME_AGE_MS * 1000) {
+            flushFrame(nowUs);
+        }
+        writePending();
+    }
+
+    void finish(uint64_t nowUs) {
+        if (_options.binary) flushFrame(nowUs);
+        writePending();
+    }
+
+    const DeviceStats& stats() const { return _stats; }
+
+private:
+    void produce(uint64_t sampleUs, uint64_t nowUs) {
+        SourceSample s = sourceSample(_index, _seq, _rateHz);
+        _stats.samples++;
+        if (!_options.binary) {
+            if (sampleUs - _lastLineUs < _options.textIntervalMs * 1000ull) {
+                _seq++;
+                return;
+            }
+            _lastLineUs = sampleUs;
+            String line = BreathController::formatDataLine((unsigned long)(sampleUs / 1000), s.pressureKpa,
+                                                           s.temperatureC, s.valveFraction * MAX_VALVE_OPEN,
+                                                           (BreathState)s.state);
+            queue((const uint8_t*)line.c_str(), line.length(), 1);
+            _seq++;
+            return;
+        }
+        TelemetryRecord r;
+        r.seq = _seq++;
+        r.timestampUs = (uint32_t)sampleUs;
+        r.pressureKpa = s.pressureKpa;
+        r.backupPressureKpa = NAN;
+        r.flowRate = s.flowRate;
+        r.temperatureC = s.temperatureC;
+        r.co2Ppm = s.co2Ppm;
+        r.oxygenPercent = s.oxygenPercent;
+        r.valveFraction = s.valveFraction;
+        r.state = s.state;
+        r.flags = TELEMETRY_FLAG_BASE_SET;
+        if (_encoder.pending() == 0) _frameStartUs = nowUs;
+        if (_encoder.add(r)) flushFrame(nowUs);
+    }
+
+    void flushFrame(uint64_t nowUs) {
+        uint8_t count = _encoder.pending();
+        size_t len = _encoder.finish((uint32_t)nowUs);
+        if (len == 0) return;
+        if (!queue(_encoder.data(), len, count)) _encoder.addDropped(count);
+    }
+
+    // 与ConnectionManager::send()相同：上一块没写完时拒绝
+    bool queue(const uint8_t* data, size_t len, uint32_t samples) {
+        if (_pendingOffset < _pending.size()) {
+            _stats.rejectedSamples += samples;
+            return false;
+        }
+        _pending.assign(data, data + len);
+        _pendingOffset = 0;
+        _stats.sentSamples += samples;
+        writePending();
+        return true;
+    }
+
+    void writePending() {
+        while (_fd >= 0 && _pendingOffset < _pending.size()) {
+            ssize_t n = send(_fd, _pending.data() + _pendingOffset, _pending.size() - _pendingOffset,
+                             MSG_DONTWAIT | MSG_NOSIGNAL);
+            if (n <= 0) return;
+            _pendingOffset += (size_t)n;
+            _stats.bytes += (uint64_t)n;
+        }
+    }
+
+    uint32_t _index;
+    const Options& _options;
+    int _rateHz;
+    int _fd = -1;
+    uint32_t _seq = 0;
+    uint64_t _nextSampleUs = 0;
+    uint64_t _lastLineUs = 0;
+    uint64_t _frameStartUs = 0;
+    TelemetryEncoder _encoder;
+    std::vector<uint8_t> _pending;
+    size_t _pendingOffset = 0;
+    DeviceStats _stats = {};
+};
+
+// 延迟统计：接收服务的样本回调（主线程）
+struct LatencyCollector {
+    std::vector<uint32_t> latencyUs;
+    uint64_t samples = 0;
+};
+
+void onIngestSample(void* context, const IngestDevice&, const IngestSample& s) {
+    LatencyCollector* c = static_cast<LatencyCollector*>(context);
+    c->samples++;
+    c->latencyUs.push_back((uint32_t)s.hostUs - s.deviceUs);
+}
+
+double threadCpuS() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+bool runCase(const Options& options, int deviceCount, int rateHz) {
+    IngestServer server;
+    LatencyCollector latency;
+    bool local = options.host.empty();
+    uint16_t port = options.port;
+    if (local) {
+        server.setRingCapacity(4096);
+        server.setSampleCallback(onIngestSample, &latency);
+        if (!server.listenTcp(0, true)) {
+            fprintf(stderr, "无法启动接收服务\n");
+            return false;
+        }
+        port = server.tcpPort();
+    }
+
+    std::vector<std::unique_ptr<VirtualDevice>> devices;
+    for (int i = 0; i < deviceCount; i++) devices.emplace_back(new VirtualDevice((uint32_t)i, options, rateHz));
+
+    // 发送线程各负责一段设备；先全部连上再同时开始
+    std::atomic<int> connected(0);
+    std::atomic<int> failed(0);
+    std::atomic<bool> go(false);
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> startUs(0);
+    int threadCount = std::max(1, std::min(options.threads, deviceCount));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back([&, t]() {
+            size_t begin = devices.size() * t / threadCount;
+            size_t end = devices.size() * (t + 1) / threadCount;
+            for (size_t i = begin; i < end; i++) {
+                if (devices[i]->connectTo(options.host, port)) connected++;
+                else failed++;
+            }
+            while (!go) std::this_thread::sleep_for(std::chrono::microseconds(100));
+            for (size_t i = begin; i < end; i++) devices[i]->start(startUs);
+            while (!stop) {
+                uint64_t now = IngestServer::hostNowUs();
+                for (size_t i = begin; i < end; i++) devices[i]->step(now);
+                std::this_thread::sleep_for(std::chrono::microseconds(TICK_US));
+            }
+            uint64_t now = IngestServer::hostNowUs();
+            for (size_t i = begin; i < end; i++) devices[i]->finish(now);
+        });
+    }
+
+    uint64_t waitStart = IngestServer::hostNowUs();
+    while (connected + failed < deviceCount ||
+           (local && server.stats().activeConnections < (uint32_t)connected.load())) {
+        if (local) server.poll(10);
+        else std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        if (IngestServer::hostNowUs() - waitStart > CONNECT_TIMEOUT_S * 1e6) break;
+    }
+    if (failed > 0 || connected < deviceCount) {
+        fprintf(stderr, "%d 台设备中 %d 台连接失败\n", deviceCount, deviceCount - connected.load());
+        stop = go = true;
+        for (std::thread& t : threads) t.join();
+        return false;
+    }
+
+    latency.latencyUs.reserve((size_t)(deviceCount * rateHz * (options.seconds + DRAIN_S)));
+    startUs = IngestServer::hostNowUs();
+    go = true;
+    double cpu0 = threadCpuS();
+    uint64_t endUs = startUs + (uint64_t)(options.seconds * 1e6);
+    while (IngestServer::hostNowUs() < endUs) {
+        if (local) server.poll(5);
+        else std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    stop = true;
+    for (std::thread& t : threads) t.join();
+    uint64_t drainEnd = IngestServer::hostNowUs() + (uint64_t)(DRAIN_S * 1e6);
+    while (local && IngestServer::hostNowUs() < drainEnd) server.poll(5);
+    double cpuS = threadCpuS() - cpu0;
+    double elapsedS = (IngestServer::hostNowUs() - startUs) / 1e6;
+
+    DeviceStats total = {};
+    for (auto& d : devices) {
+        total.samples += d->stats().samples;
+        total.sentSamples += d->stats().sentSamples;
+        total.rejectedSamples += d->stats().rejectedSamples;
+        total.bytes += d->stats().bytes;
+    }
+    double expectedRate = (double)deviceCount * rateHz;
+    if (!options.binary && options.textIntervalMs > 0) {
+        expectedRate = deviceCount * std::min<double>(rateHz, 1000.0 / options.textIntervalMs);
+    }
+    printf("%6d  %6d  %12.0f  %11.0f  %10.1f  %7llu", deviceCount, rateHz, expectedRate,
+           total.sentSamples / options.seconds, total.bytes / options.seconds / 1024,
+           (unsigned long long)total.rejectedSamples);
+    if (!local) {
+        printf("        -        -        -        -\n");
+        return true;
+    }
+    IngestServerStats s = server.stats();
+    std::vector<uint32_t>& l = latency.latencyUs;
+    std::sort(l.begin(), l.end());
+    auto pct = [&](double p) { return l.empty() ? 0.0 : l[(size_t)((l.size() - 1) * p)] / 1000.0; };
+    printf("  %11.0f  %7.2f  %7.2f  %7.2f  %6.1f%%\n", latency.samples / options.seconds, pct(0.5), pct(0.99),
+           l.empty() ? 0.0 : l.back() / 1000.0, cpuS / elapsedS * 100);
+    if (s.badLines || s.crcErrors || latency.samples != total.sentSamples) {
+        printf("        接收端: 样本 %llu / 发出 %llu, 无效行 %u, CRC错误 %u\n", (unsigned long long)latency.samples,
+               (unsigned long long)total.sentSamples, s.badLines, s.crcErrors);
+    }
+    return true;
+}
+
+std::vector<int> parseList(const char* arg) {
+    std::vector<int> values;
+    for (const char* p = arg; *p;) {
+        values.push_back(atoi(p));
+        const char* comma = strchr(p, ',');
+        if (!comma) break;
+        p = comma + 1;
+    }
+    return values;
+}
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--devices") && i + 1 < argc) options.devices = parseList(argv[++i]);
+        else if (!strcmp(argv[i], "--rate") && i + 1 < argc) options.rates = parseList(argv[++i]);
+        else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) options.seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--binary")) options.binary = true;
+        else if (!strcmp(argv[i], "--compress")) options.binary = options.compress = true;
+        else if (!strcmp(argv[i], "--text-interval-ms") && i + 1 < argc) options.textIntervalMs = (uint32_t)atol(argv[++i]);
+        else if (!strcmp(argv[i], "--sim") && i + 1 < argc) options.simSeconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc) options.threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--connect") && i + 1 < argc) {
+            std::string target = argv[++i];
+            size_t colon = target.rfind(':');
+            if (colon == std::string::npos) {
+                fprintf(stderr, "--connect 需要 HOST:PORT\n");
+                return 2;
+            }
+            options.host = target.substr(0, colon);
+            options.port = (uint16_t)atoi(target.c_str() + colon + 1);
+        } else if (!strcmp(argv[i], "--verbose")) options.verbose = true;
+        else {
+            fprintf(stderr,
+                    "用法: %s [--devices 1,10,100] [--rate 200] [--seconds S] [--binary [--compress]]\n"
+                    "         [--text-interval-ms MS] [--sim S] [--threads T] [--connect HOST:PORT] [--verbose]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    for (int n : options.devices) {
+        if (n < 1 || (options.host.empty() && n > 60000)) {
+            fprintf(stderr, "设备数应为1~60000\n");
+            return 2;
+        }
+    }
+    for (int r : options.rates) {
+        if (r < 1 || r > 10000) {
+            fprintf(stderr, "采样率应为1~10000 Hz\n");
+            return 2;
+        }
+    }
+
+    if (options.simSeconds > 0) {
+        if (!recordSimulation(options.simSeconds, options.verbose)) {
+            fprintf(stderr, "整机仿真未录到样本\n");
+            return 1;
+        }
+    }
+
+    const char* format = options.binary ? (options.compress ? "二进制压缩帧" : "二进制帧") : "文本行";
+    printf("=== 多设备接收负载 (%s, %s, 每组 %.0f s, %s) ===\n", format,
+           g_recorded.empty() ? "合成波形" : "整机仿真回放",
+           options.seconds, options.host.empty() ? "本进程接收服务" : options.host.c_str());
+    printf("  设备  采样率  期望(样本/s)  发出(样本/s)  发送(KB/s)     拒绝  实收(样本/s)  P50(ms)  P99(ms)  "
+           "最大(ms)  接收CPU\n");
+    for (int n : options.devices) {
+        for (int r : options.rates) {
+            if (!runCase(options, n, r)) return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,138 @@
+// 肺力学在线估计主机基准
+//
+// 用单室被动肺模型（已知阻力R、顺应性C）模拟压力控制通气：气道压在吸气开始后
+// 按指数上升到PIP，呼气回到PEEP，流量 Q = (Paw - PEEP - V/C) / R。
+// 按流量传感器的采样率把（压力, 流量, 状态）送入LungMechanicsEstimator，报告：
+//   收敛所需呼吸数（C误差<10%且R误差<20%）、稳态误差、每次更新耗时；
+//   --step-c 在中途把顺应性改为新值，报告重新收敛所需呼吸数（遗忘因子的跟踪能力）。
+//
+// 用法: bench_lung_mechanics [--rate HZ] [--breaths N] [--r CMH2O_S_PER_L] [--c ML_PER_CMH2O]
+//                            [--step-c ML_PER_CMH2O] [--noise KPA] [--flow-noise LPM]
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "LungMechanics.h"
+
+namespace {
+constexpr double PERIOD_S = 3.0;
+constexpr double TI_S = 1.0;
+constexpr double PEEP_KPA = 0.5;
+constexpr double PIP_KPA = 2.0;
+constexpr double RISE_TAU_S = 0.05;   // 气道压上升时间常数
+constexpr double SIM_DT_S = 1e-4;
+
+uint32_t g_seed = 1;
+double noise(double sigma) {
+    if (sigma <= 0) return 0;
+    g_seed = g_seed * 1664525u + 1013904223u;
+    double u1 = ((g_seed >> 8) + 1.0) / 16777217.0;
+    g_seed = g_seed * 1664525u + 1013904223u;
+    double u2 = (g_seed >> 8) / 16777216.0;
+    return sigma * sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+}
+
+bool converged(const LungMechanics& m, double r, double c) {
+    return m.valid && fabs(m.complianceMlCmH2O - c) < 0.1 * c && fabs(m.resistanceCmH2O - r) < 0.2 * r;
+}
+}
+
+int main(int argc, char** argv) {
+    uint32_t rateHz = 10;
+    uint32_t breaths = 60;
+    double r = 10;
+    double c = 50;
+    double stepC = 0;
+    double sigmaP = 0.005;
+    double sigmaQ = 0.2;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--rate") && i + 1 < argc) rateHz = (uint32_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--breaths") && i + 1 < argc) breaths = (uint32_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--r") && i + 1 < argc) r = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--c") && i + 1 < argc) c = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--step-c") && i + 1 < argc) stepC = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--noise") && i + 1 < argc) sigmaP = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--flow-noise") && i + 1 < argc) sigmaQ = atof(argv[++i]);
+        else {
+            fprintf(stderr, "用法: %s [--rate HZ] [--breaths N] [--r CMH2O_S_PER_L] [--c ML_PER_CMH2O]"
+                            " [--step-c ML_PER_CMH2O] [--noise KPA] [--flow-noise LPM]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (rateHz == 0 || breaths < 4 || r <= 0 || c <= 0) {
+        fprintf(stderr, "参数无效：需要 rate > 0, breaths >= 4, r > 0, c > 0\n");
+        return 2;
+    }
+
+    LungMechanicsEstimator estimator;
+    double volumeL = 0;
+    double trueR = r, trueC = c;
+    uint32_t stepBreath = stepC > 0 ? breaths / 2 : breaths;
+    int convergedAt = -1, reconvergedAt = -1;
+    double errC = 0, errR = 0;
+    uint32_t errCount = 0;
+    double updateNs = 0;
+    uint32_t updates = 0;
+    double nextSample = 0;
+    uint64_t steps = (uint64_t)(breaths * PERIOD_S / SIM_DT_S);
+
+    for (uint64_t i = 0; i < steps; i++) {
+        double t = i * SIM_DT_S;
+        uint32_t breath = (uint32_t)(t / PERIOD_S);
+        if (breath == stepBreath && stepC > 0) trueC = stepC;
+        double phase = t - breath * PERIOD_S;
+        bool inspiration = phase < TI_S;
+        double paw = inspiration ? PEEP_KPA + (PIP_KPA - PEEP_KPA) * (1 - exp(-phase / RISE_TAU_S)) : PEEP_KPA;
+        // R: cmH2O·s/L -> kPa·s/L；C: ml/cmH2O -> L/kPa
+        double rKpa = trueR / KPA_TO_CMH2O;
+        double cL = trueC * KPA_TO_CMH2O / 1000.0;
+        double flowLps = (paw - PEEP_KPA - volumeL / cL) / rKpa;
+
+        if (t >= nextSample) {
+            nextSample += 1.0 / rateHz;
+            BreathState state = inspiration ? (phase < TI_S / 2 ? INHALE : PEAK) : EXHALE;
+            float p = (float)(paw + noise(sigmaP));
+            float q = (float)((flowLps * 60 + noise(sigmaQ)) * 1000);   // 传感器只测吸入方向
+            if (q < 0) q = 0;
+            auto t0 = std::chrono::steady_clock::now();
+            estimator.update((unsigned long)llround(t * 1e6), state, p, q);
+            updateNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+            updates++;
+
+            const LungMechanics& m = estimator.estimate();
+            bool ok = converged(m, trueR, trueC);
+            if (breath < stepBreath) {
+                if (ok && convergedAt < 0) convergedAt = breath;
+            } else if (ok && reconvergedAt < 0) {
+                reconvergedAt = breath - stepBreath;
+            }
+            // 稳态误差：每段的后半程
+            uint32_t segmentStart = breath < stepBreath ? 0 : stepBreath;
+            uint32_t segmentEnd = breath < stepBreath ? stepBreath : breaths;
+            if (m.valid && breath >= (segmentStart + segmentEnd) / 2) {
+                errC += fabs(m.complianceMlCmH2O - trueC) / trueC;
+                errR += fabs(m.resistanceCmH2O - trueR) / trueR;
+                errCount++;
+            }
+        }
+        volumeL += flowLps * SIM_DT_S;
+    }
+
+    const LungMechanics& m = estimator.estimate();
+    printf("=== 肺力学RLS估计 (%u Hz, %u 次呼吸, R=%.1f cmH2O/(L/s), C=%.1f ml/cmH2O, 噪声 %.3f kPa / %.2f L/min) ===\n",
+           rateHz, breaths, r, c, sigmaP, sigmaQ);
+    printf("收敛:               第 %d 次呼吸 (C误差<10%%, R误差<20%%)\n", convergedAt);
+    if (stepC > 0) {
+        printf("顺应性阶跃:         第 %u 次呼吸 C -> %.1f, 重新收敛 %d 次呼吸\n", stepBreath, stepC, reconvergedAt);
+    }
+    printf("稳态平均误差:       C %.1f%%, R %.1f%%\n", errCount ? 100 * errC / errCount : NAN,
+           errCount ? 100 * errR / errCount : NAN);
+    printf("最终估计:           C %.1f ml/cmH2O, R %.1f cmH2O/(L/s), P0 %.3f kPa, τ %.0f ms, 残差RMS %.4f kPa, 有效 %s\n",
+           m.complianceMlCmH2O, m.resistanceCmH2O, m.offsetKpa, m.timeConstantMs, m.residualRmsKpa,
+           m.valid ? "是" : "否");
+    printf("更新耗时:           %.1f ns/样本 (%u 样本)\n", updates ? updateNs / updates : 0, updates);
+    return 0;
+}
@@ -0,0 +1,242 @@
+// 双核流水线主机基准
+//
+// 初始化在虚拟时钟下完成（与bench_update相同的sketch配置），随后切换到实时时钟，
+// 用std::thread承载的FreeRTOS任务替身运行startPipeline()的两个任务，
+// 遥测发往本机的TCP接收端。报告控制周期抖动/超限、控制步耗时、队列丢弃和遥测行数。
+// --unreachable 模拟服务器不可达（每次重连阻塞5秒），用于验证网络阻塞不影响控制核；
+// --single-core 在主线程中运行原有的单核定时循环作对照；
+// --binary 改用二进制批量帧遥测，接收端用TelemetryDecoder解码并核对CRC和样本序号；
+// --udp 经UDP发送二进制帧，接收端用UdpTelemetryReceiver统计丢包、乱序和单向延迟
+// （设备与主机时钟在切换实时模式时对齐），--loss/--reorder 设置替身链路的丢包/乱序概率。
+//
+// 用法: bench_pipeline [--rate HZ] [--seconds S] [--unreachable] [--single-core] [--binary]
+//                      [--udp [--loss P] [--reorder P]] [--verbose]
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+#include "BreathController.h"
+#include "SimClock.h"
+#include "SimRig.h"
+#include "SketchSetup.h"
+#include "TelemetryProtocol.h"
+#include "UdpTelemetryReceiver.h"
+
+namespace {
+// 本机遥测接收端：统计收到的行数和字节数，二进制帧交给解码器（只在接收线程中使用，stop()后读取）
+class TelemetrySink {
+public:
+    bool start() {
+        _listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        if (_listenFd < 0) return false;
+        struct sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(addr);
+        if (bind(_listenFd, (struct sockaddr*)&addr, len) != 0 || listen(_listenFd, 1) != 0 ||
+            getsockname(_listenFd, (struct sockaddr*)&addr, &len) != 0) {
+            close(_listenFd);
+            return false;
+        }
+        _port = ntohs(addr.sin_port);
+        _thread = std::thread([this] { run(); });
+        return true;
+    }
+
+    void stop() {
+        _stop = true;
+        if (_thread.joinable()) _thread.join();
+        if (_listenFd >= 0) close(_listenFd);
+    }
+
+    uint16_t port() const { return _port; }
+    uint32_t lines() const { return _lines; }
+    uint64_t bytes() const { return _bytes; }
+    const TelemetryDecoderStats& decoded() const { return _decoder.stats(); }
+
+private:
+    void run() {
+        int fd = -1;
+        char buf[4096];
+        while (!_stop) {
+            struct pollfd pfd = {fd >= 0 ? fd : _listenFd, POLLIN, 0};
+            if (poll(&pfd, 1, 50) <= 0) continue;
+            if (fd < 0) {
+                fd = accept(_listenFd, nullptr, nullptr);
+                continue;
+            }
+            ssize_t n = recv(fd, buf, sizeof(buf), 0);
+            if (n <= 0) {
+                close(fd);
+                fd = -1;
+                continue;
+            }
+            for (ssize_t i = 0; i < n; i++) {
+                if (buf[i] == '\n') _lines++;
+            }
+            _bytes += n;
+            _decoder.feed((const uint8_t*)buf, (size_t)n);
+        }
+        if (fd >= 0) close(fd);
+    }
+
+    int _listenFd = -1;
+    uint16_t _port = 0;
+    std::thread _thread;
+    std::atomic<bool> _stop{false};
+    std::atomic<uint32_t> _lines{0};
+    std::atomic<uint64_t> _bytes{0};
+    TelemetryDecoder _decoder;
+};
+
+// UDP接收线程
+class UdpSink {
+public:
+    bool start() {
+        if (!_receiver.open(0, true)) return false;
+        _thread = std::thread([this] {
+            while (!_stop) _receiver.poll(50);
+            _receiver.poll(0);
+        });
+        return true;
+    }
+
+    void stop() {
+        _stop = true;
+        if (_thread.joinable()) _thread.join();
+    }
+
+    uint16_t port() const { return _receiver.port(); }
+    UdpTelemetryReceiver& receiver() { return _receiver; }
+
+private:
+    UdpTelemetryReceiver _receiver;
+    std::thread _thread;
+    std::atomic<bool> _stop{false};
+};
+}
+
+int main(int argc, char** argv) {
+    uint32_t rateHz = DEFAULT_SAMPLE_RATE_HZ;
+    double seconds = 5.0;
+    bool unreachable = false;
+    bool singleCore = false;
+    bool binary = false;
+    bool udp = false;
+    float lossRate = 0;
+    float reorderRate = 0;
+    bool verbose = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--rate") && i + 1 < argc) rateHz = (uint32_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--unreachable")) unreachable = true;
+        else if (!strcmp(argv[i], "--single-core")) singleCore = true;
+        else if (!strcmp(argv[i], "--binary")) binary = true;
+        else if (!strcmp(argv[i], "--udp")) udp = binary = true;
+        else if (!strcmp(argv[i], "--loss") && i + 1 < argc) lossRate = (float)atof(argv[++i]);
+        else if (!strcmp(argv[i], "--reorder") && i + 1 < argc) reorderRate = (float)atof(argv[++i]);
+        else if (!strcmp(argv[i], "--verbose")) verbose = true;
+        else {
+            fprintf(stderr, "用法: %s [--rate HZ] [--seconds S] [--unreachable] [--single-core] [--binary]"
+                            " [--udp [--loss P] [--reorder P]] [--verbose]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (rateHz == 0) {
+        fprintf(stderr, "双核流水线需要定时采样（--rate > 0）\n");
+        return 2;
+    }
+
+    TelemetrySink sink;
+    UdpSink udpSink;
+    if (!sink.start() || (udp && !udpSink.start())) {
+        fprintf(stderr, "无法启动遥测接收端\n");
+        return 1;
+    }
+
+    SimRig rig;
+    rig.install();
+    HardwareSerial::setConsoleEnabled(verbose);
+    WiFi.simSetServerReachable(!unreachable);
+    WiFi.simSetUdpImpairment(lossRate, reorderRate);
+
+    I2CMux i2cMux(0x70);
+    BreathController breathController(&i2cMux);
+    breathController.setADS1115Channel(5);
+    configureSketchChannels(i2cMux);
+    breathController.setWiFiCredentials("sim", "sim", "127.0.0.1", udp ? udpSink.port() : sink.port());
+    breathController.setSamplingRate(rateHz);
+    breathController.setTelemetryFormat(binary ? TELEMETRY_BINARY : TELEMETRY_TEXT);
+    if (udp) breathController.setTelemetryTransport(TELEMETRY_UDP);
+    breathController.begin();
+    breathController.initializeOxygenSensor();
+
+    SimClock::setRealtime(true);
+    udpSink.receiver().monitor().setClockOffsetUs((int64_t)(UdpTelemetryReceiver::hostNowUs() - micros()));
+    rig.resetStats();
+    SamplingEngine* sampler = breathController.getSamplingEngine();
+    sampler->resetStats();
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds((int64_t)(seconds * 1e6));
+    bool pipelined = !singleCore && breathController.startPipeline();
+    if (pipelined) {
+        std::this_thread::sleep_until(deadline);
+        breathController.stopPipeline();
+    } else {
+        while (std::chrono::steady_clock::now() < deadline) {
+            breathController.update();
+        }
+    }
+    SamplingStats st = pipelined ? breathController.getPipelineStats().sampling : sampler->getStats();
+    SimClock::setRealtime(false);
+    sink.stop();
+    udpSink.stop();
+    HardwareSerial::setConsoleEnabled(true);
+
+    printf("=== 双核流水线实时基准 (%s, %.1f s, 服务器%s, %s遥测) ===\n", pipelined ? "双核" : "单核", seconds,
+           unreachable ? "不可达" : "可达", udp ? "UDP二进制" : binary ? "二进制" : "文本");
+    printf("实际采样率:         %.2f Hz / %u Hz (节拍 %u, 样本 %u, 失败 %u)\n", st.actualRateHz, rateHz, st.ticks,
+           st.samples, st.failures);
+    printf("超限周期:           %u (%.2f%%)\n", st.overruns, st.ticks ? 100.0 * st.overruns / st.ticks : 0.0);
+    printf("周期抖动:           平均 %.1f us, 最大 %u us; 中断到采集最大延迟 %u us\n", st.meanJitterUs,
+           st.maxJitterUs, st.maxLatencyUs);
+    if (pipelined) {
+        PipelineStats ps = breathController.getPipelineStats();
+        printf("控制步:             %u 次, 平均 %.0f us, 最大 %u us\n", ps.controlSteps, ps.meanControlStepUs,
+               ps.maxControlStepUs);
+        printf("遥测队列:           发布 %u, 取出 %u, 丢弃 %u, 最高水位 %u/%u\n", ps.published, ps.consumed,
+               ps.queueDropped, ps.queueHighWater, (unsigned)TELEMETRY_QUEUE_SIZE);
+        printf("网络任务单轮最长:   %.1f ms\n", ps.maxNetworkStepUs / 1000.0);
+    }
+    if (udp) {
+        TelemetryLinkStats link = breathController.getTelemetryLinkStats();
+        LinkQualityStats q = udpSink.receiver().monitor().stats();
+        printf("遥测帧(发送端):     %u 帧, %u 样本, %u 字节, 丢弃 %u 样本\n", link.frames, link.samples, link.bytes,
+               link.dropped);
+        printf("UDP接收端:          %u 帧, %u 样本, 丢失 %u/%u (%.2f%%), 乱序 %u, 重复 %u, 无效 %u\n", q.frames,
+               q.samples, q.lost, q.expected, q.lossPercent, q.reordered, q.duplicates, q.invalid);
+        printf("单向延迟:           平均 %.2f ms, P50 %.2f ms, P99 %.2f ms, 最大 %.2f ms, 抖动 %.2f ms\n",
+               q.meanLatencyMs, q.p50LatencyMs, q.p99LatencyMs, q.maxLatencyMs, q.jitterMs);
+    } else if (binary) {
+        TelemetryLinkStats link = breathController.getTelemetryLinkStats();
+        const TelemetryDecoderStats& d = sink.decoded();
+        printf("遥测帧(发送端):     %u 帧, %u 样本, %u 字节, 丢弃 %u 样本\n", link.frames, link.samples, link.bytes,
+               link.dropped);
+        printf("遥测帧(接收端):     %u 帧, %u 样本, %.1f 字节/样本, CRC错误 %u, 丢失样本 %u\n", d.frames,
+               d.records, d.records ? (double)sink.bytes() / d.records : 0.0, d.crcErrors, d.lostSamples);
+    } else {
+        printf("遥测行(接收端):     %u, %.1f 字节/行\n", sink.lines(),
+               sink.lines() ? (double)sink.bytes() / sink.lines() : 0.0);
+    }
+    printf("OLED整帧:           %u\n", rig.oled.framesCompleted());
+    return 0;
+}
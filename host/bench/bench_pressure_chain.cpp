@@ -0,0 +1,123 @@
+// 气压换算与滤波链路主机基准
+//
+// 用合成的呼吸波形ADC样本（24位压力 + 16位温度）分别跑浮点链路
+// （逐样本求k、浮点换算、浮点移动平均 + EWMA，与setFixedPointFilter(false)一致）
+// 和定点链路（编译期折叠系数的Q19.12换算、定点移动平均 + EWMA），
+// 报告每样本耗时（ns）以及定点结果相对浮点结果的误差（kPa）。
+// 定点链路分别计入/不计入最后一次转为浮点kPa的开销。
+//
+// 用法: bench_pressure_chain [--samples N] [--rounds R]
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "BreathController.h"
+#include "PressureMath.h"
+
+namespace {
+struct RawSample {
+    uint32_t pressureAdc;
+    uint16_t temperatureAdc;
+};
+
+// 100~104 kPa的呼吸波形叠加噪声，按传感器公式反算ADC值
+std::vector<RawSample> makeSamples(uint32_t count) {
+    std::vector<RawSample> samples(count);
+    uint32_t seed = 12345;
+    for (uint32_t i = 0; i < count; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        float noise = ((seed >> 8) / 16777216.0f - 0.5f) * 0.05f;
+        float kpa = 102.0f + 2.0f * sinf(i * 0.02f) + noise;
+        int32_t counts = (int32_t)lroundf((kpa * PRESSURE_DIVISOR - PRESSURE_OFFSET_COUNTS) * PRESSURE_K);
+        samples[i].pressureAdc = (uint32_t)counts & 0xFFFFFF;
+        samples[i].temperatureAdc = (uint16_t)(int16_t)lroundf((25.0f + 0.5f * sinf(i * 0.001f)) * 256);
+    }
+    return samples;
+}
+
+volatile float g_range = PRESSURE_RANGE;  // 防止浮点链路的k被编译期折叠
+volatile float g_sinkF;
+volatile int32_t g_sinkQ;
+
+double nowNs() {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+template <typename Fn>
+double bestNsPerSample(uint32_t rounds, uint32_t count, Fn fn) {
+    double best = 1e30;
+    for (uint32_t r = 0; r < rounds; r++) {
+        double t0 = nowNs();
+        fn();
+        double ns = (nowNs() - t0) / count;
+        if (ns < best) best = ns;
+    }
+    return best;
+}
+}
+
+int main(int argc, char** argv) {
+    uint32_t count = 1u << 16;
+    uint32_t rounds = 20;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--samples") && i + 1 < argc) count = (uint32_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--rounds") && i + 1 < argc) rounds = (uint32_t)atoi(argv[++i]);
+        else {
+            fprintf(stderr, "用法: %s [--samples N] [--rounds R]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (count == 0 || rounds == 0) {
+        fprintf(stderr, "样本数和轮数必须大于0\n");
+        return 2;
+    }
+
+    std::vector<RawSample> samples = makeSamples(count);
+    std::vector<float> floatOut(count), fixedOut(count);
+
+    double floatNs = bestNsPerSample(rounds, count, [&] {
+        PressureFilter filter;
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t k = pressureKValue(g_range);
+            float temperature = pressureTemperatureC(samples[i].temperatureAdc);
+            floatOut[i] = filter.update(pressureAdcToKpa(samples[i].pressureAdc, k));
+            g_sinkF = temperature;
+        }
+    });
+
+    double fixedNs = bestNsPerSample(rounds, count, [&] {
+        FixedPressureFilter filter;
+        for (uint32_t i = 0; i < count; i++) {
+            fixedOut[i] = pressureQToKpa(filter.update(pressureAdcToQ<PRESSURE_K>(samples[i].pressureAdc)));
+            g_sinkF = temperatureQ8ToC(samples[i].temperatureAdc);
+        }
+    });
+
+    double integerNs = bestNsPerSample(rounds, count, [&] {
+        FixedPressureFilter filter;
+        int32_t q = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            q = filter.update(pressureAdcToQ<PRESSURE_K>(samples[i].pressureAdc));
+            g_sinkQ = q;
+        }
+    });
+
+    double maxErr = 0, sumErr = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        double err = fabs((double)fixedOut[i] - floatOut[i]);
+        if (err > maxErr) maxErr = err;
+        sumErr += err;
+    }
+
+    printf("=== 气压换算+滤波链路 (%u 样本, 最优 %u 轮, k=%u, Q%u) ===\n", count, rounds, (unsigned)PRESSURE_K,
+           (unsigned)PRESSURE_Q_BITS);
+    printf("浮点链路:               %.2f ns/样本\n", floatNs);
+    printf("定点链路(输出浮点kPa):  %.2f ns/样本 (%.2fx)\n", fixedNs, floatNs / fixedNs);
+    printf("定点链路(纯整数):       %.2f ns/样本 (%.2fx)\n", integerNs, floatNs / integerNs);
+    printf("定点相对浮点误差:       平均 %.3f Pa, 最大 %.3f Pa\n", sumErr / count * 1000, maxErr * 1000);
+    return 0;
+}
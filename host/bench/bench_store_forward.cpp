@@ -0,0 +1,245 @@
+// 断线存储转发主机基准
+//
+// 按sketch配置在虚拟时钟下运行定时采样的update()，二进制TCP遥测发往本机接收端，
+// 开启存储转发（LittleFS替身落在临时目录）。时间表：
+//   0–10 s 服务器在线；之后关闭 --outage 秒（帧存入闪存日志）；随后恢复，
+//   补发完成后再运行10秒。
+// --reboot S 在第S秒模拟掉电重启：丢弃控制器（内存中未写入闪存的帧随之丢失），
+// 新建控制器从闪存恢复日志，启动计数加1。
+// 接收端解码全部帧，按(bootId, frameSeq)去重，报告唯一样本、重复帧、仍缺失的帧，
+// 补发耗时和速率，闪存写入次数/字节（平均每次写入大小即擦写粒度），以及update()最长耗时。
+//
+// --compress 开启帧负载压缩（同样的闪存和补发带宽容纳更多样本）。
+//
+// 用法: bench_store_forward [--outage S] [--backfill-bps N] [--reboot S] [--compress] [--verbose]
+
+#include <chrono>
+#include <fcntl.h>
+#include <memory>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <LittleFS.h>
+#include <Preferences.h>
+
+#include "BreathController.h"
+#include "SimClock.h"
+#include "SimRig.h"
+#include "SketchSetup.h"
+#include "TelemetryDeduplicator.h"
+
+namespace {
+constexpr double CONNECTED_S = 10;
+constexpr double TAIL_S = 10;
+constexpr double MAX_BACKFILL_S = 600;
+
+// 非阻塞本机TCP接收端：解码并去重，可关闭后在同一端口重新监听
+class DedupSink {
+public:
+    DedupSink() { _decoder.setFrameCallback(onFrame, this); }
+
+    bool open(uint16_t port) {
+        if (_listenFd >= 0) return true;
+        _listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        if (_listenFd < 0) return false;
+        int one = 1;
+        setsockopt(_listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        struct sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(port);
+        socklen_t len = sizeof(addr);
+        if (bind(_listenFd, (struct sockaddr*)&addr, len) != 0 || listen(_listenFd, 1) != 0 ||
+            getsockname(_listenFd, (struct sockaddr*)&addr, &len) != 0) {
+            close();
+            return false;
+        }
+        fcntl(_listenFd, F_SETFL, O_NONBLOCK);
+        _port = ntohs(addr.sin_port);
+        return true;
+    }
+
+    void close() {
+        closeConnection();
+        if (_listenFd >= 0) ::close(_listenFd);
+        _listenFd = -1;
+    }
+
+    void poll() {
+        if (_fd < 0 && _listenFd >= 0) {
+            _fd = accept(_listenFd, nullptr, nullptr);
+            if (_fd >= 0) fcntl(_fd, F_SETFL, O_NONBLOCK);
+        }
+        if (_fd < 0) return;
+        uint8_t buf[4096];
+        ssize_t n;
+        while ((n = recv(_fd, buf, sizeof(buf), 0)) > 0) _decoder.feed(buf, (size_t)n);
+        if (n == 0) closeConnection();
+    }
+
+    uint16_t port() const { return _port; }
+    const TelemetryDeduplicator& dedup() const { return _dedup; }
+    const TelemetryDecoderStats& decoded() const { return _decoder.stats(); }
+    uint64_t uniqueSamples() const { return _uniqueSamples; }
+
+private:
+    static void onFrame(void* self, const TelemetryFrameHeader& header) {
+        DedupSink* s = static_cast<DedupSink*>(self);
+        if (s->_dedup.accept(header)) s->_uniqueSamples += header.recordCount;
+    }
+
+    // 连接之间的半帧不能拼接
+    void closeConnection() {
+        if (_fd >= 0) ::close(_fd);
+        _fd = -1;
+        _decoder.resetStream();
+    }
+
+    int _listenFd = -1;
+    int _fd = -1;
+    uint16_t _port = 0;
+    TelemetryDecoder _decoder;
+    TelemetryDeduplicator _dedup;
+    uint64_t _uniqueSamples = 0;
+};
+
+std::unique_ptr<BreathController> makeController(I2CMux& mux, uint16_t port, uint32_t backfillBps, bool compress) {
+    std::unique_ptr<BreathController> bc(new BreathController(&mux));
+    bc->setADS1115Channel(5);
+    bc->setWiFiCredentials("sim", "sim", "127.0.0.1", port);
+    bc->setSamplingRate(DEFAULT_SAMPLE_RATE_HZ);
+    bc->setTelemetryFormat(TELEMETRY_BINARY);
+    bc->setTelemetryCompression(compress);
+    bc->setStoreAndForward(true);
+    if (backfillBps) bc->setBackfillRate(backfillBps);
+    bc->begin();
+    bc->initializeOxygenSensor();
+    return bc;
+}
+}
+
+int main(int argc, char** argv) {
+    double outageS = 60;
+    double rebootS = -1;
+    uint32_t backfillBps = 0;
+    bool compress = false;
+    bool verbose = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--outage") && i + 1 < argc) outageS = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--backfill-bps") && i + 1 < argc) backfillBps = (uint32_t)atol(argv[++i]);
+        else if (!strcmp(argv[i], "--reboot") && i + 1 < argc) rebootS = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--compress")) compress = true;
+        else if (!strcmp(argv[i], "--verbose")) verbose = true;
+        else {
+            fprintf(stderr, "用法: %s [--outage S] [--backfill-bps N] [--reboot S] [--compress] [--verbose]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    char root[] = "/tmp/bench_store_forward_XXXXXX";
+    if (!mkdtemp(root)) {
+        fprintf(stderr, "无法创建临时目录\n");
+        return 1;
+    }
+    LittleFS.simSetRoot(root);
+
+    DedupSink sink;
+    if (!sink.open(0)) {
+        fprintf(stderr, "无法启动遥测接收端\n");
+        return 1;
+    }
+    uint16_t port = sink.port();
+
+    SimRig rig;
+    rig.install();
+    HardwareSerial::setConsoleEnabled(verbose);
+    simPreferencesClear();
+
+    I2CMux i2cMux(0x70);
+    configureSketchChannels(i2cMux);
+    std::unique_ptr<BreathController> bc = makeController(i2cMux, port, backfillBps, compress);
+
+    // 重启前的控制器统计（重启后从零开始）
+    TelemetryLinkStats before = {};
+    TelemetryLogStats logBefore = {};
+    bool rebooted = false;
+
+    uint64_t startUs = SimClock::nowUs();
+    double outageEndS = CONNECTED_S + outageS;
+    double drainedS = -1;
+    double maxWallUs = 0;
+    uint32_t updates = 0;
+    uint32_t maxBacklog = 0;
+    while (true) {
+        double t = (SimClock::nowUs() - startUs) / 1e6;
+        bool serverUp = t < CONNECTED_S || t >= outageEndS;
+        if (serverUp) {
+            sink.open(port);
+        } else {
+            sink.poll();
+            sink.close();
+        }
+
+        if (rebootS >= 0 && !rebooted && t >= rebootS) {
+            rebooted = true;
+            before = bc->getTelemetryLinkStats();
+            logBefore = bc->getTelemetryLogStats();
+            bc->getSamplingEngine()->end();
+            bc.reset();
+            bc = makeController(i2cMux, port, backfillBps, compress);
+        }
+
+        uint64_t t0 = SimClock::nowUs();
+        auto w0 = std::chrono::steady_clock::now();
+        bc->update();
+        double wallUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - w0).count();
+        if (wallUs > maxWallUs) maxWallUs = wallUs;
+        if (SimClock::nowUs() == t0) SimClock::advanceUs(5);
+        if (++updates % 64 == 0 && serverUp) sink.poll();
+
+        TelemetryLogStats ls = bc->getTelemetryLogStats();
+        if (ls.backlogBytes > maxBacklog) maxBacklog = ls.backlogBytes;
+        if (t >= outageEndS && drainedS < 0 && ls.backlogBytes == 0) drainedS = t - outageEndS;
+        if ((drainedS >= 0 && t >= outageEndS + drainedS + TAIL_S) || t >= outageEndS + MAX_BACKFILL_S) break;
+    }
+    sink.poll();
+    sink.close();
+    HardwareSerial::setConsoleEnabled(true);
+
+    TelemetryLinkStats link = bc->getTelemetryLinkStats();
+    TelemetryLogStats log = bc->getTelemetryLogStats();
+    uint64_t generated = (uint64_t)before.samples + before.stored + before.dropped + link.samples + link.stored +
+                         link.dropped;
+    DedupStats d = sink.dedup().stats();
+
+    printf("=== 断线存储转发 (虚拟时钟, 断线 %.0f s%s%s) ===\n", outageS, compress ? ", 压缩" : "",
+           rebooted ? ", 中途重启" : "");
+    printf("样本:               实时发送 %u, 存入闪存 %u, 丢弃 %u\n", before.samples + link.samples,
+           before.stored + link.stored, before.dropped + link.dropped);
+    printf("接收端:             唯一样本 %llu / 编码 %llu, 帧 %u（补发 %u）, 重复帧 %u, 缺失帧 %u（%u处）, 启动 %u\n",
+           (unsigned long long)sink.uniqueSamples(), (unsigned long long)generated, d.frames, d.backfillFrames,
+           d.duplicates, d.missingFrames, d.gaps, d.boots);
+    printf("解码:               CRC错误 %u, 实时流跳号 %u 帧\n", sink.decoded().crcErrors, sink.decoded().lostFrames);
+    if (drainedS >= 0) {
+        uint32_t bytes = before.backfillBytes + link.backfillBytes;
+        printf("补发:               %u 帧 / %u 字节, 用时 %.1f s（%.1f KB/s）, 最大积压 %u 字节\n",
+               before.backfillFrames + link.backfillFrames, bytes, drainedS, drainedS > 0 ? bytes / drainedS / 1024 : 0.0,
+               maxBacklog);
+    } else {
+        printf("补发:               %.0f s内未完成, 剩余 %u 字节\n", MAX_BACKFILL_S, log.backlogBytes);
+    }
+    uint32_t flashWrites = logBefore.flashWrites + log.flashWrites;
+    uint32_t flashBytes = logBefore.flashBytes + log.flashBytes;
+    printf("闪存:               写入 %u 次 / %u 字节（平均 %.0f 字节/次）, 覆盖段 %u, 损坏帧 %u\n", flashWrites,
+           flashBytes, flashWrites ? (double)flashBytes / flashWrites : 0.0,
+           logBefore.overwrittenSegments + log.overwrittenSegments, logBefore.corruptFrames + log.corruptFrames);
+    printf("update():           %u 次, 最长主机耗时 %.2f ms\n", updates, maxWallUs / 1000.0);
+
+    LittleFS.format();
+    rmdir(root);
+    return 0;
+}
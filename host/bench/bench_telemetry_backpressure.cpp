@@ -0,0 +1,240 @@
+// 自适应遥测背压主机基准
+//
+// 按sketch配置在虚拟时钟下运行定时采样的update()，主气压为呼吸波形，二进制TCP遥测发往
+// 本机接收端。lwIP替身的发送缓冲区按时间表限速（WiFi.simSetLinkRate）：
+//   0–20 s 不限速；20–50 s 3 KB/s（低于全速原始流）；50–80 s 0.3 KB/s（只够呼吸摘要）；
+//   80–140 s 恢复不限速。
+// 接收端解码样本、窗口、呼吸和模式切换记录，按带内切换记录（设备时间戳）给出模式时间线，
+// 逐阶段报告收到的样本/窗口/呼吸数、字节率和update()最长主机耗时，以及丢弃的样本和跳号。
+//
+// --fixed 关闭自适应（始终全速原始流）作对照。
+//
+// 用法: bench_telemetry_backpressure [--fixed] [--verbose]
+
+#include <chrono>
+#include <fcntl.h>
+#include <math.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+#include <WiFi.h>
+
+#include "BreathController.h"
+#include "SimClock.h"
+#include "SimRig.h"
+#include "SketchSetup.h"
+#include "TelemetryProtocol.h"
+
+namespace {
+constexpr double BASE_KPA = 101.3;
+constexpr double AMPLITUDE_KPA = 2.0;
+constexpr double PERIOD_S = 3.0;
+constexpr double INSPIRATION_FRACTION = 0.4;
+
+struct Phase {
+    const char* name;
+    double endS;
+    uint32_t linkRate;  // 字节/秒，0为不限
+};
+
+const Phase PHASES[] = {
+    {"不限速", 20, 0},
+    {"3 KB/s", 50, 3000},
+    {"0.3 KB/s", 80, 300},
+    {"恢复", 140, 0},
+};
+constexpr size_t PHASE_COUNT = sizeof(PHASES) / sizeof(PHASES[0]);
+
+float breathWaveform(double t) {
+    double phase = fmod(t, PERIOD_S);
+    double ti = PERIOD_S * INSPIRATION_FRACTION;
+    double breath = phase < ti ? 0.5 * (1 - cos(2 * M_PI * phase / ti)) : 0;
+    return (float)(BASE_KPA + AMPLITUDE_KPA * breath);
+}
+
+struct PhaseCounts {
+    uint64_t bytes;
+    uint32_t samples;
+    uint32_t windows;
+    uint32_t windowSamples;  // 窗口覆盖的样本
+    uint32_t breaths;
+};
+
+// 非阻塞本机TCP接收端：解码全部记录类型，按当前阶段计数
+class ShapedSink {
+public:
+    ShapedSink() {
+        _decoder.setCallback(onRecord, this);
+        _decoder.setSummaryCallbacks(onWindow, onBreath, onMode, this);
+    }
+
+    bool open() {
+        _listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        if (_listenFd < 0) return false;
+        int one = 1;
+        setsockopt(_listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        struct sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(addr);
+        if (bind(_listenFd, (struct sockaddr*)&addr, len) != 0 || listen(_listenFd, 1) != 0 ||
+            getsockname(_listenFd, (struct sockaddr*)&addr, &len) != 0) {
+            close();
+            return false;
+        }
+        fcntl(_listenFd, F_SETFL, O_NONBLOCK);
+        _port = ntohs(addr.sin_port);
+        return true;
+    }
+
+    void close() {
+        if (_fd >= 0) ::close(_fd);
+        if (_listenFd >= 0) ::close(_listenFd);
+        _fd = _listenFd = -1;
+    }
+
+    void poll(size_t phase) {
+        _phase = phase;
+        if (_fd < 0 && _listenFd >= 0) {
+            _fd = accept(_listenFd, nullptr, nullptr);
+            if (_fd >= 0) fcntl(_fd, F_SETFL, O_NONBLOCK);
+        }
+        if (_fd < 0) return;
+        uint8_t buf[4096];
+        ssize_t n;
+        while ((n = recv(_fd, buf, sizeof(buf), 0)) > 0) {
+            _counts[_phase].bytes += (size_t)n;
+            _decoder.feed(buf, (size_t)n);
+        }
+    }
+
+    uint16_t port() const { return _port; }
+    const PhaseCounts& counts(size_t phase) const { return _counts[phase]; }
+    const std::vector<TelemetryModeChange>& modes() const { return _modes; }
+    const TelemetryDecoderStats& decoded() const { return _decoder.stats(); }
+
+private:
+    static void onRecord(void* self, const TelemetryFrameHeader&, const TelemetryRecord&) {
+        ShapedSink* s = static_cast<ShapedSink*>(self);
+        s->_counts[s->_phase].samples++;
+    }
+    static void onWindow(void* self, const TelemetryFrameHeader&, const TelemetryWindowRecord& w) {
+        ShapedSink* s = static_cast<ShapedSink*>(self);
+        s->_counts[s->_phase].windows++;
+        s->_counts[s->_phase].windowSamples += w.count;
+    }
+    static void onBreath(void* self, const TelemetryFrameHeader&, const TelemetryBreathRecord&) {
+        ShapedSink* s = static_cast<ShapedSink*>(self);
+        s->_counts[s->_phase].breaths++;
+    }
+    static void onMode(void* self, const TelemetryFrameHeader&, const TelemetryModeChange& change) {
+        ShapedSink* s = static_cast<ShapedSink*>(self);
+        s->_modes.push_back(change);
+    }
+
+    int _listenFd = -1;
+    int _fd = -1;
+    uint16_t _port = 0;
+    size_t _phase = 0;
+    TelemetryDecoder _decoder;
+    PhaseCounts _counts[PHASE_COUNT] = {};
+    std::vector<TelemetryModeChange> _modes;
+};
+}
+
+int main(int argc, char** argv) {
+    bool fixed = false;
+    bool verbose = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--fixed")) fixed = true;
+        else if (!strcmp(argv[i], "--verbose")) verbose = true;
+        else {
+            fprintf(stderr, "用法: %s [--fixed] [--verbose]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    ShapedSink sink;
+    if (!sink.open()) {
+        fprintf(stderr, "无法启动遥测接收端\n");
+        return 1;
+    }
+
+    SimRig rig;
+    rig.install();
+    rig.primaryPressure.setPressureWaveform(breathWaveform);
+    HardwareSerial::setConsoleEnabled(verbose);
+
+    I2CMux i2cMux(0x70);
+    configureSketchChannels(i2cMux);
+    BreathController bc(&i2cMux);
+    bc.setADS1115Channel(5);
+    bc.setWiFiCredentials("sim", "sim", "127.0.0.1", sink.port());
+    bc.setSamplingRate(DEFAULT_SAMPLE_RATE_HZ);
+    bc.setTelemetryFormat(TELEMETRY_BINARY);
+    if (fixed) bc.setTelemetryMode(TELEMETRY_MODE_FULL);
+    bc.begin();
+    bc.initializeOxygenSensor();
+
+    uint64_t startUs = SimClock::nowUs();
+    size_t phase = 0;
+    double maxWallUs[PHASE_COUNT] = {};
+    uint32_t updates = 0;
+    WiFi.simSetLinkRate(PHASES[0].linkRate);
+    while (true) {
+        double t = (SimClock::nowUs() - startUs) / 1e6;
+        if (t >= PHASES[phase].endS) {
+            sink.poll(phase);
+            if (++phase == PHASE_COUNT) break;
+            WiFi.simSetLinkRate(PHASES[phase].linkRate);
+        }
+
+        uint64_t t0 = SimClock::nowUs();
+        auto w0 = std::chrono::steady_clock::now();
+        bc.update();
+        double wallUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - w0).count();
+        if (wallUs > maxWallUs[phase]) maxWallUs[phase] = wallUs;
+        if (SimClock::nowUs() == t0) SimClock::advanceUs(5);
+        if (++updates % 64 == 0) sink.poll(phase);
+    }
+    bc.getSamplingEngine()->end();
+    sink.close();
+    HardwareSerial::setConsoleEnabled(true);
+
+    TelemetryLinkStats link = bc.getTelemetryLinkStats();
+    TelemetryShaperStats shaper = bc.getTelemetryShaperStats();
+    const TelemetryDecoderStats& d = sink.decoded();
+
+    printf("=== 自适应遥测背压 (虚拟时钟, %s) ===\n", fixed ? "固定全速" : "自适应");
+    printf("阶段        时长(s)  样本    窗口(覆盖样本)   呼吸  接收(B/s)  最长update(ms)\n");
+    double startS = 0;
+    for (size_t i = 0; i < PHASE_COUNT; i++) {
+        const PhaseCounts& c = sink.counts(i);
+        double span = PHASES[i].endS - startS;
+        printf("%-10s  %7.0f  %6u  %6u(%6u)    %4u  %9.0f  %14.2f\n", PHASES[i].name, span, c.samples, c.windows,
+               c.windowSamples, c.breaths, c.bytes / span, maxWallUs[i] / 1000.0);
+        startS = PHASES[i].endS;
+    }
+
+    printf("模式时间线（带内切换记录）:\n");
+    if (sink.modes().empty()) printf("  无切换\n");
+    for (const TelemetryModeChange& c : sink.modes()) {
+        printf("  %6.1f s  %s -> %s（%s）, seq %u, 吞吐 %u B/s, 积压 %u B, 拒绝 %u, 队列 %u%%\n",
+               (uint32_t)(c.timestampUs - (uint32_t)startUs) / 1e6, telemetryModeName(c.fromMode),
+               telemetryModeName(c.toMode), telemetryModeReasonName(c.reason), c.nextSeq, c.throughputBps,
+               c.backlogBytes, c.rejected, c.queuePercent);
+    }
+    printf("发送端:             帧 %u, 样本 %u, 窗口 %u, 呼吸 %u, 切换 %u, 丢弃样本 %u, 丢弃摘要 %u\n", link.frames,
+           link.samples, link.windows, link.breaths, link.modeChanges, link.dropped, link.droppedSummaries);
+    printf("模式控制:           降级 %u, 升级 %u, 试探失败 %u, 拥塞窗口 %u\n", shaper.downgrades, shaper.upgrades,
+           shaper.failedProbes, shaper.congestedIntervals);
+    printf("解码:               CRC错误 %u, 跳号 %u 帧 / %u 样本, 未知帧 %u\n", d.crcErrors, d.lostFrames,
+           d.lostSamples, d.unknownFrames);
+    printf("update():           %u 次\n", updates);
+    return 0;
+}
@@ -0,0 +1,327 @@
+// 遥测压缩主机基准
+//
+// 样本来源：默认按sketch配置在虚拟时钟下运行定时采样的update()，主气压为带噪声的呼吸波形，
+// 二进制TCP遥测发往本机接收端并原样录下（--save 保存录制文件）；--input 改为读取录制好的
+// 二进制遥测（telemetry_decode能读的任意版本帧流，如 nc -l PORT > capture.bin）。
+// 解码出的记录按不同批量重新编码为原始帧和压缩帧，报告每样本字节数（含帧头和CRC）、
+// 压缩率、编码/解码每样本耗时（主机），并逐位核对压缩帧解码结果与原始帧一致。
+// 仿真模式另以文本格式运行同样时长，给出文本遥测每行字节数作对照。
+//
+// 用法: bench_telemetry_compression [--input FILE | [--seconds S] [--noise KPA] [--save FILE]]
+//                                   [--rounds N] [--verbose]
+
+#include <chrono>
+#include <fcntl.h>
+#include <math.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+#include "BreathController.h"
+#include "SimClock.h"
+#include "SimRig.h"
+#include "SketchSetup.h"
+#include "TelemetryProtocol.h"
+
+namespace {
+constexpr double BASE_KPA = 101.3;
+constexpr double AMPLITUDE_KPA = 2.0;
+constexpr double PERIOD_S = 3.0;
+constexpr double INSPIRATION_FRACTION = 0.4;
+const uint8_t BATCHES[] = {5, 10, TELEMETRY_BATCH_SAMPLES, TELEMETRY_MAX_BATCH};
+
+double g_noise = 0.005;
+
+double gaussianNoise(double seconds) {
+    uint64_t x = (uint64_t)llround(seconds * 1e6) * 0x9E3779B97F4A7C15ULL;
+    x ^= x >> 31;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    double u1 = ((x >> 11) + 1.0) / 9007199254740993.0;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 29;
+    double u2 = (x >> 11) / 9007199254740992.0;
+    return sqrt(-2.0 * log(u1)) * cos(2 * M_PI * u2);
+}
+
+float breathWaveform(double t) {
+    double phase = fmod(t, PERIOD_S);
+    double ti = PERIOD_S * INSPIRATION_FRACTION;
+    double breath = phase < ti ? 0.5 * (1 - cos(2 * M_PI * phase / ti)) : 0;
+    return (float)(BASE_KPA + AMPLITUDE_KPA * breath + g_noise * gaussianNoise(t));
+}
+
+// 非阻塞本机TCP接收端：原样录下收到的字节
+class CaptureSink {
+public:
+    bool open() {
+        _listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        if (_listenFd < 0) return false;
+        int one = 1;
+        setsockopt(_listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        struct sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(addr);
+        if (bind(_listenFd, (struct sockaddr*)&addr, len) != 0 || listen(_listenFd, 1) != 0 ||
+            getsockname(_listenFd, (struct sockaddr*)&addr, &len) != 0) {
+            close();
+            return false;
+        }
+        fcntl(_listenFd, F_SETFL, O_NONBLOCK);
+        _port = ntohs(addr.sin_port);
+        return true;
+    }
+
+    void close() {
+        if (_fd >= 0) ::close(_fd);
+        if (_listenFd >= 0) ::close(_listenFd);
+        _fd = _listenFd = -1;
+    }
+
+    void poll() {
+        if (_fd < 0 && _listenFd >= 0) {
+            _fd = accept(_listenFd, nullptr, nullptr);
+            if (_fd >= 0) fcntl(_fd, F_SETFL, O_NONBLOCK);
+        }
+        if (_fd < 0) return;
+        uint8_t buf[4096];
+        ssize_t n;
+        while ((n = recv(_fd, buf, sizeof(buf), 0)) > 0) _data.insert(_data.end(), buf, buf + n);
+    }
+
+    uint16_t port() const { return _port; }
+    const std::vector<uint8_t>& data() const { return _data; }
+
+private:
+    int _listenFd = -1;
+    int _fd = -1;
+    uint16_t _port = 0;
+    std::vector<uint8_t> _data;
+};
+
+// 按sketch配置运行seconds秒，返回接收端录下的字节流
+bool simulate(double seconds, TelemetryFormat format, bool verbose, std::vector<uint8_t>& out) {
+    CaptureSink sink;
+    if (!sink.open()) return false;
+
+    SimRig rig;
+    rig.install();
+    rig.primaryPressure.setPressureWaveform(breathWaveform);
+    HardwareSerial::setConsoleEnabled(verbose);
+
+    I2CMux i2cMux(0x70);
+    configureSketchChannels(i2cMux);
+    BreathController bc(&i2cMux);
+    bc.setADS1115Channel(5);
+    bc.setWiFiCredentials("sim", "sim", "127.0.0.1", sink.port());
+    bc.setSamplingRate(DEFAULT_SAMPLE_RATE_HZ);
+    bc.setTelemetryFormat(format);
+    bc.begin();
+    bc.initializeOxygenSensor();
+
+    uint64_t endUs = SimClock::nowUs() + (uint64_t)(seconds * 1e6);
+    uint32_t updates = 0;
+    while (SimClock::nowUs() < endUs) {
+        uint64_t t0 = SimClock::nowUs();
+        bc.update();
+        if (SimClock::nowUs() == t0) SimClock::advanceUs(5);
+        if (++updates % 64 == 0) sink.poll();
+    }
+    bc.getSamplingEngine()->end();
+    sink.poll();
+    sink.close();
+    HardwareSerial::setConsoleEnabled(true);
+    out = sink.data();
+    return true;
+}
+
+struct Capture {
+    std::vector<TelemetryRecord> records;
+    TelemetryFrameHeader first;
+    bool hasHeader = false;
+};
+
+void onRecord(void* context, const TelemetryFrameHeader& header, const TelemetryRecord& record) {
+    Capture* c = static_cast<Capture*>(context);
+    if (!c->hasHeader) {
+        c->first = header;
+        c->hasHeader = true;
+    }
+    c->records.push_back(record);
+}
+
+struct Encoded {
+    std::vector<uint8_t> stream;
+    uint32_t frames = 0;
+    uint32_t compressedFrames = 0;
+};
+
+// 按批量编码全部记录；发送时刻用批内最后一条的时间戳，保证两种编码的帧头相同
+void encodeAll(const Capture& c, uint8_t batch, bool compress, Encoded* out) {
+    TelemetryEncoder enc(batch);
+    enc.setCompression(compress);
+    enc.setSampleRate(c.first.sampleRateHz);
+    enc.setBase(c.first.basePressureKpa, c.first.baseTemperatureC);
+    for (size_t i = 0; i < c.records.size(); i++) {
+        bool full = enc.add(c.records[i]);
+        if (!full && i + 1 < c.records.size()) continue;
+        size_t len = enc.finish(c.records[i].timestampUs);
+        if (out) {
+            out->stream.insert(out->stream.end(), enc.data(), enc.data() + len);
+            out->frames++;
+            if (enc.data()[30] & TELEMETRY_FRAME_COMPRESSED) out->compressedFrames++;
+        }
+    }
+}
+
+bool sameBits(float a, float b) {
+    return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+bool sameRecord(const TelemetryRecord& a, const TelemetryRecord& b) {
+    return a.seq == b.seq && a.timestampUs == b.timestampUs && a.state == b.state && a.flags == b.flags &&
+           sameBits(a.pressureKpa, b.pressureKpa) && sameBits(a.backupPressureKpa, b.backupPressureKpa) &&
+           sameBits(a.flowRate, b.flowRate) && sameBits(a.temperatureC, b.temperatureC) &&
+           sameBits(a.co2Ppm, b.co2Ppm) && sameBits(a.oxygenPercent, b.oxygenPercent) &&
+           sameBits(a.valveFraction, b.valveFraction);
+}
+
+void decodeAll(const std::vector<uint8_t>& stream, Capture* out, TelemetryDecoderStats* stats) {
+    TelemetryDecoder dec;
+    if (out) dec.setCallback(onRecord, out);
+    dec.feed(stream.data(), stream.size());
+    if (stats) *stats = dec.stats();
+}
+
+double nsPerSample(std::chrono::steady_clock::time_point start, size_t samples) {
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return samples ? ns / samples : 0;
+}
+}
+
+int main(int argc, char** argv) {
+    const char* input = nullptr;
+    const char* save = nullptr;
+    double seconds = 60;
+    int rounds = 20;
+    bool verbose = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--input") && i + 1 < argc) input = argv[++i];
+        else if (!strcmp(argv[i], "--save") && i + 1 < argc) save = argv[++i];
+        else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--noise") && i + 1 < argc) g_noise = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--rounds") && i + 1 < argc) rounds = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--verbose")) verbose = true;
+        else {
+            fprintf(stderr, "用法: %s [--input FILE | [--seconds S] [--noise KPA] [--save FILE]] [--rounds N] [--verbose]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (rounds < 1) rounds = 1;
+
+    std::vector<uint8_t> recorded;
+    std::vector<uint8_t> text;
+    if (input) {
+        FILE* f = fopen(input, "rb");
+        if (!f) {
+            fprintf(stderr, "无法打开 %s\n", input);
+            return 1;
+        }
+        uint8_t buf[4096];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), f)) > 0) recorded.insert(recorded.end(), buf, buf + n);
+        fclose(f);
+    } else {
+        if (!simulate(seconds, TELEMETRY_BINARY, verbose, recorded) || !simulate(seconds, TELEMETRY_TEXT, verbose, text)) {
+            fprintf(stderr, "无法启动遥测接收端\n");
+            return 1;
+        }
+        if (save) {
+            FILE* f = fopen(save, "wb");
+            if (!f || fwrite(recorded.data(), 1, recorded.size(), f) != recorded.size()) {
+                fprintf(stderr, "无法写入 %s\n", save);
+                if (f) fclose(f);
+                return 1;
+            }
+            fclose(f);
+        }
+    }
+
+    Capture capture;
+    TelemetryDecoderStats recordedStats;
+    decodeAll(recorded, &capture, &recordedStats);
+    size_t n = capture.records.size();
+    if (n == 0) {
+        fprintf(stderr, "录制数据中没有可解码的记录\n");
+        return 1;
+    }
+    double spanS = (uint32_t)(capture.records.back().timestampUs - capture.records.front().timestampUs) / 1e6;
+    double rateHz = spanS > 0 ? (n - 1) / spanS : 0;
+
+    printf("=== 遥测压缩 (%s) ===\n", input ? input : "仿真录制");
+    printf("样本:               %zu 条, %.1f s, %.0f Hz（录制 %zu 字节 / %u 帧, CRC错误 %u）\n", n, spanS, rateHz,
+           recorded.size(), recordedStats.frames, recordedStats.crcErrors);
+    if (!text.empty()) {
+        size_t lines = 0;
+        for (uint8_t c : text) lines += c == '\n';
+        printf("文本遥测:           %zu 行, %.1f 字节/行（每行只含部分字段）\n", lines,
+               lines ? (double)text.size() / lines : 0.0);
+    }
+    printf("\n%-6s %10s %10s %8s %10s %10s %10s %10s\n", "批量", "原始B/样本", "压缩B/样本", "压缩率", "压缩帧",
+           "编码ns(原)", "编码ns(压)", "解码ns(压)");
+
+    bool lossless = true;
+    for (uint8_t batch : BATCHES) {
+        Encoded raw, packed;
+        encodeAll(capture, batch, false, &raw);
+        encodeAll(capture, batch, true, &packed);
+
+        // 逐位核对：两种编码解码出的记录必须完全相同
+        Capture rawDecoded, packedDecoded;
+        TelemetryDecoderStats packedStats;
+        decodeAll(raw.stream, &rawDecoded, nullptr);
+        decodeAll(packed.stream, &packedDecoded, &packedStats);
+        size_t mismatches = 0;
+        if (rawDecoded.records.size() != n || packedDecoded.records.size() != n) {
+            mismatches = n;
+        } else {
+            for (size_t i = 0; i < n; i++) mismatches += !sameRecord(rawDecoded.records[i], packedDecoded.records[i]);
+        }
+        if (mismatches || packedStats.badPayloads || packedStats.crcErrors) {
+            lossless = false;
+            printf("批量 %u: %zu 条记录不一致, 负载无法还原 %u 帧\n", batch, mismatches, packedStats.badPayloads);
+        }
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) encodeAll(capture, batch, false, nullptr);
+        double encRaw = nsPerSample(t0, n * rounds);
+        t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) encodeAll(capture, batch, true, nullptr);
+        double encPacked = nsPerSample(t0, n * rounds);
+        t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) decodeAll(packed.stream, nullptr, nullptr);
+        double decPacked = nsPerSample(t0, n * rounds);
+
+        double rawPer = (double)raw.stream.size() / n;
+        double packedPer = (double)packed.stream.size() / n;
+        printf("%-6u %10.1f %10.1f %7.2fx %5u/%-4u %10.0f %10.0f %10.0f\n", batch, rawPer, packedPer,
+               rawPer / packedPer, packed.compressedFrames, packed.frames, encRaw, encPacked, decPacked);
+    }
+
+    // 默认批量下的链路字节率
+    Encoded raw, packed;
+    encodeAll(capture, TELEMETRY_BATCH_SAMPLES, false, &raw);
+    encodeAll(capture, TELEMETRY_BATCH_SAMPLES, true, &packed);
+    if (spanS > 0) {
+        printf("\n链路字节率(批量%u): 原始 %.1f KB/s, 压缩 %.1f KB/s\n", TELEMETRY_BATCH_SAMPLES,
+               raw.stream.size() / spanS / 1024, packed.stream.size() / spanS / 1024);
+    }
+    printf("无损校验:           %s\n", lossless ? "通过" : "失败");
+    return lossless ? 0 : 1;
+}
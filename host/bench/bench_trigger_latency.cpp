@@ -0,0 +1,165 @@
+// 呼吸触发延迟主机基准
+//
+// 主气压传感器输出起点已知的合成呼吸波形（可叠加高斯噪声），按sketch配置在虚拟时钟下
+// 运行定时采样的update()循环。每次状态切到INHALE时记录虚拟时刻，与该周期的
+// 真实吸气起点比较，得到触发延迟（含转换、采集和处理时间）；同时输出检测器自身
+// 估计的延迟（触发样本时刻减去斜率最后一次不为正的样本时刻），以及漏触发/误触发数。
+// --smoothed 让触发改用平滑后的压力，作为原单路径的对照。
+//
+// 波形: halfsine  吸气段压力半正弦升降（起点斜率最大，即默认仿真波形）
+//       cosine    升余弦缓升后缓降（起点斜率为0，更接近自主呼吸）
+//
+// 用法: bench_trigger_latency [--rate HZ] [--seconds S] [--period S] [--amplitude KPA]
+//                             [--shape halfsine|cosine] [--noise KPA] [--smoothed] [--verbose]
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "BreathController.h"
+#include "SimClock.h"
+#include "SimRig.h"
+#include "SketchSetup.h"
+
+namespace {
+constexpr double BASE_KPA = 101.3;
+constexpr double ONSET_OFFSET_S = 0.5;     // 第一个周期内吸气起点的位置
+constexpr double INSPIRATION_FRACTION = 0.4;
+
+double g_period = 3.0;
+double g_amplitude = 2.0;
+bool g_cosine = false;
+double g_noise = 0.0;
+
+// 按采样时刻（微秒）生成确定性的高斯噪声
+double gaussianNoise(double seconds) {
+    uint64_t x = (uint64_t)llround(seconds * 1e6) * 0x9E3779B97F4A7C15ULL;
+    x ^= x >> 31;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    double u1 = ((x >> 11) + 1.0) / 9007199254740993.0;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 29;
+    double u2 = (x >> 11) / 9007199254740992.0;
+    return sqrt(-2.0 * log(u1)) * cos(2 * M_PI * u2);
+}
+
+float breathWaveform(double t) {
+    double shifted = t - ONSET_OFFSET_S;
+    double phase = shifted < 0 ? 1.0 : fmod(shifted, g_period) / g_period;
+    double breath = 0;
+    if (phase < INSPIRATION_FRACTION) {
+        double x = phase / INSPIRATION_FRACTION;
+        breath = g_cosine ? 0.5 * (1 - cos(2 * M_PI * x)) : sin(x * M_PI);
+    }
+    return (float)(BASE_KPA + g_amplitude * breath + g_noise * gaussianNoise(t));
+}
+
+double percentile(std::vector<double> v, double p) {
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    return v[(size_t)((v.size() - 1) * p + 0.5)];
+}
+}
+
+int main(int argc, char** argv) {
+    uint32_t rateHz = DEFAULT_SAMPLE_RATE_HZ;
+    double seconds = 60.0;
+    bool smoothed = false;
+    bool verbose = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--rate") && i + 1 < argc) rateHz = (uint32_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--period") && i + 1 < argc) g_period = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--amplitude") && i + 1 < argc) g_amplitude = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--shape") && i + 1 < argc) g_cosine = !strcmp(argv[++i], "cosine");
+        else if (!strcmp(argv[i], "--noise") && i + 1 < argc) g_noise = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--smoothed")) smoothed = true;
+        else if (!strcmp(argv[i], "--verbose")) verbose = true;
+        else {
+            fprintf(stderr, "用法: %s [--rate HZ] [--seconds S] [--period S] [--amplitude KPA]"
+                            " [--shape halfsine|cosine] [--noise KPA] [--smoothed] [--verbose]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (rateHz == 0 || g_period <= 0) {
+        fprintf(stderr, "需要定时采样（--rate > 0）且周期为正\n");
+        return 2;
+    }
+
+    SimRig rig;
+    rig.install();
+    rig.primaryPressure.setPressureWaveform(breathWaveform);
+    HardwareSerial::setConsoleEnabled(verbose);
+
+    I2CMux i2cMux(0x70);
+    BreathController breathController(&i2cMux);
+    breathController.setADS1115Channel(5);
+    configureSketchChannels(i2cMux);
+    breathController.setSamplingRate(rateHz);
+    breathController.setFastTriggerPath(!smoothed);
+    breathController.begin();
+    breathController.initializeOxygenSensor();
+
+    const OnsetDetector& detector = breathController.getOnsetDetector();
+    uint64_t startUs = SimClock::nowUs();
+    uint64_t endUs = startUs + (uint64_t)(seconds * 1e6);
+    uint32_t lastTriggers = detector.getStats().triggers;
+    unsigned long lastTriggerUs = detector.lastTriggerUs();
+    std::vector<double> latencies;
+    std::vector<double> estimates;
+    int64_t lastCycle = -1;
+    uint32_t falseTriggers = 0;
+
+    while (SimClock::nowUs() < endUs) {
+        uint64_t t0 = SimClock::nowUs();
+        breathController.update();
+        if (SimClock::nowUs() == t0) SimClock::advanceUs(5);
+
+        if (detector.lastTriggerUs() == lastTriggerUs) continue;
+        lastTriggerUs = detector.lastTriggerUs();
+        double nowS = SimClock::nowUs() / 1e6;
+        TriggerStats ts = detector.getStats();
+        bool hasEstimate = ts.triggers != lastTriggers;
+        lastTriggers = ts.triggers;
+
+        // 触发归属的周期：真实起点不晚于触发时刻的最近一个
+        double shifted = nowS - ONSET_OFFSET_S;
+        int64_t cycle = shifted < 0 ? -1 : (int64_t)floor(shifted / g_period);
+        double sinceOnsetMs = (shifted - cycle * g_period) * 1000.0;
+        if (SimClock::nowUs() < startUs + 1000000 || cycle < 0 || cycle == lastCycle ||
+            sinceOnsetMs > g_period * INSPIRATION_FRACTION * 500.0) {
+            if (SimClock::nowUs() >= startUs + 1000000) falseTriggers++;
+            continue;
+        }
+        lastCycle = cycle;
+        latencies.push_back(sinceOnsetMs);
+        if (hasEstimate) estimates.push_back(ts.lastDelayMs);
+    }
+    HardwareSerial::setConsoleEnabled(true);
+
+    double firstOnset = ceil(((startUs + 1000000) / 1e6 - ONSET_OFFSET_S) / g_period);
+    double lastOnset = floor((endUs / 1e6 - ONSET_OFFSET_S) / g_period);
+    int64_t expected = (int64_t)(lastOnset - firstOnset + 1);
+    double sum = 0;
+    for (double v : latencies) sum += v;
+    double estSum = 0;
+    for (double v : estimates) estSum += v;
+
+    printf("=== 呼吸触发延迟 (%s路径, %u Hz, %s波形, 周期 %.1f s, 幅度 %.2f kPa, 噪声 %.3f kPa) ===\n",
+           smoothed ? "平滑" : "快速", rateHz, g_cosine ? "升余弦" : "半正弦", g_period, g_amplitude, g_noise);
+    printf("触发:               %u / %lld 个周期, 误触发 %u\n", (unsigned)latencies.size(), (long long)expected,
+           falseTriggers);
+    if (!latencies.empty()) {
+        printf("相对真实起点:       平均 %.1f ms, 中位 %.1f ms, P95 %.1f ms, 最大 %.1f ms\n", sum / latencies.size(),
+               percentile(latencies, 0.5), percentile(latencies, 0.95), percentile(latencies, 1.0));
+    }
+    if (!estimates.empty()) {
+        printf("检测器自估延迟:     平均 %.1f ms, 最大 %.1f ms\n", estSum / estimates.size(),
+               percentile(estimates, 1.0));
+    }
+    printf("斜率阈值:           %.2f kPa/s\n", detector.getSlopeThreshold());
+    return 0;
+}
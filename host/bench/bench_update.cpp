@@ -0,0 +1,147 @@
+// BreathController::update() 主机吞吐量基准
+//
+// 在仿真总线上运行与sketch_oct9a.ino相同的初始化流程，然后反复执行update()，
+// 报告每次循环的虚拟耗时（总线+等待）、总线事务数、多路复用器切换数和主机CPU耗时。
+// 定时采样模式（默认200Hz，与sketch一致）按虚拟时长运行并输出采样抖动/超限统计；
+// --rate 0 为原有delay(100)循环，按--updates次数运行。
+//
+// 用法: bench_update [--rate HZ] [--seconds S] [--updates N] [--latency-us US] [--single-channel]
+//                    [--no-pipeline] [--pressure-rounds N] [--verbose]
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "BreathController.h"
+#include "SimClock.h"
+#include "SimRig.h"
+#include "SketchSetup.h"
+
+int main(int argc, char** argv) {
+    int updates = 200;
+    uint32_t latencyUs = 0;
+    bool verbose = false;
+    bool singleChannel = false;
+    bool pipeline = true;
+    int pressureRounds = 0;
+    uint32_t rateHz = DEFAULT_SAMPLE_RATE_HZ;
+    double seconds = 10.0;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--updates") && i + 1 < argc) updates = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--latency-us") && i + 1 < argc) latencyUs = (uint32_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--single-channel")) singleChannel = true;
+        else if (!strcmp(argv[i], "--no-pipeline")) pipeline = false;
+        else if (!strcmp(argv[i], "--rate") && i + 1 < argc) rateHz = (uint32_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--pressure-rounds") && i + 1 < argc) pressureRounds = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--verbose")) verbose = true;
+        else {
+            fprintf(stderr, "用法: %s [--rate HZ] [--seconds S] [--updates N] [--latency-us US] [--single-channel]"
+                            " [--no-pipeline] [--pressure-rounds N] [--verbose]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    SimRig rig;
+    rig.setLatencyUs(latencyUs);
+    rig.install();
+    HardwareSerial::setConsoleEnabled(verbose);
+
+    I2CMux i2cMux(0x70);
+    BreathController breathController(&i2cMux);
+    breathController.setADS1115Channel(5);
+    configureSketchChannels(i2cMux);
+    if (singleChannel) i2cMux.setGroupSelect(false);
+    breathController.setPipelinedAcquisition(pipeline);
+    breathController.setSamplingRate(rateHz);
+    breathController.begin();
+    breathController.initializeOxygenSensor();
+
+    uint64_t setupUs = SimClock::nowUs();
+    rig.resetStats();
+    SamplingEngine* sampler = breathController.getSamplingEngine();
+    sampler->resetStats();
+    bool timed = sampler->isRunning();
+    uint64_t durationUs = (uint64_t)(seconds * 1e6);
+
+    uint64_t minUs = UINT64_MAX, maxUs = 0;
+    auto wallStart = std::chrono::steady_clock::now();
+    uint64_t start = SimClock::nowUs();
+    int loops = 0;
+    while (timed ? SimClock::nowUs() - start < durationUs : loops < updates) {
+        uint64_t t0 = SimClock::nowUs();
+        breathController.update();
+        uint64_t dt = SimClock::nowUs() - t0;
+        // 定时模式下空转的loop()不访问总线，按5us的循环开销推进时钟
+        if (dt == 0) {
+            SimClock::advanceUs(5);
+            dt = 5;
+        }
+        if (dt < minUs) minUs = dt;
+        if (dt > maxUs) maxUs = dt;
+        loops++;
+    }
+    updates = loops;
+    auto wallNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - wallStart).count();
+    uint64_t totalUs = SimClock::nowUs() - start;
+    HardwareSerial::setConsoleEnabled(true);
+
+    double avgMs = updates ? totalUs / 1000.0 / updates : 0;
+    printf("=== BreathController::update() 仿真基准 ===\n");
+    printf("初始化虚拟耗时:     %.1f ms\n", setupUs / 1000.0);
+    printf("update()次数:       %d\n", updates);
+    printf("每次虚拟耗时:       平均 %.2f ms, 最小 %.2f ms, 最大 %.2f ms\n", avgMs, minUs / 1000.0, maxUs / 1000.0);
+    printf("循环频率:           %.2f Hz\n", avgMs > 0 ? 1000.0 / avgMs : 0.0);
+    printf("I2C事务:            %u (%.1f/次), NACK %u\n", Wire.bus().transactions(),
+           updates ? (double)Wire.bus().transactions() / updates : 0.0, Wire.bus().nacks());
+    printf("I2C总线占用:        %.1f ms (%.1f%%)\n", Wire.bus().busTimeUs() / 1000.0,
+           totalUs ? 100.0 * Wire.bus().busTimeUs() / totalUs : 0.0);
+    printf("多路复用器切换:     %u (控制写入 %u), 地址组 %u\n", rig.mux.switchCount(), rig.mux.controlWrites(),
+           i2cMux.getGroupCount());
+    printf("主气压传感器采集:   %u, 备用 %u\n", rig.primaryPressure.conversions(), rig.backupPressure.conversions());
+    printf("主气压传感器采样率: %.2f Hz\n", totalUs ? rig.primaryPressure.conversions() * 1e6 / totalUs : 0.0);
+    if (rig.primaryPressure.conversions()) {
+        const SimPressureSensor& p = rig.primaryPressure;
+        double n = p.conversions();
+        uint32_t txns = p.writeTransactions() + p.readTransactions();
+        // 每个事务另有1字节地址
+        printf("主气压每次采样:     %.1f 事务, %.1f 字节\n", txns / n,
+               (p.bytesWritten() + p.bytesRead() + txns) / n);
+    }
+    printf("ADS1115转换:        %u, ACD1100读数: %u, OLED整帧: %u\n", rig.ads1115.conversions(),
+           rig.acd1100.measurementsServed(), rig.oled.framesCompleted());
+    printf("主机CPU耗时:        %.1f us/次\n", updates ? wallNs / 1000.0 / updates : 0.0);
+    if (timed) {
+        SamplingStats st = sampler->getStats();
+        printf("--- 定时采样 (%u Hz) ---\n", sampler->getRateHz());
+        printf("实际采样率:         %.2f Hz (节拍 %u, 样本 %u, 失败 %u)\n", st.actualRateHz, st.ticks, st.samples,
+               st.failures);
+        printf("超限周期:           %u (%.2f%%)\n", st.overruns, st.ticks ? 100.0 * st.overruns / st.ticks : 0.0);
+        printf("周期抖动:           平均 %.1f us, 最大 %u us; 中断到采集最大延迟 %u us\n", st.meanJitterUs,
+               st.maxJitterUs, st.maxLatencyUs);
+        printf("消费者丢弃:         控制 %u, 遥测 %u\n", st.dropped[CONSUMER_CONTROL], st.dropped[CONSUMER_TELEMETRY]);
+    }
+
+    // 只跑气压通道（无update()末尾的固定延时），衡量冗余气压传感器对的总吞吐
+    if (pressureRounds > 0) {
+        HardwareSerial::setConsoleEnabled(verbose);
+        uint32_t conv0 = rig.primaryPressure.conversions() + rig.backupPressure.conversions();
+        uint64_t t0 = SimClock::nowUs();
+        for (int i = 0; i < pressureRounds; i++) breathController.acquirePressureRound();
+        uint64_t dt = SimClock::nowUs() - t0;
+        uint32_t conv = rig.primaryPressure.conversions() + rig.backupPressure.conversions() - conv0;
+        HardwareSerial::setConsoleEnabled(true);
+        printf("气压对采集(%s):  %d轮 %.2f ms/轮, 合计 %.1f 样本/s\n", pipeline ? "流水线" : "阻塞",
+               pressureRounds, dt / 1000.0 / pressureRounds, dt ? conv * 1e6 / dt : 0.0);
+    }
+
+    I2CScheduler* sched = breathController.getScheduler();
+    printf("--- 总线调度 (%u轮, 选通%u次) ---\n", sched->getRunCount(), sched->getSelectCount());
+    for (uint8_t i = 0; i < sched->getDeviceCount(); i++) {
+        SchedDeviceStats st = sched->getDeviceStats(i);
+        printf("通道%u %-12s %8.2f Hz  成功 %u  失败 %u\n", st.channel, st.name, st.sampleRate,
+               st.completed, st.failed);
+    }
+    return 0;
+}
@@ -0,0 +1,99 @@
+// 气阀执行器主机基准
+//
+// 按sketch配置在虚拟时钟下运行update()循环（默认200Hz定时采样），PID输出经ValveDriver
+// 下发到LEDC替身。LEDC替身记录每条命令，据此统计：每秒下发的命令数（CPU介入次数）、
+// 硬件渐变/直接写入次数、输出占空比的最大跳变（渐变从当前输出连续过渡，跳变应为0），
+// 以及与原8位analogWrite阶跃相比的分辨率。
+//
+// 用法: bench_valve_driver [--rate HZ] [--seconds S] [--freq HZ] [--bits N] [--verbose]
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "BreathController.h"
+#include "SimClock.h"
+#include "SimRig.h"
+#include "SketchSetup.h"
+
+int main(int argc, char** argv) {
+    uint32_t rateHz = DEFAULT_SAMPLE_RATE_HZ;
+    double seconds = 30.0;
+    uint32_t freqHz = VALVE_PWM_FREQ_HZ;
+    uint8_t bits = VALVE_PWM_BITS;
+    bool verbose = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--rate") && i + 1 < argc) rateHz = (uint32_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--freq") && i + 1 < argc) freqHz = (uint32_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--bits") && i + 1 < argc) bits = (uint8_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--verbose")) verbose = true;
+        else {
+            fprintf(stderr, "用法: %s [--rate HZ] [--seconds S] [--freq HZ] [--bits N] [--verbose]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    SimRig rig;
+    rig.install();
+    HardwareSerial::setConsoleEnabled(verbose);
+
+    I2CMux i2cMux(0x70);
+    BreathController breathController(&i2cMux);
+    breathController.setADS1115Channel(5);
+    configureSketchChannels(i2cMux);
+    breathController.setSamplingRate(rateHz);
+    breathController.setValvePwm(freqHz, bits);
+    breathController.begin();
+    breathController.initializeOxygenSensor();
+
+    const ValveDriver& valve = breathController.getValveDriver();
+    if (!valve.isReady()) {
+        HardwareSerial::setConsoleEnabled(true);
+        fprintf(stderr, "气阀PWM配置无效: %u Hz @ %u位（需12–16位且 频率 × 2^位数 <= 80MHz）\n", freqHz, bits);
+        return 1;
+    }
+
+    simLedcClearCommands();
+    uint64_t startUs = SimClock::nowUs();
+    uint64_t endUs = startUs + (uint64_t)(seconds * 1e6);
+    while (SimClock::nowUs() < endUs) {
+        uint64_t t0 = SimClock::nowUs();
+        breathController.update();
+        if (SimClock::nowUs() == t0) SimClock::advanceUs(5);
+    }
+    HardwareSerial::setConsoleEnabled(true);
+
+    // 命令序列：跳变 = 命令开始时的目标与当时实际输出之差（渐变从当前输出开始，为0）
+    size_t count = simLedcCommandCount();
+    uint32_t fades = 0, writes = 0;
+    uint32_t maxJump = 0;
+    double maxSlewPerS = 0;
+    for (size_t i = 0; i < count; i++) {
+        const SimLedcCommand& c = simLedcCommand(i);
+        uint32_t delta = c.targetDuty > c.startDuty ? c.targetDuty - c.startDuty : c.startDuty - c.targetDuty;
+        if (c.type == SIM_LEDC_FADE) {
+            fades++;
+            if (c.fadeMs) maxSlewPerS = fmax(maxSlewPerS, (double)delta / valve.getMaxDuty() * 1000.0 / c.fadeMs);
+        } else {
+            writes++;
+            if (delta > maxJump) maxJump = delta;
+        }
+    }
+    ValveDriverStats st = valve.getStats();
+    double elapsed = (SimClock::nowUs() - startUs) / 1e6;
+    int channel = simLedcPinChannel(VALVE_PIN);
+
+    printf("=== 气阀执行器 (%u Hz采样, %.0f s, LEDC通道%d %u Hz @ %u位) ===\n", rateHz, elapsed, channel,
+           simLedcFrequency(channel < 0 ? 0 : channel), simLedcResolution(channel < 0 ? 0 : channel));
+    printf("开度更新:           %u 次 (%.0f 次/s), 占空比未变 %u, 渐变未完成跳过 %u, 变化率截断 %u\n", st.commands,
+           st.commands / elapsed, st.unchanged, st.busy, st.slewLimited);
+    printf("外设命令:           %u 条 (%.0f 条/s): 硬件渐变 %u, 直接写入 %u\n", (unsigned)count, count / elapsed, fades,
+           writes);
+    printf("输出最大跳变:       %u 计数 (%.3f%%)，渐变最大速率 %.2f 满量程/s\n", maxJump,
+           100.0 * maxJump / valve.getMaxDuty(), maxSlewPerS);
+    printf("分辨率:             %u 级 (%.4f%%)，原analogWrite 256级 (0.3906%%)\n", valve.getMaxDuty() + 1,
+           100.0 / valve.getMaxDuty());
+    return 0;
+}
@@ -0,0 +1,171 @@
+// 气阀线性化主机基准
+//
+// 非线性比例阀模型：占空比d在死区以下无输出，之后稳态压力按 ((d - 死区)/(1 - 死区))^gamma
+// 上升到满开压力；气道压力为一阶响应（时间常数tau）。
+//   1. 用ValveLinearizer按固件的扫描流程（200Hz样本，带测量噪声）建表，报告扫描耗时、
+//      线性化后的残余非线性（期望开度与实际归一化响应之差的最大值），以及闪存保存/加载往返
+//   2. 同一PressurePid分别直接输出占空比和经特性表反查，比较逐周期跟踪误差和吸气建压时间
+//      （吸气开始到误差首次进入目标10%以内）
+//
+// 用法: bench_valve_linearization [--deadband D] [--gamma G] [--full-scale KPA] [--tau S]
+//                                 [--noise KPA] [--breaths N]
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Preferences.h>
+#include "BreathController.h"
+#include "PressurePid.h"
+#include "ValveLinearizer.h"
+
+namespace {
+constexpr uint32_t RATE_HZ = DEFAULT_SAMPLE_RATE_HZ;
+constexpr double PERIOD_S = 3.0;
+constexpr double TI_S = 1.0;
+
+struct Valve {
+    double deadband;
+    double gamma;
+    double fullScaleKpa;
+    double tau;
+
+    double steady(double duty) const {
+        if (duty <= deadband) return 0;
+        return fullScaleKpa * pow((duty - deadband) / (1 - deadband), gamma);
+    }
+};
+
+uint32_t g_seed = 1;
+double noise(double sigma) {
+    if (sigma <= 0) return 0;
+    g_seed = g_seed * 1664525u + 1013904223u;
+    double u1 = ((g_seed >> 8) + 1.0) / 16777217.0;
+    g_seed = g_seed * 1664525u + 1013904223u;
+    double u2 = (g_seed >> 8) / 16777216.0;
+    return sigma * sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+}
+
+BreathState phaseState(double t) {
+    double phase = fmod(t, PERIOD_S);
+    if (phase < TI_S / 2) return INHALE;
+    if (phase < TI_S) return PEAK;
+    return EXHALE;
+}
+
+struct Result {
+    double meanRms = 0;
+    double worstMax = 0;
+    double meanRiseMs = 0;
+    uint32_t cycles = 0;
+};
+
+Result track(const Valve& valve, const ValveLinearizer* linearizer, uint32_t breaths, double sigma) {
+    PressurePid pid;
+    Result r;
+    double dt = 1.0 / RATE_HZ;
+    double pressure = 0;
+    double riseSum = 0;
+    uint32_t rises = 0;
+    double onset = -1;
+    uint32_t total = (uint32_t)(breaths * PERIOD_S * RATE_HZ);
+    for (uint32_t i = 0; i < total; i++) {
+        double t = i * dt;
+        BreathState state = phaseState(t);
+        float measured = (float)(pressure + noise(sigma));
+        float opening = pid.update((unsigned long)llround(t * 1e6), state, measured, 1.0f, MAX_VALVE_OPEN) / MAX_VALVE_OPEN;
+        double duty = linearizer ? linearizer->dutyFor(opening) : opening;
+
+        if (pid.cycleCompleted() && pid.lastCycle().cycleIndex > 0) {
+            r.meanRms += pid.lastCycle().rmsErrorKpa;
+            r.worstMax = fmax(r.worstMax, pid.lastCycle().maxAbsErrorKpa);
+            r.cycles++;
+        }
+        double phase = fmod(t, PERIOD_S);
+        if (phase < dt) onset = t;
+        if (onset >= 0 && state != EXHALE && fabs(pid.target() - pressure) < 0.1 * pid.target()) {
+            if (t >= PERIOD_S) {
+                riseSum += (t - onset) * 1000;
+                rises++;
+            }
+            onset = -1;
+        }
+        pressure += (valve.steady(duty) - pressure) * dt / valve.tau;
+    }
+    if (r.cycles) r.meanRms /= r.cycles;
+    r.meanRiseMs = rises ? riseSum / rises : NAN;
+    return r;
+}
+}
+
+int main(int argc, char** argv) {
+    Valve valve = {0.15, 2.0, 2.55, 0.15};
+    double sigma = 0.005;
+    uint32_t breaths = 40;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--deadband") && i + 1 < argc) valve.deadband = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--gamma") && i + 1 < argc) valve.gamma = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--full-scale") && i + 1 < argc) valve.fullScaleKpa = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--tau") && i + 1 < argc) valve.tau = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--noise") && i + 1 < argc) sigma = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--breaths") && i + 1 < argc) breaths = (uint32_t)atoi(argv[++i]);
+        else {
+            fprintf(stderr, "用法: %s [--deadband D] [--gamma G] [--full-scale KPA] [--tau S] [--noise KPA]"
+                            " [--breaths N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (valve.deadband < 0 || valve.deadband >= 1 || valve.gamma <= 0 || valve.tau <= 0 || breaths < 2) {
+        fprintf(stderr, "参数无效：需要 0 <= deadband < 1, gamma > 0, tau > 0, breaths >= 2\n");
+        return 2;
+    }
+
+    // 1. 扫描建表
+    ValveLinearizer linearizer;
+    double pressure = 0;
+    double duty = 0;
+    double dt = 1.0 / RATE_HZ;
+    uint32_t samples = 0;
+    linearizer.startSweep(0);
+    while (linearizer.isSweeping()) {
+        unsigned long us = (unsigned long)llround(samples * dt * 1e6);
+        duty = linearizer.sweepUpdate(us, (float)(pressure + noise(sigma)), NAN);
+        pressure += (valve.steady(duty) - pressure) * dt / valve.tau;
+        samples++;
+    }
+    if (linearizer.sweepState() != VALVE_SWEEP_DONE) {
+        fprintf(stderr, "扫描失败：满开响应不足 %.2f kPa\n", VALVE_MIN_RESPONSE_KPA);
+        return 1;
+    }
+    double maxResidual = 0, maxRaw = 0;
+    for (int k = 0; k <= 1000; k++) {
+        double y = k / 1000.0;
+        maxResidual = fmax(maxResidual, fabs(valve.steady(linearizer.dutyFor(y)) / valve.fullScaleKpa - y));
+        maxRaw = fmax(maxRaw, fabs(valve.steady(y) / valve.fullScaleKpa - y));
+    }
+
+    simPreferencesClear();
+    linearizer.save();
+    ValveLinearizer reloaded;
+    bool roundTrip = reloaded.load();
+    for (int k = 0; k <= 100 && roundTrip; k++) {
+        roundTrip = reloaded.dutyFor(k / 100.0f) == linearizer.dutyFor(k / 100.0f);
+    }
+
+    // 2. 闭环跟踪
+    Result direct = track(valve, nullptr, breaths, sigma);
+    Result linear = track(valve, &linearizer, breaths, sigma);
+
+    printf("=== 气阀线性化 (死区 %.2f, gamma %.2f, 满开 %.2f kPa, tau %.2f s, 噪声 %.3f kPa) ===\n", valve.deadband,
+           valve.gamma, valve.fullScaleKpa, valve.tau, sigma);
+    printf("扫描:               %u 点, %.1f s, 满开响应 %.3f kPa\n", VALVE_TABLE_POINTS, samples * dt,
+           linearizer.table().fullScale);
+    printf("残余非线性:         %.1f%% (未线性化 %.1f%%)，闪存往返 %s\n", maxResidual * 100, maxRaw * 100,
+           roundTrip ? "一致" : "不一致");
+    printf("直接输出占空比:     误差RMS平均 %.3f kPa, 最大 %.3f kPa, 吸气建压 %.0f ms\n", direct.meanRms,
+           direct.worstMax, direct.meanRiseMs);
+    printf("经特性表反查:       误差RMS平均 %.3f kPa, 最大 %.3f kPa, 吸气建压 %.0f ms\n", linear.meanRms,
+           linear.worstMax, linear.meanRiseMs);
+    return 0;
+}
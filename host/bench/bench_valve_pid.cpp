@@ -0,0 +1,159 @@
+// 气阀压力闭环主机基准
+//
+// 用一阶“气阀 -> 气道压力”对象模型（稳态增益G kPa/计数，时间常数tau）闭环运行
+// PressurePid，呼吸阶段按固定的Ti/Te切换，比较两种控制方式的逐周期跟踪误差：
+//   原阶梯控制：每轮主循环（100ms）吸气+10·响应因子、呼气-20
+//   PID：每个采样节拍更新一次（默认200Hz）
+// 另报告呼气开始后气阀关到5计数以下所需时间（衡量积分饱和）和PID每次更新耗时（含计时调用本身）。
+// --plant-gain 调小可让吸气目标不可达，用于观察抗积分饱和。
+//
+// 用法: bench_valve_pid [--rate HZ] [--breaths N] [--plant-gain KPA_PER_COUNT] [--tau S]
+//                       [--noise KPA] [--assist LEVEL]
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "BreathController.h"
+#include "PressurePid.h"
+
+namespace {
+constexpr double PERIOD_S = 3.0;
+constexpr double TI_S = 1.0;
+constexpr double LEGACY_LOOP_S = 0.1;
+
+struct Result {
+    double meanRms = 0;
+    double worstMax = 0;
+    double meanSaturated = 0;
+    double meanReleaseMs = 0;
+    uint32_t cycles = 0;
+    double nsPerUpdate = 0;
+};
+
+BreathState phaseState(double t) {
+    double phase = fmod(t, PERIOD_S);
+    if (phase < TI_S / 2) return INHALE;
+    if (phase < TI_S) return PEAK;
+    return EXHALE;
+}
+
+uint32_t g_seed = 1;
+double noise(double sigma) {
+    if (sigma <= 0) return 0;
+    g_seed = g_seed * 1664525u + 1013904223u;
+    double u1 = ((g_seed >> 8) + 1.0) / 16777217.0;
+    g_seed = g_seed * 1664525u + 1013904223u;
+    double u2 = (g_seed >> 8) / 16777216.0;
+    return sigma * sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+}
+
+// pid为nullptr时运行原阶梯控制（每LEGACY_LOOP_S更新一次开度）
+Result run(PressurePid* pid, uint32_t rateHz, uint32_t breaths, double gain, double tau, double sigma,
+           double assist) {
+    PressurePid tracker;   // 原阶梯控制也用同一套周期统计，输出不使用
+    Result r;
+    double dt = 1.0 / rateHz;
+    double pressure = 0;
+    double valve = 0;
+    double nextLegacy = 0;
+    double releaseStart = -1;
+    double releaseSum = 0;
+    uint32_t releases = 0;
+    double pidNs = 0;
+    uint32_t updates = 0;
+    uint32_t total = (uint32_t)(breaths * PERIOD_S * rateHz);
+    double outputMax = MAX_VALVE_OPEN * assist;
+
+    for (uint32_t i = 0; i < total; i++) {
+        double t = i * dt;
+        unsigned long us = (unsigned long)llround(t * 1e6);
+        BreathState state = phaseState(t);
+        float measured = (float)(pressure + noise(sigma));
+
+        if (pid) {
+            auto t0 = std::chrono::steady_clock::now();
+            valve = pid->update(us, state, measured, 1.0f, outputMax);
+            pidNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+            updates++;
+        } else if (t >= nextLegacy) {
+            if (state == INHALE) valve = fmin(fmax(valve + 10, 0), outputMax);
+            else if (state == EXHALE) valve = fmin(fmax(valve - 20, 0), MAX_VALVE_OPEN);
+            nextLegacy += LEGACY_LOOP_S;
+        }
+        tracker.update(us, state, measured, 1.0f, outputMax);
+        if (tracker.cycleCompleted() && tracker.lastCycle().cycleIndex > 0) {
+            const TrackingStats& s = tracker.lastCycle();
+            r.meanRms += s.rmsErrorKpa;
+            r.worstMax = fmax(r.worstMax, s.maxAbsErrorKpa);
+            r.cycles++;
+        }
+        if (pid && pid->cycleCompleted() && pid->lastCycle().cycleIndex > 0) {
+            r.meanSaturated += pid->lastCycle().saturatedPercent;
+        }
+
+        // 呼气开始到气阀基本关闭的时间
+        double phase = fmod(t, PERIOD_S);
+        if (phase >= TI_S && phase < TI_S + dt) releaseStart = t;
+        if (releaseStart >= 0 && valve < 5) {
+            releaseSum += (t - releaseStart) * 1000;
+            releases++;
+            releaseStart = -1;
+        }
+
+        // 一阶对象：dP/dt = (G·u - P) / tau
+        pressure += (gain * valve - pressure) * dt / tau;
+    }
+    if (r.cycles) {
+        r.meanRms /= r.cycles;
+        r.meanSaturated /= r.cycles;
+    }
+    r.meanReleaseMs = releases ? releaseSum / releases : NAN;
+    r.nsPerUpdate = updates ? pidNs / updates : 0;
+    return r;
+}
+}
+
+int main(int argc, char** argv) {
+    uint32_t rateHz = DEFAULT_SAMPLE_RATE_HZ;
+    uint32_t breaths = 40;
+    double gain = 0.01;
+    double tau = 0.15;
+    double sigma = 0.005;
+    double assist = 0.5;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--rate") && i + 1 < argc) rateHz = (uint32_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--breaths") && i + 1 < argc) breaths = (uint32_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--plant-gain") && i + 1 < argc) gain = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--tau") && i + 1 < argc) tau = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--noise") && i + 1 < argc) sigma = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--assist") && i + 1 < argc) assist = atof(argv[++i]);
+        else {
+            fprintf(stderr, "用法: %s [--rate HZ] [--breaths N] [--plant-gain KPA_PER_COUNT] [--tau S]"
+                            " [--noise KPA] [--assist LEVEL]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (rateHz == 0 || breaths < 2 || tau <= 0) {
+        fprintf(stderr, "参数无效：需要 rate > 0, breaths >= 2, tau > 0\n");
+        return 2;
+    }
+
+    PressurePid pid;
+    Result legacy = run(nullptr, rateHz, breaths, gain, tau, sigma, assist);
+    Result closed = run(&pid, rateHz, breaths, gain, tau, sigma, assist);
+
+    const PidGains& g = pid.getGains();
+    printf("=== 气阀压力闭环 (%u Hz, %u 周期, 对象 G=%.4f kPa/计数 tau=%.2f s, 噪声 %.3f kPa, 辅助 %.2f) ===\n",
+           rateHz, breaths, gain, tau, sigma, assist);
+    printf("目标:               吸气/峰值 %.2f kPa, 呼气 %.2f kPa; 增益 Kp %.0f Ki %.0f Kd %.1f Kff %.0f\n",
+           pid.getPhaseTarget(INHALE), pid.getPhaseTarget(EXHALE), g.kp, g.ki, g.kd, g.kff);
+    printf("原阶梯控制(100ms):  误差RMS平均 %.3f kPa, 最大 %.3f kPa, 呼气关阀 %.0f ms\n", legacy.meanRms,
+           legacy.worstMax, legacy.meanReleaseMs);
+    printf("PID(每节拍):        误差RMS平均 %.3f kPa, 最大 %.3f kPa, 呼气关阀 %.0f ms, 限幅 %.0f%%\n",
+           closed.meanRms, closed.worstMax, closed.meanReleaseMs, closed.meanSaturated);
+    printf("PID更新耗时:        %.1f ns/次\n", closed.nsPerUpdate);
+    return 0;
+}
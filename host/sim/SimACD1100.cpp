@@ -0,0 +1,138 @@
+#include "SimACD1100.h"
+#include "SimClock.h"
+
+#include <math.h>
+#include <string.h>
+
+SimACD1100::SimACD1100(uint8_t address) : SimI2CDevice(address) {
+    _co2 = [](double t) { return (float)(650.0 + 150.0 * sin(t / 60.0)); };
+    _temperature = [](double) { return 26.5f; };
+}
+
+uint8_t SimACD1100::crc8(const uint8_t* data, size_t len) {
+    uint8_t crc = 0xFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 8; bit > 0; --bit) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+void SimACD1100::sample(uint16_t& ppm, int16_t& tempCenti) {
+    // 传感器数据刷新周期2s，取最近一个刷新时刻的值
+    double t = floor(SimClock::nowUs() / 2e6) * 2.0;
+    double v = _co2(t);
+    ppm = (uint16_t)(v < 0 ? 0 : (v > 65535 ? 65535 : lround(v)));
+    tempCenti = (int16_t)lround(_temperature(t) * 100.0);
+    _served++;
+}
+
+void SimACD1100::prepareWord(size_t offset, uint8_t hi, uint8_t lo) {
+    _response[offset] = hi;
+    _response[offset + 1] = lo;
+    _response[offset + 2] = crc8(&_response[offset], 2);
+}
+
+bool SimACD1100::onWrite(const uint8_t* data, size_t len, bool) {
+    if (len < 2) return true;
+    uint16_t cmd = ((uint16_t)data[0] << 8) | data[1];
+    _responseLen = 0;
+    switch (cmd) {
+        case 0x0300: {
+            uint16_t ppm;
+            int16_t temp;
+            sample(ppm, temp);
+            prepareWord(0, 0, 0);
+            prepareWord(3, (uint8_t)(ppm >> 8), (uint8_t)ppm);
+            prepareWord(6, (uint8_t)((uint16_t)temp >> 8), (uint8_t)temp);
+            _responseLen = 9;
+            break;
+        }
+        case 0x5306:
+            if (len >= 4) _autoCalibration = data[3] != 0;
+            prepareWord(0, 0, _autoCalibration ? 1 : 0);
+            _responseLen = 3;
+            break;
+        case 0x5204:
+            if (len >= 4) _manualCalPPM = ((uint16_t)data[2] << 8) | data[3];
+            prepareWord(0, (uint8_t)(_manualCalPPM >> 8), (uint8_t)_manualCalPPM);
+            _responseLen = 3;
+            break;
+        case 0x5202:
+            prepareWord(0, 0, 1);
+            _responseLen = 3;
+            break;
+        case 0xD100:
+            memcpy(_response, "ACD1100V01", 10);
+            _responseLen = 10;
+            break;
+        case 0xD201:
+            memcpy(_response, "SIM0000001", 10);
+            _responseLen = 10;
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+void SimACD1100::onRead(uint8_t* buffer, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        buffer[i] = i < _responseLen ? _response[i] : 0xFF;
+    }
+}
+
+void SimACD1100::onHostByte(uint8_t byte, SimUartLink& link) {
+    if (_uartLen == 0 && byte != 0xFE) return;  // 等待帧头
+    if (_uartLen >= sizeof(_uartFrame)) _uartLen = 0;
+    _uartFrame[_uartLen++] = byte;
+    if (_uartLen == 2 && byte != 0xA6) {
+        _uartLen = 0;
+        return;
+    }
+    // FE A6 len cmd data[len] CS
+    if (_uartLen >= 4 && _uartLen == (size_t)_uartFrame[2] + 5) {
+        handleUartFrame(link);
+        _uartLen = 0;
+    }
+}
+
+void SimACD1100::handleUartFrame(SimUartLink& link) {
+    uint8_t sum = 0;
+    for (size_t i = 1; i < _uartLen - 1; i++) sum += _uartFrame[i];
+    if (sum != _uartFrame[_uartLen - 1]) return;  // 校验失败不应答
+
+    uint8_t out[16];
+    size_t n = 0;
+    out[n++] = 0xFE;
+    out[n++] = 0xA6;
+    uint8_t cmd = _uartFrame[3];
+    switch (cmd) {
+        case 0x01: {
+            uint16_t ppm;
+            int16_t temp;
+            sample(ppm, temp);
+            out[n++] = 0x04;
+            out[n++] = cmd;
+            out[n++] = (uint8_t)(ppm >> 8);
+            out[n++] = (uint8_t)ppm;
+            out[n++] = (uint8_t)((uint16_t)temp >> 8);
+            out[n++] = (uint8_t)temp;
+            break;
+        }
+        case 0x03:
+        case 0x04:
+        case 0x05:
+            out[n++] = 0x00;
+            out[n++] = cmd;
+            break;
+        default:
+            return;
+    }
+    uint8_t cs = 0;
+    for (size_t i = 1; i < n; i++) cs += out[i];
+    out[n++] = cs;
+    link.deliver(out, n, SimUartDevice::latencyUs());
+}
@@ -0,0 +1,51 @@
+#ifndef SimACD1100_h
+#define SimACD1100_h
+
+#include <functional>
+#include "SimI2CDevice.h"
+#include "SimUartDevice.h"
+
+// ACD1100红外CO2传感器模型（I2C 0x2A + UART 1200bps）
+// I2C：写命令字后读取应答（0x0300读浓度，每2字节跟CRC-8/0x31）
+// UART：FE A6 len cmd data.. CS 帧，CS为固定码起的累加和
+class SimACD1100 : public SimI2CDevice, public SimUartDevice {
+public:
+    typedef std::function<float(double seconds)> Waveform;
+
+    explicit SimACD1100(uint8_t address = 0x2A);
+
+    void setCO2Waveform(Waveform ppm) { _co2 = ppm; }
+    void setTemperatureWaveform(Waveform celsius) { _temperature = celsius; }
+
+    // 两个接口共享同一个延迟设置
+    void setLatencyUs(uint32_t us) {
+        SimI2CDevice::setLatencyUs(us);
+        SimUartDevice::setLatencyUs(us);
+    }
+
+    bool onWrite(const uint8_t* data, size_t len, bool stop) override;
+    void onRead(uint8_t* buffer, size_t len) override;
+    void onHostByte(uint8_t byte, SimUartLink& link) override;
+
+    uint32_t measurementsServed() const { return _served; }
+
+    static uint8_t crc8(const uint8_t* data, size_t len);
+
+private:
+    uint8_t _response[16];
+    size_t _responseLen = 0;
+    bool _autoCalibration = true;
+    uint16_t _manualCalPPM = 450;
+    uint32_t _served = 0;
+    Waveform _co2;
+    Waveform _temperature;
+
+    uint8_t _uartFrame[32];
+    size_t _uartLen = 0;
+
+    void sample(uint16_t& ppm, int16_t& tempCenti);
+    void prepareWord(size_t offset, uint8_t hi, uint8_t lo);
+    void handleUartFrame(SimUartLink& link);
+};
+
+#endif
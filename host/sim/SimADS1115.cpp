@@ -0,0 +1,91 @@
+#include "SimADS1115.h"
+#include "SimClock.h"
+
+#include <math.h>
+
+namespace {
+constexpr uint16_t OS = 0x8000;
+constexpr uint16_t MODE_SINGLE = 0x0100;
+const float FSR[8] = {6.144f, 4.096f, 2.048f, 1.024f, 0.512f, 0.256f, 0.256f, 0.256f};
+const uint16_t SPS[8] = {8, 16, 32, 64, 128, 250, 475, 860};
+}
+
+SimADS1115::SimADS1115(uint8_t address) : SimI2CDevice(address) {
+    _regs[0] = 0;
+    _regs[1] = 0x8583;  // 上电默认配置
+    _regs[2] = 0x8000;
+    _regs[3] = 0x7FFF;
+    for (int i = 0; i < 4; i++) _ain[i] = [](double) { return 0.0f; };
+    // 电化学氧传感器在空气中约10mV
+    _ain[0] = [](double) { return 0.0105f; };
+}
+
+void SimADS1115::setInputVoltage(uint8_t ain, Waveform volts) {
+    if (ain < 4) _ain[ain] = volts;
+}
+
+float SimADS1115::inputVoltage(double seconds) {
+    uint8_t mux = (_regs[1] >> 12) & 0x07;
+    switch (mux) {
+        case 0: return _ain[0](seconds) - _ain[1](seconds);
+        case 1: return _ain[0](seconds) - _ain[3](seconds);
+        case 2: return _ain[1](seconds) - _ain[3](seconds);
+        case 3: return _ain[2](seconds) - _ain[3](seconds);
+        default: return _ain[mux - 4](seconds);
+    }
+}
+
+void SimADS1115::sync() {
+    uint64_t now = SimClock::nowUs();
+    if (!_converting || now < _doneAtUs) return;
+    uint64_t latchedAt = _doneAtUs;
+    if (_regs[1] & MODE_SINGLE) {
+        _converting = false;
+        _regs[1] |= OS;
+    } else {
+        // 连续模式：取最近一次完成的转换，并排好下一次
+        uint64_t period = 1000000UL / SPS[(_regs[1] >> 5) & 0x07] + 1;
+        while (_doneAtUs <= now) {
+            latchedAt = _doneAtUs;
+            _doneAtUs += period;
+            _conversions++;
+        }
+    }
+    float fsr = FSR[(_regs[1] >> 9) & 0x07];
+    double code = inputVoltage(latchedAt / 1e6) / fsr * 32768.0;
+    if (code > 32767) code = 32767;
+    if (code < -32768) code = -32768;
+    _regs[0] = (uint16_t)(int16_t)lround(code);
+}
+
+void SimADS1115::startConversion() {
+    uint16_t sps = SPS[(_regs[1] >> 5) & 0x07];
+    _converting = true;
+    _doneAtUs = SimClock::nowUs() + 1000000UL / sps + 1;
+    _regs[1] &= ~OS;
+    _conversions++;
+}
+
+bool SimADS1115::onWrite(const uint8_t* data, size_t len, bool) {
+    sync();
+    if (len == 0) return true;
+    _pointer = data[0] & 0x03;
+    if (len >= 3) {
+        uint16_t value = ((uint16_t)data[1] << 8) | data[2];
+        if (_pointer == 1) {
+            bool start = !(value & MODE_SINGLE) || ((value & OS) && !_converting);
+            if (!(value & MODE_SINGLE)) _converting = false;
+            _regs[1] = (uint16_t)(value & ~OS) | (_converting ? 0 : OS);
+            if (start) startConversion();
+        } else if (_pointer != 0) {
+            _regs[_pointer] = value;
+        }
+    }
+    return true;
+}
+
+void SimADS1115::onRead(uint8_t* buffer, size_t len) {
+    sync();
+    uint16_t v = _regs[_pointer];
+    for (size_t i = 0; i < len; i++) buffer[i] = (i % 2 == 0) ? (uint8_t)(v >> 8) : (uint8_t)v;
+}
@@ -0,0 +1,37 @@
+#ifndef SimADS1115_h
+#define SimADS1115_h
+
+#include <functional>
+#include "SimI2CDevice.h"
+
+// ADS1115 16位ADC模型
+// 指针寄存器 + 4个16位寄存器（转换/配置/低阈值/高阈值），高字节在前。
+// 单次模式下写入OS=1启动转换，转换时间为1/DR；转换期间OS读为0。
+class SimADS1115 : public SimI2CDevice {
+public:
+    typedef std::function<float(double seconds)> Waveform;
+
+    explicit SimADS1115(uint8_t address = 0x4A);
+
+    // 单端输入AINx对地电压（V）
+    void setInputVoltage(uint8_t ain, Waveform volts);
+
+    bool onWrite(const uint8_t* data, size_t len, bool stop) override;
+    void onRead(uint8_t* buffer, size_t len) override;
+
+    uint32_t conversions() const { return _conversions; }
+
+private:
+    uint16_t _regs[4];
+    uint8_t _pointer = 0;
+    bool _converting = false;
+    uint64_t _doneAtUs = 0;
+    uint32_t _conversions = 0;
+    Waveform _ain[4];
+
+    void sync();
+    void startConversion();
+    float inputVoltage(double seconds);
+};
+
+#endif
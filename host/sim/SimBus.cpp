@@ -0,0 +1,86 @@
+#include "SimBus.h"
+#include "SimClock.h"
+
+#include <string.h>
+
+void SimBus::attach(SimI2CDevice* device) {
+    if (device) _devices.push_back(device);
+}
+
+void SimBus::detachAll() {
+    _devices.clear();
+}
+
+void SimBus::resetStats() {
+    _transactions = 0;
+    _nacks = 0;
+    _busTimeUs = 0;
+}
+
+void SimBus::resolve(uint8_t address, std::vector<SimI2CDevice*>& out) {
+    for (SimI2CDevice* dev : _devices) {
+        if (dev->address() == address && dev->acknowledges()) {
+            out.push_back(dev);
+        }
+        dev->findDownstream(address, out);
+    }
+}
+
+void SimBus::spend(size_t bytes, uint32_t latencyUs) {
+    // START + 地址字节 + 数据字节（每字节9个时钟含ACK）+ STOP
+    uint64_t bits = 9 * (uint64_t)(bytes + 1) + 2;
+    uint64_t us = (bits * 1000000 + _clockHz - 1) / _clockHz + latencyUs;
+    _busTimeUs += us;
+    SimClock::advanceUs(us);
+}
+
+uint8_t SimBus::write(uint8_t address, const uint8_t* data, size_t len, bool stop) {
+    _transactions++;
+    std::vector<SimI2CDevice*> targets;
+    resolve(address, targets);
+    if (targets.empty()) {
+        _nacks++;
+        spend(0, 0);
+        return 2;
+    }
+
+    bool acked = true;
+    uint32_t latency = 0;
+    for (SimI2CDevice* dev : targets) {
+        dev->countWrite(len);
+        if (!dev->onWrite(data, len, stop)) acked = false;
+        if (dev->latencyUs() > latency) latency = dev->latencyUs();
+    }
+    spend(len, latency);
+    if (!acked) {
+        _nacks++;
+        return 3;
+    }
+    return 0;
+}
+
+size_t SimBus::read(uint8_t address, uint8_t* buffer, size_t len) {
+    _transactions++;
+    std::vector<SimI2CDevice*> targets;
+    resolve(address, targets);
+    if (targets.empty()) {
+        _nacks++;
+        spend(0, 0);
+        return 0;
+    }
+
+    // 线与：任一设备拉低的位即为0
+    memset(buffer, 0xFF, len);
+    uint8_t scratch[256];
+    uint32_t latency = 0;
+    for (SimI2CDevice* dev : targets) {
+        size_t chunk = len < sizeof(scratch) ? len : sizeof(scratch);
+        memset(scratch, 0xFF, chunk);
+        dev->countRead(chunk);
+        dev->onRead(scratch, chunk);
+        for (size_t i = 0; i < chunk; i++) buffer[i] &= scratch[i];
+        if (dev->latencyUs() > latency) latency = dev->latencyUs();
+    }
+    spend(len, latency);
+    return len;
+}
@@ -0,0 +1,43 @@
+#ifndef SimBus_h
+#define SimBus_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "SimI2CDevice.h"
+
+// 仿真I2C总线
+// 根设备直接挂在总线上（如TCA9548），其下游设备通过findDownstream()解析。
+// 多个可达设备地址相同时按线与(wired-AND)合成读数据，与真实总线冲突行为一致。
+class SimBus {
+public:
+    void attach(SimI2CDevice* device);
+    void detachAll();
+
+    void setClockHz(uint32_t hz) { _clockHz = hz ? hz : 100000; }
+    uint32_t clockHz() const { return _clockHz; }
+
+    // 写事务，返回值与Wire.endTransmission()一致：0成功，2地址NACK，3数据NACK
+    uint8_t write(uint8_t address, const uint8_t* data, size_t len, bool stop);
+
+    // 读事务，返回实际读取的字节数（地址NACK时为0）
+    size_t read(uint8_t address, uint8_t* buffer, size_t len);
+
+    // 统计
+    uint32_t transactions() const { return _transactions; }
+    uint32_t nacks() const { return _nacks; }
+    uint64_t busTimeUs() const { return _busTimeUs; }
+    void resetStats();
+
+private:
+    std::vector<SimI2CDevice*> _devices;
+    uint32_t _clockHz = 100000;
+    uint32_t _transactions = 0;
+    uint32_t _nacks = 0;
+    uint64_t _busTimeUs = 0;
+
+    void resolve(uint8_t address, std::vector<SimI2CDevice*>& out);
+    void spend(size_t bytes, uint32_t latencyUs);
+};
+
+#endif
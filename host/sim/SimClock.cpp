@@ -0,0 +1,135 @@
+#include "SimClock.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace {
+typedef std::chrono::steady_clock SteadyClock;
+
+// 短于此值的剩余等待改为让出CPU自旋，避免系统休眠的几十微秒唤醒误差
+constexpr uint64_t SPIN_THRESHOLD_US = 200;
+
+std::atomic<uint64_t> g_nowUs(0);
+SimClock::EventHook g_hook = nullptr;
+uint64_t g_deadlineUs = UINT64_MAX;
+bool g_inHook = false;
+
+// 实时模式
+std::atomic<bool> g_realtime(false);
+SteadyClock::time_point g_realStart;
+uint64_t g_realBaseUs = 0;
+std::mutex g_eventMutex;
+std::condition_variable g_eventCv;
+uint64_t g_eventGeneration = 0;  // 回调执行期间deadline被重设时丢弃回调的返回值
+bool g_stopEvents = false;
+std::thread g_eventThread;
+
+uint64_t realNowUs() {
+    return g_realBaseUs +
+           std::chrono::duration_cast<std::chrono::microseconds>(SteadyClock::now() - g_realStart).count();
+}
+
+void sleepUntilUs(uint64_t targetUs) {
+    uint64_t now = realNowUs();
+    if (targetUs > now + SPIN_THRESHOLD_US) {
+        std::this_thread::sleep_for(std::chrono::microseconds(targetUs - now - SPIN_THRESHOLD_US / 2));
+    }
+    while (realNowUs() < targetUs) {
+        std::this_thread::yield();
+    }
+}
+
+void eventLoop() {
+    std::unique_lock<std::mutex> lock(g_eventMutex);
+    while (!g_stopEvents) {
+        if (!g_hook || g_deadlineUs == UINT64_MAX) {
+            g_eventCv.wait(lock);
+            continue;
+        }
+        uint64_t deadline = g_deadlineUs;
+        uint64_t now = realNowUs();
+        if (now + SPIN_THRESHOLD_US < deadline) {
+            g_eventCv.wait_until(lock, g_realStart + std::chrono::microseconds(deadline - g_realBaseUs - SPIN_THRESHOLD_US / 2));
+            continue;
+        }
+        // 回调在锁外执行：定时器替身会在持有自身锁时调用setEventHook()
+        SimClock::EventHook hook = g_hook;
+        uint64_t generation = g_eventGeneration;
+        lock.unlock();
+        sleepUntilUs(deadline);
+        uint64_t next = hook(deadline);
+        lock.lock();
+        if (generation == g_eventGeneration) g_deadlineUs = next;
+    }
+}
+}
+
+uint64_t SimClock::nowUs() {
+    if (g_realtime.load(std::memory_order_acquire)) return realNowUs();
+    return g_nowUs.load(std::memory_order_relaxed);
+}
+
+void SimClock::advanceUs(uint64_t us) {
+    if (g_realtime.load(std::memory_order_acquire)) {
+        sleepUntilUs(realNowUs() + us);
+        return;
+    }
+    uint64_t target = g_nowUs.load(std::memory_order_relaxed) + us;
+    // 事件回调内部推进时钟（中断里的延时）时不再嵌套触发
+    while (g_hook && !g_inHook && g_deadlineUs <= target) {
+        g_nowUs.store(g_deadlineUs, std::memory_order_relaxed);
+        g_inHook = true;
+        g_deadlineUs = g_hook(g_deadlineUs);
+        g_inHook = false;
+        if (g_nowUs.load(std::memory_order_relaxed) > target) {
+            target = g_nowUs.load(std::memory_order_relaxed);
+        }
+    }
+    g_nowUs.store(target, std::memory_order_relaxed);
+}
+
+void SimClock::reset(uint64_t us) {
+    g_nowUs.store(us, std::memory_order_relaxed);
+}
+
+void SimClock::setEventHook(EventHook hook, uint64_t firstDeadlineUs) {
+    std::lock_guard<std::mutex> lock(g_eventMutex);
+    g_hook = hook;
+    g_deadlineUs = hook ? firstDeadlineUs : UINT64_MAX;
+    g_eventGeneration++;
+    g_eventCv.notify_all();
+}
+
+void SimClock::setNextDeadline(uint64_t deadlineUs) {
+    std::lock_guard<std::mutex> lock(g_eventMutex);
+    g_deadlineUs = deadlineUs;
+    g_eventGeneration++;
+    g_eventCv.notify_all();
+}
+
+void SimClock::setRealtime(bool enable) {
+    if (enable == g_realtime.load()) return;
+    if (enable) {
+        g_realBaseUs = g_nowUs.load(std::memory_order_relaxed);
+        g_realStart = SteadyClock::now();
+        g_stopEvents = false;
+        g_realtime.store(true, std::memory_order_release);
+        g_eventThread = std::thread(eventLoop);
+    } else {
+        {
+            std::lock_guard<std::mutex> lock(g_eventMutex);
+            g_stopEvents = true;
+            g_eventCv.notify_all();
+        }
+        g_eventThread.join();
+        g_nowUs.store(realNowUs(), std::memory_order_relaxed);
+        g_realtime.store(false, std::memory_order_release);
+    }
+}
+
+bool SimClock::isRealtime() {
+    return g_realtime.load(std::memory_order_acquire);
+}
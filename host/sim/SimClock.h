@@ -0,0 +1,30 @@
+#ifndef SimClock_h
+#define SimClock_h
+
+#include <stdint.h>
+
+// 主机仿真用的虚拟时钟（微秒）
+// millis()/micros()/delay() 以及所有仿真设备的事务延迟都推进这同一个时钟，
+// 因此在Linux上测得的循环周期与真实硬件的总线/等待时间一致且可复现。
+//
+// 实时模式用于多线程（FreeRTOS任务替身）仿真：时钟跟随主机单调时钟，
+// advanceUs()改为真实休眠，定时事件由独立的事件线程按deadline触发。
+class SimClock {
+public:
+    // 定时事件回调：时钟走到deadline时调用，返回下一个deadline（无则UINT64_MAX）
+    typedef uint64_t (*EventHook)(uint64_t nowUs);
+
+    static uint64_t nowUs();
+    static void advanceUs(uint64_t us);
+    static void reset(uint64_t us = 0);
+
+    // 推进时钟时按deadline逐个触发事件（用于仿真硬件定时器中断）
+    static void setEventHook(EventHook hook, uint64_t firstDeadlineUs);
+    static void setNextDeadline(uint64_t deadlineUs);
+
+    // 切换实时模式：从当前虚拟时间接续，关闭时停在当前实时时间
+    static void setRealtime(bool enable);
+    static bool isRealtime();
+};
+
+#endif
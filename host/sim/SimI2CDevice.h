@@ -0,0 +1,60 @@
+#ifndef SimI2CDevice_h
+#define SimI2CDevice_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+// 仿真I2C从设备基类
+// 每个设备模型实现写/读两个回调；总线在事务结束时按设备配置的
+// 每事务延迟推进虚拟时钟，用于模拟时钟拉伸/内部处理时间。
+class SimI2CDevice {
+public:
+    explicit SimI2CDevice(uint8_t address) : _address(address) {}
+    virtual ~SimI2CDevice() {}
+
+    uint8_t address() const { return _address; }
+
+    // 主机写事务（地址已ACK之后的数据字节）；stop=false表示重复起始
+    // 返回false表示数据字节被NACK
+    virtual bool onWrite(const uint8_t* data, size_t len, bool stop) = 0;
+
+    // 主机读事务，填充len字节（设备无数据时应填0xFF）
+    virtual void onRead(uint8_t* buffer, size_t len) = 0;
+
+    // 设备是否应答地址（可用于模拟掉线）
+    virtual bool acknowledges() const { return _present; }
+    void setPresent(bool present) { _present = present; }
+
+    // 下游设备查找（仅多路复用器等桥接器件需要重载）
+    virtual void findDownstream(uint8_t address, std::vector<SimI2CDevice*>& out) {
+        (void)address;
+        (void)out;
+    }
+
+    // 每事务附加延迟（微秒）
+    void setLatencyUs(uint32_t us) { _latencyUs = us; }
+    uint32_t latencyUs() const { return _latencyUs; }
+
+    // 统计
+    uint32_t writeTransactions() const { return _writes; }
+    uint32_t readTransactions() const { return _reads; }
+    uint32_t bytesWritten() const { return _bytesWritten; }
+    uint32_t bytesRead() const { return _bytesRead; }
+    void resetStats() { _writes = _reads = _bytesWritten = _bytesRead = 0; }
+
+    // 由总线调用，记录统计
+    void countWrite(size_t len) { _writes++; _bytesWritten += (uint32_t)len; }
+    void countRead(size_t len) { _reads++; _bytesRead += (uint32_t)len; }
+
+private:
+    uint8_t _address;
+    bool _present = true;
+    uint32_t _latencyUs = 0;
+    uint32_t _writes = 0;
+    uint32_t _reads = 0;
+    uint32_t _bytesWritten = 0;
+    uint32_t _bytesRead = 0;
+};
+
+#endif
@@ -0,0 +1,78 @@
+#include "SimPressureSensor.h"
+#include "SimClock.h"
+
+#include <math.h>
+#include <string.h>
+
+namespace {
+constexpr uint8_t REG_STATUS = 0x02;
+constexpr uint8_t REG_DATA_MSB = 0x06;
+constexpr uint8_t REG_TEMP_MSB = 0x09;
+constexpr uint8_t REG_CMD = 0x30;
+constexpr uint8_t CMD_SCO = 0x08;   // 转换进行中
+constexpr uint8_t DRDY = 0x01;
+
+// 约3秒一个呼吸周期的默认波形
+float defaultPressure(double t) {
+    double phase = fmod(t, 3.0) / 3.0;
+    double breath = phase < 0.4 ? sin(phase / 0.4 * M_PI) : 0.0;
+    return (float)(101.3 + 2.0 * breath);
+}
+}
+
+SimPressureSensor::SimPressureSensor(uint8_t address) : SimI2CDevice(address) {
+    memset(_regs, 0, sizeof(_regs));
+    _regs[0x01] = 0x00;
+    _regs[REG_CMD] = 0x02;
+    _pressure = defaultPressure;
+    _temperature = [](double) { return 25.0f; };
+}
+
+void SimPressureSensor::sync() {
+    if (_converting && SimClock::nowUs() >= _doneAtUs) {
+        _converting = false;
+        latchSample(_doneAtUs / 1e6);
+        _regs[REG_CMD] &= ~CMD_SCO;
+        _regs[REG_STATUS] |= DRDY;
+    }
+}
+
+void SimPressureSensor::latchSample(double seconds) {
+    // BreathController: kPa = (raw/k + 1032) / 12.10111
+    double raw = ((double)_pressure(seconds) * 12.10111 - 1032.0) * _k;
+    int32_t p = (int32_t)lround(raw);
+    if (p > 0x7FFFFF) p = 0x7FFFFF;
+    if (p < -0x800000) p = -0x800000;
+    uint32_t u = (uint32_t)p & 0xFFFFFF;
+    _regs[REG_DATA_MSB] = (uint8_t)(u >> 16);
+    _regs[REG_DATA_MSB + 1] = (uint8_t)(u >> 8);
+    _regs[REG_DATA_MSB + 2] = (uint8_t)u;
+
+    int16_t t = (int16_t)lround((double)_temperature(seconds) * 256.0);
+    _regs[REG_TEMP_MSB] = (uint8_t)((uint16_t)t >> 8);
+    _regs[REG_TEMP_MSB + 1] = (uint8_t)t;
+}
+
+bool SimPressureSensor::onWrite(const uint8_t* data, size_t len, bool) {
+    sync();
+    if (len == 0) return true;
+    _pointer = data[0];
+    for (size_t i = 1; i < len; i++) {
+        uint8_t r = _pointer++;
+        if (r == REG_CMD && (data[i] & CMD_SCO)) {
+            _regs[REG_CMD] = data[i];
+            _regs[REG_STATUS] &= ~DRDY;
+            _converting = true;
+            _doneAtUs = SimClock::nowUs() + _conversionUs;
+            _conversions++;
+        } else if (r != REG_STATUS) {
+            _regs[r] = data[i];
+        }
+    }
+    return true;
+}
+
+void SimPressureSensor::onRead(uint8_t* buffer, size_t len) {
+    sync();
+    for (size_t i = 0; i < len; i++) buffer[i] = _regs[_pointer++];
+}
@@ -0,0 +1,45 @@
+#ifndef SimPressureSensor_h
+#define SimPressureSensor_h
+
+#include <functional>
+#include "SimI2CDevice.h"
+
+// 0x6D数字气压传感器模型
+// 寄存器：0x02状态(bit0数据就绪)、0x06-0x08压力(24位补码)、0x09-0x0A温度(/256°C)、
+// 0x30命令(写0x0A启动组合采集，bit3在转换期间为1)、0xA5特殊寄存器。
+// 读写均支持寄存器地址自动递增。
+class SimPressureSensor : public SimI2CDevice {
+public:
+    typedef std::function<float(double seconds)> Waveform;
+
+    explicit SimPressureSensor(uint8_t address = 0x6D);
+
+    // 激励：输出值与BreathController换算后的kPa/°C一致
+    void setPressureWaveform(Waveform kpa) { _pressure = kpa; }
+    void setTemperatureWaveform(Waveform celsius) { _temperature = celsius; }
+    void setConversionTimeUs(uint32_t us) { _conversionUs = us; }
+    // 压力换算使用的k值（与getKValue(PRESSURE_RANGE)一致）
+    void setKValue(uint32_t k) { _k = k ? k : 16; }
+
+    bool onWrite(const uint8_t* data, size_t len, bool stop) override;
+    void onRead(uint8_t* buffer, size_t len) override;
+
+    uint32_t conversions() const { return _conversions; }
+    uint8_t reg(uint8_t r) { sync(); return _regs[r]; }
+
+private:
+    uint8_t _regs[256];
+    uint8_t _pointer = 0;
+    bool _converting = false;
+    uint64_t _doneAtUs = 0;
+    uint32_t _conversionUs = 2500;
+    uint32_t _conversions = 0;
+    uint32_t _k = 16;
+    Waveform _pressure;
+    Waveform _temperature;
+
+    void sync();
+    void latchSample(double seconds);
+};
+
+#endif
@@ -0,0 +1,57 @@
+#include "SimRig.h"
+#include "SimClock.h"
+
+#include <math.h>
+#include <Wire.h>
+
+SimRig::SimRig()
+    : mux(0x70), primaryPressure(0x6D), backupPressure(0x6D), oled(0x3C), acd1100(0x2A), ads1115(0x4A) {
+    mux.attach(1, &primaryPressure);
+    mux.attach(2, &oled);
+    mux.attach(3, &backupPressure);
+    mux.attach(4, &acd1100);
+    mux.attach(5, &ads1115);
+
+    // 备用传感器与主传感器略有偏差，便于区分两路数据
+    backupPressure.setPressureWaveform([](double t) {
+        double phase = fmod(t, 3.0) / 3.0;
+        double breath = phase < 0.4 ? sin(phase / 0.4 * M_PI) : 0.0;
+        return (float)(101.25 + 1.9 * breath);
+    });
+}
+
+SimRig::~SimRig() {
+    uninstall();
+}
+
+void SimRig::install() {
+    SimClock::reset();
+    Wire.bus().detachAll();
+    Wire.bus().attach(&mux);
+    Serial1.attachDevice(&acd1100);
+}
+
+void SimRig::uninstall() {
+    Wire.bus().detachAll();
+    Serial1.attachDevice(nullptr);
+}
+
+void SimRig::setLatencyUs(uint32_t us) {
+    mux.setLatencyUs(us);
+    primaryPressure.setLatencyUs(us);
+    backupPressure.setLatencyUs(us);
+    oled.setLatencyUs(us);
+    acd1100.setLatencyUs(us);
+    ads1115.setLatencyUs(us);
+}
+
+void SimRig::resetStats() {
+    Wire.bus().resetStats();
+    mux.resetStats();
+    mux.resetSwitchStats();
+    primaryPressure.resetStats();
+    backupPressure.resetStats();
+    oled.resetStats();
+    acd1100.resetStats();
+    ads1115.resetStats();
+}
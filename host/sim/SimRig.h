@@ -0,0 +1,34 @@
+#ifndef SimRig_h
+#define SimRig_h
+
+#include "SimTCA9548.h"
+#include "SimPressureSensor.h"
+#include "SimACD1100.h"
+#include "SimADS1115.h"
+#include "SimSSD1306.h"
+
+// 与sketch_oct9a.ino一致的整机仿真接线：
+// TCA9548(0x70) 通道1主气压/2 OLED/3备用气压/4 ACD1100/5 ADS1115(0x4A)，
+// ACD1100的UART同时挂在Serial1上。
+class SimRig {
+public:
+    SimRig();
+    ~SimRig();
+
+    // 挂到全局Wire/Serial1，并复位虚拟时钟
+    void install();
+    void uninstall();
+
+    // 为所有设备统一设置每事务延迟
+    void setLatencyUs(uint32_t us);
+    void resetStats();
+
+    SimTCA9548 mux;
+    SimPressureSensor primaryPressure;
+    SimPressureSensor backupPressure;
+    SimSSD1306 oled;
+    SimACD1100 acd1100;
+    SimADS1115 ads1115;
+};
+
+#endif
@@ -0,0 +1,79 @@
+#include "SimSSD1306.h"
+
+#include <string.h>
+
+namespace {
+// 需要参数的命令及其参数个数
+uint8_t argCount(uint8_t c) {
+    switch (c) {
+        case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+        case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+            return 1;
+        case 0x21: case 0x22:
+            return 2;
+        default:
+            return 0;
+    }
+}
+}
+
+SimSSD1306::SimSSD1306(uint8_t address) : SimI2CDevice(address) {
+    memset(_ram, 0, sizeof(_ram));
+}
+
+bool SimSSD1306::onWrite(const uint8_t* data, size_t len, bool) {
+    if (len == 0) return true;
+    uint8_t control = data[0];
+    bool isData = control & 0x40;
+    for (size_t i = 1; i < len; i++) {
+        if (isData) this->data(data[i]);
+        else command(data[i]);
+    }
+    return true;
+}
+
+void SimSSD1306::onRead(uint8_t* buffer, size_t len) {
+    // 状态字节：bit6为显示关闭
+    for (size_t i = 0; i < len; i++) buffer[i] = _on ? 0x00 : 0x40;
+}
+
+void SimSSD1306::command(uint8_t c) {
+    _commandBytes++;
+    if (_pendingArgs) {
+        _args[_argIndex++] = c;
+        if (--_pendingArgs) return;
+        switch (_pendingCmd) {
+            case 0x21:
+                _colStart = _args[0] & 0x7F;
+                _colEnd = _args[1] & 0x7F;
+                _col = _colStart;
+                _bytesThisFrame = 0;
+                break;
+            case 0x22:
+                _pageStart = _args[0] & 0x07;
+                _pageEnd = _args[1] & 0x07;
+                _page = _pageStart;
+                _bytesThisFrame = 0;
+                break;
+        }
+        return;
+    }
+    if (c == 0xAE) _on = false;
+    if (c == 0xAF) _on = true;
+    _pendingCmd = c;
+    _pendingArgs = argCount(c);
+    _argIndex = 0;
+}
+
+void SimSSD1306::data(uint8_t d) {
+    _dataBytes++;
+    _ram[_page * 128 + _col] = d;
+    if (++_bytesThisFrame == sizeof(_ram)) {
+        _frames++;
+        _bytesThisFrame = 0;
+    }
+    if (_col++ >= _colEnd) {
+        _col = _colStart;
+        if (_page++ >= _pageEnd) _page = _pageStart;
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef SimSSD1306_h
+#define SimSSD1306_h
+
+#include "SimI2CDevice.h"
+
+// SSD1306 128x64 OLED控制器模型
+// 控制字节0x00后为命令流，0x40后为显存数据；支持水平寻址模式下的
+// 0x21列地址/0x22页地址窗口，数据按窗口自动回绕写入GDDRAM。
+class SimSSD1306 : public SimI2CDevice {
+public:
+    explicit SimSSD1306(uint8_t address = 0x3C);
+
+    bool onWrite(const uint8_t* data, size_t len, bool stop) override;
+    void onRead(uint8_t* buffer, size_t len) override;
+
+    const uint8_t* gddram() const { return _ram; }
+    bool displayOn() const { return _on; }
+    uint32_t commandBytes() const { return _commandBytes; }
+    uint32_t dataBytes() const { return _dataBytes; }
+    // 完整写满一帧（1024字节）的次数
+    uint32_t framesCompleted() const { return _frames; }
+
+private:
+    uint8_t _ram[128 * 8];
+    bool _on = false;
+    uint8_t _colStart = 0, _colEnd = 127, _pageStart = 0, _pageEnd = 7;
+    uint8_t _col = 0, _page = 0;
+    uint8_t _pendingCmd = 0;
+    uint8_t _pendingArgs = 0;
+    uint8_t _args[2];
+    uint8_t _argIndex = 0;
+    uint32_t _commandBytes = 0;
+    uint32_t _dataBytes = 0;
+    uint32_t _frames = 0;
+    uint32_t _bytesThisFrame = 0;
+
+    void command(uint8_t c);
+    void data(uint8_t d);
+};
+
+#endif
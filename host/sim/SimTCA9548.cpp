@@ -0,0 +1,29 @@
+#include "SimTCA9548.h"
+
+void SimTCA9548::attach(uint8_t channel, SimI2CDevice* device) {
+    if (channel < 8 && device) _downstream[channel].push_back(device);
+}
+
+bool SimTCA9548::onWrite(const uint8_t* data, size_t len, bool) {
+    // 只有一个控制寄存器，最后写入的字节生效
+    if (len == 0) return true;
+    uint8_t value = data[len - 1];
+    _controlWrites++;
+    if (value != _control) _switches++;
+    _control = value;
+    return true;
+}
+
+void SimTCA9548::onRead(uint8_t* buffer, size_t len) {
+    for (size_t i = 0; i < len; i++) buffer[i] = _control;
+}
+
+void SimTCA9548::findDownstream(uint8_t address, std::vector<SimI2CDevice*>& out) {
+    for (uint8_t ch = 0; ch < 8; ch++) {
+        if (!(_control & (1 << ch))) continue;
+        for (SimI2CDevice* dev : _downstream[ch]) {
+            if (dev->address() == address && dev->acknowledges()) out.push_back(dev);
+            dev->findDownstream(address, out);
+        }
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef SimTCA9548_h
+#define SimTCA9548_h
+
+#include "SimI2CDevice.h"
+
+// TCA9548 8通道I2C多路复用器模型
+// 控制寄存器的每一位对应一个下游通道；多个位可同时置1。
+class SimTCA9548 : public SimI2CDevice {
+public:
+    explicit SimTCA9548(uint8_t address = 0x70) : SimI2CDevice(address) {}
+
+    void attach(uint8_t channel, SimI2CDevice* device);
+
+    bool onWrite(const uint8_t* data, size_t len, bool stop) override;
+    void onRead(uint8_t* buffer, size_t len) override;
+    void findDownstream(uint8_t address, std::vector<SimI2CDevice*>& out) override;
+
+    uint8_t controlRegister() const { return _control; }
+    // 控制寄存器实际发生变化的次数
+    uint32_t switchCount() const { return _switches; }
+    // 控制寄存器写入次数（含未变化的写入）
+    uint32_t controlWrites() const { return _controlWrites; }
+    void resetSwitchStats() { _switches = _controlWrites = 0; }
+
+private:
+    std::vector<SimI2CDevice*> _downstream[8];
+    uint8_t _control = 0;
+    uint32_t _switches = 0;
+    uint32_t _controlWrites = 0;
+};
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef SimUartDevice_h
+#define SimUartDevice_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+// 仿真UART设备接口
+// 主机每发送一个字节调用onHostByte()；设备通过SimUartLink回送应答，
+// 应答字节按波特率和设备延迟在虚拟时钟上逐个到达。
+class SimUartLink {
+public:
+    virtual ~SimUartLink() {}
+    virtual void deliver(const uint8_t* data, size_t len, uint32_t latencyUs) = 0;
+};
+
+class SimUartDevice {
+public:
+    virtual ~SimUartDevice() {}
+    virtual void onHostByte(uint8_t byte, SimUartLink& link) = 0;
+
+    void setLatencyUs(uint32_t us) { _latencyUs = us; }
+    uint32_t latencyUs() const { return _latencyUs; }
+
+private:
+    uint32_t _latencyUs = 0;
+};
+
+#endif
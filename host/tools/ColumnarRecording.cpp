@@ -0,0 +1,767 @@
+#include "ColumnarRecording.h"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <math.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "TelemetryProtocol.h"
+
+namespace {
+const uint8_t FILE_MAGIC[4] = {'B', 'R', 'C', 'R'};
+const uint8_t CHUNK_MAGIC[4] = {'C', 'H', 'N', 'K'};
+const uint8_t INDEX_MAGIC[4] = {'B', 'R', 'I', 'X'};
+constexpr uint8_t RECORDING_VERSION = 1;
+constexpr size_t FILE_HEADER_SIZE = 16;
+constexpr size_t CHUNK_HEADER_FIXED = 32;
+constexpr size_t INDEX_ENTRY_SIZE = 40;
+constexpr size_t TRAILER_SIZE = 32;
+constexpr size_t WRITE_BUFFER = 1 << 18;
+constexpr int MAX_DECIMAL_DIGITS = 6;
+
+enum ColumnCodec : uint8_t { CODEC_CONSTANT, CODEC_INTEGER, CODEC_DECIMAL, CODEC_XOR };
+
+const char* const COLUMN_NAMES[] = {"时间", "序号", "压力", "备用压力", "流量", "温度",
+                                    "CO2", "氧浓度", "气阀", "呼吸状态", "标志", "窗口样本数"};
+const double POW10[MAX_DECIMAL_DIGITS + 1] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+
+size_t chunkHeaderSize(size_t columns) {
+    return CHUNK_HEADER_FIXED + 4 * columns;
+}
+
+void put32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+void put64(uint8_t* p, uint64_t v) {
+    for (int i = 0; i < 8; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+uint32_t get32(const uint8_t* p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+uint64_t get64(const uint8_t* p) {
+    return (uint64_t)get32(p) | (uint64_t)get32(p + 4) << 32;
+}
+
+uint64_t zigzag(int64_t v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+int64_t unzigzag(uint64_t v) {
+    return (int64_t)((v >> 1) ^ (0 - (v & 1)));
+}
+
+bool isFloatColumn(uint8_t c) {
+    return c >= RECORDING_PRESSURE && c <= RECORDING_VALVE;
+}
+
+float* floatField(RecordingRow& r, uint8_t c) {
+    switch (c) {
+    case RECORDING_PRESSURE: return &r.pressureKpa;
+    case RECORDING_BACKUP_PRESSURE: return &r.backupPressureKpa;
+    case RECORDING_FLOW: return &r.flowRate;
+    case RECORDING_TEMPERATURE: return &r.temperatureC;
+    case RECORDING_CO2: return &r.co2Ppm;
+    case RECORDING_OXYGEN: return &r.oxygenPercent;
+    default: return &r.valveFraction;
+    }
+}
+
+// 列值的64位原始表示：整数列为数值，浮点列为位模式
+uint64_t rawValue(const RecordingRow& r, uint8_t c) {
+    switch (c) {
+    case RECORDING_TIME: return (uint64_t)r.timeUs;
+    case RECORDING_SEQ: return r.seq;
+    case RECORDING_STATE: return r.state;
+    case RECORDING_FLAGS: return r.flags;
+    case RECORDING_WINDOW_COUNT: return r.windowCount;
+    default: {
+        uint32_t bits;
+        memcpy(&bits, floatField(const_cast<RecordingRow&>(r), c), 4);
+        return bits;
+    }
+    }
+}
+
+void setRawValue(RecordingRow& r, uint8_t c, uint64_t v) {
+    switch (c) {
+    case RECORDING_TIME: r.timeUs = (int64_t)v; break;
+    case RECORDING_SEQ: r.seq = (uint32_t)v; break;
+    case RECORDING_STATE: r.state = (uint8_t)v; break;
+    case RECORDING_FLAGS: r.flags = (uint8_t)v; break;
+    case RECORDING_WINDOW_COUNT: r.windowCount = (uint8_t)v; break;
+    default: {
+        uint32_t bits = (uint32_t)v;
+        memcpy(floatField(r, c), &bits, 4);
+        break;
+    }
+    }
+}
+
+float bitsToFloat(uint32_t bits) {
+    float v;
+    memcpy(&v, &bits, 4);
+    return v;
+}
+
+uint32_t floatToBits(float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, 4);
+    return bits;
+}
+
+// 位流（高位在前）
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : _out(out), _acc(0), _count(0) {}
+
+    void put(uint64_t value, uint8_t bits) {
+        if (bits > 32) {
+            put32((uint32_t)(value >> 32), (uint8_t)(bits - 32));
+            put32((uint32_t)value, 32);
+        } else {
+            put32((uint32_t)value, bits);
+        }
+    }
+
+    // 残差：0为1位，否则1位 + 6位(位数-1) + 有效位
+    void putResidual(uint64_t v) {
+        if (v == 0) {
+            put(0, 1);
+            return;
+        }
+        uint8_t bits = (uint8_t)(64 - __builtin_clzll(v));
+        put(1, 1);
+        put(bits - 1, 6);
+        put(v, bits);
+    }
+
+    void finish() {
+        if (_count > 0) put32(0, (uint8_t)(8 - _count));
+    }
+
+private:
+    void put32(uint32_t value, uint8_t bits) {
+        if (bits == 0) return;
+        uint64_t mask = bits == 32 ? 0xFFFFFFFFull : ((1ull << bits) - 1);
+        _acc = (_acc << bits) | (value & mask);
+        _count = (uint8_t)(_count + bits);
+        while (_count >= 8) {
+            _count -= 8;
+            _out.push_back((uint8_t)(_acc >> _count));
+        }
+        _acc &= (1ull << _count) - 1;
+    }
+
+    std::vector<uint8_t>& _out;
+    uint64_t _acc;
+    uint8_t _count;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t len) : _p(data), _end(data + len), _acc(0), _count(0), _overrun(false) {}
+
+    uint64_t get(uint8_t bits) {
+        if (bits > 32) {
+            uint64_t high = get32((uint8_t)(bits - 32));
+            return high << 32 | get32(32);
+        }
+        return get32(bits);
+    }
+
+    uint64_t getResidual() {
+        if (get(1) == 0) return 0;
+        uint8_t bits = (uint8_t)(get(6) + 1);
+        return get(bits);
+    }
+
+    bool overrun() const { return _overrun; }
+
+private:
+    uint32_t get32(uint8_t bits) {
+        if (bits == 0) return 0;
+        while (_count < bits) {
+            uint8_t byte = 0;
+            if (_p < _end) byte = *_p++;
+            else _overrun = true;
+            _acc = (_acc << 8) | byte;
+            _count = (uint8_t)(_count + 8);
+        }
+        _count = (uint8_t)(_count - bits);
+        uint64_t mask = bits == 32 ? 0xFFFFFFFFull : ((1ull << bits) - 1);
+        return (uint32_t)((_acc >> _count) & mask);
+    }
+
+    const uint8_t* _p;
+    const uint8_t* _end;
+    uint64_t _acc;
+    uint8_t _count;
+    bool _overrun;
+};
+
+void encodeIntegers(const std::vector<uint64_t>& values, uint8_t order, std::vector<uint8_t>& out) {
+    BitWriter w(out);
+    uint64_t prev = 0;
+    uint64_t prevDelta = 0;
+    for (uint64_t v : values) {
+        uint64_t delta = v - prev;
+        w.putResidual(zigzag((int64_t)(order == 1 ? delta : delta - prevDelta)));
+        prev = v;
+        prevDelta = delta;
+    }
+    w.finish();
+}
+
+bool decodeIntegers(BitReader& in, uint8_t order, std::vector<uint64_t>& values) {
+    if (order != 1 && order != 2) return false;
+    uint64_t prev = 0;
+    uint64_t prevDelta = 0;
+    for (uint64_t& v : values) {
+        uint64_t r = (uint64_t)unzigzag(in.getResidual());
+        uint64_t delta = order == 1 ? r : prevDelta + r;
+        v = prev + delta;
+        prev = v;
+        prevDelta = delta;
+    }
+    return !in.overrun();
+}
+
+void encodeXor(const std::vector<uint64_t>& values, std::vector<uint8_t>& out) {
+    BitWriter w(out);
+    uint32_t prev = 0;
+    uint8_t prevLeading = 32;
+    uint8_t prevTrailing = 0;
+    for (size_t i = 0; i < values.size(); i++) {
+        uint32_t bits = (uint32_t)values[i];
+        if (i == 0) {
+            w.put(bits, 32);
+            prev = bits;
+            continue;
+        }
+        uint32_t x = bits ^ prev;
+        prev = bits;
+        if (x == 0) {
+            w.put(0, 1);
+            continue;
+        }
+        uint8_t leading = (uint8_t)std::min(__builtin_clz(x), 31);
+        uint8_t trailing = (uint8_t)__builtin_ctz(x);
+        if (prevLeading < 32 && leading >= prevLeading && trailing >= prevTrailing) {
+            w.put(2, 2);
+            w.put(x >> prevTrailing, (uint8_t)(32 - prevLeading - prevTrailing));
+        } else {
+            uint8_t meaningful = (uint8_t)(32 - leading - trailing);
+            w.put(3, 2);
+            w.put(leading, 5);
+            w.put(meaningful - 1, 5);
+            w.put(x >> trailing, meaningful);
+            prevLeading = leading;
+            prevTrailing = trailing;
+        }
+    }
+    w.finish();
+}
+
+bool decodeXor(BitReader& in, std::vector<uint64_t>& values) {
+    uint32_t prev = 0;
+    uint8_t prevLeading = 32;
+    uint8_t prevTrailing = 0;
+    for (size_t i = 0; i < values.size(); i++) {
+        if (i == 0) {
+            prev = (uint32_t)in.get(32);
+        } else if (in.get(1) != 0) {
+            if (in.get(1) == 0) {
+                if (prevLeading >= 32) return false;
+                prev ^= (uint32_t)in.get((uint8_t)(32 - prevLeading - prevTrailing)) << prevTrailing;
+            } else {
+                uint8_t leading = (uint8_t)in.get(5);
+                uint8_t meaningful = (uint8_t)(in.get(5) + 1);
+                if (leading + meaningful > 32) return false;
+                uint8_t trailing = (uint8_t)(32 - leading - meaningful);
+                prev ^= (uint32_t)in.get(meaningful) << trailing;
+                prevLeading = leading;
+                prevTrailing = trailing;
+            }
+        }
+        values[i] = prev;
+    }
+    return !in.overrun();
+}
+
+// 整块能否按d位小数逐位还原
+bool decimalValues(const std::vector<uint64_t>& values, int digits, std::vector<uint64_t>& scaled) {
+    scaled.resize(values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        float v = bitsToFloat((uint32_t)values[i]);
+        if (!isfinite(v)) return false;
+        double s = (double)v * POW10[digits];
+        if (fabs(s) > 9e15) return false;
+        int64_t q = llround(s);
+        if (floatToBits((float)((double)q / POW10[digits])) != (uint32_t)values[i]) return false;
+        scaled[i] = (uint64_t)q;
+    }
+    return true;
+}
+
+// 一列的最短编码
+void encodeColumn(const std::vector<uint64_t>& values, bool floating, std::vector<uint8_t>& out) {
+    bool constant = std::all_of(values.begin(), values.end(), [&](uint64_t v) { return v == values[0]; });
+    if (constant) {
+        uint8_t block[9];
+        block[0] = CODEC_CONSTANT;
+        put64(block + 1, values.empty() ? 0 : values[0]);
+        out.insert(out.end(), block, block + 9);
+        return;
+    }
+    std::vector<uint8_t> best;
+    std::vector<uint8_t> candidate;
+    auto consider = [&]() {
+        if (best.empty() || candidate.size() < best.size()) best.swap(candidate);
+        candidate.clear();
+    };
+    auto integerCandidates = [&](uint8_t codec, int digits, const std::vector<uint64_t>& ints) {
+        for (uint8_t order = 1; order <= 2; order++) {
+            candidate.push_back(codec);
+            if (codec == CODEC_DECIMAL) candidate.push_back((uint8_t)digits);
+            candidate.push_back(order);
+            encodeIntegers(ints, order, candidate);
+            consider();
+        }
+    };
+    if (!floating) {
+        integerCandidates(CODEC_INTEGER, 0, values);
+    } else {
+        candidate.push_back(CODEC_XOR);
+        encodeXor(values, candidate);
+        consider();
+        std::vector<uint64_t> scaled;
+        for (int digits = 0; digits <= MAX_DECIMAL_DIGITS; digits++) {
+            if (decimalValues(values, digits, scaled)) {
+                integerCandidates(CODEC_DECIMAL, digits, scaled);
+                break;
+            }
+        }
+    }
+    out.insert(out.end(), best.begin(), best.end());
+}
+
+bool decodeColumn(const uint8_t* data, size_t len, uint8_t column, std::vector<RecordingRow>& rows) {
+    if (len < 1) return false;
+    std::vector<uint64_t> values(rows.size());
+    uint8_t codec = data[0];
+    bool ok;
+    if (codec == CODEC_CONSTANT) {
+        if (len < 9) return false;
+        std::fill(values.begin(), values.end(), get64(data + 1));
+        ok = true;
+    } else if (codec == CODEC_INTEGER) {
+        if (len < 2) return false;
+        BitReader in(data + 2, len - 2);
+        ok = decodeIntegers(in, data[1], values);
+    } else if (codec == CODEC_DECIMAL) {
+        if (len < 3 || data[1] > MAX_DECIMAL_DIGITS) return false;
+        BitReader in(data + 3, len - 3);
+        ok = decodeIntegers(in, data[2], values);
+        for (uint64_t& v : values) v = floatToBits((float)((double)(int64_t)v / POW10[data[1]]));
+    } else if (codec == CODEC_XOR) {
+        BitReader in(data + 1, len - 1);
+        ok = decodeXor(in, values);
+    } else {
+        return false;
+    }
+    for (size_t i = 0; i < rows.size(); i++) setRawValue(rows[i], column, values[i]);
+    return ok;
+}
+
+void fillDefault(std::vector<RecordingRow>& rows, uint8_t column) {
+    for (RecordingRow& r : rows) {
+        if (isFloatColumn(column)) *floatField(r, column) = NAN;
+        else setRawValue(r, column, 0);
+    }
+}
+}
+
+const char* recordingColumnName(uint8_t column) {
+    return column < RECORDING_COLUMN_COUNT ? COLUMN_NAMES[column] : "?";
+}
+
+// ---------------- 时间轴 ----------------
+
+RecordingTimeline::RecordingTimeline(int64_t toleranceUs)
+    : _toleranceUs(toleranceUs), _started(false), _lastDeviceUs(0), _timeUs(0), _reanchors(0) {}
+
+int64_t RecordingTimeline::map(int64_t hostUs, uint32_t deviceUs) {
+    if (!_started) {
+        _started = true;
+        _timeUs = hostUs;
+    } else {
+        // 有符号差值：设备重启或乱序时为负，由主机时刻重新锚定
+        int64_t t = _timeUs + (int32_t)(deviceUs - _lastDeviceUs);
+        if (t - hostUs > _toleranceUs || hostUs - t > _toleranceUs) {
+            t = hostUs;
+            _reanchors++;
+        }
+        _timeUs = t;
+    }
+    _lastDeviceUs = deviceUs;
+    return _timeUs;
+}
+
+int64_t RecordingTimeline::unwrap(uint32_t deviceUs) {
+    if (!_started) {
+        _started = true;
+        _timeUs = deviceUs;
+    } else {
+        _timeUs += (uint32_t)(deviceUs - _lastDeviceUs);
+    }
+    _lastDeviceUs = deviceUs;
+    return _timeUs;
+}
+
+// ---------------- 写入 ----------------
+
+RecordingWriter::RecordingWriter()
+    : _file(nullptr), _chunkRows(RECORDING_DEFAULT_CHUNK_ROWS), _firstRow(0), _offset(0), _lastTimeUs(0),
+      _hasLastTime(false), _failed(false), _stats() {}
+
+RecordingWriter::~RecordingWriter() {
+    close();
+}
+
+bool RecordingWriter::open(const std::string& path, uint32_t chunkRows) {
+    close();
+    _stats = RecordingWriterStats();
+    _index.clear();
+    _pending.clear();
+    _firstRow = 0;
+    _hasLastTime = false;
+    _failed = false;
+    _chunkRows = std::max<uint32_t>(1, std::min(chunkRows, RECORDING_MAX_CHUNK_ROWS));
+
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0 && st.st_size > 0) {
+        // 接着写：沿用已有的块（含没有索引的不完整文件），去掉旧索引
+        RecordingReader reader;
+        if (!reader.open(path)) return false;
+        _chunkRows = reader.chunkRows();
+        for (size_t i = 0; i < reader.chunkCount(); i++) _index.push_back(reader.chunk(i));
+        _firstRow = reader.rows();
+        _offset = reader.dataEnd();
+        if (!_index.empty()) {
+            _lastTimeUs = reader.lastTimeUs();
+            _hasLastTime = true;
+        }
+        reader.close();
+        _file = fopen(path.c_str(), "r+b");
+        if (!_file) return false;
+        if (ftruncate(fileno(_file), (off_t)_offset) != 0 || fseek(_file, (long)_offset, SEEK_SET) != 0) {
+            fclose(_file);
+            _file = nullptr;
+            return false;
+        }
+    } else {
+        _file = fopen(path.c_str(), "wb");
+        if (!_file) return false;
+        uint8_t header[FILE_HEADER_SIZE] = {};
+        memcpy(header, FILE_MAGIC, 4);
+        header[4] = RECORDING_VERSION;
+        header[5] = RECORDING_COLUMN_COUNT;
+        header[6] = (uint8_t)FILE_HEADER_SIZE;
+        put32(header + 8, _chunkRows);
+        if (fwrite(header, 1, sizeof(header), _file) != sizeof(header)) _failed = true;
+        _offset = FILE_HEADER_SIZE;
+    }
+    setvbuf(_file, nullptr, _IOFBF, WRITE_BUFFER);
+    _pending.reserve(_chunkRows);
+    _stats.fileBytes = _offset;
+    return !_failed;
+}
+
+bool RecordingWriter::append(const RecordingRow& row) {
+    if (!_file) return false;
+    _pending.push_back(row);
+    RecordingRow& r = _pending.back();
+    if (_hasLastTime && r.timeUs < _lastTimeUs) {
+        r.timeUs = _lastTimeUs;
+        _stats.clampedTimes++;
+    }
+    _lastTimeUs = r.timeUs;
+    _hasLastTime = true;
+    _stats.rows++;
+    if (_pending.size() >= _chunkRows) return writeChunk();
+    return !_failed;
+}
+
+bool RecordingWriter::flush() {
+    if (!_file) return false;
+    if (!_pending.empty()) writeChunk();
+    if (fflush(_file) != 0) _failed = true;
+    return !_failed;
+}
+
+bool RecordingWriter::writeChunk() {
+    size_t headerSize = chunkHeaderSize(RECORDING_COLUMN_COUNT);
+    uint32_t lengths[RECORDING_COLUMN_COUNT];
+    std::vector<uint64_t> values(_pending.size());
+    _payload.clear();
+    for (uint8_t c = 0; c < RECORDING_COLUMN_COUNT; c++) {
+        for (size_t i = 0; i < _pending.size(); i++) values[i] = rawValue(_pending[i], c);
+        size_t before = _payload.size();
+        encodeColumn(values, isFloatColumn(c), _payload);
+        lengths[c] = (uint32_t)(_payload.size() - before);
+        _stats.columnBytes[c] += lengths[c];
+    }
+
+    RecordingChunkInfo info;
+    info.offset = _offset;
+    info.firstTimeUs = _pending.front().timeUs;
+    info.lastTimeUs = _pending.back().timeUs;
+    info.firstRow = _firstRow;
+    info.rowCount = (uint32_t)_pending.size();
+
+    std::vector<uint8_t> header(headerSize);
+    memcpy(header.data(), CHUNK_MAGIC, 4);
+    put32(&header[4], info.rowCount);
+    put64(&header[8], (uint64_t)info.firstTimeUs);
+    put64(&header[16], (uint64_t)info.lastTimeUs);
+    put32(&header[24], (uint32_t)_payload.size());
+    put32(&header[28], telemetryCrc32(_payload.data(), _payload.size()));
+    for (uint8_t c = 0; c < RECORDING_COLUMN_COUNT; c++) put32(&header[CHUNK_HEADER_FIXED + 4 * c], lengths[c]);
+    if (fwrite(header.data(), 1, header.size(), _file) != header.size() ||
+        fwrite(_payload.data(), 1, _payload.size(), _file) != _payload.size()) {
+        _failed = true;
+    }
+
+    _index.push_back(info);
+    _offset += header.size() + _payload.size();
+    _firstRow += _pending.size();
+    _pending.clear();
+    _stats.chunks++;
+    _stats.fileBytes = _offset;
+    return !_failed;
+}
+
+bool RecordingWriter::close() {
+    if (!_file) return true;
+    if (!_pending.empty()) writeChunk();
+
+    std::vector<uint8_t> index(_index.size() * INDEX_ENTRY_SIZE + TRAILER_SIZE);
+    uint64_t totalRows = 0;
+    for (size_t i = 0; i < _index.size(); i++) {
+        uint8_t* e = &index[i * INDEX_ENTRY_SIZE];
+        put64(e, _index[i].offset);
+        put64(e + 8, (uint64_t)_index[i].firstTimeUs);
+        put64(e + 16, (uint64_t)_index[i].lastTimeUs);
+        put64(e + 24, _index[i].firstRow);
+        put32(e + 32, _index[i].rowCount);
+        totalRows += _index[i].rowCount;
+    }
+    size_t indexBytes = _index.size() * INDEX_ENTRY_SIZE;
+    uint8_t* t = &index[indexBytes];
+    put64(t, _offset);
+    put64(t + 8, totalRows);
+    put32(t + 16, (uint32_t)_index.size());
+    put32(t + 20, telemetryCrc32(index.data(), indexBytes));
+    memcpy(t + 28, INDEX_MAGIC, 4);
+    if (fwrite(index.data(), 1, index.size(), _file) != index.size()) _failed = true;
+    if (fclose(_file) != 0) _failed = true;
+    _file = nullptr;
+    _stats.fileBytes = _offset + index.size();
+    return !_failed;
+}
+
+// ---------------- 读取 ----------------
+
+RecordingReader::RecordingReader()
+    : _data(nullptr), _size(0), _chunkRows(0), _rows(0), _dataEnd(0), _recovered(false), _columnCount(0),
+      _headerSize(0) {}
+
+RecordingReader::~RecordingReader() {
+    close();
+}
+
+bool RecordingReader::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)FILE_HEADER_SIZE) {
+        ::close(fd);
+        return false;
+    }
+    void* map = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return false;
+    _data = static_cast<const uint8_t*>(map);
+    _size = (size_t)st.st_size;
+
+    _columnCount = _data[5];
+    _headerSize = (uint16_t)(_data[6] | _data[7] << 8);
+    _chunkRows = get32(_data + 8);
+    if (memcmp(_data, FILE_MAGIC, 4) != 0 || _data[4] != RECORDING_VERSION || _columnCount == 0 ||
+        _headerSize < FILE_HEADER_SIZE || _headerSize > _size) {
+        close();
+        return false;
+    }
+    if (!loadIndex() && !recoverIndex()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void RecordingReader::close() {
+    if (_data) munmap(const_cast<uint8_t*>(_data), _size);
+    _data = nullptr;
+    _size = 0;
+    _rows = 0;
+    _dataEnd = 0;
+    _recovered = false;
+    _chunks.clear();
+}
+
+bool RecordingReader::loadIndex() {
+    if (_size < _headerSize + TRAILER_SIZE) return false;
+    const uint8_t* t = _data + _size - TRAILER_SIZE;
+    if (memcmp(t + 28, INDEX_MAGIC, 4) != 0) return false;
+    uint64_t indexOffset = get64(t);
+    uint32_t count = get32(t + 16);
+    if (indexOffset < _headerSize || indexOffset + (uint64_t)count * INDEX_ENTRY_SIZE + TRAILER_SIZE != _size) {
+        return false;
+    }
+    const uint8_t* index = _data + indexOffset;
+    if (telemetryCrc32(index, (size_t)count * INDEX_ENTRY_SIZE) != get32(t + 20)) return false;
+
+    _chunks.resize(count);
+    uint64_t row = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        const uint8_t* e = index + (size_t)i * INDEX_ENTRY_SIZE;
+        RecordingChunkInfo& c = _chunks[i];
+        c.offset = get64(e);
+        c.firstTimeUs = (int64_t)get64(e + 8);
+        c.lastTimeUs = (int64_t)get64(e + 16);
+        c.firstRow = get64(e + 24);
+        c.rowCount = get32(e + 32);
+        if (c.firstRow != row || c.offset + chunkHeaderSize(_columnCount) > indexOffset) {
+            _chunks.clear();
+            return false;
+        }
+        row += c.rowCount;
+    }
+    _rows = row;
+    _dataEnd = indexOffset;
+    return true;
+}
+
+// 没有有效索引：从文件头之后逐块检查块头和CRC，停在第一个不完整的块
+bool RecordingReader::recoverIndex() {
+    _chunks.clear();
+    _recovered = true;
+    size_t headerSize = chunkHeaderSize(_columnCount);
+    uint64_t offset = _headerSize;
+    uint64_t row = 0;
+    while (offset + headerSize <= _size) {
+        const uint8_t* h = _data + offset;
+        uint32_t rowCount = get32(h + 4);
+        uint32_t payloadLength = get32(h + 24);
+        if (memcmp(h, CHUNK_MAGIC, 4) != 0 || rowCount == 0 || rowCount > RECORDING_MAX_CHUNK_ROWS ||
+            offset + headerSize + payloadLength > _size) {
+            break;
+        }
+        uint64_t columnsLength = 0;
+        for (size_t c = 0; c < _columnCount; c++) columnsLength += get32(h + CHUNK_HEADER_FIXED + 4 * c);
+        if (columnsLength != payloadLength || telemetryCrc32(h + headerSize, payloadLength) != get32(h + 28)) break;
+
+        RecordingChunkInfo c;
+        c.offset = offset;
+        c.firstTimeUs = (int64_t)get64(h + 8);
+        c.lastTimeUs = (int64_t)get64(h + 16);
+        c.firstRow = row;
+        c.rowCount = rowCount;
+        _chunks.push_back(c);
+        row += rowCount;
+        offset += headerSize + payloadLength;
+    }
+    _rows = row;
+    _dataEnd = offset;
+    return true;
+}
+
+uint32_t RecordingReader::columnBytes(size_t chunk, uint8_t column) const {
+    if (chunk >= _chunks.size() || column >= _columnCount) return 0;
+    return get32(_data + _chunks[chunk].offset + CHUNK_HEADER_FIXED + 4 * column);
+}
+
+bool RecordingReader::verifyChunk(size_t index) const {
+    if (index >= _chunks.size()) return false;
+    const uint8_t* h = _data + _chunks[index].offset;
+    uint32_t payloadLength = get32(h + 24);
+    size_t headerSize = chunkHeaderSize(_columnCount);
+    if (memcmp(h, CHUNK_MAGIC, 4) != 0 || _chunks[index].offset + headerSize + payloadLength > _size) return false;
+    return telemetryCrc32(h + headerSize, payloadLength) == get32(h + 28);
+}
+
+uint64_t RecordingReader::seek(int64_t timeUs) const {
+    auto it = std::lower_bound(_chunks.begin(), _chunks.end(), timeUs,
+                               [](const RecordingChunkInfo& c, int64_t t) { return c.lastTimeUs < t; });
+    if (it == _chunks.end()) return _rows;
+    std::vector<RecordingRow> rows;
+    if (!readChunk((size_t)(it - _chunks.begin()), 1u << RECORDING_TIME, rows)) return it->firstRow;
+    auto r = std::lower_bound(rows.begin(), rows.end(), timeUs,
+                              [](const RecordingRow& row, int64_t t) { return row.timeUs < t; });
+    return it->firstRow + (uint64_t)(r - rows.begin());
+}
+
+bool RecordingReader::readChunk(size_t index, uint32_t columns, std::vector<RecordingRow>& rows) const {
+    if (index >= _chunks.size()) return false;
+    const RecordingChunkInfo& info = _chunks[index];
+    const uint8_t* h = _data + info.offset;
+    size_t headerSize = chunkHeaderSize(_columnCount);
+    uint64_t payloadEnd = info.offset + headerSize + get32(h + 24);
+    if (memcmp(h, CHUNK_MAGIC, 4) != 0 || get32(h + 4) != info.rowCount || payloadEnd > _size) return false;
+
+    rows.resize(info.rowCount);
+    uint64_t offset = info.offset + headerSize;
+    bool ok = true;
+    for (uint8_t c = 0; c < RECORDING_COLUMN_COUNT; c++) {
+        if (!(columns & (1u << c))) continue;
+        if (c >= _columnCount) {
+            fillDefault(rows, c);
+            continue;
+        }
+        // 各列从块头的长度累加定位，未选的列不触及
+        uint64_t columnOffset = offset;
+        for (uint8_t k = 0; k < c; k++) columnOffset += get32(h + CHUNK_HEADER_FIXED + 4 * k);
+        uint32_t length = get32(h + CHUNK_HEADER_FIXED + 4 * c);
+        if (columnOffset + length > payloadEnd || !decodeColumn(_data + columnOffset, length, c, rows)) ok = false;
+    }
+    return ok;
+}
+
+size_t RecordingReader::chunkForRow(uint64_t row) const {
+    auto it = std::upper_bound(_chunks.begin(), _chunks.end(), row,
+                               [](uint64_t r, const RecordingChunkInfo& c) { return r < c.firstRow; });
+    return it == _chunks.begin() ? 0 : (size_t)(it - _chunks.begin()) - 1;
+}
+
+size_t RecordingReader::read(uint64_t firstRow, size_t count, uint32_t columns, std::vector<RecordingRow>& rows) const {
+    rows.clear();
+    if (firstRow >= _rows || count == 0) return 0;
+    rows.reserve((size_t)std::min<uint64_t>(count, _rows - firstRow));
+    std::vector<RecordingRow> chunkRows;
+    uint64_t row = firstRow;
+    for (size_t i = chunkForRow(firstRow); i < _chunks.size() && rows.size() < count; i++) {
+        if (!readChunk(i, columns, chunkRows)) break;
+        size_t begin = (size_t)(row - _chunks[i].firstRow);
+        size_t end = std::min<size_t>(chunkRows.size(), begin + (count - rows.size()));
+        rows.insert(rows.end(), chunkRows.begin() + begin, chunkRows.begin() + end);
+        row = _chunks[i].firstRow + end;
+    }
+    return rows.size();
+}
@@ -0,0 +1,192 @@
+#ifndef ColumnarRecording_h
+#define ColumnarRecording_h
+
+// 列式遥测录制文件（替代Server_pp.py逐行追加的respiratory_data.csv）：每个数据流（时间、压力、温度、
+// 气阀、呼吸状态、CO2、氧、流量……）按固定行数分块，块内各列单独压缩，文件末尾是各块时间范围的索引。
+// 读取端mmap整个文件，按索引二分查找定位任意时刻，只解码用到的块和列，不需要从头扫描。
+//
+// 文件布局（全部小端）:
+//   文件头(16字节): "BRCR" | version u8 | columnCount u8 | headerSize u16 | chunkRows u32 | 保留 u32
+//   数据块 × N: 块头(32 + 4×columnCount字节) + 各列数据依次拼接
+//     块头: "CHNK" | rowCount u32 | firstTimeUs i64 | lastTimeUs i64 | payloadLength u32 |
+//           payloadCrc u32(CRC-32，覆盖各列数据) | 每列的压缩字节数 u32 × columnCount
+//   索引: 每块40字节: 块偏移 u64 | firstTimeUs i64 | lastTimeUs i64 | 首行行号 u64 | rowCount u32 | 保留 u32
+//   文件尾(32字节): 索引偏移 u64 | 总行数 u64 | 块数 u32 | 索引CRC u32 | 保留 u32 | "BRIX"
+// 时间为64位微秒（主机Unix时间），整个文件内不递减（写入端把倒退的时间钳到上一行）。
+// 没有写完索引的文件（进程被杀、掉电）读取时按块头逐块恢复，丢弃最后一个不完整的块；
+// 再次打开写入时去掉旧索引接着写。
+//
+// 每列数据以1字节编码方式开头，随后是位流（高位在前），每块从零状态开始：
+//   常数: 8字节原值（整列相同，如无效的流量全为NAN）
+//   整数: 阶数u8 + 逐行残差（1阶为差值，2阶为差值的差值——定速采样的时间戳为0），
+//         残差zigzag后: 0为1位"0"，否则1位"1" + 6位(位数-1) + 有效位
+//   定点小数: 小数位数u8 + 阶数u8 + 按整数编码的value×10^位数（固件文本行和CSV按固定小数位输出，
+//         只在整块逐位还原为同一个float时采用）
+//   异或: 首值32位原值，之后与上一个值的异或（同遥测帧压缩的Gorilla方式）
+// 写入端对每列尝试可用的编码，取最短的一种。
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+constexpr uint32_t RECORDING_DEFAULT_CHUNK_ROWS = 4096;    // 200Hz下约20秒一块
+constexpr uint32_t RECORDING_MAX_CHUNK_ROWS = 1 << 20;
+constexpr int64_t RECORDING_TIMELINE_TOLERANCE_US = 2000000;
+
+enum RecordingColumn : uint8_t {
+    RECORDING_TIME,             // int64 微秒
+    RECORDING_SEQ,              // 样本序号
+    RECORDING_PRESSURE,         // float kPa
+    RECORDING_BACKUP_PRESSURE,
+    RECORDING_FLOW,             // ml/min
+    RECORDING_TEMPERATURE,      // °C
+    RECORDING_CO2,              // ppm
+    RECORDING_OXYGEN,           // %
+    RECORDING_VALVE,            // 气阀开度 0~1
+    RECORDING_STATE,            // BreathState
+    RECORDING_FLAGS,            // TELEMETRY_FLAG_*
+    RECORDING_WINDOW_COUNT,     // 降采样窗口样本数，原始样本为0
+    RECORDING_COLUMN_COUNT
+};
+
+constexpr uint32_t RECORDING_ALL_COLUMNS = (1u << RECORDING_COLUMN_COUNT) - 1;
+
+// 一行（没有的字段为NAN）
+struct RecordingRow {
+    int64_t timeUs;
+    uint32_t seq;
+    float pressureKpa;
+    float backupPressureKpa;
+    float flowRate;
+    float temperatureC;
+    float co2Ppm;
+    float oxygenPercent;
+    float valveFraction;
+    uint8_t state;
+    uint8_t flags;
+    uint8_t windowCount;
+};
+
+// 索引项：块的位置和时间范围
+struct RecordingChunkInfo {
+    uint64_t offset;
+    int64_t firstTimeUs;
+    int64_t lastTimeUs;
+    uint64_t firstRow;
+    uint32_t rowCount;
+};
+
+const char* recordingColumnName(uint8_t column);
+
+// 录制的时间轴：主机收到时刻带攒批和调度抖动，设备时间戳是32位回绕的micros()。按设备时间差推进、
+// 以主机时刻锚定，偏离主机时刻超过容差（设备重启、长时间断线、时钟漂移累积）时重新锚定
+class RecordingTimeline {
+public:
+    explicit RecordingTimeline(int64_t toleranceUs = RECORDING_TIMELINE_TOLERANCE_US);
+
+    int64_t map(int64_t hostUs, uint32_t deviceUs);
+    // 没有主机时刻（串口/固件文本日志）：从第一个样本的设备时间起展开回绕
+    int64_t unwrap(uint32_t deviceUs);
+    uint32_t reanchors() const { return _reanchors; }
+
+private:
+    int64_t _toleranceUs;
+    bool _started;
+    uint32_t _lastDeviceUs;
+    int64_t _timeUs;
+    uint32_t _reanchors;
+};
+
+struct RecordingWriterStats {
+    uint64_t rows;
+    uint32_t chunks;                    // 本次写入的块
+    uint64_t fileBytes;
+    uint32_t clampedTimes;              // 时间倒退而钳到上一行
+    uint64_t columnBytes[RECORDING_COLUMN_COUNT];
+};
+
+class RecordingWriter {
+public:
+    RecordingWriter();
+    ~RecordingWriter();
+
+    // 已有的录制文件接着写（块行数沿用文件头）；不是录制文件时返回false，不覆盖
+    bool open(const std::string& path, uint32_t chunkRows = RECORDING_DEFAULT_CHUNK_ROWS);
+    bool append(const RecordingRow& row);
+    // 把未满的块写成一个较小的块（不写索引）
+    bool flush();
+    // 写出剩余的行和索引
+    bool close();
+    bool isOpen() const { return _file != nullptr; }
+
+    uint64_t rows() const { return _firstRow + _pending.size(); }
+    size_t pendingRows() const { return _pending.size(); }
+    const RecordingWriterStats& stats() const { return _stats; }
+
+private:
+    bool writeChunk();
+
+    FILE* _file;
+    uint32_t _chunkRows;
+    std::vector<RecordingRow> _pending;
+    std::vector<RecordingChunkInfo> _index;
+    uint64_t _firstRow;
+    uint64_t _offset;
+    int64_t _lastTimeUs;
+    bool _hasLastTime;
+    bool _failed;
+    std::vector<uint8_t> _payload;
+    RecordingWriterStats _stats;
+};
+
+// 只读访问：mmap整个文件，索引常驻内存，数据按需解码
+class RecordingReader {
+public:
+    RecordingReader();
+    ~RecordingReader();
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return _data != nullptr; }
+    // 文件没有有效索引，按块头恢复
+    bool recovered() const { return _recovered; }
+    // 最后一个有效块的结尾（写入端从这里接着写）
+    uint64_t dataEnd() const { return _dataEnd; }
+
+    uint32_t chunkRows() const { return _chunkRows; }
+    uint64_t rows() const { return _rows; }
+    size_t chunkCount() const { return _chunks.size(); }
+    const RecordingChunkInfo& chunk(size_t index) const { return _chunks[index]; }
+    int64_t firstTimeUs() const { return _chunks.empty() ? 0 : _chunks.front().firstTimeUs; }
+    int64_t lastTimeUs() const { return _chunks.empty() ? 0 : _chunks.back().lastTimeUs; }
+    // 某块某列的压缩字节数（读块头）
+    uint32_t columnBytes(size_t chunk, uint8_t column) const;
+    // 校验一块的CRC（读取路径只做边界检查，不校验CRC，以免触及未选的列）
+    bool verifyChunk(size_t index) const;
+
+    // 第一个时间不早于timeUs的行号（都更早时返回rows()）：二分查找索引，再只解码一块的时间列
+    uint64_t seek(int64_t timeUs) const;
+    // 解码一块的指定列（columns为1<<RecordingColumn的组合，未选的列不解码、内容未定义）
+    bool readChunk(size_t index, uint32_t columns, std::vector<RecordingRow>& rows) const;
+    // 行号区间[firstRow, firstRow+count)，返回实际读到的行数
+    size_t read(uint64_t firstRow, size_t count, uint32_t columns, std::vector<RecordingRow>& rows) const;
+
+private:
+    bool loadIndex();
+    bool recoverIndex();
+    size_t chunkForRow(uint64_t row) const;
+
+    const uint8_t* _data;
+    size_t _size;
+    uint32_t _chunkRows;
+    uint64_t _rows;
+    uint64_t _dataEnd;
+    bool _recovered;
+    uint8_t _columnCount;       // 文件的列数（新版本追加的列旧读取端跳过）
+    uint16_t _headerSize;
+    std::vector<RecordingChunkInfo> _chunks;
+};
+
+#endif
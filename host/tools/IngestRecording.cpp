@@ -0,0 +1,198 @@
+#include "IngestRecording.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+namespace {
+const char* const STATE_NAMES[] = {"INHALE", "EXHALE", "PEAK", "TROUGH"};
+const char* const STATE_NAMES_ZH[] = {"吸气", "呼气", "峰值", "谷值"};
+const char INGEST_HEADER[] = "主机时刻";
+const char SERVER_PP_HEADER[] = "时间戳";
+constexpr size_t INGEST_FIELDS = 13;
+
+bool startsWith(const char* line, size_t len, const char* prefix) {
+    size_t n = strlen(prefix);
+    return len >= n && memcmp(line, prefix, n) == 0;
+}
+
+// 按逗号切分，字段指向原行（行以'\0'结尾，strtod在逗号处停下）
+size_t splitFields(const char* line, size_t len, const char** fields, size_t* lengths, size_t maxFields) {
+    size_t n = 0;
+    const char* p = line;
+    const char* end = line + len;
+    while (n < maxFields) {
+        const char* comma = static_cast<const char*>(memchr(p, ',', (size_t)(end - p)));
+        const char* fieldEnd = comma ? comma : end;
+        fields[n] = p;
+        lengths[n] = (size_t)(fieldEnd - p);
+        n++;
+        if (!comma) return n;
+        p = comma + 1;
+    }
+    return n + 1;   // 字段过多
+}
+
+// 空字段为NAN
+bool parseFloat(const char* field, size_t len, float& value) {
+    if (len == 0) {
+        value = NAN;
+        return true;
+    }
+    char* end;
+    double v = strtod(field, &end);
+    if (end != field + len) return false;
+    value = (float)v;
+    return true;
+}
+
+bool parseUnsigned(const char* field, size_t len, uint64_t& value) {
+    if (len == 0) return false;
+    char* end;
+    value = strtoull(field, &end, 0);
+    return end == field + len;
+}
+
+bool parseState(const char* field, size_t len, uint8_t& state) {
+    for (uint8_t i = 0; i < 4; i++) {
+        if ((strlen(STATE_NAMES[i]) == len && memcmp(STATE_NAMES[i], field, len) == 0) ||
+            (strlen(STATE_NAMES_ZH[i]) == len && memcmp(STATE_NAMES_ZH[i], field, len) == 0)) {
+            state = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Server_pp.py的主机时刻（本地时间，秒）
+bool parseDateTime(const char* field, size_t len, int64_t& hostUs) {
+    struct tm tm = {};
+    int consumed = 0;
+    if (sscanf(field, "%d-%d-%d %d:%d:%d%n", &tm.tm_year, &tm.tm_mon, &tm.tm_mday, &tm.tm_hour, &tm.tm_min,
+               &tm.tm_sec, &consumed) != 6 || (size_t)consumed != len) {
+        return false;
+    }
+    tm.tm_year -= 1900;
+    tm.tm_mon -= 1;
+    tm.tm_isdst = -1;
+    time_t t = mktime(&tm);
+    if (t == (time_t)-1) return false;
+    hostUs = (int64_t)t * 1000000;
+    return true;
+}
+
+CsvLogFormat detectFormat(const char* line, size_t len) {
+    const char* fields[INGEST_FIELDS + 1];
+    size_t lengths[INGEST_FIELDS + 1];
+    size_t n = splitFields(line, len, fields, lengths, INGEST_FIELDS + 1);
+    if (n == INGEST_FIELDS) return CSV_LOG_INGEST;
+    if (n >= 1 && memchr(fields[0], '-', lengths[0]) && memchr(fields[0], ':', lengths[0])) return CSV_LOG_SERVER_PP;
+    return CSV_LOG_FIRMWARE;
+}
+}
+
+const char* csvLogFormatName(CsvLogFormat format) {
+    switch (format) {
+    case CSV_LOG_INGEST: return "接收服务录制";
+    case CSV_LOG_SERVER_PP: return "Server_pp.py日志";
+    case CSV_LOG_FIRMWARE: return "固件文本行";
+    default: return "未知";
+    }
+}
+
+RecordingRow ingestRecordingRow(const IngestSample& s, int64_t timeUs) {
+    RecordingRow r;
+    r.timeUs = timeUs;
+    r.seq = s.seq;
+    r.pressureKpa = s.pressureKpa;
+    r.backupPressureKpa = s.backupPressureKpa;
+    r.flowRate = s.flowRate;
+    r.temperatureC = s.temperatureC;
+    r.co2Ppm = s.co2Ppm;
+    r.oxygenPercent = s.oxygenPercent;
+    r.valveFraction = s.valveFraction;
+    r.state = s.state;
+    r.flags = s.flags;
+    r.windowCount = s.windowCount;
+    return r;
+}
+
+bool parseIngestCsvLine(const char* line, size_t len, IngestSample& s) {
+    const char* f[INGEST_FIELDS + 1];
+    size_t l[INGEST_FIELDS + 1];
+    if (splitFields(line, len, f, l, INGEST_FIELDS + 1) != INGEST_FIELDS) return false;
+    uint64_t hostUs, deviceUs, seq, flags, windowCount;
+    if (!parseUnsigned(f[0], l[0], hostUs) || !parseUnsigned(f[1], l[1], deviceUs) || !parseUnsigned(f[2], l[2], seq) ||
+        !parseFloat(f[3], l[3], s.pressureKpa) || !parseFloat(f[4], l[4], s.backupPressureKpa) ||
+        !parseFloat(f[5], l[5], s.flowRate) || !parseFloat(f[6], l[6], s.temperatureC) ||
+        !parseFloat(f[7], l[7], s.co2Ppm) || !parseFloat(f[8], l[8], s.oxygenPercent) ||
+        !parseFloat(f[9], l[9], s.valveFraction) || !parseState(f[10], l[10], s.state) ||
+        !parseUnsigned(f[11], l[11], flags) || !parseUnsigned(f[12], l[12], windowCount)) {
+        return false;
+    }
+    s.hostUs = hostUs;
+    s.deviceUs = (uint32_t)deviceUs;
+    s.seq = (uint32_t)seq;
+    s.flags = (uint8_t)flags;
+    s.windowCount = (uint8_t)windowCount;
+    return true;
+}
+
+bool importCsvLog(FILE* in, RecordingWriter& writer, CsvImportStats& stats) {
+    stats = CsvImportStats();
+    RecordingTimeline timeline;
+    uint32_t textSeq = 0;
+    char* line = nullptr;
+    size_t capacity = 0;
+    ssize_t n;
+    bool ok = true;
+    while (ok && (n = getline(&line, &capacity, in)) >= 0) {
+        size_t len = (size_t)n;
+        while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r')) line[--len] = '\0';
+        if (len == 0) continue;
+        stats.lines++;
+        // 表头（拼接的日志中间也可能出现）
+        if (startsWith(line, len, INGEST_HEADER)) {
+            if (stats.format == CSV_LOG_UNKNOWN) stats.format = CSV_LOG_INGEST;
+            continue;
+        }
+        if (startsWith(line, len, SERVER_PP_HEADER)) {
+            if (stats.format == CSV_LOG_UNKNOWN) stats.format = CSV_LOG_SERVER_PP;
+            continue;
+        }
+        if (stats.format == CSV_LOG_UNKNOWN) stats.format = detectFormat(line, len);
+
+        IngestSample s;
+        int64_t timeUs;
+        if (stats.format == CSV_LOG_INGEST) {
+            if (!parseIngestCsvLine(line, len, s)) {
+                stats.badLines++;
+                continue;
+            }
+            timeUs = timeline.map((int64_t)s.hostUs, s.deviceUs);
+        } else if (stats.format == CSV_LOG_SERVER_PP) {
+            const char* comma = static_cast<const char*>(memchr(line, ',', len));
+            int64_t hostUs;
+            if (!comma || !parseDateTime(line, (size_t)(comma - line), hostUs) ||
+                !IngestStream::parseLine(comma + 1, len - (size_t)(comma + 1 - line), s)) {
+                stats.badLines++;
+                continue;
+            }
+            s.seq = textSeq++;
+            timeUs = timeline.map(hostUs, s.deviceUs);
+        } else {
+            if (!IngestStream::parseLine(line, len, s)) {
+                stats.badLines++;
+                continue;
+            }
+            s.seq = textSeq++;
+            timeUs = timeline.unwrap(s.deviceUs);
+        }
+        ok = writer.append(ingestRecordingRow(s, timeUs));
+        stats.rows++;
+    }
+    free(line);
+    stats.reanchors = timeline.reanchors();
+    return ok;
+}
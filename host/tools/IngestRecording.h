@@ -0,0 +1,39 @@
+#ifndef IngestRecording_h
+#define IngestRecording_h
+
+// 接收样本写入列式录制（ColumnarRecording.h），以及已有CSV日志的导入。CSV格式按表头或首行判断：
+//   接收服务录制（telemetry_ingest --dir）: 主机时刻(Unix us),设备时间戳(us),样本序号,压力,备用压力,流量,
+//       温度,CO2,氧浓度,气阀开度,呼吸状态,标志,窗口样本数
+//   Server_pp.py的respiratory_data.csv: YYYY-MM-DD HH:MM:SS,millis,压力,温度,气阀开度,呼吸状态
+//       （主机时刻为本地时间，只到秒；表头少一列）
+//   固件文本行（串口输出或TCP抓包）: millis,压力,温度,气阀开度,呼吸状态
+// 时间轴由RecordingTimeline按设备时间戳推进、主机时刻锚定；没有主机时刻的固件文本行从设备时间展开。
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "ColumnarRecording.h"
+#include "IngestStream.h"
+
+enum CsvLogFormat : uint8_t { CSV_LOG_UNKNOWN, CSV_LOG_INGEST, CSV_LOG_SERVER_PP, CSV_LOG_FIRMWARE };
+
+struct CsvImportStats {
+    CsvLogFormat format;
+    uint64_t lines;             // 非空行（含表头）
+    uint64_t rows;
+    uint64_t badLines;          // 字段不全或数值无法解析
+    uint32_t reanchors;         // 时间轴按主机时刻重新锚定（设备重启、断线）
+};
+
+const char* csvLogFormatName(CsvLogFormat format);
+
+RecordingRow ingestRecordingRow(const IngestSample& sample, int64_t timeUs);
+
+// 解析接收服务录制的一行（不含换行）
+bool parseIngestCsvLine(const char* line, size_t len, IngestSample& sample);
+
+// 逐行导入到已打开的writer（不关闭），写入失败返回false
+bool importCsvLog(FILE* in, RecordingWriter& writer, CsvImportStats& stats);
+
+#endif
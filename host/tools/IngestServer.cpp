@@ -0,0 +1,311 @@
+#include "IngestServer.h"
+
+#include <arpa/inet.h>
+#include <chrono>
+#include <errno.h>
+#include <math.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "IngestRecording.h"
+
+namespace {
+const char* const STATE_NAMES[] = {"吸气", "呼气", "峰值", "谷值"};
+constexpr int MAX_EVENTS = 64;
+constexpr size_t RECORDING_BUFFER = 1 << 18;
+
+void writeValue(FILE* f, float v, int digits) {
+    if (isnan(v)) fputc(',', f);
+    else fprintf(f, ",%.*f", digits, v);
+}
+
+void addStats(IngestServerStats& total, const IngestStreamStats& s) {
+    total.bytes += s.bytes;
+    total.samples += s.samples;
+    total.badLines += s.badLines;
+    total.longLines += s.longLines;
+    total.crcErrors += s.crcErrors;
+    total.duplicateFrames += s.duplicateFrames;
+}
+}
+
+// 一个TCP连接：字节流重组状态属于连接，统计和样本归入设备
+struct IngestConnection {
+    int fd;
+    IngestDevice* device;
+    IngestStream stream;
+};
+
+// ---------------- 环形缓冲 ----------------
+
+SampleRing::SampleRing(size_t capacity) : _head(0) {
+    size_t n = 1;
+    while (n < capacity) n <<= 1;
+    _buffer.resize(n);
+    _mask = n - 1;
+}
+
+size_t SampleRing::latest(IngestSample* out, size_t n) const {
+    if (n > size()) n = size();
+    uint64_t start = _head - n;
+    for (size_t i = 0; i < n; i++) out[i] = _buffer[(start + i) & _mask];
+    return n;
+}
+
+// ---------------- 接收服务 ----------------
+
+IngestServer::IngestServer()
+    : _epollFd(-1), _tcpFd(-1), _udpFd(-1), _tcpPort(0), _udpPort(0), _ringCapacity(INGEST_DEFAULT_RING),
+      _recordingFormat(INGEST_RECORD_CSV), _sampleCallback(nullptr), _sampleContext(nullptr), _recvBuffer(INGEST_RECV_BUFFER), _totalConnections(0),
+      _udpDatagrams(0), _recordingErrors(0), _lastFlushUs(0) {}
+
+IngestServer::~IngestServer() {
+    close();
+}
+
+// 录制文件按墙上时间对齐多台设备，用系统时钟
+uint64_t IngestServer::hostNowUs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+bool IngestServer::openSocket(int type, uint16_t port, bool loopbackOnly, int& fd, uint16_t& boundPort) {
+    if (_epollFd < 0) _epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (_epollFd < 0) return false;
+    fd = socket(AF_INET, type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (type == SOCK_DGRAM) {
+        int rcvbuf = 1 << 20;
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    }
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(loopbackOnly ? INADDR_LOOPBACK : INADDR_ANY);
+    addr.sin_port = htons(port);
+    socklen_t len = sizeof(addr);
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.ptr = &fd;
+    if (bind(fd, (struct sockaddr*)&addr, len) != 0 || (type == SOCK_STREAM && listen(fd, SOMAXCONN) != 0) ||
+        getsockname(fd, (struct sockaddr*)&addr, &len) != 0 || epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    boundPort = ntohs(addr.sin_port);
+    return true;
+}
+
+bool IngestServer::listenTcp(uint16_t port, bool loopbackOnly) {
+    return _tcpFd < 0 && openSocket(SOCK_STREAM, port, loopbackOnly, _tcpFd, _tcpPort);
+}
+
+bool IngestServer::listenUdp(uint16_t port, bool loopbackOnly) {
+    return _udpFd < 0 && openSocket(SOCK_DGRAM, port, loopbackOnly, _udpFd, _udpPort);
+}
+
+void IngestServer::close() {
+    while (!_connections.empty()) closeConnection(_connections.begin()->second.get());
+    if (_tcpFd >= 0) ::close(_tcpFd);
+    if (_udpFd >= 0) ::close(_udpFd);
+    if (_epollFd >= 0) ::close(_epollFd);
+    _tcpFd = _udpFd = _epollFd = -1;
+    _tcpPort = _udpPort = 0;
+    for (auto& d : _devices) {
+        if (d.second->recording) fclose(d.second->recording);
+        d.second->recording = nullptr;
+        if (d.second->columnar) d.second->columnar->close();
+        d.second->columnar.reset();
+    }
+}
+
+int IngestServer::poll(int timeoutMs) {
+    if (_epollFd < 0) return -1;
+    struct epoll_event events[MAX_EVENTS];
+    int n = epoll_wait(_epollFd, events, MAX_EVENTS, timeoutMs);
+    if (n < 0) return errno == EINTR ? 0 : -1;
+    for (int i = 0; i < n; i++) {
+        void* tag = events[i].data.ptr;
+        if (tag == &_tcpFd) acceptConnections();
+        else if (tag == &_udpFd) readDatagrams();
+        else readConnection(static_cast<IngestConnection*>(tag));
+    }
+    uint64_t now = hostNowUs();
+    if (now - _lastFlushUs >= INGEST_FLUSH_INTERVAL_US) {
+        _lastFlushUs = now;
+        flushRecordings();
+    }
+    return n;
+}
+
+void IngestServer::acceptConnections() {
+    while (true) {
+        struct sockaddr_in peer = {};
+        socklen_t len = sizeof(peer);
+        int fd = accept4(_tcpFd, (struct sockaddr*)&peer, &len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+        std::unique_ptr<IngestConnection> c(new IngestConnection());
+        c->fd = fd;
+        c->device = device(peer.sin_addr.s_addr);
+        c->stream.setCallback(onSample, c->device);
+        c->stream.setStats(&c->device->stats);
+        c->stream.setDeduplicator(&c->device->dedup);
+        struct epoll_event ev = {};
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.ptr = c.get();
+        if (epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            ::close(fd);
+            continue;
+        }
+        c->device->connections++;
+        c->device->activeConnections++;
+        _totalConnections++;
+        _connections[fd] = std::move(c);
+    }
+}
+
+void IngestServer::readConnection(IngestConnection* c) {
+    // 水平触发：一轮读不完的留到下一次epoll_wait()，各连接轮流
+    for (int i = 0; i < INGEST_MAX_READS; i++) {
+        ssize_t n = recv(c->fd, _recvBuffer.data(), _recvBuffer.size(), 0);
+        if (n > 0) {
+            c->stream.setHostTime(hostNowUs());
+            c->stream.feed(_recvBuffer.data(), (size_t)n);
+            if ((size_t)n < _recvBuffer.size()) return;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+            return;
+        } else {
+            closeConnection(c);
+            return;
+        }
+    }
+}
+
+void IngestServer::readDatagrams() {
+    for (int i = 0; i < MAX_EVENTS; i++) {
+        struct sockaddr_in peer = {};
+        socklen_t len = sizeof(peer);
+        ssize_t n = recvfrom(_udpFd, _recvBuffer.data(), _recvBuffer.size(), 0, (struct sockaddr*)&peer, &len);
+        if (n < 0) return;
+        _udpDatagrams++;
+        IngestDevice* d = device(peer.sin_addr.s_addr);
+        // 每个数据报是一个完整帧，不与前后数据报拼接
+        d->udpStream.setHostTime(hostNowUs());
+        d->udpStream.feed(_recvBuffer.data(), (size_t)n);
+        d->udpStream.reset();
+    }
+}
+
+void IngestServer::closeConnection(IngestConnection* c) {
+    int fd = c->fd;
+    epoll_ctl(_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    c->device->activeConnections--;
+    _connections.erase(fd);
+}
+
+IngestDevice* IngestServer::device(uint32_t addr) {
+    char name[INET_ADDRSTRLEN];
+    struct in_addr in = {};
+    in.s_addr = addr;
+    inet_ntop(AF_INET, &in, name, sizeof(name));
+    std::unique_ptr<IngestDevice>& d = _devices[name];
+    if (d) return d.get();
+
+    d.reset(new IngestDevice(name, _ringCapacity));
+    d->server = this;
+    d->udpStream.setCallback(onSample, d.get());
+    d->udpStream.setStats(&d->stats);
+    d->udpStream.setDeduplicator(&d->dedup);
+    if (!_recordingDir.empty() && _recordingFormat == INGEST_RECORD_COLUMNAR) {
+        d->columnar.reset(new RecordingWriter());
+        if (!d->columnar->open(_recordingDir + "/" + name + ".rec")) {
+            d->columnar.reset();
+            _recordingErrors++;
+        }
+    } else if (!_recordingDir.empty()) {
+        std::string path = _recordingDir + "/" + name + ".csv";
+        d->recording = fopen(path.c_str(), "a");
+        if (!d->recording) {
+            _recordingErrors++;
+        } else {
+            setvbuf(d->recording, nullptr, _IOFBF, RECORDING_BUFFER);
+            fseek(d->recording, 0, SEEK_END);
+            if (ftell(d->recording) == 0) {
+                fputs("主机时刻(Unix us),设备时间戳(us),样本序号,压力(kPa),备用压力(kPa),流量(ml/min),温度(°C),CO2(ppm),"
+                      "氧浓度(%),气阀开度,呼吸状态,标志,窗口样本数\n", d->recording);
+            }
+        }
+    }
+    return d.get();
+}
+
+void IngestServer::onSample(void* context, const IngestSample& sample) {
+    IngestDevice* d = static_cast<IngestDevice*>(context);
+    d->ring.push(sample);
+    d->lastHostUs = sample.hostUs;
+    if (d->recording || d->columnar) d->server->record(d, sample);
+    if (d->server->_sampleCallback) d->server->_sampleCallback(d->server->_sampleContext, *d, sample);
+}
+
+void IngestServer::record(IngestDevice* d, const IngestSample& s) {
+    if (d->columnar) {
+        d->columnar->append(ingestRecordingRow(s, d->timeline.map((int64_t)s.hostUs, s.deviceUs)));
+        d->recordedSamples++;
+        return;
+    }
+    FILE* f = d->recording;
+    fprintf(f, "%llu,%u,%u", (unsigned long long)s.hostUs, s.deviceUs, s.seq);
+    writeValue(f, s.pressureKpa, 4);
+    writeValue(f, s.backupPressureKpa, 4);
+    writeValue(f, s.flowRate, 1);
+    writeValue(f, s.temperatureC, 2);
+    writeValue(f, s.co2Ppm, 0);
+    writeValue(f, s.oxygenPercent, 2);
+    writeValue(f, s.valveFraction, 4);
+    fprintf(f, ",%s,0x%02X,%u\n", s.state < 4 ? STATE_NAMES[s.state] : "?", s.flags, s.windowCount);
+    d->recordedSamples++;
+}
+
+void IngestServer::flushRecordings() {
+    for (auto& d : _devices) {
+        if (d.second->recording) fflush(d.second->recording);
+    }
+}
+
+IngestServerStats IngestServer::stats() const {
+    IngestServerStats s = {};
+    s.devices = (uint32_t)_devices.size();
+    s.connections = _totalConnections;
+    s.activeConnections = (uint32_t)_connections.size();
+    s.udpDatagrams = _udpDatagrams;
+    s.recordingErrors = _recordingErrors;
+    for (auto& d : _devices) {
+        addStats(s, d.second->stats);
+        s.recordedSamples += d.second->recordedSamples;
+    }
+    return s;
+}
+
+void IngestServer::printStats(FILE* out) const {
+    IngestServerStats s = stats();
+    fprintf(out, "设备 %u, 连接 %u（当前 %u）, UDP数据报 %u, 接收 %.1f MB, 样本 %llu, 录制 %llu\n", s.devices,
+            s.connections, s.activeConnections, s.udpDatagrams, s.bytes / 1048576.0, (unsigned long long)s.samples,
+            (unsigned long long)s.recordedSamples);
+    if (s.badLines || s.longLines || s.crcErrors || s.duplicateFrames || s.recordingErrors) {
+        fprintf(out, "无效行 %u, 超长行 %u, CRC错误 %u, 重复帧 %u, 录制文件打开失败 %u\n", s.badLines, s.longLines,
+                s.crcErrors, s.duplicateFrames, s.recordingErrors);
+    }
+    for (auto& entry : _devices) {
+        const IngestDevice& d = *entry.second;
+        const IngestStreamStats& ds = d.stats;
+        fprintf(out, "  %-15s 连接 %u（当前 %u）, 样本 %u（窗口 %u）, 呼吸 %u, 模式切换 %u, 缓冲 %zu/%zu\n",
+                d.name.c_str(), d.connections, d.activeConnections, ds.samples, ds.windows, ds.breaths,
+                ds.modeChanges, d.ring.size(), d.ring.capacity());
+    }
+}
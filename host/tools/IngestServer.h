@@ -0,0 +1,148 @@
+#ifndef IngestServer_h
+#define IngestServer_h
+
+// 主机端遥测接收服务（替代Server_pp.py的接收部分）：单线程epoll同时服务多台设备的
+// TCP连接和UDP数据报，全部套接字非阻塞。设备按来源IP区分，同一设备的重连和UDP帧
+// 计入同一份环形缓冲、录制文件和去重器。每个连接各有一个IngestStream重组半行/半帧。
+//   环形缓冲: 每设备最近N个样本（默认65536，200Hz下约5分钟），追加O(1)，满时覆盖最旧的
+//   录制: --dir 目录下每设备一个CSV文件（<IP>.csv，追加写入，带缓冲，每秒落盘一次），
+//         或列式录制文件（<IP>.rec，ColumnarRecording.h，按块写入，关闭时写索引）
+
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "ColumnarRecording.h"
+#include "IngestStream.h"
+#include "TelemetryDeduplicator.h"
+
+constexpr size_t INGEST_DEFAULT_RING = 65536;
+constexpr size_t INGEST_RECV_BUFFER = 65536;
+constexpr int INGEST_MAX_READS = 8;              // 每次就绪每连接最多读几次，避免一台设备占满一轮
+constexpr uint64_t INGEST_FLUSH_INTERVAL_US = 1000000;
+
+enum IngestRecordingFormat : uint8_t { INGEST_RECORD_CSV, INGEST_RECORD_COLUMNAR };
+
+// 每设备最近样本的环形缓冲：容量取2的幂
+class SampleRing {
+public:
+    explicit SampleRing(size_t capacity);
+
+    void push(const IngestSample& sample) { _buffer[_head++ & _mask] = sample; }
+    size_t size() const { return _head < _buffer.size() ? (size_t)_head : _buffer.size(); }
+    size_t capacity() const { return _buffer.size(); }
+    uint64_t total() const { return _head; }
+    // 最近n个样本按时间顺序复制到out，返回实际个数
+    size_t latest(IngestSample* out, size_t n) const;
+
+private:
+    std::vector<IngestSample> _buffer;
+    size_t _mask;
+    uint64_t _head;
+};
+
+class IngestServer;
+
+struct IngestDevice {
+    IngestDevice(const std::string& deviceName, size_t ringCapacity) : name(deviceName), ring(ringCapacity) {}
+
+    IngestServer* server = nullptr;
+    std::string name;           // 来源IP
+    SampleRing ring;
+    TelemetryDeduplicator dedup;
+    IngestStreamStats stats = {};
+    IngestStream udpStream;     // UDP数据报各自成帧，共用一个解析器
+    FILE* recording = nullptr;
+    std::unique_ptr<RecordingWriter> columnar;
+    RecordingTimeline timeline;
+    uint64_t recordedSamples = 0;
+    uint32_t connections = 0;   // 累计连接次数
+    uint32_t activeConnections = 0;
+    uint64_t lastHostUs = 0;
+};
+
+struct IngestServerStats {
+    uint32_t devices;
+    uint32_t connections;       // 累计接受的TCP连接
+    uint32_t activeConnections;
+    uint32_t udpDatagrams;
+    uint64_t bytes;
+    uint64_t samples;
+    uint32_t badLines;
+    uint32_t longLines;
+    uint32_t crcErrors;
+    uint32_t duplicateFrames;
+    uint64_t recordedSamples;
+    uint32_t recordingErrors;   // 无法打开录制文件
+};
+
+struct IngestConnection;
+
+class IngestServer {
+public:
+    IngestServer();
+    ~IngestServer();
+
+    // 在第一台设备出现之前设置
+    void setRingCapacity(size_t samples) { _ringCapacity = samples; }
+    // 录制目录（须已存在），空串不录制
+    void setRecordingDir(const std::string& dir) { _recordingDir = dir; }
+    void setRecordingFormat(IngestRecordingFormat format) { _recordingFormat = format; }
+    // 每个样本的回调（在poll()所在线程）
+    void setSampleCallback(void (*callback)(void* context, const IngestDevice& device, const IngestSample& sample),
+                           void* context) {
+        _sampleCallback = callback;
+        _sampleContext = context;
+    }
+
+    // port为0时绑定临时端口，用tcpPort()/udpPort()查询
+    bool listenTcp(uint16_t port, bool loopbackOnly = false);
+    bool listenUdp(uint16_t port, bool loopbackOnly = false);
+    uint16_t tcpPort() const { return _tcpPort; }
+    uint16_t udpPort() const { return _udpPort; }
+    void close();
+
+    // 等待最多timeoutMs毫秒并处理就绪的套接字，返回处理的事件数（出错返回-1）
+    int poll(int timeoutMs);
+    void flushRecordings();
+
+    const std::map<std::string, std::unique_ptr<IngestDevice>>& devices() const { return _devices; }
+    IngestServerStats stats() const;
+    void printStats(FILE* out) const;
+
+    static uint64_t hostNowUs();
+
+private:
+    bool openSocket(int type, uint16_t port, bool loopbackOnly, int& fd, uint16_t& boundPort);
+    void acceptConnections();
+    void readConnection(IngestConnection* connection);
+    void readDatagrams();
+    void closeConnection(IngestConnection* connection);
+    IngestDevice* device(uint32_t addr);
+    static void onSample(void* context, const IngestSample& sample);
+    void record(IngestDevice* device, const IngestSample& sample);
+
+    int _epollFd;
+    int _tcpFd;
+    int _udpFd;
+    uint16_t _tcpPort;
+    uint16_t _udpPort;
+    size_t _ringCapacity;
+    std::string _recordingDir;
+    IngestRecordingFormat _recordingFormat;
+    void (*_sampleCallback)(void*, const IngestDevice&, const IngestSample&);
+    void* _sampleContext;
+
+    std::map<std::string, std::unique_ptr<IngestDevice>> _devices;
+    std::map<int, std::unique_ptr<IngestConnection>> _connections;
+    std::vector<uint8_t> _recvBuffer;
+    uint32_t _totalConnections;
+    uint32_t _udpDatagrams;
+    uint32_t _recordingErrors;
+    uint64_t _lastFlushUs;
+};
+
+#endif
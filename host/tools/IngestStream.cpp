@@ -0,0 +1,226 @@
+#include "IngestStream.h"
+
+#include <math.h>
+#include <string.h>
+
+namespace {
+const char* const STATE_NAMES[] = {"INHALE", "EXHALE", "PEAK", "TROUGH"};
+const double POW10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+                        1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19};
+
+// 十进制定点数（固件String(float, n)的输出，或"nan"）。只在[p, end)内读取，
+// 不依赖结尾的'\0'，行可以直接在接收缓冲区里解析
+bool parseNumber(const char*& p, const char* end, double& out) {
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+    if (end - p >= 3 && p[0] == 'n' && p[1] == 'a' && p[2] == 'n') {
+        p += 3;
+        out = NAN;
+        return true;
+    }
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int scale = 0;              // 正数为小数位数，负数为舍去的整数位数
+    while (p < end && *p >= '0' && *p <= '9') {
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+            digits++;
+        } else {
+            scale--;
+        }
+        p++;
+    }
+    bool fraction = p < end && *p == '.';
+    if (fraction) {
+        p++;
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+                digits++;
+                scale++;
+            }
+            p++;
+        }
+    }
+    if (digits == 0 || scale < 0) return false;
+    out = (double)mantissa / POW10[scale];
+    if (negative) out = -out;
+    return true;
+}
+
+bool parseField(const char*& p, const char* end, double& out) {
+    if (!parseNumber(p, end, out) || p >= end || *p != ',') return false;
+    p++;
+    return true;
+}
+}
+
+IngestStream::IngestStream()
+    : _callback(nullptr), _context(nullptr), _stats(&_ownStats), _dedup(nullptr), _hostUs(0),
+      _format(INGEST_UNKNOWN), _lineLength(0), _discarding(false), _textSeq(0), _frameAccepted(true) {
+    memset(&_ownStats, 0, sizeof(_ownStats));
+    _decoder.setCallback(onRecord, this);
+    _decoder.setFrameCallback(onFrame, this);
+    _decoder.setSummaryCallbacks(onWindow, onBreath, onMode, this);
+}
+
+void IngestStream::reset() {
+    _format = INGEST_UNKNOWN;
+    _lineLength = 0;
+    _discarding = false;
+    _decoder.resetStream();
+}
+
+void IngestStream::feed(const uint8_t* data, size_t len) {
+    if (len == 0) return;
+    _stats->bytes += len;
+    if (_format == INGEST_UNKNOWN) _format = data[0] == TELEMETRY_SYNC_0 ? INGEST_BINARY : INGEST_TEXT;
+    if (_format == INGEST_TEXT) {
+        feedText(data, len);
+        return;
+    }
+    uint32_t crcErrors = _decoder.stats().crcErrors;
+    _decoder.feed(data, len);
+    _stats->crcErrors += _decoder.stats().crcErrors - crcErrors;
+}
+
+void IngestStream::feedText(const uint8_t* data, size_t len) {
+    while (len > 0) {
+        const uint8_t* newline = (const uint8_t*)memchr(data, '\n', len);
+        size_t n = newline ? (size_t)(newline - data) : len;
+        if (_discarding) {
+            if (!newline) return;
+            _discarding = false;
+        } else if (_lineLength == 0 && newline) {
+            // 完整的行直接在接收缓冲区里解析
+            processLine((const char*)data, n);
+        } else if (_lineLength + n > INGEST_MAX_LINE) {
+            _stats->longLines++;
+            _lineLength = 0;
+            _discarding = !newline;
+        } else {
+            memcpy(_line + _lineLength, data, n);
+            _lineLength += n;
+            if (!newline) return;
+            processLine(_line, _lineLength);
+            _lineLength = 0;
+        }
+        if (!newline) return;
+        data += n + 1;
+        len -= n + 1;
+    }
+}
+
+void IngestStream::processLine(const char* line, size_t len) {
+    while (len > 0 && (line[len - 1] == '\r' || line[len - 1] == ' ')) len--;
+    if (len == 0) return;
+    if (len > INGEST_MAX_LINE) {
+        _stats->longLines++;
+        return;
+    }
+    _stats->lines++;
+    IngestSample sample;
+    if (!parseLine(line, len, sample)) {
+        _stats->badLines++;
+        return;
+    }
+    sample.seq = _textSeq++;
+    emit(sample);
+}
+
+bool IngestStream::parseLine(const char* line, size_t len, IngestSample& sample) {
+    const char* p = line;
+    const char* end = line + len;
+    double millis, pressure, temperature, valve;
+    if (!parseField(p, end, millis) || !parseField(p, end, pressure) || !parseField(p, end, temperature) ||
+        !parseField(p, end, valve)) {
+        return false;
+    }
+    // 设备millis()为32位无符号数；负数、NAN或超出范围的值直接转整数是未定义行为
+    if (!(millis >= 0 && millis <= (double)UINT32_MAX)) return false;
+    size_t nameLength = (size_t)(end - p);
+    uint8_t state = 0xFF;
+    for (uint8_t i = 0; i < 4; i++) {
+        if (strlen(STATE_NAMES[i]) == nameLength && memcmp(STATE_NAMES[i], p, nameLength) == 0) state = i;
+    }
+    if (state == 0xFF) return false;
+
+    sample.hostUs = 0;
+    sample.deviceUs = (uint32_t)((uint64_t)millis * 1000);
+    sample.seq = 0;
+    sample.pressureKpa = (float)pressure;
+    sample.backupPressureKpa = NAN;
+    sample.flowRate = NAN;
+    sample.temperatureC = (float)temperature;
+    sample.co2Ppm = NAN;
+    sample.oxygenPercent = NAN;
+    sample.valveFraction = (float)valve;
+    sample.state = state;
+    sample.flags = 0;
+    sample.windowCount = 0;
+    return true;
+}
+
+void IngestStream::emit(IngestSample& sample) {
+    sample.hostUs = _hostUs;
+    _stats->samples++;
+    if (_callback) _callback(_context, sample);
+}
+
+// ---------------- 二进制帧 ----------------
+
+void IngestStream::onFrame(void* self, const TelemetryFrameHeader& header) {
+    IngestStream* s = static_cast<IngestStream*>(self);
+    s->_stats->frames++;
+    s->_frameAccepted = !s->_dedup || s->_dedup->accept(header);
+    if (!s->_frameAccepted) s->_stats->duplicateFrames++;
+}
+
+void IngestStream::onRecord(void* self, const TelemetryFrameHeader&, const TelemetryRecord& r) {
+    IngestStream* s = static_cast<IngestStream*>(self);
+    if (!s->_frameAccepted) return;
+    IngestSample sample;
+    sample.deviceUs = r.timestampUs;
+    sample.seq = r.seq;
+    sample.pressureKpa = r.pressureKpa;
+    sample.backupPressureKpa = r.backupPressureKpa;
+    sample.flowRate = r.flowRate;
+    sample.temperatureC = r.temperatureC;
+    sample.co2Ppm = r.co2Ppm;
+    sample.oxygenPercent = r.oxygenPercent;
+    sample.valveFraction = r.valveFraction;
+    sample.state = r.state;
+    sample.flags = r.flags;
+    sample.windowCount = 0;
+    s->emit(sample);
+}
+
+void IngestStream::onWindow(void* self, const TelemetryFrameHeader&, const TelemetryWindowRecord& w) {
+    IngestStream* s = static_cast<IngestStream*>(self);
+    if (!s->_frameAccepted) return;
+    s->_stats->windows++;
+    IngestSample sample;
+    sample.deviceUs = w.timestampUs;
+    sample.seq = w.firstSeq;
+    sample.pressureKpa = w.pressureMeanKpa;
+    sample.backupPressureKpa = w.backupPressureKpa;
+    sample.flowRate = w.flowRate;
+    sample.temperatureC = w.temperatureC;
+    sample.co2Ppm = w.co2Ppm;
+    sample.oxygenPercent = w.oxygenPercent;
+    sample.valveFraction = w.valveMean;
+    sample.state = w.state;
+    sample.flags = w.flags;
+    sample.windowCount = w.count;
+    s->emit(sample);
+}
+
+void IngestStream::onBreath(void* self, const TelemetryFrameHeader&, const TelemetryBreathRecord&) {
+    IngestStream* s = static_cast<IngestStream*>(self);
+    if (s->_frameAccepted) s->_stats->breaths++;
+}
+
+void IngestStream::onMode(void* self, const TelemetryFrameHeader&, const TelemetryModeChange&) {
+    IngestStream* s = static_cast<IngestStream*>(self);
+    if (s->_frameAccepted) s->_stats->modeChanges++;
+}
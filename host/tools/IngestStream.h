@@ -0,0 +1,104 @@
+#ifndef IngestStream_h
+#define IngestStream_h
+
+// 设备遥测流的重组与解析：TCP字节流可以在任意位置被切分，这里把一个连接上收到的字节
+// 重新组装成完整的文本行或二进制帧，逐样本回调。格式按连接的第一个字节判断：
+// 0xA5（帧同步字）为二进制帧（TelemetryProtocol.h），否则为固件的文本格式
+//   millis,压力(kPa),温度(°C),气阀开度,呼吸状态\r\n
+// 文本行收到'\n'才解析，跨包的半行留在缓冲中；超过INGEST_MAX_LINE的行不可能是合法数据，
+// 丢弃到下一个换行。二进制帧由TelemetryDecoder重组，按(bootId, frameSeq)去掉补发的重复帧。
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "TelemetryDeduplicator.h"
+#include "TelemetryProtocol.h"
+
+constexpr size_t INGEST_MAX_LINE = 256;
+
+enum IngestFormat : uint8_t { INGEST_UNKNOWN, INGEST_TEXT, INGEST_BINARY };
+
+// 统一的样本：文本行没有的字段为NAN
+struct IngestSample {
+    uint64_t hostUs;            // 主机收到该批字节的时刻（Unix时间，微秒）
+    uint32_t deviceUs;          // 设备时间戳（文本行为millis()*1000，32位回绕）
+    uint32_t seq;               // 样本序号（文本行没有序号，按到达顺序编号）
+    float pressureKpa;
+    float backupPressureKpa;
+    float flowRate;
+    float temperatureC;
+    float co2Ppm;
+    float oxygenPercent;
+    float valveFraction;
+    uint8_t state;              // BreathState：0吸气 1呼气 2峰值 3谷值
+    uint8_t flags;              // TELEMETRY_FLAG_*（文本行为0）
+    uint8_t windowCount;        // 降采样窗口记录的样本数（各字段为窗口平均值），原始样本为0
+};
+
+struct IngestStreamStats {
+    uint64_t bytes;
+    uint32_t lines;             // 完整文本行
+    uint32_t badLines;          // 字段不全或数值无法解析
+    uint32_t longLines;         // 超长而丢弃的行
+    uint32_t frames;            // CRC正确的二进制帧
+    uint32_t crcErrors;
+    uint32_t duplicateFrames;   // 补发/重发的重复帧（整帧跳过）
+    uint32_t samples;           // 回调的样本（含窗口记录）
+    uint32_t windows;
+    uint32_t breaths;
+    uint32_t modeChanges;
+};
+
+class IngestStream {
+public:
+    typedef void (*SampleCallback)(void* context, const IngestSample& sample);
+
+    IngestStream();
+
+    void setCallback(SampleCallback callback, void* context) { _callback = callback; _context = context; }
+    // 统计计入外部结构（同一设备的多个连接共用一份），默认计入自身
+    void setStats(IngestStreamStats* stats) { _stats = stats ? stats : &_ownStats; }
+    // 同一设备的各个连接（重连、UDP）共用一个去重器；不设置则不去重
+    void setDeduplicator(TelemetryDeduplicator* dedup) { _dedup = dedup; }
+    // 下一批字节的接收时刻
+    void setHostTime(uint64_t hostUs) { _hostUs = hostUs; }
+
+    void feed(const uint8_t* data, size_t len);
+    // 连接断开或数据报边界：丢弃半行/半帧，下一批字节重新判断格式
+    void reset();
+
+    IngestFormat format() const { return _format; }
+    const IngestStreamStats& stats() const { return *_stats; }
+
+    // 解析一行文本（不含换行），基准和离线导入共用
+    static bool parseLine(const char* line, size_t len, IngestSample& sample);
+
+private:
+    void feedText(const uint8_t* data, size_t len);
+    void processLine(const char* line, size_t len);
+    void emit(IngestSample& sample);
+
+    static void onFrame(void* self, const TelemetryFrameHeader& header);
+    static void onRecord(void* self, const TelemetryFrameHeader& header, const TelemetryRecord& record);
+    static void onWindow(void* self, const TelemetryFrameHeader& header, const TelemetryWindowRecord& record);
+    static void onBreath(void* self, const TelemetryFrameHeader& header, const TelemetryBreathRecord& record);
+    static void onMode(void* self, const TelemetryFrameHeader& header, const TelemetryModeChange& record);
+
+    SampleCallback _callback;
+    void* _context;
+    IngestStreamStats _ownStats;
+    IngestStreamStats* _stats;
+    TelemetryDeduplicator* _dedup;
+    uint64_t _hostUs;
+    IngestFormat _format;
+
+    char _line[INGEST_MAX_LINE];
+    size_t _lineLength;
+    bool _discarding;           // 超长行，丢弃到下一个换行
+    uint32_t _textSeq;
+
+    TelemetryDecoder _decoder;
+    bool _frameAccepted;
+};
+
+#endif
@@ -0,0 +1,64 @@
+#include "TelemetryDeduplicator.h"
+
+bool TelemetryDeduplicator::accept(const TelemetryFrameHeader& header) {
+    RangeSet& ranges = _boots[header.bootId];
+    uint32_t seq = header.frameSeq;
+
+    // 起点不大于seq的最后一个区间
+    RangeSet::iterator next = ranges.upper_bound(seq);
+    RangeSet::iterator prev = next;
+    if (prev != ranges.begin()) {
+        --prev;
+        if (seq <= prev->second) {
+            _duplicates++;
+            return false;
+        }
+    } else {
+        prev = ranges.end();
+    }
+
+    bool joinPrev = prev != ranges.end() && prev->second + 1 == seq;
+    bool joinNext = next != ranges.end() && next->first == seq + 1;
+    if (joinPrev && joinNext) {
+        prev->second = next->second;
+        ranges.erase(next);
+    } else if (joinPrev) {
+        prev->second = seq;
+    } else if (joinNext) {
+        uint32_t end = next->second;
+        ranges.erase(next);
+        ranges[seq] = end;
+    } else {
+        ranges[seq] = seq;
+    }
+
+    _frames++;
+    if (header.frameFlags & TELEMETRY_FRAME_BACKFILL) _backfillFrames++;
+    return true;
+}
+
+DedupStats TelemetryDeduplicator::stats() const {
+    DedupStats s = {};
+    s.frames = _frames;
+    s.duplicates = _duplicates;
+    s.backfillFrames = _backfillFrames;
+    s.boots = (uint32_t)_boots.size();
+    for (const auto& boot : _boots) {
+        uint32_t lastEnd = 0;
+        bool first = true;
+        for (const auto& range : boot.second) {
+            if (!first) {
+                s.missingFrames += range.first - lastEnd - 1;
+                s.gaps++;
+            }
+            first = false;
+            lastEnd = range.second;
+        }
+    }
+    return s;
+}
+
+void TelemetryDeduplicator::reset() {
+    _boots.clear();
+    _frames = _duplicates = _backfillFrames = 0;
+}
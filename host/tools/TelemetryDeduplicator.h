@@ -0,0 +1,39 @@
+#ifndef TelemetryDeduplicator_h
+#define TelemetryDeduplicator_h
+
+// 主机端遥测帧去重：设备断线时把帧存入闪存，重连后补发；掉电重启后闪存中
+// 尚未确认的帧可能再发一次。每帧由(bootId, frameSeq)唯一标识，这里按启动分别
+// 记录已收到的帧序号区间，重复帧丢弃，区间之间的空洞即最终未能送达的帧。
+// 实时帧与补发帧交错到达也能正确合并；区间表只在出现空洞时增长。
+
+#include <map>
+#include <stdint.h>
+
+#include "TelemetryProtocol.h"
+
+struct DedupStats {
+    uint32_t frames;            // 接受的帧（不含重复）
+    uint32_t duplicates;        // 丢弃的重复帧
+    uint32_t backfillFrames;    // 接受的帧中补发的部分
+    uint32_t boots;             // 出现过的bootId数
+    uint32_t missingFrames;     // 各启动内首帧到最大帧序号之间仍未收到的帧
+    uint32_t gaps;              // 空洞个数
+};
+
+class TelemetryDeduplicator {
+public:
+    // 新帧返回true，重复帧返回false
+    bool accept(const TelemetryFrameHeader& header);
+    DedupStats stats() const;
+    void reset();
+
+private:
+    // 每个启动：区间起点 -> 区间终点（含），区间互不相邻
+    typedef std::map<uint32_t, uint32_t> RangeSet;
+    std::map<uint16_t, RangeSet> _boots;
+    uint32_t _frames = 0;
+    uint32_t _duplicates = 0;
+    uint32_t _backfillFrames = 0;
+};
+
+#endif
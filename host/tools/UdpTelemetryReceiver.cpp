@@ -0,0 +1,183 @@
+#include "UdpTelemetryReceiver.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <chrono>
+#include <math.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// ---------------- 链路统计 ----------------
+
+TelemetryLinkMonitor::TelemetryLinkMonitor() : _clockSynced(false), _clockOffsetUs(0) {
+    reset();
+}
+
+void TelemetryLinkMonitor::reset() {
+    _hasFirst = false;
+    _firstSeq = _highestSeq = 0;
+    _uniqueFrames = _frames = _invalid = _reordered = _duplicates = _samples = _backfill = 0;
+    memset(_seen, 0, sizeof(_seen));
+    _minTransitUs = INT64_MAX;
+    _transitUs.clear();
+    _hasLastTransit = false;
+    _lastTransitUs = 0;
+    _jitterUs = 0;
+}
+
+void TelemetryLinkMonitor::setClockOffsetUs(int64_t offsetUs) {
+    _clockSynced = true;
+    _clockOffsetUs = offsetUs;
+}
+
+void TelemetryLinkMonitor::onFrame(const TelemetryFrameHeader& header, uint64_t recvUs) {
+    _frames++;
+    if (header.frameFlags & TELEMETRY_FRAME_BACKFILL) {
+        _backfill++;
+        return;
+    }
+    uint32_t seq = header.frameSeq;
+    uint64_t& word = _seen[(seq % WINDOW) / 64];
+    uint64_t bit = 1ull << (seq % 64);
+
+    if (!_hasFirst) {
+        _hasFirst = true;
+        _firstSeq = _highestSeq = seq;
+    } else {
+        int32_t ahead = (int32_t)(seq - _highestSeq);
+        if (ahead > 0) {
+            // 窗口前移：清除新进入窗口的序号
+            if ((uint32_t)ahead >= WINDOW) {
+                memset(_seen, 0, sizeof(_seen));
+            } else {
+                for (uint32_t s = _highestSeq + 1; s != seq + 1; s++) {
+                    _seen[(s % WINDOW) / 64] &= ~(1ull << (s % 64));
+                }
+            }
+            _highestSeq = seq;
+        } else if ((uint32_t)(-ahead) < WINDOW && (word & bit)) {
+            _duplicates++;
+            return;
+        } else if ((int32_t)(seq - _firstSeq) < 0) {
+            // 比首帧还早（首帧本身迟到）：起点前移
+            _firstSeq = seq;
+            _reordered++;
+        } else {
+            _reordered++;
+        }
+    }
+    word |= bit;
+    _uniqueFrames++;
+    _samples += header.recordCount;
+
+    // 设备时钟为32位微秒，按差值取模计算，跨回绕也连续
+    uint32_t hostUs = (uint32_t)(recvUs - (uint64_t)_clockOffsetUs);
+    int64_t transit = (int32_t)(hostUs - header.sendTimeUs);
+    _transitUs.push_back(transit);
+    if (transit < _minTransitUs) _minTransitUs = transit;
+    if (_hasLastTransit) {
+        double d = fabs((double)(transit - _lastTransitUs));
+        _jitterUs += (d - _jitterUs) / 16.0;
+    }
+    _hasLastTransit = true;
+    _lastTransitUs = transit;
+}
+
+LinkQualityStats TelemetryLinkMonitor::stats() const {
+    LinkQualityStats s = {};
+    s.frames = _frames;
+    s.invalid = _invalid;
+    s.expected = _hasFirst ? _highestSeq - _firstSeq + 1 : 0;
+    s.lost = s.expected > _uniqueFrames ? s.expected - _uniqueFrames : 0;
+    s.reordered = _reordered;
+    s.duplicates = _duplicates;
+    s.samples = _samples;
+    s.backfill = _backfill;
+    s.lossPercent = s.expected ? 100.0f * s.lost / s.expected : 0;
+    s.clockSynced = _clockSynced;
+    s.jitterMs = (float)(_jitterUs / 1000.0);
+    if (!_transitUs.empty()) {
+        std::vector<int64_t> sorted(_transitUs);
+        std::sort(sorted.begin(), sorted.end());
+        int64_t zero = _clockSynced ? 0 : _minTransitUs;
+        double sum = 0;
+        for (int64_t t : sorted) sum += (double)(t - zero);
+        s.meanLatencyMs = (float)(sum / sorted.size() / 1000.0);
+        s.p50LatencyMs = (sorted[sorted.size() / 2] - zero) / 1000.0f;
+        s.p99LatencyMs = (sorted[(sorted.size() - 1) * 99 / 100] - zero) / 1000.0f;
+        s.maxLatencyMs = (sorted.back() - zero) / 1000.0f;
+    }
+    return s;
+}
+
+// ---------------- UDP接收端 ----------------
+
+UdpTelemetryReceiver::UdpTelemetryReceiver() : _fd(-1), _port(0), _bytes(0), _recvUs(0) {
+    _decoder.setFrameCallback(onFrame, this);
+}
+
+UdpTelemetryReceiver::~UdpTelemetryReceiver() {
+    close();
+}
+
+uint64_t UdpTelemetryReceiver::hostNowUs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool UdpTelemetryReceiver::open(uint16_t port, bool loopbackOnly) {
+    close();
+    _fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (_fd < 0) return false;
+    // 加大接收缓冲，避免突发到达时内核丢包被误算为链路丢包
+    int rcvbuf = 1 << 20;
+    setsockopt(_fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(loopbackOnly ? INADDR_LOOPBACK : INADDR_ANY);
+    addr.sin_port = htons(port);
+    socklen_t len = sizeof(addr);
+    if (bind(_fd, (struct sockaddr*)&addr, len) != 0 || getsockname(_fd, (struct sockaddr*)&addr, &len) != 0) {
+        close();
+        return false;
+    }
+    _port = ntohs(addr.sin_port);
+    return true;
+}
+
+void UdpTelemetryReceiver::close() {
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+    _port = 0;
+}
+
+int UdpTelemetryReceiver::poll(int timeoutMs) {
+    if (_fd < 0) return 0;
+    struct pollfd pfd = {_fd, POLLIN, 0};
+    if (::poll(&pfd, 1, timeoutMs) <= 0) return 0;
+
+    uint8_t buf[2048];
+    int count = 0;
+    ssize_t n;
+    while ((n = recv(_fd, buf, sizeof(buf), MSG_DONTWAIT)) > 0) {
+        _recvUs = hostNowUs();
+        _bytes += (uint64_t)n;
+        count++;
+        // 每个数据报应恰好是一个完整帧：解码后缓冲区有残留或没有产生帧都算无效
+        uint32_t framesBefore = _decoder.stats().frames;
+        _decoder.feed(buf, (size_t)n);
+        if (_decoder.stats().frames == framesBefore) _monitor.onInvalid();
+        _decoder.resetStream();
+    }
+    return count;
+}
+
+void UdpTelemetryReceiver::onFrame(void* self, const TelemetryFrameHeader& header) {
+    UdpTelemetryReceiver* r = static_cast<UdpTelemetryReceiver*>(self);
+    r->_monitor.onFrame(header, r->_recvUs);
+}
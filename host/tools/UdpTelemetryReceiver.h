@@ -0,0 +1,107 @@
+#ifndef UdpTelemetryReceiver_h
+#define UdpTelemetryReceiver_h
+
+// 主机端UDP遥测接收库：每个数据报是一帧二进制遥测（TelemetryProtocol.h），
+// 按帧序号统计丢包、乱序和重复，按帧头的设备发送时刻统计单向延迟。
+// 只依赖POSIX套接字和TelemetryProtocol.cpp，不链接Arduino替身。
+
+#include <stdint.h>
+#include <vector>
+
+#include "TelemetryProtocol.h"
+
+struct LinkQualityStats {
+    uint32_t frames;            // 收到的有效帧（含重复）
+    uint32_t invalid;           // CRC或帧头无效的数据报
+    uint32_t expected;          // 首帧到最大帧序号之间应收的帧数
+    uint32_t lost;              // 应收 - 实收（迟到的帧到达后会从中扣除）
+    uint32_t reordered;         // 晚于更大序号到达的帧
+    uint32_t duplicates;
+    uint32_t samples;           // 收到的样本（不含重复帧）
+    uint32_t backfill;          // 补发帧（不计入序号窗口和延迟，去重见TelemetryDeduplicator）
+    float lossPercent;
+    // 单向延迟：时钟已对齐（setClockOffsetUs）时为绝对值，否则为相对观察到的最小传输时间
+    bool clockSynced;
+    float meanLatencyMs;
+    float p50LatencyMs;
+    float p99LatencyMs;
+    float maxLatencyMs;
+    float jitterMs;             // RFC 3550到达间隔抖动
+};
+
+// 与套接字无关的链路统计：每收到一帧调用onFrame()
+class TelemetryLinkMonitor {
+public:
+    TelemetryLinkMonitor();
+
+    // offsetUs = 主机时钟 - 设备时钟（微秒）；不设置时以最小传输时间为零点
+    void setClockOffsetUs(int64_t offsetUs);
+    void onFrame(const TelemetryFrameHeader& header, uint64_t recvUs);
+    void onInvalid() { _invalid++; }
+    LinkQualityStats stats() const;
+    void reset();
+
+private:
+    static constexpr uint32_t WINDOW = 1024;    // 重复检测窗口（帧）
+
+    bool _hasFirst;
+    uint32_t _firstSeq;
+    uint32_t _highestSeq;
+    uint32_t _uniqueFrames;
+    uint32_t _frames;
+    uint32_t _invalid;
+    uint32_t _reordered;
+    uint32_t _duplicates;
+    uint32_t _samples;
+    uint32_t _backfill;
+    uint64_t _seen[WINDOW / 64];
+
+    bool _clockSynced;
+    int64_t _clockOffsetUs;
+    int64_t _minTransitUs;
+    std::vector<int64_t> _transitUs;            // 主机接收时刻 - 设备发送时刻（含时钟差）
+    bool _hasLastTransit;
+    int64_t _lastTransitUs;
+    double _jitterUs;
+};
+
+// UDP套接字接收端：绑定本机端口，poll()收取并解码所有到达的数据报
+class UdpTelemetryReceiver {
+public:
+    UdpTelemetryReceiver();
+    ~UdpTelemetryReceiver();
+
+    // port为0时绑定临时端口，用port()查询
+    bool open(uint16_t port, bool loopbackOnly = false);
+    void close();
+    uint16_t port() const { return _port; }
+
+    // 等待最多timeoutMs毫秒，返回本次处理的数据报数
+    int poll(int timeoutMs);
+
+    void setRecordCallback(TelemetryDecoder::RecordCallback callback, void* context) {
+        _decoder.setCallback(callback, context);
+    }
+    void setSummaryCallbacks(TelemetryDecoder::WindowCallback window, TelemetryDecoder::BreathCallback breath,
+                             TelemetryDecoder::ModeCallback mode, void* context) {
+        _decoder.setSummaryCallbacks(window, breath, mode, context);
+    }
+    TelemetryLinkMonitor& monitor() { return _monitor; }
+    const TelemetryLinkMonitor& monitor() const { return _monitor; }
+    uint64_t bytes() const { return _bytes; }
+
+    // 主机单调时钟（微秒），与onFrame()的recvUs同一时基
+    static uint64_t hostNowUs();
+
+private:
+    static void onFrame(void* self, const TelemetryFrameHeader& header);
+
+    int _fd;
+    uint16_t _port;
+    uint64_t _bytes;
+    uint64_t _recvUs;
+    TelemetryDecoder _decoder;
+    TelemetryLinkMonitor _monitor;
+};
+
+#endif
@@ -0,0 +1,389 @@
+// 列式录制文件工具（ColumnarRecording.h）
+//
+//   import: 把已有CSV日志（Server_pp.py的respiratory_data.csv、telemetry_ingest --dir 的录制、
+//           固件文本行）导入为列式录制文件，报告格式、行数、无效行和压缩率；输出文件已存在时接着写
+//   info:   块数、行数、时间范围和各列压缩后每行字节数；--verify 校验全部块的CRC
+//   export: 按时间区间（--from/--to，相对第一行的秒数）导出CSV到标准输出，只解码区间内的块
+//   bench:  合成 --rows 行200Hz数据，对比CSV追加写入与列式写入的速率和文件大小、全量加载耗时、
+//           随机定位到某时刻读1秒数据的耗时（CSV只能顺序扫描），并逐位核对CSV导入与直接写入的结果
+// 只依赖接收库，不链接Arduino替身。
+//
+// 用法: recording_tool import IN.csv|- OUT.rec [--chunk N]
+//       recording_tool info FILE.rec [--verify]
+//       recording_tool export FILE.rec [--from S] [--to S]
+//       recording_tool bench [--rows N] [--chunk N]
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+#include "ColumnarRecording.h"
+#include "IngestRecording.h"
+
+namespace {
+const char* const STATE_NAMES[] = {"吸气", "呼气", "峰值", "谷值"};
+const char EXPORT_HEADER[] = "时间(Unix us),样本序号,压力(kPa),备用压力(kPa),流量(ml/min),温度(°C),CO2(ppm),"
+                             "氧浓度(%),气阀开度,呼吸状态,标志,窗口样本数\n";
+const char INGEST_HEADER[] = "主机时刻(Unix us),设备时间戳(us),样本序号,压力(kPa),备用压力(kPa),流量(ml/min),"
+                             "温度(°C),CO2(ppm),氧浓度(%),气阀开度,呼吸状态,标志,窗口样本数\n";
+constexpr uint32_t BENCH_RATE_HZ = 200;
+constexpr int BENCH_SEEKS = 1000;
+constexpr int BENCH_CSV_SEEKS = 10;
+
+double nowS() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint64_t fileSize(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? (uint64_t)st.st_size : 0;
+}
+
+void writeValue(FILE* f, float v, int digits) {
+    if (isnan(v)) fputc(',', f);
+    else fprintf(f, ",%.*f", digits, v);
+}
+
+void writeRow(FILE* f, const RecordingRow& r) {
+    fprintf(f, "%lld,%u", (long long)r.timeUs, r.seq);
+    writeValue(f, r.pressureKpa, 4);
+    writeValue(f, r.backupPressureKpa, 4);
+    writeValue(f, r.flowRate, 1);
+    writeValue(f, r.temperatureC, 2);
+    writeValue(f, r.co2Ppm, 0);
+    writeValue(f, r.oxygenPercent, 2);
+    writeValue(f, r.valveFraction, 4);
+    fprintf(f, ",%s,0x%02X,%u\n", r.state < 4 ? STATE_NAMES[r.state] : "?", r.flags, r.windowCount);
+}
+
+std::string formatTime(int64_t timeUs) {
+    time_t t = (time_t)(timeUs / 1000000);
+    struct tm tm;
+    char text[32];
+    localtime_r(&t, &tm);
+    strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &tm);
+    return text;
+}
+
+void printColumns(FILE* out, const uint64_t* bytes, uint64_t rows) {
+    for (uint8_t c = 0; c < RECORDING_COLUMN_COUNT; c++) {
+        fprintf(out, "%s%s %.2f", c == 0 ? "  每行字节: " : ", ", recordingColumnName(c),
+                rows ? (double)bytes[c] / rows : 0.0);
+    }
+    fprintf(out, "\n");
+}
+
+int runImport(const char* input, const char* output, uint32_t chunkRows) {
+    FILE* in = strcmp(input, "-") == 0 ? stdin : fopen(input, "r");
+    if (!in) {
+        fprintf(stderr, "无法打开 %s\n", input);
+        return 1;
+    }
+    RecordingWriter writer;
+    if (!writer.open(output, chunkRows)) {
+        fprintf(stderr, "无法写入 %s（已存在且不是录制文件？）\n", output);
+        if (in != stdin) fclose(in);
+        return 1;
+    }
+    uint64_t existingRows = writer.rows();
+    uint64_t existingBytes = writer.stats().fileBytes;
+    CsvImportStats stats;
+    double t0 = nowS();
+    bool ok = importCsvLog(in, writer, stats);
+    ok = writer.close() && ok;
+    double elapsedS = nowS() - t0;
+    uint64_t csvBytes = in == stdin ? 0 : fileSize(input);
+    if (in != stdin) fclose(in);
+    if (!ok) {
+        fprintf(stderr, "写入 %s 失败\n", output);
+        return 1;
+    }
+
+    const RecordingWriterStats& w = writer.stats();
+    printf("格式: %s, 行 %llu（无效 %llu）, 时间轴重新锚定 %u, 时间倒退钳制 %u\n", csvLogFormatName(stats.format),
+           (unsigned long long)stats.rows, (unsigned long long)stats.badLines, stats.reanchors, w.clampedTimes);
+    if (existingRows) printf("接在已有的 %llu 行之后\n", (unsigned long long)existingRows);
+    uint64_t written = w.fileBytes - existingBytes;
+    printf("写入 %u 块, %.1f KB", w.chunks, written / 1024.0);
+    if (csvBytes) printf("（CSV %.1f KB, %.1f 倍）", csvBytes / 1024.0, written ? (double)csvBytes / written : 0.0);
+    if (existingRows) printf(", 录制文件共 %.1f KB", w.fileBytes / 1024.0);
+    printf(", 导入 %.2f M行/s\n", elapsedS > 0 ? stats.rows / elapsedS / 1e6 : 0.0);
+    printColumns(stdout, w.columnBytes, w.rows);
+    return stats.rows > 0 ? 0 : 1;
+}
+
+int runInfo(const char* path, bool verify) {
+    RecordingReader reader;
+    if (!reader.open(path)) {
+        fprintf(stderr, "%s 不是录制文件\n", path);
+        return 1;
+    }
+    printf("%s: %llu 行, %zu 块（每块 %u 行）, %.1f KB%s\n", path, (unsigned long long)reader.rows(),
+           reader.chunkCount(), reader.chunkRows(), fileSize(path) / 1024.0,
+           reader.recovered() ? ", 没有索引（按块头恢复）" : "");
+    if (reader.rows() > 0) {
+        printf("时间: %s ~ %s（%.1f s）\n", formatTime(reader.firstTimeUs()).c_str(),
+               formatTime(reader.lastTimeUs()).c_str(), (reader.lastTimeUs() - reader.firstTimeUs()) / 1e6);
+    }
+    uint64_t bytes[RECORDING_COLUMN_COUNT] = {};
+    uint32_t bad = 0;
+    for (size_t i = 0; i < reader.chunkCount(); i++) {
+        for (uint8_t c = 0; c < RECORDING_COLUMN_COUNT; c++) bytes[c] += reader.columnBytes(i, c);
+        if (verify && !reader.verifyChunk(i)) bad++;
+    }
+    printColumns(stdout, bytes, reader.rows());
+    if (verify) printf("CRC校验: %zu 块, 错误 %u\n", reader.chunkCount(), bad);
+    return bad ? 1 : 0;
+}
+
+int runExport(const char* path, double fromS, double toS) {
+    RecordingReader reader;
+    if (!reader.open(path)) {
+        fprintf(stderr, "%s 不是录制文件\n", path);
+        return 1;
+    }
+    int64_t fromUs = reader.firstTimeUs() + (int64_t)(fromS * 1e6);
+    int64_t toUs = toS >= 0 ? reader.firstTimeUs() + (int64_t)(toS * 1e6) : reader.lastTimeUs();
+    fputs(EXPORT_HEADER, stdout);
+    uint64_t row = reader.seek(fromUs);
+    std::vector<RecordingRow> rows;
+    while (row < reader.rows() && reader.read(row, reader.chunkRows(), RECORDING_ALL_COLUMNS, rows) > 0) {
+        for (const RecordingRow& r : rows) {
+            if (r.timeUs > toUs) return 0;
+            writeRow(stdout, r);
+        }
+        row += rows.size();
+    }
+    return 0;
+}
+
+// ---------------- 基准 ----------------
+
+float quantize(float v, int digits) {
+    char text[32];
+    snprintf(text, sizeof(text), "%.*f", digits, v);
+    return (float)strtod(text, nullptr);
+}
+
+// 200Hz二进制遥测经接收服务录制的内容：主机时刻按100ms一帧到达，设备时间戳定速
+void syntheticSamples(uint32_t count, std::vector<IngestSample>& samples) {
+    samples.resize(count);
+    uint64_t startUs = 1700000000000000ull;
+    uint32_t noise = 12345;
+    uint32_t periodUs = 1000000 / BENCH_RATE_HZ;
+    for (uint32_t k = 0; k < count; k++) {
+        noise = noise * 1664525u + 1013904223u;
+        double t = k / (double)BENCH_RATE_HZ;
+        double phase = fmod(t, 3.0);
+        bool inhale = phase < 1.2;
+        double breath = inhale ? 0.5 * (1 - cos(2 * M_PI * phase / 1.2)) : 0;
+        IngestSample& s = samples[k];
+        uint64_t deviceUs = (uint64_t)k * periodUs;
+        s.hostUs = startUs + (deviceUs / 100000 + 1) * 100000 + (noise >> 8) % 3000;
+        s.deviceUs = (uint32_t)deviceUs;
+        s.seq = k;
+        s.pressureKpa = quantize((float)(101.3 + 2.0 * breath + ((int)((noise >> 16) % 100) - 50) * 1e-4), 4);
+        s.backupPressureKpa = quantize(s.pressureKpa + 0.0123f, 4);
+        s.flowRate = NAN;
+        s.temperatureC = quantize((float)(25.0 + 0.5 * sin(t / 600)), 2);
+        s.co2Ppm = quantize((float)(450 + 3000 * breath), 0);
+        s.oxygenPercent = quantize((float)(20.9 - 0.5 * breath), 2);
+        s.valveFraction = quantize(inhale ? 0.35f : 0.0f, 4);
+        s.state = inhale ? 0 : 1;
+        s.flags = 0x1D;
+        s.windowCount = 0;
+    }
+}
+
+void writeIngestCsv(FILE* f, const IngestSample& s) {
+    fprintf(f, "%llu,%u,%u", (unsigned long long)s.hostUs, s.deviceUs, s.seq);
+    writeValue(f, s.pressureKpa, 4);
+    writeValue(f, s.backupPressureKpa, 4);
+    writeValue(f, s.flowRate, 1);
+    writeValue(f, s.temperatureC, 2);
+    writeValue(f, s.co2Ppm, 0);
+    writeValue(f, s.oxygenPercent, 2);
+    writeValue(f, s.valveFraction, 4);
+    fprintf(f, ",%s,0x%02X,%u\n", STATE_NAMES[s.state], s.flags, s.windowCount);
+}
+
+bool sameRow(const RecordingRow& a, const RecordingRow& b) {
+    return a.timeUs == b.timeUs && a.seq == b.seq && memcmp(&a.pressureKpa, &b.pressureKpa, 7 * sizeof(float)) == 0 &&
+           a.state == b.state && a.flags == b.flags && a.windowCount == b.windowCount;
+}
+
+int runBench(uint32_t rowCount, uint32_t chunkRows) {
+    char dir[] = "/tmp/recording_benchXXXXXX";
+    if (!mkdtemp(dir)) {
+        fprintf(stderr, "无法创建临时目录\n");
+        return 1;
+    }
+    std::string csvPath = std::string(dir) + "/bench.csv";
+    std::string recPath = std::string(dir) + "/bench.rec";
+    std::string importPath = std::string(dir) + "/import.rec";
+
+    std::vector<IngestSample> samples;
+    syntheticSamples(rowCount, samples);
+    std::vector<RecordingRow> expected(rowCount);
+    RecordingTimeline timeline;
+    for (uint32_t k = 0; k < rowCount; k++) {
+        expected[k] = ingestRecordingRow(samples[k], timeline.map((int64_t)samples[k].hostUs, samples[k].deviceUs));
+    }
+    printf("=== 录制格式 (%u 行, 200Hz %.1f 分钟, 每块 %u 行) ===\n", rowCount, rowCount / 200.0 / 60, chunkRows);
+
+    // 写入
+    double t0 = nowS();
+    FILE* csv = fopen(csvPath.c_str(), "w");
+    if (!csv) return 1;
+    fputs(INGEST_HEADER, csv);
+    for (const IngestSample& s : samples) writeIngestCsv(csv, s);
+    fclose(csv);
+    double csvWriteS = nowS() - t0;
+
+    t0 = nowS();
+    RecordingWriter writer;
+    if (!writer.open(recPath, chunkRows)) return 1;
+    for (const RecordingRow& r : expected) writer.append(r);
+    writer.close();
+    double recWriteS = nowS() - t0;
+    uint64_t csvBytes = fileSize(csvPath);
+    uint64_t recBytes = fileSize(recPath);
+    printf("写入     CSV %7.2f M行/s %9.1f KB (%.1f 字节/行) | 列式 %7.2f M行/s %9.1f KB (%.2f 字节/行, %.1f 倍)\n",
+           rowCount / csvWriteS / 1e6, csvBytes / 1024.0, (double)csvBytes / rowCount, rowCount / recWriteS / 1e6,
+           recBytes / 1024.0, (double)recBytes / rowCount, (double)csvBytes / recBytes);
+    printColumns(stdout, writer.stats().columnBytes, rowCount);
+
+    // 全量加载：CSV逐行解析 vs mmap逐块解码
+    t0 = nowS();
+    csv = fopen(csvPath.c_str(), "r");
+    std::vector<IngestSample> loaded;
+    loaded.reserve(rowCount);
+    char* line = nullptr;
+    size_t capacity = 0;
+    ssize_t n;
+    while ((n = getline(&line, &capacity, csv)) > 0) {
+        IngestSample s;
+        if (parseIngestCsvLine(line, (size_t)n - 1, s)) loaded.push_back(s);
+    }
+    fclose(csv);
+    double csvLoadS = nowS() - t0;
+
+    RecordingReader reader;
+    t0 = nowS();
+    if (!reader.open(recPath)) return 1;
+    std::vector<RecordingRow> rows;
+    reader.read(0, reader.rows(), RECORDING_ALL_COLUMNS, rows);
+    double recLoadS = nowS() - t0;
+    t0 = nowS();
+    std::vector<RecordingRow> pressureRows;
+    reader.read(0, reader.rows(), 1u << RECORDING_TIME | 1u << RECORDING_PRESSURE, pressureRows);
+    double pressureLoadS = nowS() - t0;
+    printf("全量加载 CSV %7.2f M行/s (%zu 行)         | 列式 %7.2f M行/s, 只读时间+压力 %.2f M行/s\n",
+           loaded.size() / csvLoadS / 1e6, loaded.size(), rows.size() / recLoadS / 1e6,
+           pressureRows.size() / pressureLoadS / 1e6);
+
+    // 随机定位：某时刻起1秒的数据
+    uint32_t seed = 2024;
+    int64_t spanUs = reader.lastTimeUs() - reader.firstTimeUs();
+    std::vector<RecordingRow> window;
+    t0 = nowS();
+    size_t seekRows = 0;
+    for (int i = 0; i < BENCH_SEEKS; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        int64_t target = reader.firstTimeUs() + (int64_t)((seed >> 8) / 16777216.0 * spanUs);
+        seekRows += reader.read(reader.seek(target), BENCH_RATE_HZ, RECORDING_ALL_COLUMNS, window);
+    }
+    double recSeekUs = (nowS() - t0) / BENCH_SEEKS * 1e6;
+    t0 = nowS();
+    for (int i = 0; i < BENCH_CSV_SEEKS; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        uint64_t target = samples.front().hostUs + (uint64_t)((seed >> 8) / 16777216.0 * spanUs);
+        csv = fopen(csvPath.c_str(), "r");
+        while ((n = getline(&line, &capacity, csv)) > 0) {
+            IngestSample s;
+            if (parseIngestCsvLine(line, (size_t)n - 1, s) && s.hostUs >= target) break;
+        }
+        fclose(csv);
+    }
+    double csvSeekUs = (nowS() - t0) / BENCH_CSV_SEEKS * 1e6;
+    free(line);
+    printf("定位+1秒 CSV %10.0f us（顺序扫描）        | 列式 %7.1f us（%d 次, 平均 %zu 行）\n", csvSeekUs, recSeekUs,
+           BENCH_SEEKS, seekRows / BENCH_SEEKS);
+
+    // 核对：直接写入和CSV导入都逐位还原
+    uint64_t mismatches = 0;
+    for (size_t i = 0; i < rows.size() && i < expected.size(); i++) {
+        if (!sameRow(rows[i], expected[i])) mismatches++;
+    }
+    RecordingWriter importer;
+    CsvImportStats importStats;
+    csv = fopen(csvPath.c_str(), "r");
+    importer.open(importPath, chunkRows);
+    importCsvLog(csv, importer, importStats);
+    importer.close();
+    fclose(csv);
+    RecordingReader imported;
+    std::vector<RecordingRow> importedRows;
+    if (imported.open(importPath)) imported.read(0, imported.rows(), RECORDING_ALL_COLUMNS, importedRows);
+    for (size_t i = 0; i < importedRows.size() && i < expected.size(); i++) {
+        if (!sameRow(importedRows[i], expected[i])) mismatches++;
+    }
+    bool complete = rows.size() == expected.size() && importedRows.size() == expected.size();
+    printf("核对: 直接写入 %zu 行, CSV导入 %zu 行, 不一致 %llu\n", rows.size(), importedRows.size(),
+           (unsigned long long)mismatches);
+
+    reader.close();
+    imported.close();
+    unlink(csvPath.c_str());
+    unlink(recPath.c_str());
+    unlink(importPath.c_str());
+    rmdir(dir);
+    return complete && mismatches == 0 ? 0 : 1;
+}
+
+int usage(const char* program) {
+    fprintf(stderr,
+            "用法: %s import IN.csv|- OUT.rec [--chunk N]\n"
+            "       %s info FILE.rec [--verify]\n"
+            "       %s export FILE.rec [--from S] [--to S]\n"
+            "       %s bench [--rows N] [--chunk N]\n",
+            program, program, program, program);
+    return 2;
+}
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) return usage(argv[0]);
+    std::string command = argv[1];
+    std::vector<const char*> paths;
+    uint32_t chunkRows = RECORDING_DEFAULT_CHUNK_ROWS;
+    uint32_t rows = 1000000;
+    double fromS = 0;
+    double toS = -1;
+    bool verify = false;
+    for (int i = 2; i < argc; i++) {
+        if (!strcmp(argv[i], "--chunk") && i + 1 < argc) chunkRows = (uint32_t)atol(argv[++i]);
+        else if (!strcmp(argv[i], "--rows") && i + 1 < argc) rows = (uint32_t)atol(argv[++i]);
+        else if (!strcmp(argv[i], "--from") && i + 1 < argc) fromS = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--to") && i + 1 < argc) toS = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--verify")) verify = true;
+        else if (argv[i][0] != '-' || !strcmp(argv[i], "-")) paths.push_back(argv[i]);
+        else return usage(argv[0]);
+    }
+    if (chunkRows == 0 || chunkRows > RECORDING_MAX_CHUNK_ROWS) {
+        fprintf(stderr, "每块行数应为1~%u\n", RECORDING_MAX_CHUNK_ROWS);
+        return 2;
+    }
+    if (command == "import" && paths.size() == 2) return runImport(paths[0], paths[1], chunkRows);
+    if (command == "info" && paths.size() == 1) return runInfo(paths[0], verify);
+    if (command == "export" && paths.size() == 1) return runExport(paths[0], fromS, toS);
+    if (command == "bench" && paths.empty() && rows > 0) return runBench(rows, chunkRows);
+    return usage(argv[0]);
+}
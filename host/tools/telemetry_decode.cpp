@@ -0,0 +1,232 @@
+// 二进制遥测解码工具
+//
+// 把固件二进制遥测帧（TelemetryProtocol.h）解码为CSV输出到标准输出，统计写到标准错误。
+// 数据来源：文件（"-"为标准输入），--listen 在指定端口接受设备的TCP连接
+// （替代Server_pp.py接收二进制格式，连接断开后继续等待下一次连接），
+// 或 --udp 在指定端口接收UDP数据报并每5秒输出丢包/乱序/延迟统计。Ctrl+C结束。
+// 文件和TCP模式按(bootId, frameSeq)去重：断线补发或重启后重发的帧只输出一次。
+// 自适应遥测的降采样窗口按窗口平均值输出为CSV行（末三列给出窗口样本数和压力最小/最大值），
+// 呼吸摘要和模式切换记录写到标准错误。
+// 只依赖TelemetryProtocol.cpp和UDP接收库，不链接Arduino替身。
+//
+// 用法: telemetry_decode FILE|-
+//       telemetry_decode --listen PORT
+//       telemetry_decode --udp PORT
+
+#include <arpa/inet.h>
+#include <math.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "TelemetryDeduplicator.h"
+#include "TelemetryProtocol.h"
+#include "UdpTelemetryReceiver.h"
+
+namespace {
+const char* const STATE_NAMES[] = {"吸气", "呼气", "峰值", "谷值"};
+
+volatile sig_atomic_t g_stop = 0;
+TelemetryDeduplicator g_dedup;
+bool g_frameAccepted = true;
+
+void onSignal(int) {
+    g_stop = 1;
+}
+
+void printValue(float v, int digits) {
+    if (isnan(v)) printf(",");
+    else printf(",%.*f", digits, v);
+}
+
+void printRecord(void*, const TelemetryFrameHeader& header, const TelemetryRecord& r) {
+    printf("%u,%u,%u", header.frameSeq, r.seq, r.timestampUs);
+    printValue(r.pressureKpa, 4);
+    printValue(r.backupPressureKpa, 4);
+    printValue(r.flowRate, 1);
+    printValue(r.temperatureC, 2);
+    printValue(r.co2Ppm, 0);
+    printValue(r.oxygenPercent, 2);
+    printValue(r.valveFraction, 4);
+    printf(",%s,0x%02X,,,\n", r.state < 4 ? STATE_NAMES[r.state] : "?", r.flags);
+}
+
+void printWindow(void*, const TelemetryFrameHeader& header, const TelemetryWindowRecord& w) {
+    printf("%u,%u,%u", header.frameSeq, w.firstSeq, w.timestampUs);
+    printValue(w.pressureMeanKpa, 4);
+    printValue(w.backupPressureKpa, 4);
+    printValue(w.flowRate, 1);
+    printValue(w.temperatureC, 2);
+    printValue(w.co2Ppm, 0);
+    printValue(w.oxygenPercent, 2);
+    printValue(w.valveMean, 4);
+    printf(",%s,0x%02X,%u", w.state < 4 ? STATE_NAMES[w.state] : "?", w.flags, w.count);
+    printValue(w.pressureMinKpa, 4);
+    printValue(w.pressureMaxKpa, 4);
+    printf("\n");
+}
+
+void printBreath(void*, const TelemetryFrameHeader&, const TelemetryBreathRecord& b) {
+    fprintf(stderr, "呼吸 #%u: PIP %.3f kPa, PEEP %.3f kPa, 呼吸频率 %.1f/min, I:E 1:%.2f, 潮气量 %.0f ml\n",
+            b.breathIndex, b.pipKpa, b.peepKpa, b.respiratoryRate, b.ieRatio, b.tidalVolumeMl);
+}
+
+void printModeChange(void*, const TelemetryFrameHeader&, const TelemetryModeChange& c) {
+    fprintf(stderr, "遥测模式 %s -> %s（%s）, 下一样本 %u, 吞吐 %u B/s, 积压 %u B, 拒绝 %u, 队列 %u%%\n",
+            telemetryModeName(c.fromMode), telemetryModeName(c.toMode), telemetryModeReasonName(c.reason), c.nextSeq,
+            c.throughputBps, c.backlogBytes, c.rejected, c.queuePercent);
+}
+
+void onFrame(void*, const TelemetryFrameHeader& header) {
+    g_frameAccepted = g_dedup.accept(header);
+}
+
+void printUniqueRecord(void* context, const TelemetryFrameHeader& header, const TelemetryRecord& r) {
+    if (g_frameAccepted) printRecord(context, header, r);
+}
+
+void printUniqueWindow(void* context, const TelemetryFrameHeader& header, const TelemetryWindowRecord& w) {
+    if (g_frameAccepted) printWindow(context, header, w);
+}
+
+void printUniqueBreath(void* context, const TelemetryFrameHeader& header, const TelemetryBreathRecord& b) {
+    if (g_frameAccepted) printBreath(context, header, b);
+}
+
+void printUniqueModeChange(void* context, const TelemetryFrameHeader& header, const TelemetryModeChange& c) {
+    if (g_frameAccepted) printModeChange(context, header, c);
+}
+
+void printStats(const TelemetryDecoder& decoder) {
+    const TelemetryDecoderStats& s = decoder.stats();
+    fprintf(stderr, "帧 %u, 样本 %u, CRC错误 %u, 帧头无效 %u, 跳过字节 %u, 丢失帧 %u, 丢失样本 %u\n", s.frames,
+            s.records, s.crcErrors, s.badHeaders, s.skippedBytes, s.lostFrames, s.lostSamples);
+    if (s.compressedFrames || s.badPayloads) {
+        fprintf(stderr, "压缩: %u 帧, 负载 %.1f 字节/样本, 无法还原 %u 帧\n", s.compressedFrames,
+                s.records ? (double)s.payloadBytes / s.records : 0.0, s.badPayloads);
+    }
+    if (s.windowRecords || s.breathRecords || s.modeChanges || s.unknownFrames) {
+        fprintf(stderr, "摘要: 窗口 %u, 呼吸 %u, 模式切换 %u, 未知类型帧 %u\n", s.windowRecords, s.breathRecords,
+                s.modeChanges, s.unknownFrames);
+    }
+    DedupStats d = g_dedup.stats();
+    fprintf(stderr, "去重: 唯一帧 %u（补发 %u）, 重复帧 %u, 仍缺失帧 %u（%u处）, 启动 %u\n", d.frames, d.backfillFrames,
+            d.duplicates, d.missingFrames, d.gaps, d.boots);
+}
+
+int decodeFile(const char* path, TelemetryDecoder& decoder) {
+    FILE* f = strcmp(path, "-") ? fopen(path, "rb") : stdin;
+    if (!f) {
+        fprintf(stderr, "无法打开 %s\n", path);
+        return 1;
+    }
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+        decoder.feed(buf, n);
+    }
+    if (f != stdin) fclose(f);
+    return 0;
+}
+
+int listenAndDecode(uint16_t port, TelemetryDecoder& decoder) {
+    int listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (listenFd < 0 || bind(listenFd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(listenFd, 1) != 0) {
+        fprintf(stderr, "无法监听端口 %u\n", port);
+        if (listenFd >= 0) close(listenFd);
+        return 1;
+    }
+    fprintf(stderr, "等待设备连接，端口 %u\n", port);
+
+    uint8_t buf[4096];
+    while (!g_stop) {
+        struct sockaddr_in peer = {};
+        socklen_t len = sizeof(peer);
+        int fd = accept(listenFd, (struct sockaddr*)&peer, &len);
+        if (fd < 0) continue;
+        fprintf(stderr, "设备已连接: %s\n", inet_ntoa(peer.sin_addr));
+        ssize_t n;
+        while (!g_stop && (n = recv(fd, buf, sizeof(buf), 0)) > 0) {
+            decoder.feed(buf, (size_t)n);
+            fflush(stdout);
+        }
+        close(fd);
+        decoder.resetStream();
+        fprintf(stderr, "连接断开\n");
+        printStats(decoder);
+    }
+    close(listenFd);
+    return 0;
+}
+
+void printLinkStats(const UdpTelemetryReceiver& receiver) {
+    LinkQualityStats s = receiver.monitor().stats();
+    fprintf(stderr, "帧 %u/%u, 丢失 %u (%.2f%%), 乱序 %u, 重复 %u, 无效 %u, 补发 %u; 延迟(相对最小值) 平均 %.2f ms, "
+                    "P99 %.2f ms, 最大 %.2f ms, 抖动 %.2f ms\n", s.frames, s.expected, s.lost, s.lossPercent,
+            s.reordered, s.duplicates, s.invalid, s.backfill, s.meanLatencyMs, s.p99LatencyMs, s.maxLatencyMs,
+            s.jitterMs);
+}
+
+int receiveUdp(uint16_t port) {
+    UdpTelemetryReceiver receiver;
+    if (!receiver.open(port)) {
+        fprintf(stderr, "无法监听UDP端口 %u\n", port);
+        return 1;
+    }
+    receiver.setRecordCallback(printRecord, nullptr);
+    receiver.setSummaryCallbacks(printWindow, printBreath, printModeChange, nullptr);
+    fprintf(stderr, "等待UDP遥测，端口 %u\n", port);
+    uint64_t lastReportUs = UdpTelemetryReceiver::hostNowUs();
+    while (!g_stop) {
+        if (receiver.poll(200) > 0) fflush(stdout);
+        if (UdpTelemetryReceiver::hostNowUs() - lastReportUs >= 5000000) {
+            lastReportUs = UdpTelemetryReceiver::hostNowUs();
+            printLinkStats(receiver);
+        }
+    }
+    printLinkStats(receiver);
+    return 0;
+}
+}
+
+int main(int argc, char** argv) {
+    bool listenMode = argc == 3 && !strcmp(argv[1], "--listen");
+    bool udpMode = argc == 3 && !strcmp(argv[1], "--udp");
+    if (!listenMode && !udpMode && argc != 2) {
+        fprintf(stderr, "用法: %s FILE|-\n       %s --listen PORT\n       %s --udp PORT\n", argv[0], argv[0],
+                argv[0]);
+        return 2;
+    }
+
+    TelemetryDecoder decoder;
+    decoder.setCallback(printUniqueRecord, nullptr);
+    decoder.setFrameCallback(onFrame, nullptr);
+    decoder.setSummaryCallbacks(printUniqueWindow, printUniqueBreath, printUniqueModeChange, nullptr);
+    printf("帧序号,样本序号,时间戳(us),压力(kPa),备用压力(kPa),流量(ml/min),温度(°C),CO2(ppm),氧浓度(%%),气阀开度,呼吸状态,标志,"
+           "窗口样本数,压力最小(kPa),压力最大(kPa)\n");
+
+    if (udpMode) {
+        signal(SIGINT, onSignal);
+        return receiveUdp((uint16_t)atoi(argv[2]));
+    }
+
+    int rc;
+    if (listenMode) {
+        signal(SIGINT, onSignal);
+        rc = listenAndDecode((uint16_t)atoi(argv[2]), decoder);
+    } else {
+        rc = decodeFile(argv[1], decoder);
+    }
+    printStats(decoder);
+    return rc;
+}
@@ -0,0 +1,280 @@
+// 遥测接收服务
+//
+// 替代Server_pp.py的接收部分：epoll单线程同时接收多台设备的文本行和二进制帧（TCP，
+// --udp 另收UDP帧），跨包的半行/半帧正确重组，样本写入每设备环形缓冲，--dir 指定时
+// 每设备录制一个CSV文件（--columnar 改为列式录制文件，见ColumnarRecording.h）。
+// 每5秒（--stats S）把统计写到标准错误，Ctrl+C结束。
+// 只依赖TelemetryProtocol.cpp和接收库，不链接Arduino替身。
+//
+// --bench 内置吞吐基准：按固件格式生成每设备 --samples 个样本的文本行（--binary 为二进制帧，
+// --compress 压缩帧），先按随机长度切块直接喂给解析器测纯解析速率，再由 --devices 个线程
+// 各用一个本机地址（127.0.0.2起）同时连接服务并尽快发送，测端到端接收速率，核对每台设备
+// 收到的样本数；--dir 时同时录制。
+//
+// 用法: telemetry_ingest [--port PORT] [--udp PORT] [--dir DIR [--columnar]] [--ring N] [--stats S]
+//       telemetry_ingest --bench [--devices N] [--samples N] [--binary [--compress]] [--dir DIR [--columnar]]
+
+#include <arpa/inet.h>
+#include <chrono>
+#include <math.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "IngestServer.h"
+#include "TelemetryProtocol.h"
+
+namespace {
+constexpr double SAMPLE_RATE_HZ = 200;
+constexpr double PERIOD_S = 3.0;
+constexpr double INSPIRATION_FRACTION = 0.4;
+constexpr size_t MAX_CHUNK = 2920;          // 两个以太网MSS，切块长度在1~MAX_CHUNK之间
+constexpr double BENCH_TIMEOUT_S = 120;
+const char* const STATE_NAMES[] = {"INHALE", "EXHALE", "PEAK", "TROUGH"};
+
+volatile sig_atomic_t g_stop = 0;
+
+void onSignal(int) {
+    g_stop = 1;
+}
+
+double nowS() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 确定性的切块长度（各线程独立）
+uint32_t nextChunk(uint32_t& state) {
+    state = state * 1664525u + 1013904223u;
+    return 1 + (state >> 8) % MAX_CHUNK;
+}
+
+float breathPressure(double t) {
+    double phase = fmod(t, PERIOD_S);
+    double ti = PERIOD_S * INSPIRATION_FRACTION;
+    return (float)(101.3 + (phase < ti ? 1.0 * (1 - cos(2 * M_PI * phase / ti)) : 0));
+}
+
+uint8_t breathState(double t) {
+    return fmod(t, PERIOD_S) < PERIOD_S * INSPIRATION_FRACTION ? 0 : 1;
+}
+
+// 与BreathController::sendDataOverWiFi()相同的行格式
+std::vector<uint8_t> makeText(uint32_t samples) {
+    std::string s;
+    s.reserve((size_t)samples * 40);
+    char line[96];
+    for (uint32_t i = 0; i < samples; i++) {
+        double t = i / SAMPLE_RATE_HZ;
+        int n = snprintf(line, sizeof(line), "%lu,%.4f,%.2f,%.2f,%s\r\n", (unsigned long)(t * 1000),
+                         breathPressure(t), 25.0 + 0.01 * (i % 7), breathState(t) == 0 ? 0.35 : 0.0,
+                         STATE_NAMES[breathState(t)]);
+        s.append(line, (size_t)n);
+    }
+    return std::vector<uint8_t>(s.begin(), s.end());
+}
+
+std::vector<uint8_t> makeBinary(uint32_t samples, bool compress) {
+    std::vector<uint8_t> out;
+    TelemetryEncoder encoder(20);
+    encoder.setBase(101.3f, 25.0f);
+    encoder.setSampleRate((uint16_t)SAMPLE_RATE_HZ);
+    encoder.setBootId(1);
+    encoder.setCompression(compress);
+    for (uint32_t i = 0; i < samples; i++) {
+        double t = i / SAMPLE_RATE_HZ;
+        TelemetryRecord r;
+        r.seq = i;
+        r.timestampUs = (uint32_t)(t * 1e6);
+        r.pressureKpa = breathPressure(t);
+        r.backupPressureKpa = r.pressureKpa + 0.002f;
+        r.flowRate = NAN;
+        r.temperatureC = 25.0f + 0.01f * (i % 7);
+        r.co2Ppm = 450;
+        r.oxygenPercent = 20.9f;
+        r.valveFraction = breathState(t) == 0 ? 0.35f : 0.0f;
+        r.state = breathState(t);
+        r.flags = TELEMETRY_FLAG_BASE_SET;
+        bool full = encoder.add(r);
+        if (full || i + 1 == samples) {
+            size_t len = encoder.finish(r.timestampUs);
+            out.insert(out.end(), encoder.data(), encoder.data() + len);
+        }
+    }
+    return out;
+}
+
+void sendAll(int fd, const std::vector<uint8_t>& data, uint32_t seed) {
+    size_t offset = 0;
+    while (offset < data.size()) {
+        size_t n = nextChunk(seed);
+        if (n > data.size() - offset) n = data.size() - offset;
+        ssize_t sent = send(fd, data.data() + offset, n, MSG_NOSIGNAL);
+        if (sent <= 0) return;
+        offset += (size_t)sent;
+    }
+}
+
+// 一台模拟设备：从127.0.0.(2+index)连接服务并发送全部数据
+void deviceThread(uint16_t port, int index, const std::vector<uint8_t>* data) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return;
+    struct sockaddr_in local = {};
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_LOOPBACK + 1 + index);
+    struct sockaddr_in server = {};
+    server.sin_family = AF_INET;
+    server.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    server.sin_port = htons(port);
+    if (bind(fd, (struct sockaddr*)&local, sizeof(local)) == 0 &&
+        connect(fd, (struct sockaddr*)&server, sizeof(server)) == 0) {
+        sendAll(fd, *data, 12345u + (uint32_t)index);
+    }
+    close(fd);
+}
+
+int runBench(int devices, uint32_t samples, bool binary, bool compress, const std::string& dir,
+             IngestRecordingFormat recordingFormat) {
+    std::vector<uint8_t> data = binary ? makeBinary(samples, compress) : makeText(samples);
+    const char* format = binary ? (compress ? "二进制压缩帧" : "二进制帧") : "文本行";
+    printf("=== 遥测接收吞吐 (%s, %u 样本/设备, %.1f 字节/样本) ===\n", format, samples,
+           (double)data.size() / samples);
+
+    // 纯解析：随机切块喂给单个解析器
+    IngestStream stream;
+    uint32_t seed = 1;
+    double t0 = nowS();
+    for (size_t offset = 0; offset < data.size();) {
+        size_t n = nextChunk(seed);
+        if (n > data.size() - offset) n = data.size() - offset;
+        stream.feed(data.data() + offset, n);
+        offset += n;
+    }
+    double parseS = nowS() - t0;
+    const IngestStreamStats& ps = stream.stats();
+    printf("解析:               %.1f MB/s, %.2f M样本/s（%.0f ns/样本）, 样本 %u/%u, 无效行 %u, CRC错误 %u\n",
+           data.size() / parseS / 1048576.0, ps.samples / parseS / 1e6, parseS * 1e9 / samples, ps.samples,
+           samples, ps.badLines, ps.crcErrors);
+
+    // 端到端：多台设备同时连接本机服务
+    IngestServer server;
+    server.setRingCapacity(INGEST_DEFAULT_RING);
+    if (!dir.empty()) server.setRecordingDir(dir);
+    server.setRecordingFormat(recordingFormat);
+    if (!server.listenTcp(0, true)) {
+        fprintf(stderr, "无法监听本机端口\n");
+        return 1;
+    }
+    uint64_t expected = (uint64_t)devices * samples;
+    std::vector<std::thread> threads;
+    t0 = nowS();
+    for (int i = 0; i < devices; i++) threads.emplace_back(deviceThread, server.tcpPort(), i, &data);
+    double lastSampleS = t0;
+    uint64_t received = 0;
+    while (nowS() - t0 < BENCH_TIMEOUT_S) {
+        server.poll(10);
+        uint64_t total = server.stats().samples;
+        if (total != received) {
+            received = total;
+            lastSampleS = nowS();
+        }
+        if (received >= expected && server.stats().activeConnections == 0) break;
+    }
+    for (std::thread& t : threads) t.join();
+    server.flushRecordings();
+    double e2eS = lastSampleS - t0;
+
+    IngestServerStats s = server.stats();
+    uint32_t complete = 0;
+    for (auto& entry : server.devices()) {
+        if (entry.second->stats.samples == samples) complete++;
+    }
+    printf("端到端(%d 设备):      %.1f MB/s, %.2f M样本/s, 用时 %.2f s, 样本 %llu/%llu, 完整设备 %u/%d\n", devices,
+           s.bytes / e2eS / 1048576.0, s.samples / e2eS / 1e6, e2eS, (unsigned long long)s.samples,
+           (unsigned long long)expected, complete, devices);
+    printf("                    无效行 %u, 超长行 %u, CRC错误 %u, 重复帧 %u, 录制 %llu 样本\n", s.badLines,
+           s.longLines, s.crcErrors, s.duplicateFrames, (unsigned long long)s.recordedSamples);
+    printf("相当于200Hz设备:    %.0f 台（端到端）, %.0f 台（纯解析）\n", s.samples / e2eS / SAMPLE_RATE_HZ,
+           ps.samples / parseS / SAMPLE_RATE_HZ);
+    return complete == (uint32_t)devices ? 0 : 1;
+}
+
+int runServer(uint16_t port, uint16_t udpPort, const std::string& dir, IngestRecordingFormat format, size_t ring,
+              double statsS) {
+    IngestServer server;
+    server.setRingCapacity(ring);
+    if (!dir.empty()) server.setRecordingDir(dir);
+    server.setRecordingFormat(format);
+    if (!server.listenTcp(port)) {
+        fprintf(stderr, "无法监听TCP端口 %u\n", port);
+        return 1;
+    }
+    if (udpPort && !server.listenUdp(udpPort)) {
+        fprintf(stderr, "无法监听UDP端口 %u\n", udpPort);
+        return 1;
+    }
+    fprintf(stderr, "等待设备连接，TCP端口 %u%s%s\n", server.tcpPort(), udpPort ? "，UDP端口 " : "",
+            udpPort ? std::to_string(server.udpPort()).c_str() : "");
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    double lastReport = nowS();
+    while (!g_stop) {
+        if (server.poll(200) < 0) break;
+        if (nowS() - lastReport >= statsS) {
+            lastReport = nowS();
+            server.printStats(stderr);
+        }
+    }
+    server.close();
+    server.printStats(stderr);
+    return 0;
+}
+}
+
+int main(int argc, char** argv) {
+    bool bench = false;
+    bool binary = false;
+    bool compress = false;
+    int devices = 8;
+    uint32_t samples = 200000;
+    uint16_t port = 8080;
+    uint16_t udpPort = 0;
+    std::string dir;
+    IngestRecordingFormat format = INGEST_RECORD_CSV;
+    size_t ring = INGEST_DEFAULT_RING;
+    double statsS = 5;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--bench")) bench = true;
+        else if (!strcmp(argv[i], "--binary")) binary = true;
+        else if (!strcmp(argv[i], "--compress")) binary = compress = true;
+        else if (!strcmp(argv[i], "--devices") && i + 1 < argc) devices = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--samples") && i + 1 < argc) samples = (uint32_t)atol(argv[++i]);
+        else if (!strcmp(argv[i], "--port") && i + 1 < argc) port = (uint16_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--udp") && i + 1 < argc) udpPort = (uint16_t)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--dir") && i + 1 < argc) dir = argv[++i];
+        else if (!strcmp(argv[i], "--columnar")) format = INGEST_RECORD_COLUMNAR;
+        else if (!strcmp(argv[i], "--ring") && i + 1 < argc) ring = (size_t)atol(argv[++i]);
+        else if (!strcmp(argv[i], "--stats") && i + 1 < argc) statsS = atof(argv[++i]);
+        else {
+            fprintf(stderr, "用法: %s [--port PORT] [--udp PORT] [--dir DIR [--columnar]] [--ring N] [--stats S]\n"
+                            "       %s --bench [--devices N] [--samples N] [--binary [--compress]] [--dir DIR [--columnar]]\n",
+                    argv[0], argv[0]);
+            return 2;
+        }
+    }
+    if (bench) {
+        if (devices < 1 || devices > 250 || samples == 0) {
+            fprintf(stderr, "设备数应为1~250，样本数大于0\n");
+            return 2;
+        }
+        return runBench(devices, samples, binary, compress, dir, format);
+    }
+    return runServer(port, udpPort, dir, format, ring, statsS);
+}
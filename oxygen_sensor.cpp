@@ -3,12 +3,8 @@
 // 构造函数
 OxygenSensor::OxygenSensor(ADS1115* ads, uint8_t muxChannel)
     : _ads(ads), _muxChannel(muxChannel), _a0(0), _a1(0), _isCalibrated(false),
-      _filterEnabled(true), _filterSize(5), _filterIndex(0) {
-    
-    // 初始化滤波缓冲区
-    for (uint8_t i = 0; i < MAX_FILTER_SIZE; i++) {
-        _filterBuffer[i] = 0;
-    }
+      _filterEnabled(true) {
+    _filter.setWindow(5);
 }
 
 // 初始化传感器
@@ -58,7 +54,7 @@ float OxygenSensor::readOxygenConcentration() {
     
     // 应用滤波
     if (_filterEnabled) {
-        rawADC = applyFilter(rawADC);
+        rawADC = _filter.update(rawADC);
     }
     
     // 应用计算公式: 氧气浓度 = (Ax − A0) × 20.9/(A1 − A0)
@@ -177,22 +173,5 @@ bool OxygenSensor::isCalibrated() {
 
 // 设置滤波窗口大小
 void OxygenSensor::setFilterWindow(uint8_t windowSize) {
-    if (windowSize > 0 && windowSize <= MAX_FILTER_SIZE) {
-        _filterSize = windowSize;
-    }
-}
-
-// 应用移动平均滤波
-int16_t OxygenSensor::applyFilter(int16_t rawValue) {
-    // 更新滤波缓冲区
-    _filterBuffer[_filterIndex] = rawValue;
-    _filterIndex = (_filterIndex + 1) % _filterSize;
-    
-    // 计算平均值
-    long sum = 0;
-    for (uint8_t i = 0; i < _filterSize; i++) {
-        sum += _filterBuffer[i];
-    }
-    
-    return (int16_t)(sum / _filterSize);
+    _filter.setWindow(windowSize);
 }
@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include "ADS1115.h"
+#include "StreamFilter.h"
 
 // 电化学氧传感器类
 class OxygenSensor {
@@ -44,7 +45,7 @@ public:
     // 应用移动平均滤波
     void enableFilter(bool enable) { _filterEnabled = enable; }
     
-    // 设置滤波窗口大小
+    // 设置滤波窗口大小（1–10，默认5；会清空滤波历史）
     void setFilterWindow(uint8_t windowSize);
 
 private:
@@ -57,12 +58,7 @@ private:
     // 滤波相关
     bool _filterEnabled;
     static const uint8_t MAX_FILTER_SIZE = 10;
-    uint8_t _filterSize;
-    int16_t _filterBuffer[MAX_FILTER_SIZE];
-    uint8_t _filterIndex;
-    
-    // 应用滤波
-    int16_t applyFilter(int16_t rawValue);
+    MovingAverage<int16_t, MAX_FILTER_SIZE, int32_t> _filter;
 };
 
 #endif
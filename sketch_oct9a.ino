@@ -143,6 +143,9 @@ void setup() {
     // Serial1.begin(1200);  // 使用Serial1，波特率1200
     // 或者使用Serial2: Serial2.begin(1200);
     
+    // 主气压传感器以200Hz定时采样（设为0恢复原有delay(100)循环）
+    breathController.setSamplingRate(200);
+    
     // 初始化气压、温度以及控制器
     breathController.begin();
     
@@ -150,6 +153,9 @@ void setup() {
     Serial.println("\n=== 初始化氧传感器 ===");
     breathController.initializeOxygenSensor();
     
+    // 启动双核流水线：采集/控制在核1，遥测/OLED/日志在核0（失败时沿用loop()单核循环）
+    breathController.startPipeline();
+    
     Serial.println("\n=== 系统初始化完成 ===");
     Serial.println("开始主循环...");
     Serial.println("ACD1100当前通信模式: I2C");